@@ -0,0 +1,38 @@
+#!/bin/env python
+
+# Compares the run time of the algorithms which use the frozen snapshot (see
+# Graph.freeze()) with the regular adjacency lists. Usage:
+#
+#     python bench_freeze.py [N] [average degree]
+
+from __future__ import print_function
+
+import sys
+import timeit
+from graph_tool.all import *
+import numpy
+import numpy.random
+
+N = int(sys.argv[1]) if len(sys.argv) > 1 else 1000000
+k = float(sys.argv[2]) if len(sys.argv) > 2 else 10
+
+numpy.random.seed(42)
+seed_rng(42)
+
+g = Graph(directed=True)
+g.add_vertex(N)
+g.add_edge_list(numpy.random.randint(0, N, (int(N * k), 2)))
+
+algorithms = [("pagerank", lambda g: pagerank(g)),
+              ("eigenvector", lambda g: eigenvector(g)),
+              ("katz", lambda g: katz(g)),
+              ("hits", lambda g: hits(g))]
+
+print("N = %d, E = %d" % (g.num_vertices(), g.num_edges()))
+print("freeze: %g s" % timeit.timeit(lambda: (g.freeze(), g.thaw()), number=1))
+for name, f in algorithms:
+    t = min(timeit.repeat(lambda: f(g), number=1, repeat=3))
+    g.freeze()
+    tf = min(timeit.repeat(lambda: f(g), number=1, repeat=3))
+    g.thaw()
+    print("%s: %g s, frozen: %g s (speedup: %.2f)" % (name, t, tf, t / tf))
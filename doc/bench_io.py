@@ -0,0 +1,78 @@
+#!/bin/env python
+
+# Measures the time taken to save and load a random graph with a few property
+# maps in the supported file formats. Usage:
+#
+#     python bench_io.py [N] [average degree]
+#
+# The readers can be compared with those of an earlier version (e.g. the
+# previous GML parser) by running the script with each build.
+
+from __future__ import print_function
+
+import os
+import sys
+import timeit
+import tempfile
+import shutil
+import gzip
+from graph_tool.all import *
+import numpy
+import numpy.random
+
+N = int(sys.argv[1]) if len(sys.argv) > 1 else 1000000
+k = float(sys.argv[2]) if len(sys.argv) > 2 else 10
+E = int(N * k)
+
+numpy.random.seed(42)
+seed_rng(42)
+
+g = Graph(directed=True)
+g.add_vertex(N)
+g.add_edge_list(numpy.random.randint(0, N, (E, 2)))
+g.vp.x = g.new_vp("double", vals=numpy.random.random(N))
+g.vp.s = g.new_vp("string", vals=numpy.random.randint(0, 1000, N).astype("str"))
+g.ep.w = g.new_ep("int", vals=numpy.random.randint(0, 1000, E))
+
+tmpdir = tempfile.mkdtemp()
+
+def bench(ext):
+    fn = os.path.join(tmpdir, "g." + ext)
+    ts = min(timeit.repeat(lambda: g.save(fn), number=1, repeat=3))
+    tl = min(timeit.repeat(lambda: load_graph(fn), number=1, repeat=3))
+    print("%s: save %g s, load %g s, %d bytes" % (ext, ts, tl,
+                                                  os.path.getsize(fn)))
+
+# a plain .gt file given by its path is parsed directly from its memory
+# mapping, whereas a file object is read through a stream, with the adjacency
+# inserted in batches
+def bench_stream():
+    fn = os.path.join(tmpdir, "g.gt")
+    g.save(fn)
+    def load():
+        with open(fn, "rb") as f:
+            load_graph(f, fmt="gt")
+    tl = min(timeit.repeat(load, number=1, repeat=3))
+    print("gt (file object): load %g s" % tl)
+
+# the .gt.gz files are written as independent gzip members, which are
+# compressed and decompressed in parallel; an ordinary gzip file with the same
+# contents is decompressed as a single stream
+def bench_gz():
+    bench("gt.gz")
+    fn = os.path.join(tmpdir, "g.gt")
+    g.save(fn)
+    sfn = os.path.join(tmpdir, "single.gt.gz")
+    with open(fn, "rb") as f, gzip.open(sfn, "wb") as gf:
+        shutil.copyfileobj(f, gf)
+    tl = min(timeit.repeat(lambda: load_graph(sfn), number=1, repeat=3))
+    print("gt.gz (single stream): load %g s, %d bytes" %
+          (tl, os.path.getsize(sfn)))
+
+print("N = %d, E = %d" % (g.num_vertices(), g.num_edges()))
+for ext in ["gt", "xml", "gml"]:
+    bench(ext)
+bench_stream()
+bench_gz()
+
+shutil.rmtree(tmpdir)
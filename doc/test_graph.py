@@ -0,0 +1,744 @@
+#!/bin/env python
+
+from __future__ import print_function
+
+verbose = __name__ == "__main__"
+
+import os
+import sys
+if not verbose:
+    out = open(os.devnull, 'w')
+else:
+    out = sys.stdout
+from graph_tool.all import *
+import graph_tool
+import numpy
+import numpy.random
+import tempfile
+import threading
+
+numpy.random.seed(42)
+seed_rng(42)
+
+def rand_graph(N, E, directed=True):
+    g = Graph(directed=directed)
+    g.add_vertex(N)
+    g.add_edge_list(numpy.random.randint(0, N, (E, 2)))
+    return g
+
+def edge_set(g, x=None):
+    if x is None:
+        x = g.vertex_index
+    return sorted((x[e.source()], x[e.target()]) for e in g.edges())
+
+# frozen snapshot
+
+g = rand_graph(200, 1000)
+es = edge_set(g)
+u = GraphView(g, vfilt=lambda v: int(v) % 2 == 0, reversed=True)
+w = g.new_ep("double", vals=numpy.random.random(g.num_edges()))
+pr = pagerank(g)
+pr_u = pagerank(u)
+ds = [shortest_distance(x, 0, weights=wx).a.copy()
+      for x in [g, u] for wx in [None, w]]
+cl = [local_clustering(x).a.copy() for x in [g, u]]
+gcl = [global_clustering(x) for x in [g, u]]
+g.freeze()
+assert g.is_frozen()
+assert edge_set(g) == es
+assert numpy.allclose(pagerank(g).a, pr.a)
+assert numpy.allclose(pagerank(u).a, pr_u.a)
+assert all(numpy.array_equal(shortest_distance(x, 0, weights=wx).a, d)
+           for (x, wx), d in zip([(x, wx) for x in [g, u] for wx in [None, w]],
+                                 ds))
+assert all(numpy.allclose(local_clustering(x).a, c) for x, c in zip([g, u], cl))
+assert numpy.allclose([global_clustering(x) for x in [g, u]], gcl)
+for f in [lambda: g.add_vertex(), lambda: g.add_edge(0, 1),
+          lambda: g.remove_edge(next(g.edges()))]:
+    try:
+        f()
+        assert False, "frozen graph was modified"
+    except RuntimeError:
+        pass
+g.thaw()
+assert not g.is_frozen()
+g.add_edge(0, 1)
+print("freeze:", g, file=out)
+
+# vertex reordering
+
+g = rand_graph(100, 300)
+x = g.new_vp("int", vals=numpy.arange(g.num_vertices()))
+es = edge_set(g, x)
+order = numpy.random.permutation(g.num_vertices())
+g.reorder_vertices(order)
+assert edge_set(g, x) == es
+assert all(x.a[order] == numpy.arange(g.num_vertices()))
+for method in ["rcm", "degree", "window"]:
+    order = vertex_ordering(g, method)
+    assert sorted(order.a) == list(range(g.num_vertices()))
+print("reorder_vertices:", g, file=out)
+
+# compact index
+
+g = rand_graph(100, 300)
+g.remove_edge(g.edge(*next(iter(edge_set(g)))))
+eidx = [g.edge_index[e] for e in g.edges()]
+assert sorted(eidx) == sorted(set(eidx))
+assert max(eidx) < g.edge_index_range
+w = g.new_ep("int64_t", vals=eidx)
+assert all(w.fa == numpy.array(eidx))
+if graph_tool.libcore.compact_index_enabled():
+    assert g.edge_index.value_type() == "unsigned int"
+print("compact index:", graph_tool.libcore.compact_index_enabled(), file=out)
+
+# edge pool
+
+g = rand_graph(100, 1000)
+h = Graph(directed=True)
+h.set_edge_pool(True)
+h.add_vertex(g.num_vertices())
+for e in g.edges():
+    h.add_edge(e.source(), e.target())
+assert h.get_edge_pool()
+assert edge_set(h) == edge_set(g)
+assert h.get_edge_memory_stats()["n_slabs"] > 0
+h.shrink_to_fit()
+assert edge_set(h) == edge_set(g)
+h.clear()
+assert h.get_edge_memory_stats()["n_slabs"] == 0
+print("edge pool:", h.get_edge_memory_stats(), file=out)
+
+# bulk edge insertion
+
+el = numpy.random.randint(0, 100, (1000, 3)).astype("double")
+g1 = Graph()
+w1 = g1.new_ep("int")
+g1.add_edge_list(el, eprops=[w1])
+g2 = Graph()
+w2 = g2.new_ep("int")
+g2.add_edge_list(el.tolist(), eprops=[w2])
+assert g1.num_vertices() == g2.num_vertices()
+assert ([(int(e.source()), int(e.target()), w1[e]) for e in g1.edges()] ==
+        [(int(e.source()), int(e.target()), w2[e]) for e in g2.edges()])
+
+for x in [numpy.nan, -1]:
+    el2 = el.copy()
+    el2[10, 1] = x
+    try:
+        Graph().add_edge_list(el2)
+        assert False, "invalid vertex index accepted"
+    except ValueError:
+        pass
+
+el = numpy.array([["a", "b", "1"], ["b", "c", "2"], ["c", "a", "3"]])
+g1 = Graph()
+w1 = g1.new_ep("int")
+n1 = g1.add_edge_list(el, hashed=True, string_vals=True, eprops=[w1])
+assert [n1[v] for v in g1.vertices()] == ["a", "b", "c"]
+assert list(w1.fa) == [1, 2, 3]
+el[1, 2] = "x"
+try:
+    Graph().add_edge_list(el, hashed=True, string_vals=True,
+                          eprops=[w1])
+    assert False, "invalid property value accepted"
+except ValueError:
+    pass
+
+g1.freeze()
+try:
+    g1.add_edge_list(numpy.array([[0, 1]]))
+    assert False, "frozen graph was modified"
+except RuntimeError:
+    pass
+g1.thaw()
+print("add_edge_list:", g1, file=out)
+
+# batch removal
+
+g = rand_graph(100, 500)
+x = g.new_vp("int", vals=numpy.arange(g.num_vertices()))
+w = g.new_ep("int", vals=numpy.arange(g.num_edges()))
+rm = set(range(0, 100, 3))
+es = [(x[e.source()], x[e.target()], w[e]) for e in g.edges()
+      if x[e.source()] not in rm and x[e.target()] not in rm]
+vmap = g.remove_vertices(list(rm))
+assert g.num_vertices() == 100 - len(rm)
+assert sorted(vmap[vmap >= 0]) == list(range(g.num_vertices()))
+assert all(vmap[list(rm)] == -1)
+assert sorted((x[e.source()], x[e.target()], w[e]) for e in g.edges()) == sorted(es)
+efilt = g.new_ep("bool", vals=w.a % 2 == 0)
+es = sorted(w[e] for e in g.edges() if not efilt[e])
+emap = g.remove_edges(efilt, compact=True)
+assert sorted(w.fa) == es
+assert g.edge_index_range == g.num_edges()
+
+# the vertex filter is compacted and permuted together with the other maps
+g = rand_graph(30, 60)
+x = g.new_vp("int", vals=numpy.arange(g.num_vertices()))
+vfilt = g.new_vp("bool", vals=x.a % 2 == 0)
+g.set_vertex_filter(vfilt)
+g.remove_vertices([1, 2, 3])
+g.reorder_vertices(numpy.random.permutation(g.num_vertices(ignore_filter=True)))
+assert list(g.get_vertex_filter()[0].a) == list(x.a % 2 == 0)
+assert sorted(x.fa) == [v for v in range(0, 30, 2) if v != 2]
+
+try:
+    g._Graph__graph.compact_vertex_property(graph_tool._prop("v", g, x),
+                                            numpy.array([0, 100]))
+    assert False, "invalid index mapping accepted"
+except ValueError:
+    pass
+print("remove_vertices:", g, file=out)
+
+# sorted adjacency
+
+g = rand_graph(50, 500)
+es = edge_set(g)
+g.set_sorted_adjacency(True)
+assert g.get_sorted_adjacency()
+assert edge_set(g) == es
+for v in g.vertices():
+    us = [int(u) for u in v.out_neighbors()]
+    assert us == sorted(us)
+for s in range(50):
+    for t in range(50):
+        n = es.count((s, t))
+        assert (g.edge(s, t) is None) == (n == 0)
+        assert len(g.edge(s, t, all_edges=True)) == n
+efilt = g.new_ep("bool", vals=numpy.random.random(g.num_edges()) < .5)
+u = GraphView(g, efilt=efilt)
+ues = edge_set(u)
+for s in range(50):
+    for t in range(50):
+        assert (u.edge(s, t) is None) == ((s, t) not in ues)
+g.add_edge(0, 1)
+us = [int(u) for u in g.vertex(0).out_neighbors()]
+assert us == sorted(us)
+print("sorted adjacency:", g, file=out)
+
+# memory accounting
+
+g = rand_graph(100, 500)
+x = g.new_vp("double", vals=numpy.random.random(g.num_vertices()))
+y = g.new_ep("vector<int>", vals=[[1, 2]] * g.num_edges())
+m = g.memory_usage()
+for k, (size, capacity) in m.items():
+    assert 0 <= size <= capacity, k
+assert x.memory_usage()[0] >= g.num_vertices() * 8
+print("memory usage:", m, file=out)
+
+# filtered iteration
+
+g = rand_graph(1000, 3000)
+for p in [.001, .1, .5, .99]:
+    mask = numpy.random.random(g.num_vertices()) < p
+    vfilt = g.new_vp("bool", vals=mask)
+    for inv in [False, True]:
+        u = GraphView(g)
+        u.set_vertex_filter(vfilt, inverted=inv)
+        idx = numpy.flatnonzero(mask != inv)
+        assert u.num_vertices() == len(idx)
+        assert [int(v) for v in u.vertices()] == list(idx)
+        assert u.num_edges() == sum(1 for e in g.edges()
+                                    if (mask[int(e.source())] != inv and
+                                        mask[int(e.target())] != inv))
+print("filtered iteration:", u, file=out)
+
+# the filtered views follow every kind of write to the filter masks
+
+def check_view(u):
+    vs = [int(v) for v in u.vertices()]
+    N, E = u.num_vertices(), u.num_edges()
+    vfilt, vinv = u.get_vertex_filter()
+    efilt, einv = u.get_edge_filter()
+    g = GraphView(u, directed=u.is_directed(), skip_properties=True)
+    g.clear_filters()
+    vm = vfilt.a.copy() != vinv if vfilt is not None else \
+        numpy.ones(g.num_vertices(), dtype="bool")
+    idx = list(numpy.flatnonzero(vm[:g.num_vertices()]))
+    assert vs == idx, (vs, idx)
+    assert N == len(idx)
+    assert E == sum(1 for e in g.edges()
+                    if ((efilt is None or efilt[e] != einv) and
+                        vm[int(e.source())] and vm[int(e.target())]))
+
+g = rand_graph(200, 600)
+vfilt = g.new_vp("bool", vals=numpy.random.random(200) < .5)
+efilt = g.new_ep("bool", vals=numpy.random.random(g.num_edges()) < .5)
+u = GraphView(g, vfilt=vfilt, efilt=efilt)
+check_view(u)
+for i in range(20):
+    vfilt[g.vertex(i)] = not vfilt[g.vertex(i)]
+    check_view(u)
+for e in list(g.edges())[:20]:
+    efilt[e] = not efilt[e]
+    check_view(u)
+v = u.add_vertex()
+u.add_edge(v, next(u.vertices()))
+check_view(u)
+for inv in [True, False]:
+    u.set_vertex_filter(vfilt, inverted=inv)
+    check_view(u)
+    u.set_edge_filter(efilt, inverted=inv)
+    check_view(u)
+
+# writes via numpy arrays, while they exist and after they are gone
+a = vfilt.a
+check_view(u)
+a[:10] = 1
+check_view(u)
+a[10:20] = 0
+check_view(u)
+del a
+check_view(u)
+efilt.a[:] = 1
+check_view(u)
+
+# writes from C++ functions
+w = g.new_vp("bool", vals=numpy.random.random(g.num_vertices()) < .5)
+g.copy_property(w, vfilt)
+check_view(u)
+check_view(u)
+w.a = numpy.random.random(g.num_vertices()) < .5
+g.copy_property(w, vfilt)
+check_view(u)
+vfilt.swap(w)
+check_view(u)
+
+# views of views, and removal of vertices
+w = GraphView(u, vfilt=lambda v: int(v) % 3 != 0)
+check_view(w)
+u.remove_vertex(next(u.vertices()))
+check_view(u)
+g.add_vertex(10)
+check_view(u)
+u.clear_filters()
+check_view(u)
+
+# masks shared by several views, and written to by C++ functions
+mask = g.new_vp("bool", vals=numpy.random.random(g.num_vertices()) < .5)
+us = [GraphView(g, vfilt=mask) for i in range(2)]
+for u in us:
+    check_view(u)
+label_out_component(g, g.vertex(0), label=mask)
+for u in us:
+    check_view(u)
+mask[g.vertex(1)] = not mask[g.vertex(1)]
+for u in us:
+    check_view(u)
+del us
+
+# materialization of filtered views
+
+g = rand_graph(100, 300)
+x = g.new_vertex_property("double", vals=numpy.random.random(g.num_vertices()))
+u = GraphView(g, vfilt=lambda v: int(v) % 2 == 0)
+m, vmap, emap = u.materialize()
+assert m.num_vertices() == u.num_vertices()
+assert m.num_edges() == u.num_edges()
+assert list(vmap.a) == [int(v) for v in u.vertices()]
+mx = m.copy_property(x, g=u, full=False)
+assert all(mx.a == x.a[vmap.a])
+
+def check_materialized(u):
+    m, vmap, emap = u.materialize()
+    assert m.is_directed() == u.is_directed()
+    # the reversal is not copied
+    m.set_reversed(u.is_reversed())
+    es = [(vmap[e.source()], vmap[e.target()]) for e in m.edges()]
+    assert es == [(int(e.source()), int(e.target())) for e in u.edges()]
+    return m
+
+# the returned graph is a copy, which can be modified
+m = check_materialized(u)
+m.add_vertex()
+m.clear_edges()
+check_materialized(u)
+
+u.set_reversed(True)
+check_materialized(u)
+u.set_reversed(False)
+u.set_directed(False)
+assert not check_materialized(u).is_directed()
+u.set_directed(True)
+g.set_sorted_adjacency(True)
+check_materialized(u)
+g.remove_edge(next(u.edges()))
+check_materialized(u)
+
+# selective views are materialized automatically by the iterative
+# centralities and the clustering coefficients, with the same results
+g = rand_graph(2000, 4000)
+g.add_edge_list(numpy.random.randint(0, 60, (600, 2)))
+w = g.new_ep("double", vals=numpy.random.random(g.num_edges()))
+u = GraphView(g, vfilt=g.vertex_index.copy().a < 60)
+assert u.get_materialize_threshold() == 0.05
+for directed, reversed in [(True, False), (True, True), (False, False)]:
+    u.set_directed(directed)
+    u.set_reversed(reversed)
+    res = []
+    for threshold in [0.05, 0]:
+        u.set_materialize_threshold(threshold)
+        res.append([pagerank(u, weight=w).fa,
+                    katz(u, weight=w).fa,
+                    eigenvector(u, weight=w)[1].fa,
+                    closeness(u, weight=w).fa,
+                    local_clustering(u).fa,
+                    global_clustering(u)])
+    for x, y in zip(*res):
+        assert numpy.allclose(x, y, equal_nan=True)
+print("materialize:", m, file=out)
+
+# ragged vector properties
+
+g = rand_graph(100, 300)
+x = g.new_vp("vector<int>")
+for v in g.vertices():
+    x[v] = numpy.random.randint(0, 10, numpy.random.randint(0, 5))
+offsets, values = x.get_ragged_array()
+assert len(offsets) == g.num_vertices() + 1
+for v in g.vertices():
+    assert list(values[offsets[int(v)]:offsets[int(v)+1]]) == list(x[v])
+y = g.new_vp("vector<int>")
+y.set_ragged_array(offsets, values)
+assert all(list(x[v]) == list(y[v]) for v in g.vertices())
+print("ragged arrays:", len(values), file=out)
+
+# vertex positions given by flat arrays, which are used without copying
+
+from graph_tool import _prop
+from graph_tool.draw import random_layout, sfdp_layout, arf_layout, \
+    fruchterman_reingold_layout, libgraph_tool_layout
+
+nthreads = openmp_get_num_threads()
+openmp_set_num_threads(1)    # for reproducible layouts
+g = rand_graph(300, 900)
+N = g.num_vertices()
+
+def layout_pair(f, ndim=2, **kwargs):
+    numpy.random.seed(43)
+    seed_rng(43)
+    pos = f(g, pos=random_layout(g, dim=ndim), **kwargs)
+    numpy.random.seed(43)
+    seed_rng(43)
+    a = numpy.zeros((N, ndim))
+    assert random_layout(g, dim=ndim, pos=a) is a
+    assert f(g, pos=a, **kwargs) is a
+    return pos, a
+
+for multilevel in [False, True]:
+    pos, a = layout_pair(sfdp_layout, multilevel=multilevel)
+    assert (pos.get_2d_array([0, 1]).T == a).all()
+pos, a = layout_pair(arf_layout, ndim=3, dim=3, max_iter=10)
+assert (pos.get_2d_array([0, 1, 2]).T == a).all()
+pos, a = layout_pair(fruchterman_reingold_layout, n_iter=10)
+assert (pos.get_2d_array([0, 1]).T == a).all()
+openmp_set_num_threads(nthreads)
+
+# filtered vertices keep their rows
+u = GraphView(g, vfilt=numpy.random.random(N) < .5)
+kept = u.get_vertex_filter()[0].a.astype("bool")
+a = numpy.random.random((N, 2))
+b = a.copy()
+sfdp_layout(u, pos=a, multilevel=False)
+assert (a[~kept] == b[~kept]).all()
+assert (a[kept] != b[kept]).all()
+
+# the fixed-width and ragged layouts are seen in the same way as the vector
+# property maps
+x = random_layout(g)
+offsets, values = x.get_ragged_array()
+d = libgraph_tool_layout.avg_dist(g._Graph__graph, _prop("v", g, x))
+assert d == libgraph_tool_layout.avg_dist(g._Graph__graph,
+                                          _prop("v", g, values.reshape(N, 2)))
+assert d == libgraph_tool_layout.avg_dist(g._Graph__graph,
+                                          _prop("v", g, (offsets, values)))
+
+for a in [numpy.zeros((N, 3)), numpy.zeros((N + 1, 2)),
+          numpy.zeros((N, 2), dtype="float32"), numpy.zeros((2, N)).T]:
+    try:
+        sfdp_layout(g, pos=a)
+        assert False, "no exception"
+    except ValueError:
+        pass
+print("flat positions:", a.shape, file=out)
+
+# memory-mapped properties
+
+g = rand_graph(100, 300)
+vals = numpy.random.random(g.num_vertices())
+x = g.new_vp("double", vals=vals)
+w = g.new_ep("int", vals=numpy.arange(g.num_edges()))
+d = tempfile.mkdtemp()
+x.set_mmap(d)
+w.set_mmap(d, advice="random")
+assert x.get_mmap() == (d, "normal")
+assert w.get_mmap() == (d, "random")
+assert all(x.fa == vals)
+assert all(w.fa == numpy.arange(g.num_edges()))
+g.add_vertex(10)
+x.a[-1] = 42
+assert x.a[-1] == 42
+x.set_mmap(None)
+assert x.get_mmap() is None
+assert all(x.fa[:len(vals)] == vals)
+assert os.listdir(d) == []
+os.rmdir(d)
+print("mmap:", x, file=out)
+
+# dictionary-encoded strings
+
+g = rand_graph(100, 300)
+labels = ["a", "b", "c", "a b"]
+s = g.new_vp("string", vals=[labels[i] for i in numpy.random.randint(0, 4, g.num_vertices())])
+codes, categories = s.get_codes()
+assert [categories[c] for c in codes] == list(s)
+t = g.new_vp("string")
+t.set_codes(codes, categories)
+assert list(t) == list(s)
+print("codes:", categories, file=out)
+
+# graph copies
+
+g = rand_graph(100, 300)
+x = g.new_vp("double", vals=numpy.random.random(g.num_vertices()))
+s = g.new_ep("string", vals=[str(i) for i in range(g.num_edges())])
+g.vp.x = x
+g.ep.s = s
+h = g.copy()
+assert edge_set(h) == edge_set(g)
+assert all(h.vp.x.a == x.a)
+assert list(h.ep.s) == list(s)
+h.vp.x.a[:] = 0
+h.ep.s[next(h.edges())] = "foo"
+assert all(g.vp.x.a == x.a)
+assert list(g.ep.s) == [str(i) for i in range(g.num_edges())]
+u = GraphView(g, vfilt=lambda v: int(v) < 50)
+h = Graph(u, prune=True)
+assert h.num_vertices() == 50
+assert list(h.vp.x.a) == list(x.a[:50])
+m, vmap, emap = u.materialize()
+assert edge_set(m) == edge_set(h)
+try:
+    g.copy_property("x")
+    assert False, "invalid property accepted"
+except TypeError:
+    pass
+print("copy:", h, file=out)
+
+# the copies share the values and the adjacency until they are modified
+g = rand_graph(100, 300)
+g.vp.x = g.new_vp("double", vals=numpy.random.random(g.num_vertices()))
+g.vp.v = g.new_vp("vector<int>")
+for v in g.vertices():
+    g.vp.v[v] = [int(v)] * 3
+g.ep.w = g.new_ep("int", vals=numpy.arange(g.num_edges()))
+x = g.vp.x.fa.copy()
+es = edge_set(g)
+h = g.copy()
+assert h.vp.x.data_ptr() == g.vp.x.data_ptr()
+assert h.ep.w.data_ptr() == g.ep.w.data_ptr()
+h.vp.x[h.vertex(0)] = -1
+assert h.vp.x.data_ptr() != g.vp.x.data_ptr()
+assert g.vp.x[g.vertex(0)] == x[0] and h.vp.x[h.vertex(0)] == -1
+h.vp.v[h.vertex(1)].append(10)
+assert list(g.vp.v[g.vertex(1)]) == [1] * 3
+assert list(h.vp.v[h.vertex(1)]) == [1] * 3 + [10]
+k = g.copy()
+k.ep.w.a[:] = 0
+assert list(g.ep.w.a) == list(range(g.num_edges()))
+assert list(h.ep.w.a) == list(range(g.num_edges()))
+h.copy_property(k.ep.w, h.ep.w, g=k)
+assert all(h.ep.w.a == 0)
+assert list(g.ep.w.a) == list(range(g.num_edges()))
+
+# the original may be modified as well
+h = g.copy()
+g.vp.x.a[:] = 0
+g.add_edge(0, 1)
+g.remove_vertex(2)
+assert all(h.vp.x.a == x)
+assert edge_set(h) == es
+assert h.num_vertices() == 100
+g = h
+h = g.copy()
+h.clear_edges()
+assert edge_set(g) == es
+
+# maps of views of the copy remain the same as those of the copy
+h = g.copy()
+u = GraphView(h)
+u.vp.x[u.vertex(3)] = -3
+assert h.vp.x[h.vertex(3)] == -3 and g.vp.x[g.vertex(3)] == x[3]
+
+# arrays which exist while copying are not shared
+a = g.vp.x.a
+h = g.copy()
+a[4] = -4
+assert h.vp.x[h.vertex(4)] == x[4]
+del a
+x[4] = -4
+h = g.copy()
+g.vp.x.swap(g.new_vp("double"))
+assert all(h.vp.x.a == x)
+
+# the memory shared between copies is reported, and pooled edge lists are
+# copied into a pool of the copy
+g = rand_graph(100, 300)
+g.vp.x = g.new_vp("double", vals=numpy.random.random(g.num_vertices()))
+g.set_edge_pool(True)
+assert g.memory_usage()["shared"] == (0, 0)
+h = g.copy()
+m = h.memory_usage()
+assert m["shared"][0] >= m["edge_lists"][0] + m["vp[x]"][0]
+assert g.memory_usage()["shared"][0] == m["shared"][0]
+h.add_edge(0, 1)
+h.vp.x[h.vertex(0)] = 0
+assert h.memory_usage()["shared"] == (0, 0)
+assert g.memory_usage()["shared"] == (0, 0)
+assert h.get_edge_pool() and h.num_edges() == g.num_edges() + 1
+
+# grouping and ungrouping
+
+g = rand_graph(100, 300)
+props = [g.new_vp("double", vals=numpy.random.random(g.num_vertices()))
+         for i in range(3)]
+vprop = group_vector_property(props)
+assert all(numpy.allclose(vprop[v], [p[v] for p in props]) for v in g.vertices())
+for i, p in enumerate(ungroup_vector_property(vprop, [0, 1, 2])):
+    assert all(p.a == props[i].a)
+
+for x in [1.5, numpy.nan, 1e10]:
+    vprop[g.vertex(10)] = [x, x, x]
+    try:
+        ungroup_vector_property(vprop, [0], props=[g.new_vp("int")])
+        assert False, "invalid conversion accepted"
+    except ValueError:
+        pass
+for x in [numpy.nan, numpy.inf]:
+    vprop[g.vertex(10)] = [x, x, x]
+    p = ungroup_vector_property(vprop, [0], props=[g.new_vp("float")])[0]
+    assert numpy.isnan(p[g.vertex(10)]) == numpy.isnan(x)
+props = [g.new_vp("int64_t", vals=numpy.full(g.num_vertices(), 2**40))]
+try:
+    group_vector_property(props, value_type="vector<int>")
+    assert False, "overflow accepted"
+except ValueError:
+    pass
+print("group:", vprop, file=out)
+
+# value mapping
+
+g = rand_graph(100, 300)
+x = g.new_vp("int", vals=numpy.random.randint(0, 5, g.num_vertices()))
+y = g.new_vp("string")
+map_property_values(x, y, {i: str(i) for i in range(5)})
+assert list(y) == [str(i) for i in x.a]
+z = g.new_vp("double")
+lut = numpy.random.random(5)
+map_property_values(x, z, lut)
+assert all(z.a == lut[x.a])
+map_property_values(x, z, lambda v: v * 2)
+assert all(z.a == x.a * 2)
+print("map_property_values:", z, file=out)
+
+# concurrent execution
+
+g = rand_graph(10000, 50000)
+ref = pagerank(g).a.copy()
+res = [None] * 4
+def run(i):
+    res[i] = pagerank(g).a.copy()
+threads = [threading.Thread(target=run, args=(i,)) for i in range(len(res))]
+for t in threads:
+    t.start()
+for t in threads:
+    t.join()
+assert all(numpy.allclose(r, ref) for r in res)
+
+# the snapshot may be discarded or replaced while algorithms run on it
+g.freeze()
+threads = [threading.Thread(target=run, args=(i,)) for i in range(len(res))]
+for t in threads:
+    t.start()
+while any(t.is_alive() for t in threads):
+    g.thaw()
+    g.freeze()
+for t in threads:
+    t.join()
+g.thaw()
+assert all(numpy.allclose(r, ref) for r in res)
+print("threads:", len(res), file=out)
+
+# batch neighborhoods
+
+g = rand_graph(100, 500)
+w = g.new_ep("double", vals=numpy.random.random(g.num_edges()))
+vs = numpy.random.randint(0, g.num_vertices(), 20)
+for mode in ["out", "in", "all"]:
+    offsets, neighbors, edge_ids, weights = g.get_neighborhoods(vs, mode=mode,
+                                                                eweight=w)
+    for i, v in enumerate(vs):
+        v = g.vertex(v)
+        es = list(v.out_edges()) if mode == "out" else \
+             list(v.in_edges()) if mode == "in" else \
+             list(v.out_edges()) + list(v.in_edges())
+        ns = [int(e.target()) if mode == "out" or
+              (mode == "all" and j < v.out_degree()) else int(e.source())
+              for j, e in enumerate(es)]
+        r = slice(offsets[i], offsets[i+1])
+        assert sorted(neighbors[r]) == sorted(ns)
+        assert sorted(edge_ids[r]) == sorted(g.edge_index[e] for e in es)
+        assert all(weights[r] == w.a[edge_ids[r]])
+
+offsets, vertices = g.get_khop_frontiers([0], 3)
+seen = {0}
+frontier = [0]
+for d in range(4):
+    assert list(vertices[offsets[d]:offsets[d+1]]) == sorted(frontier)
+    nfrontier = set()
+    for v in frontier:
+        nfrontier.update(int(u) for u in g.vertex(v).out_neighbors())
+    frontier = sorted(nfrontier - seen)
+    seen.update(frontier)
+print("neighborhoods:", len(neighbors), file=out)
+
+# batch edge lookup
+
+g = rand_graph(100, 500)
+def check_lookup(g):
+    pairs = numpy.random.randint(0, g.num_vertices(), (1000, 2))
+    idx = g.edge_index_of(pairs)
+    for (s, t), i in zip(pairs, idx):
+        e = g.edge(s, t, all_edges=True)
+        if len(e) == 0:
+            assert i == -1
+        else:
+            assert i in [g.edge_index[x] for x in e]
+check_lookup(g)
+g.set_edge_hash(True)
+check_lookup(g)
+g.add_edge(0, 1)
+check_lookup(g)
+g.remove_vertex(10)
+check_lookup(g)
+g.remove_vertices([20, 30])
+check_lookup(g)
+assert g.get_edge_hash_stats()["entries"] == g.num_edges()
+g.set_sorted_adjacency(True)
+g.set_edge_hash(False)
+check_lookup(g)
+
+# a filtered parallel edge does not hide the others
+g = Graph()
+g.add_edge_list([(0, 1), (0, 1), (1, 2)])
+efilt = g.new_ep("bool", vals=[False, True, True])
+u = GraphView(g, efilt=efilt)
+for hashed in [False, True]:
+    u.set_edge_hash(hashed)
+    assert list(u.edge_index_of([[0, 1], [1, 2], [2, 1]])) == [1, 2, -1]
+    assert list(GraphView(u, directed=False).edge_index_of([[1, 0]])) == [1]
+print("edge_index_of:", g.get_edge_hash_stats(), file=out)
+
+print("OK")
@@ -0,0 +1,381 @@
+#!/bin/env python
+
+from __future__ import print_function
+
+verbose = __name__ == "__main__"
+
+import os
+import sys
+if not verbose:
+    out = open(os.devnull, 'w')
+else:
+    out = sys.stdout
+from graph_tool.all import *
+import numpy
+import numpy.random
+import tempfile
+import shutil
+import csv
+import io
+import gzip
+
+numpy.random.seed(42)
+seed_rng(42)
+
+tmpdir = tempfile.mkdtemp()
+
+def rand_graph(N, E, directed=True):
+    g = Graph(directed=directed)
+    g.add_vertex(N)
+    g.add_edge_list(numpy.random.randint(0, N, (E, 2)))
+    g.vp.x = g.new_vp("double", vals=numpy.random.random(N))
+    g.vp.n = g.new_vp("int", vals=numpy.random.randint(-100, 100, N))
+    g.vp.s = g.new_vp("string", vals=["v%d" % i for i in range(N)])
+    g.ep.w = g.new_ep("double", vals=numpy.random.random(E))
+    g.ep.c = g.new_ep("string", vals=["abc"[i] for i in
+                                      numpy.random.randint(0, 3, E)])
+    g.ep.v = g.new_ep("vector<int>", vals=[[i, i + 1] for i in range(E)])
+    g.gp.name = g.new_gp("string", "foo bar")
+    return g
+
+def check_equal(g, h, props=True):
+    assert g.is_directed() == h.is_directed()
+    assert g.num_vertices() == h.num_vertices()
+    assert ([(int(e.source()), int(e.target())) for e in g.edges()] ==
+            [(int(e.source()), int(e.target())) for e in h.edges()])
+    if not props:
+        return
+    for k, p in g.properties.items():
+        q = h.properties[k]
+        if k[0] == "g":
+            assert p[g] == q[h], k
+        elif p.value_type().startswith("vector"):
+            assert ([list(x) for x in p] == [list(x) for x in q]), k
+        else:
+            assert list(p) == list(q), k
+
+# dictionary-encoded strings
+
+def gt_version(fn):
+    with open(fn, "rb") as f:
+        return f.read(7)[6]
+
+g = rand_graph(1000, 3000)
+fn = os.path.join(tmpdir, "g.gt")
+g.save(fn)
+assert gt_version(fn) == 1             # the encoding is only used if requested
+plain_size = os.path.getsize(fn)
+g.save(fn, dict_strings=True)
+assert gt_version(fn) == 2
+size = os.path.getsize(fn)
+assert size < plain_size
+h = load_graph(fn)
+assert h.ep.c.value_type() == "string"
+check_equal(g, h)
+g.ep.c = g.new_ep("string", vals=["x%d" % i for i in range(g.num_edges())])
+g.save(fn, dict_strings=True)
+assert os.path.getsize(fn) > size
+check_equal(g, load_graph(fn))
+print("dictionary strings:", size, os.path.getsize(fn), file=out)
+
+# binary format
+
+g = rand_graph(1000, 3000)
+g.vp.o = g.new_vp("object", vals=[{"i": i} for i in range(g.num_vertices())])
+for directed in [True, False]:
+    g.set_directed(directed)
+    fn = os.path.join(tmpdir, "g.gt")
+    g.save(fn)
+    check_equal(g, load_graph(fn))
+    buf = io.BytesIO()
+    g.save(buf, fmt="gt")
+    buf.seek(0)
+    check_equal(g, load_graph(buf, fmt="gt"))
+u = GraphView(g, vfilt=lambda v: int(v) % 2 == 0)
+u.save(fn)
+h = load_graph(fn)              # the filter is saved with the graph
+assert h.get_vertex_filter()[0] is not None
+check_equal(u, h, props=False)
+with open(fn, "rb") as f:
+    data = f.read()
+with open(fn, "wb") as f:
+    f.write(data[:len(data) // 2])
+try:
+    load_graph(fn)
+    assert False, "truncated file accepted"
+except IOError:
+    pass
+
+# a corrupt length of an adjacency list is rejected, without attempting to
+# allocate that much memory
+g.save(fn)
+with open(fn, "rb") as f:
+    data = bytearray(f.read())
+pos = 16 + int.from_bytes(data[8:16], "little") + 1 + 8
+data[pos:pos + 8] = (2 ** 62).to_bytes(8, "little")
+with open(fn, "wb") as f:
+    f.write(data)
+for src in [fn, io.BytesIO(data)]:
+    try:
+        load_graph(src, fmt="gt")
+        assert False, "corrupt adjacency accepted"
+    except IOError:
+        pass
+print("gt:", g, file=out)
+
+# compressed files
+
+g = rand_graph(10000, 30000)
+for ext in ["gt.gz", "xml.gz", "gt"]:
+    fn = os.path.join(tmpdir, "g." + ext)
+    g.save(fn)
+    check_equal(g, load_graph(fn))
+    with open(fn, "rb") as f:
+        data = f.read()
+    if ext.endswith(".gz"):             # file objects are not decompressed
+        data = gzip.decompress(data)
+    check_equal(g, load_graph(io.BytesIO(data), fmt=ext.split(".")[0]))
+fn = os.path.join(tmpdir, "g.gt.gz")
+with open(fn, "rb") as f:
+    data = f.read()
+with open(fn, "wb") as f:
+    f.write(data[:len(data) // 2])
+try:
+    load_graph(fn)
+    assert False, "truncated file accepted"
+except IOError:
+    pass
+
+# a corrupted member in the middle of the file is detected, even if the
+# members after it are intact
+g = rand_graph(20000, 100000)
+g.save(fn)
+with open(fn, "rb") as f:
+    data = bytearray(f.read())
+members = []
+pos = 0
+while pos < len(data):
+    members.append(pos)
+    pos += int.from_bytes(data[pos + 16:pos + 20], "little")
+assert len(members) > 2
+pos = members[len(members) // 2]
+m = int.from_bytes(data[pos + 16:pos + 20], "little")
+data[pos + m - 8] ^= 0xff                # CRC of the member
+with open(fn, "wb") as f:
+    f.write(data)
+try:
+    load_graph(fn)
+    assert False, "corrupted member accepted"
+except IOError:
+    pass
+print("gz:", g, file=out)
+
+# property directory
+
+g = rand_graph(1000, 3000)
+fn = os.path.join(tmpdir, "g.gt")
+g.save(fn)
+h = load_graph(fn)
+for k, p in g.properties.items():
+    q = h.load_property(fn, k[1], key_type=k[0])
+    if k[0] == "g":
+        assert p[g] == q[h], k
+    elif p.value_type().startswith("vector"):
+        assert [list(x) for x in p] == [list(x) for x in q], k
+    else:
+        assert list(p) == list(q), k
+try:
+    h.load_property(os.path.join(tmpdir, "nonexistent.gt"), "x")
+    assert False, "missing file accepted"
+except IOError:
+    pass
+try:
+    h.load_property(fn, "nonexistent")
+    assert False, "missing property accepted"
+except (KeyError, ValueError, IOError):
+    pass
+
+# the number of directory entries is bounded by the size of the file
+with open(fn, "rb") as f:
+    data = bytearray(f.read())
+offset = int(numpy.frombuffer(data[-16:-8], dtype="<u8")[0])
+data[offset:offset + 8] = numpy.array([2**60], dtype="<u8").tobytes()
+with open(fn, "wb") as f:
+    f.write(data)
+q = h.load_property(fn, "x")
+assert list(q) == list(g.vp.x)
+
+# a file without a directory may end with the magic string by chance, and
+# is then read sequentially
+k = Graph()
+k.add_vertex(3)
+k.gp.tag = k.new_gp("string", "x" * 100 + "gt-index")
+fn = os.path.join(tmpdir, "k.gt")
+k.save(fn)
+with open(fn, "rb") as f:
+    data = f.read()
+offset = int(numpy.frombuffer(data[-16:-8], dtype="<u8")[0])
+with open(fn, "wb") as f:
+    f.write(data[:offset])
+kk = load_graph(fn)
+assert kk.gp.tag == k.gp.tag
+assert kk.load_property(fn, "tag", key_type="g")[kk] == k.gp.tag
+print("load_property:", h, file=out)
+
+# csv files
+
+g = rand_graph(1000, 3000)
+fn = os.path.join(tmpdir, "g.csv")
+with open(fn, "w") as f:
+    w = csv.writer(f)
+    for e in g.edges():
+        w.writerow(["v%d" % int(e.source()), "v%d" % int(e.target()),
+                    g.ep.w[e], g.ep.c[e]])
+eprops = dict(eprop_types=["double", "string"], eprop_names=["w", "c"])
+h1 = load_graph_from_csv(fn, **eprops)
+with open(fn) as f:
+    h2 = load_graph_from_csv(f, **eprops)
+# the edges are read in the order in which they were written
+ws = [g.ep.w[e] for e in g.edges()]
+cs = [g.ep.c[e] for e in g.edges()]
+for h in [h1, h2]:
+    assert h.num_edges() == g.num_edges()
+    assert [h.ep.c[e] for e in h.edges()] == [cs[h.edge_index[e]]
+                                              for e in h.edges()]
+    assert numpy.allclose(h.ep.w.fa, ws)
+check_equal(h1, h2)
+assert list(h1.vp.name) == list(h2.vp.name)
+
+with open(fn, "w") as f:
+    f.write("src\ttgt\n")
+    for e in g.edges():
+        f.write("%d\t%d\n" % (10 * int(e.source()), 10 * int(e.target())))
+opts = dict(skip_first=True, string_vals=False, hashed=True,
+            csv_options={"delimiter": "\t"})
+h1 = load_graph_from_csv(fn, **opts)
+with open(fn) as f:
+    h2 = load_graph_from_csv(f, **opts)
+check_equal(h1, h2, props=False)
+assert h1.vp.name.value_type() == h2.vp.name.value_type() == "python::object"
+assert list(h1.vp.name) == list(h2.vp.name)
+h3 = load_graph_from_csv(fn, hash_type="int64_t", **opts)
+assert h3.vp.name.value_type() == "int64_t"
+assert list(h3.vp.name.fa) == list(h1.vp.name)
+
+# whitespace around numeric values is ignored, as by int() and float()
+with open(fn, "w") as f:
+    f.write("0, 1, 0.5, true\n2 ,\t0 , 1.5 ,False\n")
+opts = dict(string_vals=False, hashed=False, eprop_types=["double", "bool"])
+h1 = load_graph_from_csv(fn, **opts)
+with open(fn) as f:
+    h2 = load_graph_from_csv(f, string_vals=False, hashed=False)
+for h in [h1, h2]:
+    assert [(int(e.source()), int(e.target())) for e in h.edges()] == \
+        [(0, 1), (2, 0)]
+assert list(h1.ep.c0.fa) == [0.5, 1.5]
+assert list(h1.ep.c1.fa) == [1, 0]
+
+# empty vertex values are rejected, as by int()
+with open(fn, "w") as f:
+    f.write("0,1\n,2\n")
+for f in [fn, open(fn)]:
+    try:
+        load_graph_from_csv(f, string_vals=False, hashed=False)
+        assert False, "empty vertex value accepted"
+    except ValueError:
+        pass
+
+# quoted values with line breaks are rejected by the native parser, instead of
+# being cut, but are read by the csv module
+with open(fn, "w") as f:
+    f.write('0,1,"a\nb"\n1,2,c\n')
+try:
+    load_graph_from_csv(fn, string_vals=False, hashed=False)
+    assert False, "unterminated quoted value accepted"
+except ValueError:
+    pass
+with open(fn) as f:
+    h = load_graph_from_csv(f, string_vals=False, hashed=False)
+assert list(h.ep.c0) == ["a\nb", "c"]
+print("csv:", h1, file=out)
+
+# graphml files
+
+g = rand_graph(1000, 3000)
+g.vp.b = g.new_vp("bool", vals=numpy.random.random(g.num_vertices()) < .5)
+g.vp.s[g.vertex(0)] = "<&>\"'\n"
+fn = os.path.join(tmpdir, "g.xml")
+g.save(fn)
+h = load_graph(fn)
+check_equal(g, h)
+h.save(fn)
+check_equal(g, load_graph(fn))
+
+# default values of node, graph and "all" keys
+with open(fn, "w") as f:
+    f.write("""<?xml version="1.0" encoding="UTF-8"?>
+<graphml xmlns="http://graphml.graphdrawing.org/xmlns">
+  <key id="d0" for="node" attr.name="n" attr.type="int"><default>7</default></key>
+  <key id="d1" for="all" attr.name="a" attr.type="string"><default>x</default></key>
+  <key id="d2" for="graph" attr.name="t" attr.type="double"><default>2.5</default></key>
+  <graph id="G" edgedefault="directed">
+    <node id="n0"/>
+    <node id="n1"><data key="d0">3</data><data key="d1">y</data></node>
+    <edge source="n0" target="n1"/>
+  </graph>
+</graphml>
+""")
+h = load_graph(fn)
+assert list(h.vp.n.fa) == [7, 3]
+assert list(h.vp.a) == ["x", "y"]
+assert list(h.ep.a) == ["x"]
+assert h.gp.a == "x"
+assert h.gp["t"] == 2.5
+
+# invalid values are reported, also when converted in parallel
+with open(fn, "w") as f:
+    f.write("""<?xml version="1.0" encoding="UTF-8"?>
+<graphml xmlns="http://graphml.graphdrawing.org/xmlns">
+  <key id="d0" for="node" attr.name="n" attr.type="int"/>
+  <graph id="G" edgedefault="directed">
+""")
+    for i in range(10000):
+        f.write('<node id="n%d"><data key="d0">%s</data></node>\n' %
+                (i, "foo" if i == 5000 else str(i)))
+    f.write("</graph>\n</graphml>\n")
+try:
+    load_graph(fn)
+    assert False, "invalid value accepted"
+except IOError:
+    pass
+print("graphml:", h, file=out)
+
+# gml files
+
+g = rand_graph(1000, 3000)
+del g.ep["v"]
+fn = os.path.join(tmpdir, "g.gml")
+g.save(fn)
+h = load_graph(fn)
+check_equal(g, h, props=False)
+assert list(h.vp.s) == list(g.vp.s)
+assert list(h.ep.c) == list(g.ep.c)
+assert numpy.allclose(h.vp.x.fa, g.vp.x.fa)
+assert list(h.vp.n.fa) == list(g.vp.n.fa)
+
+with open(fn, "w") as f:
+    f.write("""graph [
+  directed 1
+  node [ id 0 label "\\x41 \\x3c\\x3E" ]
+  node [ id 1 label "a\\tb \\"c\\" \\\\" ]
+  edge [ source 0 target 1 weight 1.5 ]
+]
+""")
+h = load_graph(fn)
+assert list(h.vp.label) == ["A <>", "a\tb \"c\" \\"]
+assert list(h.ep.weight.fa) == [1.5]
+print("gml:", h, file=out)
+
+shutil.rmtree(tmpdir)
+
+print("OK")
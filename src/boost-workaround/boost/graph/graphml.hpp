@@ -62,245 +62,6 @@ struct parse_error: public graph_exception
     std::string error;
 };
 
-class mutate_graph
-{
-public:
-    virtual ~mutate_graph() {}
-    virtual int is_directed() const = 0;
-    virtual void flip_directed(bool) = 0;
-    virtual bool get_directed() const = 0;
-
-    virtual boost::any do_add_vertex() = 0;
-    virtual std::pair<boost::any,bool> do_add_edge(boost::any source,
-                                                   boost::any target) = 0;
-
-    virtual size_t n_vertices() const = 0;
-
-    virtual void
-    set_graph_property(const std::string& name, const std::string& value,
-                       const std::string& value_type) = 0;
-
-    virtual void
-    set_vertex_property(const std::string& name, boost::any vertex,
-                        const std::string& value,
-                        const std::string& value_type) = 0;
-
-    virtual void
-    set_edge_property(const std::string& name, boost::any edge,
-                      const std::string& value,
-                      const std::string& value_type) = 0;
-};
-
-template <typename MutableGraph>
-class mutate_graph_impl : public mutate_graph
-{
-    typedef typename graph_traits<MutableGraph>::vertex_descriptor
-        vertex_descriptor;
-    typedef typename graph_traits<MutableGraph>::edge_descriptor
-        edge_descriptor;
-
-public:
-    mutate_graph_impl(MutableGraph& g, dynamic_properties& dp,
-                      bool ignore_directedness,
-                      std::unordered_set<std::string> ignore_vp,
-                      std::unordered_set<std::string> ignore_ep,
-                      std::unordered_set<std::string> ignore_gp)
-        : m_g(g), m_dp(dp), m_ignore_directedness(ignore_directedness),
-          m_is_directed(false), m_ignore_vp(ignore_vp),
-          m_ignore_ep(ignore_ep), m_ignore_gp(ignore_gp) { }
-
-    virtual int is_directed() const
-    {
-        if (m_ignore_directedness)
-            return 2;
-        return is_convertible
-            <typename graph_traits<MutableGraph>::directed_category,
-            directed_tag>::value;
-    }
-
-    virtual void flip_directed(bool directed)
-    {
-        if (!m_is_directed)
-            m_is_directed = directed;
-    }
-
-    virtual bool get_directed() const
-    {
-        return m_is_directed;
-    }
-
-    virtual any do_add_vertex()
-    {
-        return any(add_vertex(m_g));
-    }
-
-    virtual std::pair<any,bool> do_add_edge(any source, any target)
-    {
-        std::pair<edge_descriptor,bool> retval =
-            add_edge(any_cast<vertex_descriptor>(source),
-                     any_cast<vertex_descriptor>(target), m_g);
-        return std::make_pair(any(retval.first), retval.second);
-    }
-
-    virtual size_t n_vertices() const
-    {
-        return num_vertices(m_g);
-    }
-
-    virtual void
-    set_graph_property(const std::string& name,
-                       const std::string& value, const std::string& value_type)
-    {
-        if (m_ignore_gp.find(name) != m_ignore_gp.end())
-            return;
-
-        bool type_found = false;
-        try
-        {
-            mpl::for_each<prop_value_types>
-                (put_property<graph_property_tag,prop_value_types>
-                 (name, m_dp, graph_property_tag(), value, value_type,
-                  type_found));
-        }
-        catch (bad_lexical_cast)
-        {
-            throw parse_error("invalid value \"" + value + "\" for key \"" +
-                              name + "\" of type \"" + value_type + "\"");
-        }
-        if (!type_found)
-            throw  parse_error("unrecognized type \"" + value_type +
-                               "\" for key " + name + "\"");
-
-    }
-
-    virtual void
-    set_vertex_property(const std::string& name, any vertex,
-                        const std::string& value, const std::string& value_type)
-    {
-        if (m_ignore_vp.find(name) != m_ignore_vp.end())
-            return;
-
-        bool type_found = false;
-        try
-        {
-            mpl::for_each<prop_value_types>
-                (put_property<vertex_descriptor,prop_value_types>
-                 (name, m_dp, any_cast<vertex_descriptor>(vertex),
-                  value, value_type, type_found));
-        }
-        catch (bad_lexical_cast)
-        {
-            throw parse_error("invalid value \"" + value + "\" for key " +
-                              name + " of type " + value_type);
-        }
-        if (!type_found)
-            throw  parse_error("unrecognized type \"" + value_type +
-                               "\" for key " + name);
-
-    }
-
-    virtual void
-    set_edge_property(const std::string& name, any edge,
-                      const std::string& value, const std::string& value_type)
-    {
-        if (m_ignore_ep.find(name) != m_ignore_ep.end())
-            return;
-
-        bool type_found = false;
-        try
-        {
-            mpl::for_each<prop_value_types>
-                (put_property<edge_descriptor,prop_value_types>
-                 (name, m_dp, any_cast<edge_descriptor>(edge),
-                  value, value_type, type_found));
-        }
-        catch (bad_lexical_cast)
-        {
-            throw parse_error("invalid value \"" + value + "\" for key " +
-                              name + " of type " + value_type);
-        }
-        if (!type_found)
-            throw  parse_error("unrecognized type \"" + value_type +
-                               "\" for key " + name);
-    }
-
-    template <typename Key, typename ValueVector>
-    class put_property
-    {
-    public:
-        put_property(const std::string& name, dynamic_properties& dp,
-                     const Key& key, const std::string& value,
-                     const std::string& value_type,
-                     bool& type_found) : m_name(name), m_dp(dp), m_key(key),
-            m_value(value), m_value_type(value_type),
-            m_type_found(type_found) {}
-        template <class Value>
-        void operator()(Value)
-        {
-            if (m_value_type ==
-                prop_type_names[mpl::find<ValueVector,Value>::type::pos::value])
-            {
-                std::string val = m_value;
-                if (m_value_type == "boolean")
-                {
-                    if (val == "true" || val == "True")
-                        val = "1";
-                    if (val == "false" || val == "False")
-                        val = "0";
-                }
-
-                if (is_same<Value,uint8_t>::value) // chars are stored as ints
-                {
-                    int v = lexical_cast<int>(val);
-                    put(m_name, m_dp, m_key, uint8_t(v));
-                }
-                else
-                {
-                    if (is_same<Value, boost::python::object>::value)
-                        val = base64_decode(m_value);
-
-                    put(m_name, m_dp, m_key, lexical_cast<Value>(val));
-                }
-                m_type_found = true;
-            }
-        }
-    private:
-        const std::string& m_name;
-        dynamic_properties& m_dp;
-        const Key& m_key;
-        const std::string& m_value;
-        const std::string& m_value_type;
-        bool& m_type_found;
-    };
-
-protected:
-    MutableGraph& m_g;
-    dynamic_properties& m_dp;
-    bool m_ignore_directedness;
-    bool m_is_directed;
-    std::unordered_set<std::string> m_ignore_vp;
-    std::unordered_set<std::string> m_ignore_ep;
-    std::unordered_set<std::string> m_ignore_gp;
-};
-
-void
-read_graphml(std::istream& in, mutate_graph& g, bool integer_vertices,
-             bool store_ids);
-
-template<typename MutableGraph>
-bool
-read_graphml(std::istream& in, MutableGraph& g, dynamic_properties& dp,
-             bool store_ids, bool integer_vertices, bool ignore_directedness,
-             std::unordered_set<std::string> ignore_vp = std::unordered_set<std::string>(),
-             std::unordered_set<std::string> ignore_ep = std::unordered_set<std::string>(),
-             std::unordered_set<std::string> ignore_gp = std::unordered_set<std::string>())
-{
-    mutate_graph_impl<MutableGraph> mg(g, dp, ignore_directedness, ignore_vp,
-                                       ignore_ep, ignore_gp);
-    read_graphml(in, mg, integer_vertices, store_ids);
-    return mg.get_directed();
-}
-
 template <typename Types>
 class get_type_name
 {
@@ -154,7 +154,7 @@ void betweenness(GraphInterface& g, std::vector<size_t>& pivots,
 
     if (!weight.empty())
     {
-        run_action<>()
+        run_action<>(true)
             (g, std::bind<>(get_weighted_betweenness(),
                             std::placeholders::_1,
                             std::ref(pivots),
@@ -168,7 +168,7 @@ void betweenness(GraphInterface& g, std::vector<size_t>& pivots,
     }
     else
     {
-        run_action<>()
+        run_action<>(true)
             (g, std::bind<void>(get_betweenness(), std::placeholders::_1,
                                 std::ref(pivots),
                                 g.get_vertex_index(), std::placeholders::_2,
@@ -194,7 +194,7 @@ double central_point(GraphInterface& g,
                      boost::any vertex_betweenness)
 {
     double c = 0.0;
-    run_action<graph_tool::detail::never_reversed>()
+    run_action<graph_tool::detail::never_reversed>(true)
         (g, std::bind<>(get_central_point_dominance(), std::placeholders::_1,
                         std::placeholders::_2, std::ref(c)),
          vertex_scalar_properties()) (vertex_betweenness);
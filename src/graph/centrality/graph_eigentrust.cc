@@ -36,7 +36,7 @@ size_t eigentrust(GraphInterface& g, boost::any c, boost::any t,
                              " value type");
 
     size_t iter = 0;
-    run_action<>()
+    run_action<>(true)
         (g, bind(get_eigentrust(),
                  _1, g.get_vertex_index(), g.get_edge_index(), _2,
                  _3, epslon, max_iter, ref(iter)),
@@ -67,7 +67,7 @@ long double hits(GraphInterface& g, boost::any w, boost::any x, boost::any y,
         w = weight_map_t();
 
     long double eig = 0;
-    run_action<>()
+    run_action<graph_tool::frozen_graph_views>(true)
         (g, std::bind(get_hits_dispatch(), std::placeholders::_1, g.get_vertex_index(),
                       std::placeholders::_2,  std::placeholders::_3, y, epsilon, max_iter,
                       std::ref(eig)),
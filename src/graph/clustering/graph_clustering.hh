@@ -21,6 +21,7 @@
 #include "config.h"
 
 #include "hash_map_wrap.hh"
+#include "graph_neighbor_intersection.hh"
 #include <boost/mpl/if.hpp>
 
 #ifdef _OPENMP
@@ -43,11 +44,10 @@ namespace graph_tool
 using namespace boost;
 using namespace std;
 
-// calculates the number of triangles to which v belongs
+// counts the (ordered) paths v -> n -> n2 -> v, with v, n and n2 distinct
 template <class Graph, class VProp>
-pair<int,int>
-get_triangles(typename graph_traits<Graph>::vertex_descriptor v, VProp& mark,
-              const Graph& g)
+size_t count_triangles_mark(typename graph_traits<Graph>::vertex_descriptor v,
+                            VProp& mark, const Graph& g)
 {
     size_t triangles = 0;
 
@@ -74,6 +74,53 @@ get_triangles(typename graph_traits<Graph>::vertex_descriptor v, VProp& mark,
     for (auto n : adjacent_vertices_range(v, g))
         mark[n] = false;
 
+    return triangles;
+}
+
+// same as above, but for sorted adjacencies: the neighborhoods of v and n are
+// intersected by merging, without touching the marks.
+template <class Graph>
+size_t count_triangles_sorted(typename graph_traits<Graph>::vertex_descriptor v,
+                              const Graph& g)
+{
+    size_t triangles = 0;
+    auto v_runs = get_neighbor_runs(v, g);
+    for (auto& run : v_runs)
+    {
+        for (auto n : boost::make_iterator_range(run.first, run.second))
+        {
+            if (n == v)
+                continue;
+            for_each_common(get_neighbor_runs(n, g), v_runs,
+                            [&](auto n2)
+                            {
+                                if (n2 != n && n2 != v)
+                                    ++triangles;
+                            });
+        }
+    }
+    return triangles;
+}
+
+// calculates the number of triangles to which v belongs
+template <class Graph, class VProp>
+pair<int,int>
+get_triangles(typename graph_traits<Graph>::vertex_descriptor v, VProp& mark,
+              const Graph& g)
+{
+    size_t triangles;
+    if constexpr (has_neighbor_runs<Graph>::value)
+    {
+        if (has_sorted_neighbors(g))
+            triangles = count_triangles_sorted(v, g);
+        else
+            triangles = count_triangles_mark(v, mark, g);
+    }
+    else
+    {
+        triangles = count_triangles_mark(v, mark, g);
+    }
+
     size_t k = out_degree(v, g);
     if (graph_tool::is_directed(g))
         return make_pair(triangles, (k * (k - 1)));
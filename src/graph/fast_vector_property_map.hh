@@ -41,6 +41,8 @@
 #include <memory>
 #include <vector>
 
+#include "mmap_allocator.hh"
+
 namespace boost {
 
 template<typename T, typename IndexMap>
@@ -50,14 +52,16 @@ template<typename T, typename IndexMap = identity_property_map>
 class checked_vector_property_map
     : public boost::put_get_helper<
               typename std::iterator_traits<
-                  typename std::vector<T>::iterator >::reference,
+                  typename std::vector<T, graph_tool::storage_allocator<T>>
+                  ::iterator >::reference,
               checked_vector_property_map<T, IndexMap> >
 {
 public:
     typedef typename property_traits<IndexMap>::key_type  key_type;
     typedef T value_type;
+    typedef std::vector<T, graph_tool::storage_allocator<T>> storage_t;
     typedef typename std::iterator_traits<
-        typename std::vector<T>::iterator >::reference reference;
+        typename storage_t::iterator >::reference reference;
     typedef boost::lvalue_property_map_tag category;
 
     template<typename Type, typename Index>
@@ -68,28 +72,28 @@ public:
     typedef checked_vector_property_map<T,IndexMap> self_t;
 
     checked_vector_property_map(const IndexMap& idx = IndexMap())
-        : store(std::make_shared<std::vector<T>>()), index(idx) {}
+        : store(std::make_shared<storage_t>()), index(idx) {}
 
     checked_vector_property_map(unsigned initial_size,
                                 const IndexMap& idx = IndexMap())
-        : store(std::make_shared<std::vector<T>>(initial_size)), index(idx) {}
+        : store(std::make_shared<storage_t>(initial_size)), index(idx) {}
 
-    typename std::vector<T>::iterator storage_begin()
+    typename storage_t::iterator storage_begin()
     {
         return store->begin();
     }
 
-    typename std::vector<T>::iterator storage_end()
+    typename storage_t::iterator storage_end()
     {
         return store->end();
     }
 
-    typename std::vector<T>::const_iterator storage_begin() const
+    typename storage_t::const_iterator storage_begin() const
     {
         return store->begin();
     }
 
-    typename std::vector<T>::const_iterator storage_end() const
+    typename storage_t::const_iterator storage_end() const
     {
         return store->end();
     }
@@ -110,7 +114,28 @@ public:
         store->shrink_to_fit();
     }
 
-    std::vector<T>& get_storage() const { return (*store); }
+    storage_t& get_storage() const { return (*store); }
+
+    const std::shared_ptr<storage_t>& get_storage_ptr() const { return store; }
+
+    // Moves the values to files mapped in memory by the given arena, or back
+    // to the heap if arena is null. All copies of the property map are
+    // affected.
+    void set_mmap_arena(std::shared_ptr<graph_tool::mmap_arena> arena) const
+    {
+        storage_t temp(std::make_move_iterator(store->begin()),
+                       std::make_move_iterator(store->end()),
+                       graph_tool::storage_allocator<T>(std::move(arena)));
+        store->swap(temp);
+    }
+
+    // the allocator is returned by value, hence so must be the arena
+    std::shared_ptr<graph_tool::mmap_arena> get_mmap_arena() const
+    {
+        return store->get_allocator().get_arena();
+    }
+
+    const IndexMap& get_index_map() const { return index; }
 
     void swap(checked_vector_property_map& other)
     {
@@ -150,7 +175,7 @@ protected:
     // store pointer to data, because if copy of property map resizes
     // the vector, the pointer to data will be invalidated.
     // I wonder if class 'pmap_ref' is simply needed.
-    std::shared_ptr< std::vector<T> > store;
+    std::shared_ptr<storage_t> store;
     IndexMap index;
 };
 
@@ -158,14 +183,16 @@ template<typename T, typename IndexMap = identity_property_map>
 class unchecked_vector_property_map
     : public boost::put_get_helper<
                 typename std::iterator_traits<
-                    typename std::vector<T>::iterator >::reference,
+                    typename std::vector<T, graph_tool::storage_allocator<T>>
+                    ::iterator >::reference,
                 unchecked_vector_property_map<T, IndexMap> >
 {
 public:
     typedef typename property_traits<IndexMap>::key_type  key_type;
     typedef T value_type;
+    typedef std::vector<T, graph_tool::storage_allocator<T>> storage_t;
     typedef typename std::iterator_traits<
-        typename std::vector<T>::iterator >::reference reference;
+        typename storage_t::iterator >::reference reference;
     typedef boost::lvalue_property_map_tag category;
 
     typedef checked_vector_property_map<T, IndexMap> checked_t;
@@ -195,7 +222,14 @@ public:
         return (*_checked.store)[get(_checked.index, v)];
     }
 
-    std::vector<T>& get_storage() const { return _checked.get_storage(); }
+    storage_t& get_storage() const { return _checked.get_storage(); }
+
+    const std::shared_ptr<storage_t>& get_storage_ptr() const
+    {
+        return _checked.get_storage_ptr();
+    }
+
+    const IndexMap& get_index_map() const { return _checked.index; }
 
     void swap(unchecked_vector_property_map& other)
     {
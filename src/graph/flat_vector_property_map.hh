@@ -0,0 +1,167 @@
+// graph-tool -- a general graph modification and manipulation thingy
+//
+// Copyright (C) 2006-2018 Tiago de Paula Peixoto <tiago@skewed.de>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef FLAT_VECTOR_PROPERTY_MAP_HH
+#define FLAT_VECTOR_PROPERTY_MAP_HH
+
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/property_map/property_map.hpp>
+
+#include "graph_exceptions.hh"
+
+namespace graph_tool
+{
+
+// ========================================================================
+// Flat vector-valued property maps
+// ========================================================================
+//
+// Vector-valued property maps store one std::vector per key, each with its own
+// heap allocation. The map below stores instead all values in a single
+// contiguous buffer, which is owned by someone else (typically a numpy array),
+// and which has one of two layouts:
+//
+//   - fixed-width: the values of key i are values[i * width + j], for
+//     0 <= j < width, as in a C-contiguous array of shape (N, width);
+//
+//   - ragged: the values of key i are values[offsets[i]:offsets[i+1]].
+//
+// The values of each key are accessed through a flat_vector_row, which can be
+// used like a std::vector whose size cannot be changed.
+
+template <class Value>
+class flat_vector_row
+{
+public:
+    typedef Value value_type;
+    typedef Value* iterator;
+    typedef const Value* const_iterator;
+
+    flat_vector_row(Value* data, size_t size) : _data(data), _size(size) {}
+    flat_vector_row(const flat_vector_row&) = default;
+
+    // assignments copy the values, which must have the same size as the row
+    const flat_vector_row& operator=(const flat_vector_row& x) const
+    {
+        return assign(x);
+    }
+
+    template <class Vec>
+    const flat_vector_row& operator=(const Vec& x) const
+    {
+        return assign(x);
+    }
+
+    const flat_vector_row& operator=(std::initializer_list<Value> x) const
+    {
+        return assign(x);
+    }
+
+    size_t size() const { return _size; }
+    bool empty() const { return _size == 0; }
+    Value* data() const { return _data; }
+    Value& operator[](size_t i) const { return _data[i]; }
+    Value* begin() const { return _data; }
+    Value* end() const { return _data + _size; }
+
+    // the size of a row is fixed, so that this only checks that it is right
+    void resize(size_t n, const Value& = Value()) const
+    {
+        if (n != _size)
+            throw ValueException("cannot resize flat vector of size " +
+                                 std::to_string(_size) + " to " +
+                                 std::to_string(n));
+    }
+
+    operator std::vector<Value>() const
+    {
+        return std::vector<Value>(begin(), end());
+    }
+
+private:
+    template <class Vec>
+    const flat_vector_row& assign(const Vec& x) const
+    {
+        resize(x.size());
+        size_t i = 0;
+        for (const auto& v : x)
+            _data[i++] = v;
+        return *this;
+    }
+
+    Value* _data;
+    size_t _size;
+};
+
+template <class Value, class IndexMap>
+class flat_vector_property_map
+    : public boost::put_get_helper<flat_vector_row<Value>,
+                                   flat_vector_property_map<Value, IndexMap>>
+{
+public:
+    typedef typename boost::property_traits<IndexMap>::key_type key_type;
+    typedef std::vector<Value> value_type;
+    typedef flat_vector_row<Value> reference;
+    typedef boost::read_write_property_map_tag category;
+
+    typedef flat_vector_property_map checked_t;
+    typedef flat_vector_property_map unchecked_t;
+
+    flat_vector_property_map() {}
+
+    // fixed-width layout; the buffer is kept alive by the given handle
+    flat_vector_property_map(Value* values, size_t width, IndexMap index,
+                             std::shared_ptr<void> handle)
+        : _values(values), _width(width), _index(index),
+          _handle(std::move(handle)) {}
+
+    // ragged layout
+    flat_vector_property_map(Value* values, const int64_t* offsets,
+                             IndexMap index, std::shared_ptr<void> handle)
+        : _values(values), _offsets(offsets), _index(index),
+          _handle(std::move(handle)) {}
+
+    reference operator[](const key_type& k) const
+    {
+        size_t i = get(_index, k);
+        if (_offsets == nullptr)
+            return reference(_values + i * _width, _width);
+        return reference(_values + _offsets[i], _offsets[i + 1] - _offsets[i]);
+    }
+
+    bool is_ragged() const { return _offsets != nullptr; }
+    size_t get_width() const { return _width; }
+
+    unchecked_t get_unchecked(size_t = 0) const { return *this; }
+    checked_t get_checked() const { return *this; }
+
+private:
+    Value* _values = nullptr;
+    const int64_t* _offsets = nullptr;
+    size_t _width = 0;
+    IndexMap _index;
+    std::shared_ptr<void> _handle;
+};
+
+} // namespace graph_tool
+
+#endif // FLAT_VECTOR_PROPERTY_MAP_HH
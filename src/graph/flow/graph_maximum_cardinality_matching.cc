@@ -74,7 +74,7 @@ struct get_max_cardinality_matching
 bool max_cardinality_matching(GraphInterface& gi, boost::any match)
 {
     bool check;
-    run_action<graph_tool::detail::never_directed>()
+    run_action<graph_tool::detail::never_directed>(true)
         (gi, std::bind(get_max_cardinality_matching(),
                         std::placeholders::_1, gi.get_vertex_index(),
                        std::placeholders::_2, std::ref(check)),
@@ -55,7 +55,7 @@ double min_cut(GraphInterface& gi, boost::any weight, boost::any part_map)
     typedef boost::mpl::push_back<writable_edge_scalar_properties, cweight_t>::type
         weight_maps;
 
-    run_action<graph_tool::detail::never_directed>()
+    run_action<graph_tool::detail::never_directed>(true)
         (gi, std::bind(get_min_cut(), std::placeholders::_1, std::placeholders::_2,
                        std::placeholders::_3, std::ref(mc)),
          weight_maps(), writable_vertex_scalar_properties())(weight, part_map);
@@ -78,7 +78,7 @@ void get_residual_graph(GraphInterface& gi, boost::any capacity,
 {
     typedef eprop_map_t<uint8_t>::type emap_t;
     emap_t augment = boost::any_cast<emap_t>(oaugment);
-    run_action<>()
+    run_action<>(true)
         (gi, std::bind(do_get_residual_graph(), std::placeholders::_1,
                        std::placeholders::_2, std::placeholders::_3, augment),
          edge_scalar_properties(), edge_scalar_properties())(capacity, res);
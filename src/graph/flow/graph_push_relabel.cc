@@ -85,7 +85,7 @@ struct get_push_relabel_max_flow
 void push_relabel_max_flow(GraphInterface& gi, size_t src, size_t sink,
                            boost::any capacity, boost::any res)
 {
-    run_action<graph_tool::detail::always_directed, boost::mpl::true_>()
+    run_action<graph_tool::detail::always_directed, boost::mpl::true_>(true)
         (gi, std::bind(get_push_relabel_max_flow(),
                        std::placeholders::_1, gi.get_vertex_index(), gi.get_edge_index(),
                        gi.get_edge_index_range(),
@@ -18,18 +18,11 @@
 #ifndef GML_HH
 #define GML_HH
 
-#include <boost/config/warning_disable.hpp>
-#include <boost/spirit/include/qi.hpp>
-#include <boost/spirit/include/phoenix_core.hpp>
-#include <boost/spirit/include/phoenix_operator.hpp>
-#include <boost/spirit/include/phoenix_fusion.hpp>
-#include <boost/spirit/include/phoenix_stl.hpp>
-#include <boost/fusion/include/adapt_struct.hpp>
-#include <boost/variant/recursive_variant.hpp>
-#include <boost/variant/get.hpp>
-#include <boost/spirit/include/support_istream_iterator.hpp>
-#include <boost/foreach.hpp>
 #include <boost/type_traits.hpp>
+#include <boost/any.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/mpl/vector.hpp>
+#include <boost/mpl/for_each.hpp>
 
 #include <boost/algorithm/string/replace.hpp>
 
@@ -44,10 +37,19 @@
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <string_view>
 #include <vector>
+#include <charconv>
+#include <limits>
+#include <cstring>
+#include <cctype>
 
 #include <unordered_map>
+#include <unordered_set>
 
+#include "graph.hh"
+#include "graph_properties.hh"
+#include "graph_io_binary.hh"
 #include "base64.hh"
 
 namespace graph_tool{
@@ -66,300 +68,664 @@ private:
     std::string _what;
 };
 
-struct to_dict_visitor: public boost::static_visitor<>
-{
-    to_dict_visitor(const std::string& key, boost::python::dict& dict)
-        : key(key), dict(dict) {}
+// ========================================================================
+// GML tokenizer
+// ========================================================================
+//
+// The input is read in blocks into a buffer, and the tokens are returned as
+// views into it, which are valid only until the next token is requested. Only
+// strings containing escape sequences are copied.
 
-    template <class Val>
-    void operator()(Val& val) const
+class gml_lexer
+{
+public:
+    enum token_t
+    {
+        key_tok,
+        number_tok,
+        string_tok,
+        open_tok,
+        close_tok,
+        end_tok
+    };
+
+    gml_lexer(std::istream& in)
+        : _in(in), _buf(1 << 16) {}
+
+    // returns a key, a closing bracket, or the end of the input
+    token_t next_key()
     {
-        const_cast<boost::python::dict&>(dict)[key] = val;
+        if (!skip_space())
+            return end_tok;
+        char c = _buf[_pos];
+        if (c == ']')
+        {
+            ++_pos;
+            return close_tok;
+        }
+        scan_word();
+        if (_text.empty())
+            throw error(string("unexpected character '") + c + "'");
+        for (char k : _text)
+        {
+            if (!is_key_char(k))
+                throw error("invalid key '" + string(_text) + "'");
+        }
+        return key_tok;
     }
 
-    template <class Val>
-    void operator()(std::unordered_map<std::string, Val>& val) const
+    // returns a number, a string, or an opening bracket
+    token_t next_value()
     {
-        boost::python::dict n_dict;
-        for (auto& kv : val)
-            boost::apply_visitor(to_dict_visitor(kv.first, n_dict), kv.second);
-        const_cast<boost::python::dict&>(dict)[key] = n_dict;
+        if (!skip_space())
+            throw error("unexpected end of file");
+        char c = _buf[_pos];
+        if (c == '[')
+        {
+            ++_pos;
+            return open_tok;
+        }
+        if (c == '"')
+        {
+            scan_string();
+            return string_tok;
+        }
+        scan_word();
+        if (_text.empty())
+            throw error(string("unexpected character '") + c + "'");
+        std::string_view s = _text;
+        if (!s.empty() && s[0] == '+')
+            s.remove_prefix(1);
+        auto ret = std::from_chars(s.data(), s.data() + s.size(), _number);
+        if (s.empty() || ret.ec != std::errc() || ret.ptr != s.data() + s.size())
+            throw error("invalid value '" + string(_text) + "'");
+        return number_tok;
     }
 
-    const std::string& key;
-    const boost::python::dict& dict;
-};
-
-template <class Desc>
-struct prop_val_visitor: public boost::static_visitor<>
-{
-    prop_val_visitor(const std::string& name, dynamic_properties& dp, Desc v)
-        : name(name), dp(dp), v(v) {}
+    std::string_view text() { return _text; }
+    double number() { return _number; }
 
-    template <class Val>
-    void operator()(Val& val) const
+    gml_parse_error error(const std::string& msg)
     {
-        put(name, const_cast<dynamic_properties&>(dp), v, val);
+        return gml_parse_error("invalid syntax on line " +
+                               lexical_cast<string>(_line) + ": " + msg);
     }
 
-    template <class Val>
-    void operator()(std::unordered_map<std::string, Val>& val) const
+private:
+    static bool is_space(char c)
     {
-        boost::python::dict dict;
-        for (auto& kv : val)
-            boost::apply_visitor(to_dict_visitor(kv.first, dict), kv.second);
-        put(name, const_cast<dynamic_properties&>(dp), v,
-            boost::python::object(dict));
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' ||
+            c == '\f';
     }
 
-    const std::string& name;
-    const dynamic_properties& dp;
-    Desc v;
-};
+    static bool is_key_char(char c)
+    {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+            (c >= '0' && c <= '9') || c == '_' || c == '-';
+    }
 
+    static bool is_word_char(char c)
+    {
+        return is_key_char(c) || c == '+' || c == '.';
+    }
 
-template <class Graph>
-class gml_state
-{
-public:
-    gml_state(Graph& g, dynamic_properties& dp,
-              const std::unordered_set<std::string>& ignore_vp = std::unordered_set<std::string>(),
-              const std::unordered_set<std::string>& ignore_ep = std::unordered_set<std::string>(),
-              const std::unordered_set<std::string>& ignore_gp = std::unordered_set<std::string>())
-        : _g(g), _dp(dp), _directed(false), _ignore_vp(ignore_vp),
-          _ignore_ep(ignore_ep), _ignore_gp(ignore_gp) {}
-
-    typedef boost::make_recursive_variant<std::string, int, double,
-                                          std::unordered_map<std::string,
-                                                             boost::recursive_variant_>>
-        ::type val_t;
-
-    // key / value mechanics
-    void push_key(const std::string& key)
-    {
-        _stack.push_back(make_pair(key, prop_list_t()));
+    // makes sure the character at offset i from the current position is in
+    // the buffer, and returns false if the input ends before it
+    bool fill(size_t i)
+    {
+        while (_pos + i >= _end)
+        {
+            if (_eof)
+                return false;
+            std::memmove(_buf.data(), _buf.data() + _pos, _end - _pos);
+            _end -= _pos;
+            _pos = 0;
+            if (_end == _buf.size())
+                _buf.resize(2 * _buf.size());
+            _in.read(_buf.data() + _end, _buf.size() - _end);
+            size_t n = _in.gcount();
+            _end += n;
+            if (n == 0 || _in.eof())
+                _eof = true;
+        }
+        return true;
     }
 
-    void push_value(const val_t& value)
+    // skips whitespace and comments, and returns false at the end of the
+    // input
+    bool skip_space()
     {
-        if (_stack.empty())
-            return;
-        std::string k = _stack.back().first;
-        _stack.pop_back();
-        if (!_stack.empty())
-            _stack.back().second[k] = value;
+        while (fill(0))
+        {
+            char c = _buf[_pos];
+            if (c == '#')
+            {
+                while (fill(0) && _buf[_pos] != '\n')
+                    ++_pos;
+            }
+            else if (is_space(c))
+            {
+                if (c == '\n')
+                    ++_line;
+                ++_pos;
+            }
+            else
+            {
+                return true;
+            }
+        }
+        return false;
     }
 
-    // actual parsing
-    void finish_list()
+    void scan_word()
     {
-        if (_stack.empty())
-            return;
+        size_t n = 0;
+        while (fill(n) && is_word_char(_buf[_pos + n]))
+            ++n;
+        _text = std::string_view(_buf.data() + _pos, n);
+        _pos += n;
+    }
 
-        std::string &k = _stack.back().first;
-        if (k == "node")
+    void scan_string()
+    {
+        size_t line = _line;
+        bool escaped = false;
+        size_t n = 1;
+        while (true)
         {
-            int id;
-            if (_stack.back().second.find("id") == _stack.back().second.end())
-                throw gml_parse_error("node does not have an id");
-            try
+            if (!fill(n))
             {
-                id = boost::get<double>(_stack.back().second["id"]);
+                _line = line;
+                throw error("unterminated string");
             }
-            catch (bad_get)
+            char c = _buf[_pos + n];
+            if (c == '"')
+                break;
+            if (c == '\\' && fill(n + 1))
             {
-                throw gml_parse_error("invalid node id");
+                escaped = true;
+                char d = _buf[_pos + n + 1];
+                if (d == '"' || d == '\\')
+                    ++n;
             }
+            else if (c == '\n')
+            {
+                ++_line;
+            }
+            ++n;
+        }
+        _text = std::string_view(_buf.data() + _pos + 1, n - 1);
+        _pos += n + 1;
+        if (escaped)
+            unescape();
+    }
 
-            typedef typename graph_traits<Graph>::vertex_descriptor vertex_t;
-            vertex_t v = get_vertex(id);
-
-            // put properties
-            for (auto& iter : _stack.back().second)
+    void unescape()
+    {
+        static const char codes[] = "a\ab\bf\fn\nr\rt\tv\v\\\\''\"\"";
+        _unescaped.clear();
+        for (size_t i = 0; i < _text.size(); ++i)
+        {
+            char c = _text[i];
+            if (c == '\\' && i + 1 < _text.size() && _text[i + 1] != '\0')
             {
-                if (iter.first == "id")
-                    continue;
-                if (_ignore_vp.find(iter.first) != _ignore_vp.end())
-                    continue;
-                boost::apply_visitor(prop_val_visitor<vertex_t>(iter.first, _dp, v),
-                                     iter.second);
+                const char* code = std::strchr(codes, _text[i + 1]);
+                if (code != nullptr && (code - codes) % 2 == 0)
+                {
+                    c = code[1];
+                    ++i;
+                }
+                else if (_text[i + 1] == 'x' && i + 2 < _text.size() &&
+                         std::isxdigit(static_cast<unsigned char>(_text[i + 2])))
+                {
+                    // \xHH..., where all the hex digits are consumed
+                    unsigned int x = 0;
+                    i += 2;
+                    for (; i < _text.size() &&
+                             std::isxdigit(static_cast<unsigned char>(_text[i]));
+                         ++i)
+                    {
+                        char d = _text[i];
+                        x = 16 * x + (std::isdigit(static_cast<unsigned char>(d)) ?
+                                      d - '0' : (d | 0x20) - 'a' + 10);
+                    }
+                    --i;
+                    c = char(x);
+                }
             }
+            _unescaped.push_back(c);
         }
-        else if (k == "edge")
+        _text = _unescaped;
+    }
+
+    std::istream& _in;
+    std::vector<char> _buf;
+    size_t _pos = 0;
+    size_t _end = 0;
+    bool _eof = false;
+    size_t _line = 1;
+
+    std::string_view _text;
+    std::string _unescaped;
+    double _number = 0;
+};
+
+// ========================================================================
+// GML reader
+// ========================================================================
+//
+// The file is parsed in a single pass. The attributes of each node and edge
+// are kept only until its closing bracket, when the vertex or edge is added to
+// the graph and its attributes are written directly to the property maps.
+// Numeric attributes are stored as double, strings as string, and nested
+// lists as python dictionaries.
+
+class gml_reader
+{
+public:
+    typedef GraphInterface::multigraph_t graph_t;
+    typedef std::vector<std::pair<std::string, boost::any>> props_t;
+
+    // the graph g must be empty
+    gml_reader(graph_t& g,
+               const std::unordered_set<std::string>& ignore_vp,
+               const std::unordered_set<std::string>& ignore_ep,
+               const std::unordered_set<std::string>& ignore_gp)
+        : _g(g), _ignore_vp(ignore_vp), _ignore_ep(ignore_ep),
+          _ignore_gp(ignore_gp) {}
+
+    // parses the file, and returns whether the graph is directed
+    bool run(std::istream& in)
+    {
+        gml_lexer lex(in);
+        _lex = &lex;
+        while (true)
         {
-            int source, target;
-            if (_stack.back().second.find("source") ==
-                _stack.back().second.end() ||
-                _stack.back().second.find("target") ==
-                _stack.back().second.end())
-                throw gml_parse_error("edge does not have source and target ids");
-            try
+            auto tok = lex.next_key();
+            if (tok == gml_lexer::end_tok)
+            {
+                if (_depth > 0)
+                    throw lex.error("unexpected end of file, missing ']'");
+                break;
+            }
+            if (tok == gml_lexer::close_tok)
             {
-                source = boost::get<double>(_stack.back().second["source"]);
-                target = boost::get<double>(_stack.back().second["target"]);
+                if (_depth == 0)
+                    throw lex.error("unexpected ']'");
+                finish_list();
+                continue;
             }
-            catch (bad_get)
+            _key.assign(lex.text());
+            switch (lex.next_value())
             {
-                throw gml_parse_error("invalid source and target ids");
+            case gml_lexer::open_tok:
+                push_list();
+                break;
+            case gml_lexer::number_tok:
+                put_value(number_val, lex);
+                break;
+            case gml_lexer::string_tok:
+                put_value(string_val, lex);
+                break;
+            default:
+                break;
             }
+        }
+        _lex = nullptr;
+        return _directed;
+    }
 
-            typename graph_traits<Graph>::vertex_descriptor s, t;
-            s = get_vertex(source);
-            t = get_vertex(target);
+    void get_properties(props_t& gprops, props_t& vprops, props_t& eprops)
+    {
+        _gprops.get(gprops);
+        _vprops.get(vprops);
+        _eprops.get(eprops);
+    }
 
-            typedef typename graph_traits<Graph>::edge_descriptor edge_t;
-            edge_t e = add_edge(s, t, _g).first;
+private:
+    enum list_kind
+    {
+        graph_list,
+        node_list,
+        edge_list,
+        other_list
+    };
 
-            // put properties
-            for (auto& iter : _stack.back().second)
-            {
-                if (iter.first == "id" || iter.first == "source" || iter.first == "target")
-                    continue;
-                if (_ignore_ep.find(iter.first) != _ignore_ep.end())
-                    continue;
-                boost::apply_visitor(prop_val_visitor<edge_t>(iter.first, _dp, e),
-                                     iter.second);
-            }
+    enum value_kind
+    {
+        number_val,
+        string_val,
+        object_val
+    };
 
-        }
-        else if (k == "graph")
+    struct attr
+    {
+        std::string key;
+        value_kind kind;
+        double number;
+        std::string str;
+        boost::python::object obj;
+    };
+
+    // the attributes of a node, edge or graph are collected until the list is
+    // closed, and those of any other list are stored in a dictionary
+    struct list
+    {
+        list_kind kind;
+        std::string key;
+        std::vector<attr> attrs;
+        size_t nattrs;
+        boost::python::dict dict;
+    };
+
+    template <class RangeTraits>
+    class property_set
+    {
+    public:
+        typedef typename RangeTraits::index_map_t index_map_t;
+
+        template <class Value>
+        using map_t = typename property_map_type::apply<Value, index_map_t>::type;
+
+        template <class Key>
+        void put(graph_t& g, const Key& k, attr& a)
         {
-            // put properties
-            for (auto& iter : _stack.back().second)
+            auto iter = _index.find(a.key);
+            if (iter == _index.end())
             {
-                if (iter.first == "directed")
-                    _directed = boost::get<double>(iter.second);
-                if (_ignore_gp.find(iter.first) != _ignore_gp.end())
-                    continue;
-                boost::apply_visitor(prop_val_visitor<graph_property_tag>(iter.first, _dp,
-                                                                          graph_property_tag()),
-                                     iter.second);
+                iter = _index.emplace(a.key, _props.size()).first;
+                _props.emplace_back();
+                auto& p = _props.back();
+                p.name = a.key;
+                p.kind = a.kind;
+                auto index = RangeTraits::get_index_map(g);
+                switch (a.kind)
+                {
+                case number_val:
+                    p.nmap = map_t<double>(index);
+                    break;
+                case string_val:
+                    p.smap = map_t<std::string>(index);
+                    break;
+                case object_val:
+                    p.omap = map_t<boost::python::object>(index);
+                    break;
+                }
             }
 
-        }
-        else
-        {
-            // Push nested lists down the stack
-            if (_stack.size() < 2)
+            // values of different types are converted to the type of the
+            // first value found, as far as possible
+            auto& p = _props[iter->second];
+            if (p.kind == number_val && a.kind == number_val)
+            {
+                p.nmap[k] = a.number;
+            }
+            else if (p.kind == number_val && a.kind == string_val)
             {
-                if (k != "comments")
-                    throw gml_parse_error("invalid syntax: list '" + k + "' not within 'node', 'edge' or 'graph'");
+                double val = 0;
+                if (!a.str.empty() &&
+                    !conversion::try_lexical_convert(a.str, val))
+                    throw gml_parse_error("invalid value \"" + a.str +
+                                          "\" for numeric property \"" +
+                                          p.name + "\"");
+                p.nmap[k] = val;
+            }
+            else if (p.kind == string_val && a.kind == string_val)
+            {
+                p.smap[k] = std::move(a.str);
+            }
+            else if (p.kind == string_val && a.kind == number_val)
+            {
+                char buf[32];
+                auto ret = std::to_chars(buf, buf + sizeof(buf), a.number);
+                p.smap[k] = std::string(buf, ret.ptr);
+            }
+            else if (p.kind == object_val && a.kind == object_val)
+            {
+                p.omap[k] = std::move(a.obj);
             }
             else
             {
-                _stack[_stack.size() - 2].second[k] = _stack.back().second;
+                throw gml_parse_error("inconsistent value types for property \"" +
+                                      p.name + "\"");
+            }
+        }
+
+        void get(props_t& props)
+        {
+            for (auto& p : _props)
+            {
+                switch (p.kind)
+                {
+                case number_val:
+                    props.emplace_back(p.name, p.nmap);
+                    break;
+                case string_val:
+                    props.emplace_back(p.name, p.smap);
+                    break;
+                case object_val:
+                    props.emplace_back(p.name, p.omap);
+                    break;
+                }
             }
         }
-        _stack.pop_back();
-    }
 
-    typename graph_traits<Graph>::vertex_descriptor get_vertex(size_t index)
+    private:
+        struct prop
+        {
+            std::string name;
+            value_kind kind;
+            map_t<double> nmap;
+            map_t<std::string> smap;
+            map_t<boost::python::object> omap;
+        };
+
+        std::vector<prop> _props;
+        std::unordered_map<std::string, size_t> _index;
+    };
+
+    void push_list()
     {
-        if (_vmap.find(index) == _vmap.end())
-            _vmap[index] = add_vertex(_g);
-        return _vmap[index];
+        if (_depth == _lists.size())
+            _lists.emplace_back();
+        auto& l = _lists[_depth++];
+        if (_key == "node")
+            l.kind = node_list;
+        else if (_key == "edge")
+            l.kind = edge_list;
+        else if (_key == "graph")
+            l.kind = graph_list;
+        else
+            l.kind = other_list;
+        l.key = _key;
+        l.nattrs = 0;
+        if (l.kind == other_list)
+            l.dict = boost::python::dict();
     }
 
-
-    bool is_directed()
+    attr& push_attr(list& l, const std::string& key)
     {
-        return _directed;
+        if (l.nattrs == l.attrs.size())
+            l.attrs.emplace_back();
+        auto& a = l.attrs[l.nattrs++];
+        a.key = key;
+        return a;
     }
 
+    void put_value(value_kind kind, gml_lexer& lex)
+    {
+        // values outside of any list are ignored
+        if (_depth == 0)
+            return;
+        auto& l = _lists[_depth - 1];
+        if (l.kind == other_list)
+        {
+            if (kind == number_val)
+                l.dict[_key] = lex.number();
+            else
+                l.dict[_key] = boost::python::str(lex.text().data(),
+                                                  lex.text().size());
+            return;
+        }
+        auto& a = push_attr(l, _key);
+        a.kind = kind;
+        if (kind == number_val)
+            a.number = lex.number();
+        else
+            a.str.assign(lex.text());
+    }
 
-private:
-    Graph& _g;
-    dynamic_properties& _dp;
-    bool _directed;
-    std::unordered_map<int, typename graph_traits<Graph>::vertex_descriptor> _vmap;
-
-    // the stack holds the keys, and its properties
-    typedef std::unordered_map<std::string, val_t> prop_list_t;
-    vector<pair<std::string,  prop_list_t> > _stack;
+    // returns the last attribute with the given key, or nullptr
+    attr* find_attr(list& l, const char* key)
+    {
+        for (size_t i = l.nattrs; i > 0; --i)
+        {
+            if (l.attrs[i - 1].key == key)
+                return &l.attrs[i - 1];
+        }
+        return nullptr;
+    }
 
-    const std::unordered_set<std::string>& _ignore_vp;
-    const std::unordered_set<std::string>& _ignore_ep;
-    const std::unordered_set<std::string>& _ignore_gp;
-};
+    size_t get_vertex(int64_t id)
+    {
+        if (id >= 0 && size_t(id) < _dense_vertex.size() &&
+            _dense_vertex[id] != _null_vertex)
+            return _dense_vertex[id];
+        auto iter = _sparse_vertex.find(id);
+        if (iter != _sparse_vertex.end())
+            return iter->second;
 
+        size_t v = add_vertex(_g);
 
-template <class Iterator, class Graph, class Skipper>
-struct gml : spirit::qi::grammar<Iterator, void(), Skipper>
-{
-    gml(Graph& g, dynamic_properties& dp,
-        const std::unordered_set<std::string>& ignore_vp = std::unordered_set<std::string>(),
-        const std::unordered_set<std::string>& ignore_ep = std::unordered_set<std::string>(),
-        const std::unordered_set<std::string>& ignore_gp = std::unordered_set<std::string>())
-        : gml::base_type(start), _state(g, dp, ignore_vp, ignore_ep, ignore_gp)
-    {
-        using namespace spirit;
-        using spirit::ascii::char_;
-
-        unesc_str = spirit::lexeme['"' >> *(unesc_char | (spirit::qi::graph - "\"") |
-                                            spirit::qi::space | "\\x" >> qi::hex) >> '"'];
-        unesc_char.add("\\a", '\a')("\\b", '\b')("\\f", '\f')("\\n", '\n')
-            ("\\r", '\r')("\\t", '\t')("\\v", '\v')("\\\\", '\\')
-            ("\\\'", '\'')("\\\"", '\"');
-        key_identifier %= spirit::lexeme[((+((spirit::qi::alnum | "_") | "-")) >> *spirit::qi::alnum)];
-        key = key_identifier
-            [boost::bind(&gml_state<Graph>::push_key, &_state, ::_1)];
-        value_identifier %= (spirit::lexeme[spirit::qi::double_] | unesc_str);
-        value %= value_identifier
-            [boost::bind(&gml_state<Graph>::push_value, &_state, ::_1)];
-        list_identifier = *(key >> (value | "[" >> list >> "]"));
-        list = list_identifier
-            [boost::bind(&gml_state<Graph>::finish_list, &_state)];
-        start = list;
+        // small non-negative ids, the usual case, are looked up in a vector
+        if (id >= 0 && size_t(id) < 2 * num_vertices(_g) + 1024)
+        {
+            if (size_t(id) >= _dense_vertex.size())
+                _dense_vertex.resize(id + 1, _null_vertex);
+            _dense_vertex[id] = v;
+        }
+        else
+        {
+            _sparse_vertex.emplace(id, v);
+        }
+        return v;
     }
 
-    typedef boost::variant<std::string, double> val_t;
-
-    spirit::qi::rule<Iterator, std::string(), Skipper> unesc_str;
-    spirit::qi::symbols<char const, char const> unesc_char;
-    spirit::qi::rule<Iterator, std::string(), Skipper> key, key_identifier;
-    spirit::qi::rule<Iterator, val_t(), Skipper> value, value_identifier;
-    spirit::qi::rule<Iterator, void(), Skipper> list, list_identifier;
-    spirit::qi::rule<Iterator, void(), Skipper> start;
+    void finish_node(list& l)
+    {
+        attr* id = find_attr(l, "id");
+        if (id == nullptr)
+            throw _lex->error("node does not have an id");
+        if (id->kind != number_val)
+            throw _lex->error("invalid node id");
+        size_t v = get_vertex(int64_t(id->number));
+        for (size_t i = 0; i < l.nattrs; ++i)
+        {
+            auto& a = l.attrs[i];
+            if (a.key == "id" || _ignore_vp.find(a.key) != _ignore_vp.end())
+                continue;
+            _vprops.put(_g, v, a);
+        }
+    }
 
-    gml_state<Graph> _state;
-};
+    void finish_edge(list& l)
+    {
+        attr* s = find_attr(l, "source");
+        attr* t = find_attr(l, "target");
+        if (s == nullptr || t == nullptr)
+            throw _lex->error("edge does not have source and target ids");
+        if (s->kind != number_val || t->kind != number_val)
+            throw _lex->error("invalid source and target ids");
+        size_t u = get_vertex(int64_t(s->number));
+        size_t v = get_vertex(int64_t(t->number));
+        auto e = add_edge(u, v, _g).first;
+        for (size_t i = 0; i < l.nattrs; ++i)
+        {
+            auto& a = l.attrs[i];
+            if (a.key == "id" || a.key == "source" || a.key == "target" ||
+                _ignore_ep.find(a.key) != _ignore_ep.end())
+                continue;
+            _eprops.put(_g, e, a);
+        }
+    }
 
-template <class Iterator, class Graph, class Skipper>
-bool parse_grammar(Iterator begin, Iterator end, Graph& g,
-                   dynamic_properties& dp, Skipper skip,
-                   const std::unordered_set<std::string>& ignore_vp = std::unordered_set<std::string>(),
-                   const std::unordered_set<std::string>& ignore_ep = std::unordered_set<std::string>(),
-                   const std::unordered_set<std::string>& ignore_gp = std::unordered_set<std::string>())
-{
-    using namespace spirit;
-    gml<spirit::istream_iterator, Graph, Skipper> parser(g, dp, ignore_vp,
-                                                         ignore_ep, ignore_gp);
-    bool ok = qi::phrase_parse(begin, end, parser, skip);
-    if (!ok)
-        throw gml_parse_error("invalid syntax");
-    return parser._state.is_directed();
-}
+    void finish_graph(list& l)
+    {
+        for (size_t i = 0; i < l.nattrs; ++i)
+        {
+            auto& a = l.attrs[i];
+            if (a.key == "directed")
+            {
+                if (a.kind != number_val)
+                    throw _lex->error("invalid value for 'directed'");
+                _directed = a.number;
+            }
+            if (_ignore_gp.find(a.key) != _ignore_gp.end())
+                continue;
+            _gprops.put(_g, graph_property_tag(), a);
+        }
+    }
 
+    void finish_list()
+    {
+        auto& l = _lists[_depth - 1];
+        switch (l.kind)
+        {
+        case node_list:
+            finish_node(l);
+            break;
+        case edge_list:
+            finish_edge(l);
+            break;
+        case graph_list:
+            finish_graph(l);
+            break;
+        case other_list:
+            if (_depth < 2)
+            {
+                if (l.key != "comments")
+                    throw _lex->error("list '" + l.key + "' not within "
+                                      "'node', 'edge' or 'graph'");
+            }
+            else
+            {
+                // nested lists are attached to the enclosing list
+                auto& parent = _lists[_depth - 2];
+                if (parent.kind == other_list)
+                {
+                    parent.dict[l.key] = l.dict;
+                }
+                else
+                {
+                    auto& a = push_attr(parent, l.key);
+                    a.kind = object_val;
+                    a.obj = l.dict;
+                }
+            }
+            break;
+        }
+        --_depth;
+    }
 
-template <class Graph>
-bool read_gml(istream& in, Graph& g, dynamic_properties& dp,
-              const std::unordered_set<std::string>& ignore_vp = std::unordered_set<std::string>(),
-              const std::unordered_set<std::string>& ignore_ep = std::unordered_set<std::string>(),
-              const std::unordered_set<std::string>& ignore_gp = std::unordered_set<std::string>())
-{
-    using namespace spirit;
+    graph_t& _g;
+    const std::unordered_set<std::string>& _ignore_vp;
+    const std::unordered_set<std::string>& _ignore_ep;
+    const std::unordered_set<std::string>& _ignore_gp;
+    gml_lexer* _lex = nullptr;
+    bool _directed = false;
 
-    in >> std::noskipws;
-    spirit::istream_iterator begin(in);
-    spirit::istream_iterator end;
+    std::string _key;
+    std::vector<list> _lists;
+    size_t _depth = 0;
 
-    bool directed =
-        parse_grammar(begin, end, g, dp,
-                      (ascii::space |'#' >> *(ascii::char_ - qi::eol) >> qi::eol),
-                      ignore_vp, ignore_ep, ignore_gp);
+    static constexpr size_t _null_vertex = std::numeric_limits<size_t>::max();
+    std::vector<size_t> _dense_vertex;
+    std::unordered_map<int64_t, size_t> _sparse_vertex;
 
-    return directed;
-}
+    property_set<graph_range_traits> _gprops;
+    property_set<vertex_range_traits> _vprops;
+    property_set<edge_range_traits> _eprops;
+};
 
 struct get_str
 {
@@ -18,6 +18,7 @@
 #include "graph.hh"
 #include "graph_filtering.hh"
 #include "graph_properties.hh"
+#include "graph_memory.hh"
 
 #include <boost/lambda/lambda.hpp>
 #include <boost/lambda/bind.hpp>
@@ -26,6 +27,7 @@
 using namespace std;
 using namespace boost;
 using namespace graph_tool;
+using namespace graph_tool::detail;
 
 
 // this is the constructor for the graph interface
@@ -41,7 +43,10 @@ GraphInterface::GraphInterface()
      _vertex_filter_active(false),
      _edge_filter_map(_edge_index),
      _edge_filter_invert(false),
-     _edge_filter_active(false)
+     _edge_filter_active(false),
+     _num_edges_key(),
+     _num_edges(0),
+     _materialize_threshold(0.05)
 {
 }
 
@@ -54,12 +59,24 @@ GraphInterface::~GraphInterface()
 // O(V) way, which is necessary if the graph is filtered
 size_t GraphInterface::get_num_vertices(bool filtered)
 {
+    size_t N = num_vertices(*_mg);
+    if (!filtered || !is_vertex_filter_active())
+        return N;
+
+    sync_filter_bits();
+    if (_vertex_filter_bits.is_active())
+    {
+        size_t n = _vertex_filter_bits.count(N);
+        return _vertex_filter_invert ? N - n : n;
+    }
+
+    auto& vmask = _vertex_filter_map.get_storage();
+    if (vmask.size() >= N)
+        return mask_count(vmask.data(), N, _vertex_filter_invert);
+
     size_t n = 0;
-    if (filtered && is_vertex_filter_active())
-        run_action<>()(*this, lambda::var(n) =
-                       lambda::bind<size_t>(HardNumVertices(),lambda::_1))();
-    else
-        n = num_vertices(*_mg);
+    run_action<>()(*this, lambda::var(n) =
+                   lambda::bind<size_t>(HardNumVertices(),lambda::_1))();
     return n;
 }
 
@@ -68,13 +85,85 @@ size_t GraphInterface::get_num_vertices(bool filtered)
 // linear complexity, since num_edges() is O(E) in Boost's adjacency_list
 size_t GraphInterface::get_num_edges(bool filtered)
 {
-    using namespace boost::lambda;
+    if (!filtered || (!is_edge_filter_active() && !is_vertex_filter_active()))
+        return num_edges(*_mg);
+
+    size_t N = num_vertices(*_mg);
+    size_t E = _mg->get_edge_index_range();
+    auto& vmask = _vertex_filter_map.get_storage();
+    auto& emask = _edge_filter_map.get_storage();
+    bool vactive = is_vertex_filter_active();
+    bool eactive = is_edge_filter_active();
+
+    sync_filter_bits();
+    bool vbits = vactive && _vertex_filter_bits.is_active();
+    bool ebits = eactive && _edge_filter_bits.is_active();
+
+    if (!vactive && num_edges(*_mg) == E)
+    {
+        // no free indexes, hence every entry of the mask is a valid edge
+        if (ebits)
+        {
+            size_t n = _edge_filter_bits.count(E);
+            return _edge_filter_invert ? E - n : n;
+        }
+        if (emask.size() >= E)
+            return mask_count(emask.data(), E, _edge_filter_invert);
+    }
+
+    // the count is kept while neither the graph nor the masks change
+    std::array<size_t, 7> key =
+        {_mg->get_stamp(),
+         vactive, _vertex_filter_invert,
+         vbits ? _vertex_filter_bits.get_version() : 0,
+         eactive, _edge_filter_invert,
+         ebits ? _edge_filter_bits.get_version() : 0};
+    bool cache = (vbits || !vactive) && (ebits || !eactive);
+    if (cache && key == _num_edges_key)
+        return _num_edges;
+
+    if ((!vactive || vmask.size() >= N) && (!eactive || emask.size() >= E))
+    {
+        // only the out-edges of the vertices which are kept need to be
+        // visited, which are found by skipping the masked blocks
+        bool vinv = _vertex_filter_invert;
+        bool einv = _edge_filter_invert;
+        size_t n = 0;
+        constexpr size_t block = 4096;
+        #pragma omp parallel for schedule(runtime) reduction(+:n) \
+            if (N > OPENMP_MIN_THRESH)
+        for (size_t b = 0; b < N; b += block)
+        {
+            size_t end = std::min(b + block, N);
+            for (size_t v = b; v < end; ++v)
+            {
+                if (vactive)
+                {
+                    v = mask_find_next(vmask.data(), v, end, vinv);
+                    if (v == end)
+                        break;
+                }
+                for (auto e : out_edges_range(v, *_mg))
+                {
+                    if (eactive && !(emask[e.idx] ^ einv))
+                        continue;
+                    if (vactive && !(vmask[target(e, *_mg)] ^ vinv))
+                        continue;
+                    ++n;
+                }
+            }
+        }
+        if (cache)
+        {
+            _num_edges_key = key;
+            _num_edges = n;
+        }
+        return n;
+    }
+
     size_t n = 0;
-    if (filtered && (is_edge_filter_active() || is_vertex_filter_active()))
-        run_action<>()(*this, lambda::var(n) =
-                       lambda::bind<size_t>(HardNumEdges(),lambda::_1))();
-    else
-        n = num_edges(*_mg);
+    run_action<>()(*this, lambda::var(n) =
+                   lambda::bind<size_t>(HardNumEdges(),lambda::_1))();
     return n;
 }
 
@@ -96,7 +185,12 @@ struct clear_vertices
 
 void GraphInterface::clear()
 {
+    check_thawed();
     run_action<>()(*this, std::bind(clear_vertices(), std::placeholders::_1))();
+
+    // release all the pool memory in bulk
+    if (_mg->get_edge_pool() && num_vertices(*_mg) == 0)
+        _mg->shrink_to_fit();
 }
 
 struct do_clear_edges
@@ -111,5 +205,90 @@ struct do_clear_edges
 
 void GraphInterface::clear_edges()
 {
+    check_thawed();
     run_action<>()(*this, std::bind(do_clear_edges(), std::placeholders::_1))();
 }
+
+// memory used by the edge lists, and by the pool, if it is enabled
+python::dict GraphInterface::get_edge_memory_stats()
+{
+    typedef multigraph_t::stored_edge_t stored_edge_t;
+    size_t size = 0;
+    for (auto v : vertices_range(*_mg))
+        size += degree(v, *_mg) * sizeof(stored_edge_t);
+    size_t capacity = _mg->get_edge_capacity() * sizeof(stored_edge_t);
+
+    python::dict stats;
+    stats["edge_bytes"] = size;
+    stats["capacity_bytes"] = capacity;
+    stats["pool"] = _mg->get_edge_pool();
+    size_t reserved = capacity;
+    auto pool = _mg->get_edge_pool_ptr();
+    if (pool != nullptr)
+    {
+        auto& pstats = pool->get_stats();
+        reserved = pstats.slab_bytes + pstats.large_bytes;
+        stats["slab_bytes"] = pstats.slab_bytes;
+        stats["large_bytes"] = pstats.large_bytes;
+        stats["used_bytes"] = pstats.used_bytes;
+        stats["free_bytes"] = pstats.free_bytes;
+        stats["n_slabs"] = pstats.n_slabs;
+    }
+    stats["reserved_bytes"] = reserved;
+    stats["fragmentation"] = (reserved > 0) ? 1 - size / double(reserved) : 0.;
+    return stats;
+}
+
+// size of the edge hash index, if it is enabled, and the cost of building it
+python::dict GraphInterface::get_edge_hash_stats()
+{
+    python::dict stats;
+    stats["enabled"] = _mg->get_edge_hash();
+    auto ehash = _mg->get_edge_hash_ptr();
+    if (ehash != nullptr)
+    {
+        stats["entries"] = ehash->size();
+        stats["used_bytes"] = ehash->memory_size();
+        stats["reserved_bytes"] = ehash->memory_capacity();
+        stats["synced"] = _mg->is_edge_hash_synced();
+        stats["n_builds"] = _mg->get_edge_hash_builds();
+        stats["build_time"] = _mg->get_edge_hash_time();
+    }
+    return stats;
+}
+
+// memory used (and allocated) by each internal data structure, in bytes
+python::dict GraphInterface::get_memory_usage()
+{
+    python::dict usage;
+    auto put = [&](const char* name, size_t size, size_t capacity)
+        {
+            usage[name] = python::make_tuple(size, capacity);
+        };
+    _mg->visit_memory(put);
+
+    // the adjacency may be shared with copies of the graph, which then report
+    // it as well
+    size_t shared_size = 0, shared_capacity = 0;
+    if (_mg->is_shared())
+        _mg->visit_memory([&](const char*, size_t size, size_t capacity)
+                          {
+                              shared_size += size;
+                              shared_capacity += capacity;
+                          });
+    put("shared", shared_size, shared_capacity);
+
+    if (_fg)
+        _fg->visit_memory(put);
+    if (_vertex_filter_active)
+    {
+        auto m = graph_tool::get_memory_usage(_vertex_filter_map.get_storage());
+        put("vertex_filter", m.size, m.capacity);
+    }
+    if (_edge_filter_active)
+    {
+        auto m = graph_tool::get_memory_usage(_edge_filter_map.get_storage());
+        put("edge_filter", m.size, m.capacity);
+    }
+    return usage;
+}
@@ -23,9 +23,11 @@
 #include <boost/python/object.hpp>
 #include <boost/python/dict.hpp>
 
+#include <array>
 #include <deque>
 
 #include "graph_adjacency.hh"
+#include "graph_adjacency_csr.hh"
 
 #include <boost/graph/graph_traits.hpp>
 
@@ -34,6 +36,7 @@
 #include <boost/mpl/vector.hpp>
 #include "graph_properties.hh"
 #include "graph_exceptions.hh"
+#include "graph_filter_bits.hh"
 
 namespace graph_tool
 {
@@ -51,6 +54,9 @@ template <class Action, class GraphViews, class Wrap = boost::mpl::false_,
 struct graph_action;
 }
 
+// compact copy of a filtered view. See graph_filtering.hh for details.
+struct materialized_view;
+
 class GraphInterface
 {
 public:
@@ -85,6 +91,25 @@ public:
     bool get_reversed() {return _reversed;}
     void set_keep_epos(bool keep) {_mg->set_keep_epos(keep);}
     bool get_keep_epos() {return _mg->get_keep_epos();}
+    void set_sorted(bool sorted) {_mg->set_sorted(sorted);}
+    bool get_sorted() {return _mg->get_sorted();}
+    void set_edge_pool(bool pool) {_mg->set_edge_pool(pool);}
+    bool get_edge_pool() {return _mg->get_edge_pool();}
+    void set_edge_hash(bool ehash) {_mg->set_edge_hash(ehash);}
+    bool get_edge_hash() {return _mg->get_edge_hash();}
+    boost::python::dict get_edge_hash_stats();
+    boost::python::dict get_edge_memory_stats();
+    boost::python::dict get_memory_usage();
+
+    // immutable snapshot
+    void freeze();
+    void thaw();
+    bool is_frozen() const {return bool(_fg);}
+    void check_thawed() const
+    {
+        if (is_frozen())
+            frozen_graph_t::throw_immutable();
+    }
 
 
     // graph filtering
@@ -97,11 +122,26 @@ public:
     void re_index_edges();
     void purge_vertices(boost::any old_index); // removes filtered vertices
     void purge_edges();    // removes filtered edges
+    void permute_vertices(boost::python::object ovmap); // relabels vertices
+    boost::python::object remove_vertices(boost::python::object ovs);
+    void remove_edges(boost::python::object oes);
+    boost::python::object compact_edge_indexes();
+    size_t get_view_stamp();
+    boost::python::tuple materialize(GraphInterface& dst);
+    std::shared_ptr<materialized_view> get_materialized_view();
+    void set_materialize_threshold(double threshold)
+    {
+        _materialize_threshold = threshold;
+    }
+    double get_materialize_threshold() {return _materialize_threshold;}
     void clear();
     void clear_edges();
     void shift_vertex_property(boost::any map, boost::python::object oindex) const;
     void move_vertex_property(boost::any map, boost::python::object oindex) const;
     void re_index_vertex_property(boost::any map, boost::any old_index) const;
+    void permute_vertex_property(boost::any map, boost::python::object ovmap) const;
+    void compact_vertex_property(boost::any map, boost::python::object ovmap) const;
+    void compact_edge_property(boost::any map, boost::python::object oemap) const;
     void copy_vertex_property(const GraphInterface& src, boost::any prop_src,
                               boost::any prop_tgt);
     void copy_edge_property(const GraphInterface& src, boost::any prop_src,
@@ -119,18 +159,32 @@ public:
 
     // I/O
     void write_to_file(std::string s, boost::python::object pf, std::string format,
-                       boost::python::list properties);
+                       boost::python::list properties, bool dict_strings);
     boost::python::tuple read_from_file(std::string s, boost::python::object pf,
                                         std::string format,
                                         boost::python::list ignore_vp,
                                         boost::python::list ignore_ep,
-                                        boost::python::list ignore_gp);
+                                        boost::python::list ignore_gp,
+                                        boost::python::object only_vp,
+                                        boost::python::object only_ep,
+                                        boost::python::object only_gp);
+    boost::python::object read_property_from_file(std::string s,
+                                                  boost::python::object pf,
+                                                  std::string key_type,
+                                                  std::string name);
+    void read_csv_edge_list(std::string s, boost::python::object pf,
+                            std::string delimiter, std::string quotechar,
+                            bool skip_first, size_t source, size_t target,
+                            bool string_vals, bool hashed,
+                            boost::python::object vmap,
+                            boost::python::object eprops, size_t batch_size);
 
     //
     // Internal types
     //
 
     typedef boost::adj_list<size_t> multigraph_t;
+    typedef boost::adj_csr<size_t> frozen_graph_t;
     typedef boost::graph_traits<multigraph_t>::vertex_descriptor vertex_t;
     typedef boost::graph_traits<multigraph_t>::edge_descriptor edge_t;
 
@@ -142,14 +196,17 @@ public:
 
     multigraph_t&      get_graph() {return *_mg;}
     std::shared_ptr<multigraph_t> get_graph_ptr() {return _mg;}
+    std::shared_ptr<frozen_graph_t> get_frozen_graph_ptr() {return _fg;}
     vertex_index_map_t get_vertex_index()   {return _vertex_index;}
     edge_index_map_t   get_edge_index()     {return _edge_index;}
     size_t             get_edge_index_range() {return _mg->get_edge_index_range();}
 
     graph_index_map_t  get_graph_index()  {return graph_index_map_t(0);}
 
-    // Gets the encapsulated graph view. See graph_filtering.cc for details
-    boost::any get_graph_view() const;
+    // Gets the encapsulated graph view. See graph_filtering.cc for details. If
+    // frozen is true, and the graph is frozen, the view is built on top of the
+    // frozen snapshot.
+    boost::any get_graph_view(bool frozen = false) const;
     std::vector<boost::any>& get_graph_views() {return _graph_views;}
 
 private:
@@ -158,9 +215,19 @@ private:
     template <class Action, class GraphViews, class Wrap, class... TRS>
     friend struct detail::graph_action;
 
+    void get_view_lists(std::vector<int64_t>& vorder,
+                        std::vector<int64_t>& eorder,
+                        std::vector<std::pair<size_t, size_t>>& elist);
+
+    void sync_filter_bits();
+
     // this is the main graph
     std::shared_ptr<multigraph_t> _mg;
 
+    // read-only snapshot of the main graph, which replaces it in the graph
+    // views while it exists
+    std::shared_ptr<frozen_graph_t> _fg;
+
     // vertex index map
     vertex_index_map_t _vertex_index;
 
@@ -190,6 +257,20 @@ private:
     edge_filter_t _edge_filter_map;
     bool _edge_filter_invert;
     bool _edge_filter_active;
+
+    // packed copies of the filter masks. See graph_filter_bits.hh for details.
+    filter_bits _vertex_filter_bits;
+    filter_bits _edge_filter_bits;
+
+    // number of filtered edges, and the state of the graph and of the filters
+    // for which it was counted
+    std::array<size_t, 7> _num_edges_key;
+    size_t _num_edges;
+
+    // cached compact copy of a selective filtered view, and the largest
+    // fraction of remaining vertices for which it is used
+    std::shared_ptr<materialized_view> _materialized;
+    double _materialize_threshold;
 };
 
 // convenience metafunctions to get property map types
@@ -218,6 +299,53 @@ struct gprop_map_t
         type;
 };
 
+// Releases the GIL while in scope, so that other python threads can run during
+// a long computation. Nothing is done if release is false, or if the GIL is not
+// held by the current thread. While the GIL is released, no python object can
+// be created, copied or destroyed, unless it is re-acquired with GILAcquire.
+class GILRelease
+{
+public:
+    GILRelease(bool release = true)
+    {
+        if (release && PyGILState_Check())
+            _state = PyEval_SaveThread();
+    }
+
+    ~GILRelease() { restore(); }
+
+    void restore()
+    {
+        if (_state != nullptr)
+        {
+            PyEval_RestoreThread(_state);
+            _state = nullptr;
+        }
+    }
+
+    GILRelease(const GILRelease&) = delete;
+    GILRelease& operator=(const GILRelease&) = delete;
+
+private:
+    PyThreadState* _state = nullptr;
+};
+
+// Acquires the GIL while in scope, e.g. to call back into python from within a
+// computation during which it was released. It can be nested, and it is a
+// no-op if the GIL is already held.
+class GILAcquire
+{
+public:
+    GILAcquire() : _state(PyGILState_Ensure()) {}
+    ~GILAcquire() { PyGILState_Release(_state); }
+
+    GILAcquire(const GILAcquire&) = delete;
+    GILAcquire& operator=(const GILAcquire&) = delete;
+
+private:
+    PyGILState_STATE _state;
+};
+
 
 } //namespace graph_tool
 
@@ -22,9 +22,12 @@
 #include <deque>
 #include <utility>
 #include <numeric>
+#include <algorithm>
 #include <iostream>
 #include <tuple>
 #include <functional>
+#include <memory>
+#include <chrono>
 #include <boost/iterator.hpp>
 #include <boost/graph/graph_traits.hpp>
 #include <boost/range/irange.hpp>
@@ -34,6 +37,9 @@
 #include <boost/iterator/iterator_facade.hpp>
 
 #include "transform_iterator.hh"
+#include "graph_exceptions.hh"
+#include "graph_adjacency_pool.hh"
+#include "graph_adjacency_hash.hh"
 
 namespace boost
 {
@@ -165,6 +171,21 @@ void remove_edge(const typename adj_list<Vertex>::edge_descriptor& e,
 // template parameter. It achieves about half as much memory as
 // boost::adjacency_list with an edge index property map and the same integer
 // type.
+//
+// If GRAPH_COMPACT_INDEX is defined (i.e. graph-tool is configured with
+// --enable-compact-index), the integers stored in the edge lists are 32-bit
+// wide, independently of the Vertex type, which halves the memory used by the
+// adjacency, and so are the values of the edge index property map. The
+// descriptors (and hence all property maps) are unaffected, but the number of
+// vertices and the edge index range are limited to 2^32 - 1.
+//
+// Optionally, the edge lists can be allocated from a slab pool owned by the
+// graph (see set_edge_pool() and graph_adjacency_pool.hh), which avoids the
+// heap fragmentation caused by the many small reallocations during
+// construction.
+//
+// Copies of the graph share the edge lists, which are only copied once one of
+// the copies is modified.
 
 // The complexity guarantees and iterator invalidation rules are the same as
 // boost::adjacency_list with vector storage selectors for both vertex and edge
@@ -172,6 +193,17 @@ void remove_edge(const typename adj_list<Vertex>::edge_descriptor& e,
 
 namespace detail
 {
+template <class Vertex>
+struct adj_stored_index
+{
+#ifdef GRAPH_COMPACT_INDEX
+    typedef typename std::conditional<(sizeof(Vertex) > sizeof(uint32_t)),
+                                      uint32_t, Vertex>::type type;
+#else
+    typedef Vertex type;
+#endif
+};
+
 template <class Vertex>
 struct adj_edge_descriptor
 {
@@ -197,6 +229,50 @@ struct adj_edge_descriptor
 
     Vertex s, t, idx;
 };
+
+// Pointer to a value which is shared between the copies of the pointer, and is
+// copied when it is accessed via a non-const pointer while still shared, i.e.
+// copy-on-write. A moved-from pointer is left empty, such that moves neither
+// allocate nor throw; it behaves as pointing to a default-constructed value,
+// which is only created when it is first accessed via a non-const pointer.
+template <class T>
+class cow_ptr
+{
+public:
+    cow_ptr(): _ptr(std::make_shared<T>()) {}
+    cow_ptr(const cow_ptr&) = default;
+    cow_ptr(cow_ptr&&) noexcept = default;
+
+    cow_ptr& operator=(const cow_ptr&) = default;
+    cow_ptr& operator=(cow_ptr&&) noexcept = default;
+
+    const T* operator->() const
+    {
+        if (_ptr == nullptr)
+            return &get_empty();
+        return _ptr.get();
+    }
+
+    T* operator->()
+    {
+        if (_ptr == nullptr)
+            _ptr = std::make_shared<T>();
+        else if (_ptr.use_count() > 1)
+            _ptr = std::make_shared<T>(*_ptr);
+        return _ptr.get();
+    }
+
+    bool is_shared() const { return _ptr.use_count() > 1; }
+
+private:
+    static const T& get_empty()
+    {
+        static const T empty;
+        return empty;
+    }
+
+    std::shared_ptr<T> _ptr;
+};
 } // namespace detail
 
 template <class Vertex = size_t>
@@ -208,18 +284,57 @@ public:
 
     typedef detail::adj_edge_descriptor<Vertex> edge_descriptor;
 
-    typedef std::vector<std::pair<vertex_t, vertex_t> > edge_list_t;
+    // integer type stored in the edge lists
+    typedef typename detail::adj_stored_index<Vertex>::type index_t;
+    typedef std::pair<index_t, index_t> stored_edge_t;
+
+    typedef detail::adj_edge_allocator<stored_edge_t> edge_allocator_t;
+    typedef std::vector<stored_edge_t, edge_allocator_t> edge_list_t;
     typedef std::vector<std::pair<size_t, edge_list_t>> vertex_list_t;
     typedef typename integer_range<Vertex>::iterator vertex_iterator;
 
-    adj_list(): _n_edges(0), _edge_index_range(0), _keep_epos(false) {}
+    adj_list(): _n_edges(0), _edge_index_range(0), _keep_epos(false),
+                _sorted(false), _stamp(0), _ehash_stamp(0),
+                _ehash_builds(0), _ehash_time(0) {}
+
+    // the edge lists are shared with g, and only copied when either graph is
+    // modified (see adj_data below)
+    adj_list(const adj_list& g)
+        : _d(g._d), _n_edges(g._n_edges),
+          _edge_index_range(g._edge_index_range), _keep_epos(g._keep_epos),
+          _sorted(g._sorted), _stamp(g._stamp), _ehash_stamp(g._ehash_stamp),
+          _ehash_builds(0), _ehash_time(0) {}
+
+    adj_list(adj_list&& g) = default;
+
+    adj_list& operator=(const adj_list& g)
+    {
+        if (this != &g)
+            *this = adj_list(g);
+        return *this;
+    }
+
+    adj_list& operator=(adj_list&& g) noexcept
+    {
+        _d = std::move(g._d);
+        _n_edges = g._n_edges;
+        _edge_index_range = g._edge_index_range;
+        _keep_epos = g._keep_epos;
+        _sorted = g._sorted;
+        bool ehash_synced = g._ehash_stamp == g._stamp;
+        _stamp = std::max(_stamp, g._stamp) + 1;
+        _ehash_stamp = ehash_synced ? _stamp : _stamp - 1;
+        _ehash_builds = g._ehash_builds;
+        _ehash_time = g._ehash_time;
+        return *this;
+    }
 
     struct get_vertex
     {
         get_vertex() {}
         typedef Vertex result_type;
         __attribute__((always_inline))
-        Vertex operator()(const std::pair<vertex_t, vertex_t>& v) const
+        Vertex operator()(const stored_edge_t& v) const
         { return v.first; }
     };
 
@@ -272,12 +387,12 @@ public:
     {
         template <class Iter>
         static edge_descriptor def(vertex_t src,
-                                   const std::pair<vertex_t, vertex_t>& v,
+                                   const stored_edge_t& v,
                                    Iter&&)
         { return edge_descriptor(src, v.first, v.second); }
 
         static edge_descriptor def(vertex_t src,
-                                   const std::pair<vertex_t, vertex_t>& v)
+                                   const stored_edge_t& v)
         { return def(src, v, nullptr); }
     };
 
@@ -285,12 +400,12 @@ public:
     {
         template <class Iter>
         static edge_descriptor def(vertex_t tgt,
-                                   const std::pair<vertex_t, vertex_t>& v,
+                                   const stored_edge_t& v,
                                    Iter&&)
         { return edge_descriptor(v.first, tgt, v.second); }
 
         static edge_descriptor def(vertex_t tgt,
-                                   const std::pair<vertex_t, vertex_t>& v)
+                                   const stored_edge_t& v)
         { return def(tgt, v, nullptr); }
     };
 
@@ -303,7 +418,7 @@ public:
     {
         template <class I>
         static edge_descriptor def(vertex_t u,
-                                   const std::pair<vertex_t, vertex_t>& v,
+                                   const stored_edge_t& v,
                                    const I& i)
         {
             const Iter& iter = reinterpret_cast<const Iter&>(i);
@@ -398,20 +513,21 @@ public:
 
     void reindex_edges()
     {
-        _free_indexes.clear();
+        _stamp++;
+        _d->_free_indexes.clear();
         _edge_index_range = 0;
-        for (auto& es : _edges)
+        for (auto& es : _d->_edges)
             es.second.resize(es.first);
-        for (size_t i = 0; i < _edges.size(); ++i)
+        for (size_t i = 0; i < _d->_edges.size(); ++i)
         {
-            auto pos = _edges[i].first;
-            auto& es = _edges[i].second;
+            auto pos = _d->_edges[i].first;
+            auto& es = _d->_edges[i].second;
             for (size_t j = 0; j < pos; ++j)
             {
                 auto& oe = es[j];
                 Vertex v = oe.first;
                 oe.second = _edge_index_range;
-                _edges[v].second.emplace_back(i, _edge_index_range);
+                _d->_edges[v].second.emplace_back(i, _edge_index_range);
                 _edge_index_range++;
             }
         }
@@ -420,6 +536,291 @@ public:
             rebuild_epos();
     }
 
+    // relabel the vertices such that vertex v becomes vmap[v], which must be a
+    // permutation. The edge indexes and the ordering of the individual edge
+    // lists are preserved (unless they are kept sorted), hence edge properties
+    // (and _epos) remain valid.
+    void permute_vertices(const std::vector<Vertex>& vmap)
+    {
+        _stamp++;
+        size_t N = _d->_edges.size();
+        vertex_list_t edges(N);
+        #pragma omp parallel for schedule(runtime) if (N > OPENMP_MIN_THRESH)
+        for (size_t v = 0; v < N; ++v)
+        {
+            auto& es = edges[vmap[v]];
+            es = std::move(_d->_edges[v]);
+            for (auto& e : es.second)
+                e.first = vmap[e.first];
+        }
+        _d->_edges.swap(edges);
+        if (_sorted)
+            sort_edges();
+    }
+
+    // add n edges at once, where the i-th edge is given by get_edge(i) as a
+    // (source, target) pair of existing vertices. The edges receive the same
+    // indexes, and appear in the out-edge lists in the same order, as if they
+    // were inserted one by one via add_edge(). However, the lists are built
+    // via a counting sort: the degrees are counted, each list is extended only
+    // once, and the edges are scattered directly into their final positions,
+    // all in parallel if parallel == true. The function put_edge(i, e) is
+    // called for each new edge e as it is inserted (concurrently, in the
+    // parallel case). Neither function may throw.
+    template <class GetEdge, class PutEdge>
+    void add_edges(size_t n, GetEdge&& get_edge, PutEdge&& put_edge,
+                   bool parallel = true)
+    {
+        if (n == 0)
+            return;
+        _stamp++;
+
+        size_t N = _d->_edges.size();
+        size_t n_free = std::min(n, _d->_free_indexes.size());
+        if (_edge_index_range + (n - n_free) > max_index())
+            throw_overflow();
+
+        // the indexes are taken first from the free list
+        std::vector<size_t> free_idx(_d->_free_indexes.begin(),
+                                     _d->_free_indexes.begin() + n_free);
+        size_t base = _edge_index_range;
+        auto get_idx = [&](size_t i) -> size_t
+            {
+                return (i < n_free) ? free_idx[i] : base + (i - n_free);
+            };
+
+        std::vector<size_t> k_out(N), k_in(N);
+        #pragma omp parallel for schedule(runtime) \
+            if (parallel && n > OPENMP_MIN_THRESH)
+        for (size_t i = 0; i < n; ++i)
+        {
+            auto e = get_edge(i);
+            #pragma omp atomic
+            k_out[e.first]++;
+            #pragma omp atomic
+            k_in[e.second]++;
+        }
+
+        // open a gap for the new out-edges between the current out- and
+        // in-edges, and set the insertion positions; the pool allocator is not
+        // thread-safe, hence the lists are only resized in parallel from the
+        // heap
+        std::vector<size_t> pos_out(N), pos_in(N);
+        #pragma omp parallel for schedule(runtime) \
+            if (parallel && !_d->_pool && N > OPENMP_MIN_THRESH)
+        for (size_t v = 0; v < N; ++v)
+        {
+            auto& pos = _d->_edges[v].first;
+            auto& es = _d->_edges[v].second;
+            size_t m = es.size();
+            if (k_out[v] + k_in[v] == 0)
+                continue;
+            es.resize(m + k_out[v] + k_in[v]);
+            std::move_backward(es.begin() + pos, es.begin() + m,
+                               es.begin() + m + k_out[v]);
+            pos_out[v] = pos;
+            pos_in[v] = m + k_out[v];
+            pos += k_out[v];
+        }
+
+        // the edges are stored temporarily with their row numbers, so that the
+        // insertion order can be recovered below
+        #pragma omp parallel for schedule(runtime) \
+            if (parallel && n > OPENMP_MIN_THRESH)
+        for (size_t i = 0; i < n; ++i)
+        {
+            auto e = get_edge(i);
+            Vertex s = e.first;
+            Vertex t = e.second;
+            size_t j_out, j_in;
+            #pragma omp atomic capture
+            j_out = pos_out[s]++;
+            #pragma omp atomic capture
+            j_in = pos_in[t]++;
+            _d->_edges[s].second[j_out] = {index_t(t), index_t(i)};
+            _d->_edges[t].second[j_in] = {index_t(s), index_t(i)};
+            put_edge(i, edge_descriptor(s, t, get_idx(i)));
+        }
+
+        #pragma omp parallel for schedule(runtime) \
+            if (parallel && N > OPENMP_MIN_THRESH)
+        for (size_t v = 0; v < N; ++v)
+        {
+            auto& es = _d->_edges[v].second;
+            auto restore = [&](auto begin, auto end)
+                {
+                    if (parallel)
+                        std::sort(begin, end,
+                                  [](const auto& a, const auto& b)
+                                  { return a.second < b.second; });
+                    for (auto iter = begin; iter != end; ++iter)
+                        iter->second = get_idx(iter->second);
+                };
+            restore(es.begin() + (pos_out[v] - k_out[v]),
+                    es.begin() + pos_out[v]);
+            restore(es.end() - k_in[v], es.end());
+            if (_sorted && k_out[v] + k_in[v] > 0)
+                sort_edge_list(v);
+        }
+
+        _d->_free_indexes.erase(_d->_free_indexes.begin(),
+                            _d->_free_indexes.begin() + n_free);
+        _edge_index_range += n - n_free;
+        _n_edges += n;
+
+        if (_keep_epos)
+            rebuild_epos();
+    }
+
+    // remove all vertices v for which removed[v] is true (and their edges) at
+    // once, in O(V + E) time. The remaining vertices keep their relative
+    // order, and the vector returned maps the old vertex indexes to the new
+    // ones, or to null_index() for the removed vertices.
+    std::vector<size_t> remove_vertices(const std::vector<uint8_t>& removed)
+    {
+        prune_edges([&](Vertex v, const stored_edge_t& e)
+                    { return !removed[v] && !removed[e.first]; });
+
+        size_t N = _d->_edges.size();
+        const size_t null = null_index();
+        std::vector<size_t> vmap(N);
+        size_t M = 0;
+        for (size_t v = 0; v < N; ++v)
+            vmap[v] = removed[v] ? null : M++;
+
+        vertex_list_t edges(M);
+        #pragma omp parallel for schedule(runtime) if (N > OPENMP_MIN_THRESH)
+        for (size_t v = 0; v < N; ++v)
+        {
+            if (removed[v])
+                continue;
+            auto& es = edges[vmap[v]];
+            es = std::move(_d->_edges[v]);
+            for (auto& e : es.second)
+                e.first = vmap[e.first];
+        }
+        _d->_edges.swap(edges);
+        return vmap;
+    }
+
+    // remove all edges with index idx for which removed[idx] is true at once,
+    // in O(V + E) time. The order of the remaining edges is unchanged.
+    void remove_edges(const std::vector<uint8_t>& removed)
+    {
+        prune_edges([&](Vertex, const stored_edge_t& e)
+                    { return !removed[e.second]; });
+    }
+
+    // relabel the edge indexes such that they lie contiguously in the range
+    // [0, E-1], while preserving their relative order, and empty the free
+    // index list. The vector returned maps the old indexes to the new ones, or
+    // to null_index() for unused indexes.
+    std::vector<size_t> compact_edge_indexes()
+    {
+        const size_t null = null_index();
+        std::vector<size_t> emap(_edge_index_range, null);
+        for (auto& pes : _d->_edges)
+        {
+            for (size_t j = 0; j < pes.first; ++j)
+            {
+                size_t idx = pes.second[j].second;
+                if (idx >= _edge_index_range)
+                    throw graph_tool::ValueException("invalid edge index: " +
+                                                     std::to_string(idx));
+                emap[idx] = 0;
+            }
+        }
+        _stamp++;
+        size_t E = 0;
+        for (auto& idx : emap)
+        {
+            if (idx != null)
+                idx = E++;
+        }
+
+        size_t N = _d->_edges.size();
+        #pragma omp parallel for schedule(runtime) if (N > OPENMP_MIN_THRESH)
+        for (size_t v = 0; v < N; ++v)
+        {
+            for (auto& e : _d->_edges[v].second)
+                e.second = emap[e.second];
+        }
+
+        _d->_free_indexes.clear();
+        _edge_index_range = E;
+        if (_keep_epos)
+            rebuild_epos();
+        return emap;
+    }
+
+    // allocate all edge lists from a slab pool owned by the graph if pool ==
+    // true, otherwise from the heap. In either case, the lists are copied with
+    // their exact sizes, and any previous pool is released at once.
+    void set_edge_pool(bool pool)
+    {
+        _d->set_edge_pool(pool);
+    }
+
+    bool get_edge_pool() const { return bool(_d->_pool); }
+
+    // whether the edge lists are shared with a copy of the graph (see
+    // adj_data below)
+    bool is_shared() const { return _d.is_shared(); }
+
+    edge_allocator_t get_edge_allocator() const
+    {
+        return edge_allocator_t(_d->_pool.get());
+    }
+
+    const detail::adj_edge_pool* get_edge_pool_ptr() const
+    {
+        return _d->_pool.get();
+    }
+
+    // total number of allocated entries in all edge lists
+    size_t get_edge_capacity() const
+    {
+        size_t c = 0;
+        for (auto& pes : _d->_edges)
+            c += pes.second.capacity();
+        return c;
+    }
+
+    // calls f(name, size, capacity) for each internal data structure, with the
+    // number of bytes used and allocated. If the edge pool is enabled, the
+    // allocated memory of the edge lists is the one reserved by the pool.
+    template <class F>
+    void visit_memory(F&& f) const
+    {
+        typedef typename vertex_list_t::value_type vertex_entry_t;
+        f("vertex_list", _d->_edges.size() * sizeof(vertex_entry_t),
+          _d->_edges.capacity() * sizeof(vertex_entry_t));
+
+        size_t size = 0;
+        for (auto& pes : _d->_edges)
+            size += pes.second.size();
+        size_t capacity = get_edge_capacity() * sizeof(stored_edge_t);
+        if (_d->_pool)
+        {
+            auto& pstats = _d->_pool->get_stats();
+            capacity = pstats.slab_bytes + pstats.large_bytes;
+        }
+        f("edge_lists", size * sizeof(stored_edge_t), capacity);
+
+        typedef typename decltype(_d->_epos)::value_type epos_entry_t;
+        f("edge_positions", _d->_epos.size() * sizeof(epos_entry_t),
+          _d->_epos.capacity() * sizeof(epos_entry_t));
+
+        // std::deque allocates fixed-size blocks, so its capacity is estimated
+        size_t block = std::max(size_t(512), sizeof(size_t));
+        size_t fsize = _d->_free_indexes.size() * sizeof(size_t);
+        f("free_indexes", fsize, ((fsize + block - 1) / block) * block);
+
+        if (_d->_ehash)
+            f("edge_hash", _d->_ehash->memory_size(),
+              _d->_ehash->memory_capacity());
+    }
+
     void set_keep_epos(bool keep)
     {
         if (keep)
@@ -429,7 +830,7 @@ public:
         }
         else
         {
-            _epos.clear();
+            _d->_epos.clear();
         }
         _keep_epos = keep;
     }
@@ -439,15 +840,109 @@ public:
         return _keep_epos;
     }
 
+    // if sorted == true, the out- and in-edge lists of every vertex are sorted
+    // (and henceforth kept sorted) by neighbor, and then by edge index. This
+    // makes edge() O(log k) instead of O(k), and allows neighborhoods to be
+    // intersected by merging (see graph_neighbor_intersection.hh), at the cost
+    // of making insertions (and removals with set_keep_epos(true)) O(k).
+    void set_sorted(bool sorted)
+    {
+        if (sorted && !_sorted)
+            sort_edges();
+        _sorted = sorted;
+    }
+
+    bool get_sorted() const
+    {
+        return _sorted;
+    }
+
+    // if enabled, an index of all edges keyed by (source, target) is kept (see
+    // graph_adjacency_hash.hh), which makes edge() O(1). The index is updated
+    // by add_edge(), remove_edge() and add_vertex(); any other modification
+    // leaves it out of date, and it is then rebuilt by the next call to
+    // sync_edge_hash(). While out of date, edge() ignores it.
+    void set_edge_hash(bool ehash)
+    {
+        if (ehash && !_d->_ehash)
+        {
+            _d->_ehash.reset(new detail::adj_edge_hash<Vertex>());
+            rebuild_edge_hash();
+        }
+        else if (!ehash)
+        {
+            _d->_ehash.reset();
+        }
+    }
+
+    bool get_edge_hash() const
+    {
+        return bool(_d->_ehash);
+    }
+
+    // rebuilds the edge index if it is out of date; this should be called
+    // before edge() is used concurrently from several threads
+    void sync_edge_hash()
+    {
+        if (_d->_ehash && _ehash_stamp != _stamp)
+            rebuild_edge_hash();
+    }
+
+    bool is_edge_hash_synced() const
+    {
+        return _d->_ehash && _ehash_stamp == _stamp;
+    }
+
+    const detail::adj_edge_hash<Vertex>* get_edge_hash_ptr() const
+    {
+        return _d->_ehash.get();
+    }
+
+    // number of times the edge index was (re)built, and the time spent on the
+    // last build, in seconds
+    size_t get_edge_hash_builds() const { return _ehash_builds; }
+    double get_edge_hash_time() const { return _ehash_time; }
+
+    // counter which changes whenever vertices or edges are added or removed,
+    // or relabeled, which can be used to invalidate derived data
+    size_t get_stamp() const
+    {
+        return _stamp;
+    }
+
     size_t get_edge_index_range() const { return _edge_index_range; }
 
     static Vertex null_vertex() { return std::numeric_limits<Vertex>::max(); }
 
+    // largest number of vertices, or edge index range, which can be stored
+    static size_t max_index()
+    {
+        return std::min(size_t(std::numeric_limits<index_t>::max()),
+                        size_t(std::numeric_limits<Vertex>::max()));
+    }
+
+    // marks removed or unused entries in the index mappings returned by
+    // remove_vertices() and compact_edge_indexes()
+    static constexpr size_t null_index()
+    {
+        return std::numeric_limits<size_t>::max();
+    }
+
+    static void throw_overflow()
+    {
+        throw graph_tool::GraphException("Maximum number of vertices or edges "
+                                         "exceeded for the compact index "
+                                         "storage (2^32 - 1).");
+    }
+
     void shrink_to_fit()
     {
-        _edges.shrink_to_fit();
-        std::for_each(_edges.begin(), _edges.end(),
-                      [](auto &es){es.second.shrink_to_fit();});
+        _d->_edges.shrink_to_fit();
+        if (_d->_pool)
+            set_edge_pool(true); // compact into a new pool, release the old
+        else
+            std::for_each(_d->_edges.begin(), _d->_edges.end(),
+                          [](auto &es){es.second.shrink_to_fit();});
         auto erange = boost::edges(*this);
         auto iter = std::max_element(erange.first, erange.second,
                                      [](const auto &a, const auto& b) -> bool
@@ -456,26 +951,26 @@ public:
             _edge_index_range = 0;
         else
             _edge_index_range = iter->idx + 1;
-        auto iter_idx = std::remove_if(_free_indexes.begin(),
-                                       _free_indexes.end(),
+        auto iter_idx = std::remove_if(_d->_free_indexes.begin(),
+                                       _d->_free_indexes.end(),
                                        [&](auto idx) -> bool
                                        {return idx >= _edge_index_range;});
-        _free_indexes.erase(iter_idx, _free_indexes.end());
-        _free_indexes.shrink_to_fit();
+        _d->_free_indexes.erase(iter_idx, _d->_free_indexes.end());
+        _d->_free_indexes.shrink_to_fit();
         if (_keep_epos)
-            _epos.resize(_edge_index_range);
-        _epos.shrink_to_fit();
+            _d->_epos.resize(_edge_index_range);
+        _d->_epos.shrink_to_fit();
     }
 
     __attribute__((always_inline))
     void reverse_edge(edge_descriptor& e) const
     {
-        auto& elist = _edges[e.s];
+        auto& elist = _d->_edges[e.s];
         auto pos = elist.first;
         auto& es = elist.second;
         if (_keep_epos)
         {
-            auto& epos = _epos[e.idx];
+            auto& epos = _d->_epos[e.idx];
             if (epos.first >= pos || es[epos.first].second != e.idx)
                 std::swap(e.s, e.t);
         }
@@ -496,20 +991,186 @@ public:
     }
 
 private:
-    vertex_list_t _edges;
+    // The edge lists, and the data structures derived from them, are shared
+    // between copies of the graph, and are copied only before one of the
+    // copies is modified. This is done by non-const accesses via _d (see
+    // detail::cow_ptr), which all happen in the member functions and friends
+    // which modify the graph.
+    struct adj_data
+    {
+        adj_data() {}
+
+        adj_data(const adj_data& d)
+            : _free_indexes(d._free_indexes), _epos(d._epos)
+        {
+            // the lists are copied directly into a pool of our own if the
+            // original ones are in a pool, and to the heap otherwise
+            if (d._pool)
+                _pool.reset(new detail::adj_edge_pool());
+            edge_allocator_t alloc(_pool.get());
+            _edges.reserve(d._edges.size());
+            for (auto& pes : d._edges)
+                _edges.emplace_back(pes.first,
+                                    edge_list_t(pes.second.begin(),
+                                                pes.second.end(), alloc));
+            if (d._ehash)
+                _ehash.reset(new detail::adj_edge_hash<Vertex>(*d._ehash));
+        }
+
+        void set_edge_pool(bool pool)
+        {
+            std::unique_ptr<detail::adj_edge_pool> npool;
+            if (pool)
+                npool.reset(new detail::adj_edge_pool());
+            edge_allocator_t alloc(npool.get());
+            for (auto& pes : _edges)
+            {
+                auto& es = pes.second;
+                es = edge_list_t(es.begin(), es.end(), alloc);
+            }
+            _pool = std::move(npool);
+        }
+
+        // the pool must outlive the edge lists, hence it is declared first
+        std::unique_ptr<detail::adj_edge_pool> _pool;
+        vertex_list_t _edges;
+        std::deque<size_t> _free_indexes; // indexes of deleted edges to be
+                                          // used up for new edges to avoid
+                                          // very large indexes, and
+                                          // unnecessary property map memory
+                                          // use
+        std::vector<std::pair<uint32_t, uint32_t>> _epos; // out, in
+        std::unique_ptr<detail::adj_edge_hash<Vertex>> _ehash;
+    };
+
+    detail::cow_ptr<adj_data> _d;
     size_t _n_edges;
     size_t _edge_index_range;
-    std::deque<size_t> _free_indexes; // indexes of deleted edges to be used up
-                                      // for new edges to avoid very large
-                                      // indexes, and unnecessary property map
-                                      // memory use
     bool _keep_epos;
-    std::vector<std::pair<uint32_t, uint32_t>> _epos; // out, in
+    bool _sorted;
+    size_t _stamp; // incremented at every modification
+    size_t _ehash_stamp; // value of _stamp for which _ehash is up to date
+    size_t _ehash_builds;
+    double _ehash_time;
+
+    void rebuild_edge_hash()
+    {
+        auto start = std::chrono::steady_clock::now();
+        _d->_ehash->clear();
+        _d->_ehash->reserve(_n_edges);
+        for (size_t v = 0; v < _d->_edges.size(); ++v)
+        {
+            auto& pes = _d->_edges[v];
+            auto& es = pes.second;
+            for (size_t i = 0; i < pes.first; ++i)
+                _d->_ehash->insert(v, es[i].first, es[i].second);
+        }
+        _ehash_stamp = _stamp;
+        _ehash_builds++;
+        std::chrono::duration<double> dt =
+            std::chrono::steady_clock::now() - start;
+        _ehash_time = dt.count();
+    }
+
+    void sort_edge_list(size_t v)
+    {
+        auto pos = _d->_edges[v].first;
+        auto& es = _d->_edges[v].second;
+        std::sort(es.begin(), es.begin() + pos);
+        std::sort(es.begin() + pos, es.end());
+    }
+
+    void sort_edges()
+    {
+        // the edge order changes, but not the edges themselves
+        bool ehash_synced = _ehash_stamp == _stamp;
+        _stamp++;
+        if (ehash_synced)
+            _ehash_stamp = _stamp;
+        size_t N = _d->_edges.size();
+        #pragma omp parallel for schedule(runtime) if (N > OPENMP_MIN_THRESH)
+        for (size_t v = 0; v < N; ++v)
+            sort_edge_list(v);
+        if (_keep_epos)
+            rebuild_epos();
+    }
+
+    // update the positions in _epos of the entries of the edge list of v,
+    // starting from position j
+    void update_epos(size_t v, size_t j = 0)
+    {
+        auto pos = _d->_edges[v].first;
+        auto& es = _d->_edges[v].second;
+        for (; j < es.size(); ++j)
+        {
+            if (j < pos)
+                _d->_epos[es[j].second].first = j;
+            else
+                _d->_epos[es[j].second].second = j;
+        }
+    }
+
+    // remove, in parallel, all the entries e of the edge lists of every vertex
+    // v for which keep(v, e) is false, preserving the order of the remaining
+    // ones. The predicate must give the same answer for both entries of the
+    // same edge. The indexes of the removed edges are put in the free list,
+    // in the order of their source vertices.
+    template <class Keep>
+    void prune_edges(Keep&& keep)
+    {
+        _stamp++;
+        size_t N = _d->_edges.size();
+        std::vector<size_t> n_removed(N + 1);
+        #pragma omp parallel for schedule(runtime) if (N > OPENMP_MIN_THRESH)
+        for (size_t v = 0; v < N; ++v)
+        {
+            auto& pes = _d->_edges[v];
+            for (size_t j = 0; j < pes.first; ++j)
+            {
+                if (!keep(v, pes.second[j]))
+                    n_removed[v + 1]++;
+            }
+        }
+        for (size_t v = 0; v < N; ++v)
+            n_removed[v + 1] += n_removed[v];
+
+        std::vector<size_t> removed(n_removed[N]);
+        #pragma omp parallel for schedule(runtime) if (N > OPENMP_MIN_THRESH)
+        for (size_t v = 0; v < N; ++v)
+        {
+            auto& pos = _d->_edges[v].first;
+            auto& es = _d->_edges[v].second;
+            size_t r = n_removed[v];
+            size_t k = 0;
+            for (size_t j = 0; j < pos; ++j)
+            {
+                if (keep(v, es[j]))
+                    es[k++] = es[j];
+                else
+                    removed[r++] = es[j].second;
+            }
+            size_t npos = k;
+            for (size_t j = pos; j < es.size(); ++j)
+            {
+                if (keep(v, es[j]))
+                    es[k++] = es[j];
+            }
+            pos = npos;
+            es.resize(k); // only shrinks, hence does not allocate
+        }
+
+        _d->_free_indexes.insert(_d->_free_indexes.end(), removed.begin(),
+                             removed.end());
+        _n_edges -= removed.size();
+
+        if (_keep_epos)
+            rebuild_epos();
+    }
 
     void rebuild_epos()
     {
-        _epos.resize(_edge_index_range);
-        for (auto& pes : _edges)
+        _d->_epos.resize(_edge_index_range);
+        for (auto& pes : _d->_edges)
         {
             auto pos = pes.first;
             auto& es = pes.second;
@@ -517,9 +1178,9 @@ private:
             {
                 size_t idx = es[j].second;
                 if (j < pos)
-                    _epos[idx].first = j;
+                    _d->_epos[idx].first = j;
                 else
-                    _epos[idx].second = j;
+                    _d->_epos[idx].second = j;
             }
         }
         //check_epos();
@@ -528,17 +1189,17 @@ private:
     void check_epos()
     {
 #ifndef NDEBUG
-        for (auto& pes : _edges)
+        for (auto& pes : _d->_edges)
         {
             auto pos = pes.first;
             auto& es = pes.second;
             for (size_t j = 0; j < es.size(); ++j)
             {
-                assert(es[j].second < _epos.size());
+                assert(es[j].second < _d->_epos.size());
                 if (j < pos)
-                    assert(_epos[es[j].second].first == j);
+                    assert(_d->_epos[es[j].second].first == j);
                 else
-                    assert(_epos[es[j].second].second == j);
+                    assert(_d->_epos[es[j].second].second == j);
             }
         }
 #endif
@@ -691,7 +1352,7 @@ std::pair<typename adj_list<Vertex>::vertex_iterator,
 vertices(const adj_list<Vertex>& g)
 {
     typedef typename adj_list<Vertex>::vertex_iterator vi_t;
-    return {vi_t(0), vi_t(g._edges.size())};
+    return {vi_t(0), vi_t(g._d->_edges.size())};
 }
 
 
@@ -705,22 +1366,22 @@ edges(const adj_list<Vertex>& g)
     typedef typename adj_list<Vertex>::vertex_list_t::const_iterator vi_t;
     ei_t ei_begin, ei_end;
     vi_t last_vi;
-    if (g._edges.empty())
+    if (g._d->_edges.empty())
     {
-        last_vi = g._edges.end();
+        last_vi = g._d->_edges.end();
     }
     else
     {
-        ei_begin = g._edges[0].second.begin();
-        last_vi = g._edges.end() - 1;
+        ei_begin = g._d->_edges[0].second.begin();
+        last_vi = g._d->_edges.end() - 1;
         ei_end = last_vi->second.begin() + last_vi->first;
     }
-    typename adj_list<Vertex>::edge_iterator ebegin(g._edges.begin(),
-                                                    g._edges.end(),
-                                                    g._edges.begin(),
+    typename adj_list<Vertex>::edge_iterator ebegin(g._d->_edges.begin(),
+                                                    g._d->_edges.end(),
+                                                    g._d->_edges.begin(),
                                                     ei_begin);
-    typename adj_list<Vertex>::edge_iterator eend(g._edges.begin(),
-                                                  g._edges.end(),
+    typename adj_list<Vertex>::edge_iterator eend(g._d->_edges.begin(),
+                                                  g._d->_edges.end(),
                                                   last_vi,
                                                   ei_end);
     return {ebegin, eend};
@@ -739,12 +1400,31 @@ std::pair<typename adj_list<Vertex>::edge_descriptor, bool>
 edge(Vertex s, Vertex t, const adj_list<Vertex>& g)
 {
     typedef typename adj_list<Vertex>::edge_descriptor edge_descriptor;
-    const auto& pes = g._edges[s];
+    const auto& pes = g._d->_edges[s];
     auto pos = pes.first;
     const auto& es = pes.second;
     auto end = es.begin() + pos;
-    auto iter = std::find_if(es.begin(), end,
-                             [&](const auto& e) -> bool {return e.first == t;});
+    typename adj_list<Vertex>::edge_list_t::const_iterator iter;
+    if (g.is_edge_hash_synced())
+    {
+        auto idx = g._d->_ehash->find(s, t);
+        if (idx != detail::adj_edge_hash<Vertex>::null)
+            return {edge_descriptor(s, t, idx), true};
+        return {edge_descriptor(), false};
+    }
+    if (g._sorted)
+    {
+        iter = std::lower_bound(es.begin(), end, t,
+                                [](const auto& e, Vertex u) -> bool
+                                {return e.first < u;});
+        if (iter != end && iter->first != t)
+            iter = end;
+    }
+    else
+    {
+        iter = std::find_if(es.begin(), end,
+                            [&](const auto& e) -> bool {return e.first == t;});
+    }
     if (iter != end)
         return {edge_descriptor(s, t, iter->second), true};
     return {edge_descriptor(), false};
@@ -754,7 +1434,7 @@ template <class Vertex>
 inline __attribute__((always_inline))
 size_t out_degree(Vertex v, const adj_list<Vertex>& g)
 {
-    const auto& pes = g._edges[v];
+    const auto& pes = g._d->_edges[v];
     return pes.first;
 }
 
@@ -762,7 +1442,7 @@ template <class Vertex>
 inline __attribute__((always_inline))
 size_t in_degree(Vertex v, const adj_list<Vertex>& g)
 {
-    const auto& pes = g._edges[v];
+    const auto& pes = g._d->_edges[v];
     auto pos = pes.first;
     auto& es = pes.second;
     return es.size() - pos;
@@ -772,7 +1452,7 @@ template <class Vertex>
 inline __attribute__((always_inline))
 size_t degree(Vertex v, const adj_list<Vertex>& g)
 {
-    return g._edges[v].second.size();
+    return g._d->_edges[v].second.size();
 }
 
 template <class Vertex>
@@ -782,7 +1462,7 @@ std::pair<typename adj_list<Vertex>::out_edge_iterator,
 out_edges(Vertex v, const adj_list<Vertex>& g)
 {
     typedef typename adj_list<Vertex>::out_edge_iterator ei_t;
-    const auto& pes = g._edges[v];
+    const auto& pes = g._d->_edges[v];
     auto pos = pes.first;
     auto& es = pes.second;
     return {ei_t(v, es.begin()), ei_t(v, es.begin() + pos)};
@@ -795,7 +1475,7 @@ std::pair<typename adj_list<Vertex>::in_edge_iterator,
 in_edges(Vertex v, const adj_list<Vertex>& g)
 {
     typedef typename adj_list<Vertex>::in_edge_iterator ei_t;
-    const auto& pes = g._edges[v];
+    const auto& pes = g._d->_edges[v];
     auto pos = pes.first;
     auto& es = pes.second;
     return {ei_t(v, es.begin() + pos), ei_t(v, es.end())};
@@ -808,7 +1488,7 @@ std::pair<typename adj_list<Vertex>::out_edge_iterator,
 _all_edges_out(Vertex v, const adj_list<Vertex>& g)
 {
     typedef typename adj_list<Vertex>::out_edge_iterator ei_t;
-    const auto& pes = g._edges[v];
+    const auto& pes = g._d->_edges[v];
     auto& es = pes.second;
     return {ei_t(v, es.begin()), ei_t(v, es.end())};
 }
@@ -820,7 +1500,7 @@ std::pair<typename adj_list<Vertex>::in_edge_iterator,
 _all_edges_in(Vertex v, const adj_list<Vertex>& g)
 {
     typedef typename adj_list<Vertex>::in_edge_iterator ei_t;
-    const auto& pes = g._edges[v];
+    const auto& pes = g._d->_edges[v];
     auto& es = pes.second;
     return {ei_t(v, es.begin()), ei_t(v, es.end())};
 }
@@ -832,7 +1512,7 @@ std::pair<typename adj_list<Vertex>::all_edge_iterator,
 all_edges(Vertex v, const adj_list<Vertex>& g)
 {
     typedef typename adj_list<Vertex>::all_edge_iterator ei_t;
-    const auto& pes = g._edges[v];
+    const auto& pes = g._d->_edges[v];
     auto& es = pes.second;
     auto pos = es.begin() + pes.first;
     return {ei_t(v, es.begin(), pos), ei_t(v, es.end(), pos)};
@@ -845,7 +1525,7 @@ std::pair<typename adj_list<Vertex>::all_edge_iterator_reversed,
 _all_edges_reversed(Vertex v, const adj_list<Vertex>& g)
 {
     typedef typename adj_list<Vertex>::all_edge_iterator_reversed ei_t;
-    const auto& pes = g._edges[v];
+    const auto& pes = g._d->_edges[v];
     auto& es = pes.second;
     auto pos = es.begin() + pes.first;
     return {ei_t(v, es.begin(), pos), ei_t(v, es.end(), pos)};
@@ -858,7 +1538,7 @@ std::pair<typename adj_list<Vertex>::adjacency_iterator,
 out_neighbors(Vertex v, const adj_list<Vertex>& g)
 {
     typedef typename adj_list<Vertex>::adjacency_iterator ai_t;
-    const auto& pes = g._edges[v];
+    const auto& pes = g._d->_edges[v];
     auto pos = pes.first;
     auto& es = pes.second;
     return {ai_t(es.begin()), ai_t(es.begin() + pos)};
@@ -871,7 +1551,7 @@ std::pair<typename adj_list<Vertex>::adjacency_iterator,
 in_neighbors(Vertex v, const adj_list<Vertex>& g)
 {
     typedef typename adj_list<Vertex>::adjacency_iterator ai_t;
-    const auto& pes = g._edges[v];
+    const auto& pes = g._d->_edges[v];
     auto pos = pes.first;
     auto& es = pes.second;
     return {ai_t(es.begin() + pos), ai_t(es.end())};
@@ -884,7 +1564,7 @@ std::pair<typename adj_list<Vertex>::adjacency_iterator,
 all_neighbors(Vertex v, const adj_list<Vertex>& g)
 {
     typedef typename adj_list<Vertex>::adjacency_iterator ai_t;
-    const auto& pes = g._edges[v];
+    const auto& pes = g._d->_edges[v];
     auto& es = pes.second;
     return {ai_t(es.begin()), ai_t(es.end())};
 }
@@ -903,7 +1583,7 @@ template <class Vertex>
 inline __attribute__((always_inline))
 size_t num_vertices(const adj_list<Vertex>& g)
 {
-    return g._edges.size();
+    return g._d->_edges.size();
 }
 
 template <class Vertex>
@@ -918,20 +1598,66 @@ template <class Vertex>
 typename std::pair<typename adj_list<Vertex>::edge_descriptor, bool>
 add_edge(Vertex s, Vertex t, adj_list<Vertex>& g)
 {
+    g._stamp++;
+
     // get index from free list, if available
     Vertex idx;
-    if (g._free_indexes.empty())
+    if (g._d->_free_indexes.empty())
     {
+        if (g._edge_index_range >= adj_list<Vertex>::max_index())
+            adj_list<Vertex>::throw_overflow();
         idx = g._edge_index_range++;
     }
     else
     {
-        idx = g._free_indexes.front();
-        g._free_indexes.pop_front();
+        idx = g._d->_free_indexes.front();
+        g._d->_free_indexes.pop_front();
+    }
+
+    if (g._d->_ehash && g._ehash_stamp + 1 == g._stamp)
+    {
+        g._d->_ehash->insert(s, t, idx);
+        g._ehash_stamp = g._stamp;
+    }
+
+    typedef typename adj_list<Vertex>::edge_descriptor edge_descriptor;
+    typedef typename adj_list<Vertex>::index_t index_t;
+
+    if (g._sorted)
+    {
+        // insert the entries in their sorted positions: O(k_s + k_t)
+        auto& s_pes = g._d->_edges[s];
+        auto& s_es = s_pes.second;
+        typename adj_list<Vertex>::stored_edge_t oe{index_t(t), index_t(idx)};
+        auto s_iter = std::upper_bound(s_es.begin(), s_es.begin() + s_pes.first,
+                                       oe);
+        size_t j_out = s_iter - s_es.begin();
+        s_es.insert(s_iter, oe);
+        s_pes.first++;
+
+        auto& t_pes = g._d->_edges[t];
+        auto& t_es = t_pes.second;
+        typename adj_list<Vertex>::stored_edge_t ie{index_t(s), index_t(idx)};
+        auto t_iter = std::upper_bound(t_es.begin() + t_pes.first, t_es.end(),
+                                       ie);
+        size_t j_in = t_iter - t_es.begin();
+        t_es.insert(t_iter, ie);
+
+        g._n_edges++;
+
+        if (g._keep_epos)
+        {
+            if (idx >= g._d->_epos.size())
+                g._d->_epos.resize(idx + 1);
+            g.update_epos(s, j_out);
+            if (t != s)
+                g.update_epos(t, j_in);
+        }
+        return {edge_descriptor(s, t, idx), true};
     }
 
     // put target on back of source's out-list (middle of total list)
-    auto& s_pes = g._edges[s];
+    auto& s_pes = g._d->_edges[s];
     auto& s_pos = s_pes.first;
     auto& s_es = s_pes.second;
 
@@ -941,7 +1667,7 @@ add_edge(Vertex s, Vertex t, adj_list<Vertex>& g)
         s_es.push_back(s_es[s_pos]);
         s_es[s_pos] = {t, idx};
         if (g._keep_epos)
-            g._epos[s_es.back().second].second = s_es.size() - 1;
+            g._d->_epos[s_es.back().second].second = s_es.size() - 1;
     }
     else
     {
@@ -950,25 +1676,24 @@ add_edge(Vertex s, Vertex t, adj_list<Vertex>& g)
     s_pos++;
 
     // put source on back of target's in-list
-    auto& t_es = g._edges[t].second;
+    auto& t_es = g._d->_edges[t].second;
     t_es.emplace_back(s, idx);
 
     g._n_edges++;
 
     if (g._keep_epos)
     {
-        if (idx >= g._epos.size())
-            g._epos.resize(idx + 1);
-        auto& ei = g._epos[idx];
+        if (idx >= g._d->_epos.size())
+            g._d->_epos.resize(idx + 1);
+        auto& ei = g._d->_epos[idx];
         ei.first = s_pos - 1;         // out
         ei.second = t_es.size() - 1;  // in
 
-        assert(g._edges[s].second[ei.first].first == t);
-        assert(g._edges[t].second[ei.second].first == s);
+        assert(g._d->_edges[s].second[ei.first].first == t);
+        assert(g._d->_edges[t].second[ei.second].first == s);
         //g.check_epos();
     }
 
-    typedef typename adj_list<Vertex>::edge_descriptor edge_descriptor;
     return {edge_descriptor(s, t, idx), true};
 }
 
@@ -982,25 +1707,34 @@ template <class Vertex>
 void remove_edge(const typename adj_list<Vertex>::edge_descriptor& e,
                  adj_list<Vertex>& g)
 {
+    g._stamp++;
+
     auto s = e.s;
     auto t = e.t;
     auto idx = e.idx;
-    auto& s_pes = g._edges[s];
+    auto& s_pes = g._d->_edges[s];
     auto& s_pos = s_pes.first;
     auto& s_es  = s_pes.second;
-    auto& t_pes = g._edges[t];
+    auto& t_pes = g._d->_edges[t];
     auto& t_pos = t_pes.first;
     auto& t_es  = t_pes.second;
 
-    if (!g._keep_epos) // O(k_s + k_t)
+    if (!g._keep_epos || g._sorted) // O(k_s + k_t)
     {
-        // remove and shift
+        // remove and shift (which preserves the ordering)
         auto remove_e = [&] (auto& elist, auto&& begin, auto&& end, auto v)
             {
-                auto iter = std::find_if(begin, end,
-                                         [&] (const auto& ei) -> bool
-                                         { return v == ei.first &&
-                                                  idx == ei.second; });
+                typedef typename adj_list<Vertex>::index_t index_t;
+                std::decay_t<decltype(begin)> iter;
+                if (g._sorted)
+                    iter = std::lower_bound(begin, end,
+                                            std::make_pair(index_t(v),
+                                                           index_t(idx)));
+                else
+                    iter = std::find_if(begin, end,
+                                        [&] (const auto& ei) -> bool
+                                        { return v == ei.first &&
+                                                 idx == ei.second; });
                 assert(iter != end);
                 elist.erase(iter);
             };
@@ -1008,11 +1742,18 @@ void remove_edge(const typename adj_list<Vertex>::edge_descriptor& e,
         remove_e(s_es, s_es.begin(), s_es.begin() + s_pos, t);
         s_pos--;
         remove_e(t_es, t_es.begin() + t_pos, t_es.end(), s);
+
+        if (g._keep_epos)
+        {
+            g.update_epos(s);
+            if (t != s)
+                g.update_epos(t);
+        }
     }
     else // O(1)
     {
         //g.check_epos();
-        assert (idx < g._epos.size());
+        assert (idx < g._d->_epos.size());
 
         // swap with back, and pop back
         auto remove_e = [&] (auto& elist, auto&& begin, auto&& end,
@@ -1029,49 +1770,63 @@ void remove_edge(const typename adj_list<Vertex>::edge_descriptor& e,
             {
                 // in-edge list; swap middle with very back
                 back = elist.back();
-                g._epos[back.second].second = back_iter - elist.begin();
+                g._d->_epos[back.second].second = back_iter - elist.begin();
             }
             elist.pop_back();
         };
 
+        auto& epos = g._d->_epos;
         remove_e(s_es, s_es.begin(), s_es.begin() + s_pos,
-                 [&](size_t i) -> auto& {return g._epos[i].first;}, true);
+                 [&](size_t i) -> auto& {return epos[i].first;}, true);
         s_pos--;
         remove_e(t_es, t_es.begin() + t_pos, t_es.end(),
-                 [&](size_t i) -> auto& {return g._epos[i].second;}, false);
+                 [&](size_t i) -> auto& {return epos[i].second;}, false);
 
         //g.check_epos();
     }
 
-    g._free_indexes.push_back(idx);
+    g._d->_free_indexes.push_back(idx);
     g._n_edges--;
+
+    if (g._d->_ehash && g._ehash_stamp + 1 == g._stamp)
+    {
+        g._d->_ehash->erase(s, t, idx);
+        g._ehash_stamp = g._stamp;
+    }
 }
 
 template <class Vertex>
 inline __attribute__((always_inline)) __attribute__((flatten))
 Vertex add_vertex(adj_list<Vertex>& g)
 {
-    g._edges.emplace_back();
-    return g._edges.size() - 1;
+    if (g._d->_edges.size() >= adj_list<Vertex>::max_index())
+        adj_list<Vertex>::throw_overflow();
+    g._stamp++;
+    if (g._d->_ehash && g._ehash_stamp + 1 == g._stamp)
+        g._ehash_stamp = g._stamp;
+    g._d->_edges.emplace_back(0, g.get_edge_allocator());
+    return g._d->_edges.size() - 1;
 }
 
 template <class Vertex, class Pred>
 void clear_vertex(Vertex v, adj_list<Vertex>& g, Pred&& pred)
 {
+    g._stamp++;
+
     typename adj_list<Vertex>::make_out_edge mk_out_edge;
     typename adj_list<Vertex>::make_in_edge mk_in_edge;
 
     if (!g._keep_epos)
     {
-        auto& pos = g._edges[v].first;
-        auto& es  = g._edges[v].second;
+        auto& pos = g._d->_edges[v].first;
+        auto& es  = g._d->_edges[v].second;
         for (size_t i = 0; i < es.size(); ++i)
         {
             auto u = es[i].first;
             if (u == v)
                 continue;
-            auto& u_pos = g._edges[u].first;
-            auto& u_es = g._edges[u].second;
+            auto& u_pos = g._d->_edges[u].first;
+            auto& u_es = g._d->_edges[u].second;
             if (i < pos)
             {
                 if (!pred(mk_out_edge.def(v, es[i])))
@@ -1127,8 +1882,8 @@ void clear_vertex(Vertex v, adj_list<Vertex>& g, Pred&& pred)
     }
     else
     {
-        auto& pos = g._edges[v].first;
-        auto& es = g._edges[v].second;
+        auto& pos = g._d->_edges[v].first;
+        auto& es = g._d->_edges[v].second;
         std::vector<typename adj_list<Vertex>::edge_descriptor> res;
         res.reserve(es.size());
         for (size_t j = 0; j < es.size(); ++j)
@@ -1159,13 +1914,14 @@ template <class Vertex>
 void remove_vertex(Vertex v, adj_list<Vertex>& g)
 {
     clear_vertex(v, g);
-    g._edges.erase(g._edges.begin() + v);
+    g._stamp++;
+    g._d->_edges.erase(g._d->_edges.begin() + v);
 
-    size_t N = g._edges.size();
+    size_t N = g._d->_edges.size();
     #pragma omp parallel for schedule(runtime) if (N > 100)
     for (size_t i = 0; i < N; ++i)
     {
-        for (auto& e : g._edges[i].second)
+        for (auto& e : g._d->_edges[i].second)
         {
             if (e.first > v)
                 e.first--;
@@ -1177,15 +1933,16 @@ void remove_vertex(Vertex v, adj_list<Vertex>& g)
 template <class Vertex>
 void remove_vertex_fast(Vertex v, adj_list<Vertex>& g)
 {
-    Vertex back = g._edges.size() - 1;
+    Vertex back = g._d->_edges.size() - 1;
 
     clear_vertex(v, g);
+    g._stamp++;
     if (v < back)
     {
-        g._edges[v] = g._edges[back];
+        g._d->_edges[v] = g._d->_edges[back];
 
-        auto pos = g._edges[v].first;
-        auto& es = g._edges[v].second;
+        auto pos = g._d->_edges[v].first;
+        auto& es = g._d->_edges[v].second;
         for (size_t i = 0; i < es.size(); ++i)
         {
             auto& eu = es[i];
@@ -1199,8 +1956,8 @@ void remove_vertex_fast(Vertex v, adj_list<Vertex>& g)
                 // change label in adjacent lists
                 if (!g._keep_epos)
                 {
-                    auto u_pos = g._edges[u].first;
-                    auto& u_es = g._edges[u].second;
+                    auto u_pos = g._d->_edges[u].first;
+                    auto& u_es = g._d->_edges[u].second;
                     size_t begin = (i < pos) ? u_pos : 0;
                     size_t end = (i < pos) ? u_es.size() : u_pos;
                     for (size_t j = begin; j < end; ++j)
@@ -1214,15 +1971,32 @@ void remove_vertex_fast(Vertex v, adj_list<Vertex>& g)
                 {
                     size_t idx = eu.second;
                     auto u_pos = (i < pos) ?
-                        g._epos[idx].second :
-                        g._epos[idx].first;
-                    assert(g._edges[u].second[u_pos].first == back);
-                    g._edges[u].second[u_pos].first = v;
+                        g._d->_epos[idx].second :
+                        g._d->_epos[idx].first;
+                    assert(g._d->_edges[u].second[u_pos].first == back);
+                    g._d->_edges[u].second[u_pos].first = v;
                 }
             }
         }
+
+        if (g._sorted)
+        {
+            // the relabeled entries need to be moved to their sorted positions
+            g.sort_edge_list(v);
+            if (g._keep_epos)
+                g.update_epos(v);
+            for (auto& e : es)
+            {
+                Vertex u = e.first;
+                if (u == v)
+                    continue;
+                g.sort_edge_list(u);
+                if (g._keep_epos)
+                    g.update_epos(u);
+            }
+        }
     }
-    g._edges.pop_back();
+    g._d->_edges.pop_back();
 }
 
 
@@ -1275,14 +2049,18 @@ get(vertex_index_t, const adj_list<Vertex>&)
     return identity_property_map();
 }
 
+// The edge indexes have the same width as the integers stored in the edge
+// lists, i.e. 32 bits if GRAPH_COMPACT_INDEX is defined, so that the data
+// structures that store them (e.g. edge maps of the algorithms) shrink as well.
 template<class Vertex>
 class adj_edge_index_property_map:
-    public put_get_helper<Vertex, adj_edge_index_property_map<Vertex> >
+    public put_get_helper<typename detail::adj_stored_index<Vertex>::type,
+                          adj_edge_index_property_map<Vertex> >
 {
 public:
     typedef typename adj_list<Vertex>::edge_descriptor key_type;
-    typedef Vertex reference;
-    typedef Vertex value_type;
+    typedef typename detail::adj_stored_index<Vertex>::type reference;
+    typedef typename detail::adj_stored_index<Vertex>::type value_type;
     typedef boost::readable_property_map_tag category;
 
     reference operator[](const key_type& k) const {return k.idx;}
@@ -0,0 +1,590 @@
+// graph-tool -- a general graph modification and manipulation thingy
+//
+// Copyright (C) 2006-2018 Tiago de Paula Peixoto <tiago@skewed.de>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GRAPH_ADJACENCY_CSR_HH
+#define GRAPH_ADJACENCY_CSR_HH
+
+#include "graph_adjacency.hh"
+#include "graph_exceptions.hh"
+
+namespace boost
+{
+
+// ========================================================================
+// adj_csr<Vertex>
+// ========================================================================
+//
+// adj_csr is an immutable, compressed-sparse-row snapshot of an
+// adj_list<Vertex>. All edge lists are stored in a single contiguous vector,
+// and each vertex v occupies the range [_out_offsets[v], _out_offsets[v+1]),
+// with the out-edges preceding the in-edges, which start at _in_offsets[v].
+// Keeping the out- and in-lists of each vertex adjacent means that the
+// undirected view, which iterates through both, is also contiguous.
+//
+// The vertex and edge descriptors (and hence also the vertex and edge indexes)
+// are exactly the same as in the adj_list from which the snapshot was taken,
+// so that all property maps remain valid. The iterator types are also shared
+// with adj_list, with the exception of edge_iterator.
+//
+// Since the structure cannot be modified, all manipulation functions throw a
+// GraphException.
+
+template <class Vertex = size_t>
+class adj_csr
+{
+public:
+    struct graph_tag {};
+    typedef Vertex vertex_t;
+
+    typedef typename adj_list<Vertex>::edge_descriptor edge_descriptor;
+    typedef typename adj_list<Vertex>::edge_list_t edge_list_t;
+    typedef typename adj_list<Vertex>::vertex_iterator vertex_iterator;
+
+    typedef typename adj_list<Vertex>::adjacency_iterator adjacency_iterator;
+    typedef typename adj_list<Vertex>::in_adjacency_iterator in_adjacency_iterator;
+    typedef typename adj_list<Vertex>::out_edge_iterator out_edge_iterator;
+    typedef typename adj_list<Vertex>::in_edge_iterator in_edge_iterator;
+    typedef typename adj_list<Vertex>::all_edge_iterator all_edge_iterator;
+    typedef typename adj_list<Vertex>::all_edge_iterator_reversed
+        all_edge_iterator_reversed;
+
+    adj_csr()
+        : _out_offsets(1, 0), _n_edges(0), _edge_index_range(0),
+          _sorted(false), _stamp(0) {}
+
+    explicit adj_csr(const adj_list<Vertex>& g)
+        : _n_edges(num_edges(g)),
+          _edge_index_range(g.get_edge_index_range()),
+          _sorted(g.get_sorted()), _stamp(g.get_stamp())
+    {
+        size_t N = num_vertices(g);
+        _out_offsets.resize(N + 1);
+        _in_offsets.resize(N);
+        _out_offsets[0] = 0;
+        for (size_t v = 0; v < N; ++v)
+            _out_offsets[v + 1] = _out_offsets[v] + degree(Vertex(v), g);
+        _edges.resize(_out_offsets[N]);
+
+        #pragma omp parallel for schedule(runtime) if (N > 100)
+        for (size_t v = 0; v < N; ++v)
+        {
+            _in_offsets[v] = _out_offsets[v] + out_degree(Vertex(v), g);
+            auto pos = _edges.begin() + _out_offsets[v];
+            auto range = _all_edges_out(Vertex(v), g);
+            for (auto e = range.first; e != range.second; ++e, ++pos)
+            {
+                auto ed = *e;
+                *pos = {typename adj_list<Vertex>::index_t(ed.t),
+                        typename adj_list<Vertex>::index_t(ed.idx)};
+            }
+        }
+    }
+
+    class edge_iterator:
+        public boost::iterator_facade<edge_iterator,
+                                      edge_descriptor,
+                                      boost::forward_traversal_tag,
+                                      edge_descriptor>
+    {
+    public:
+        edge_iterator() : _g(nullptr), _v(0), _pos(0) {}
+        explicit edge_iterator(const adj_csr* g, vertex_t v, size_t pos)
+            : _g(g), _v(v), _pos(pos)
+        {
+            // move position to first edge
+            skip();
+        }
+
+    private:
+        friend class boost::iterator_core_access;
+
+        void skip()
+        {
+            //skip vertices without out-edges
+            size_t N = _g->_in_offsets.size();
+            while (_v < N && _pos == _g->_in_offsets[_v])
+            {
+                ++_v;
+                _pos = (_v < N) ? _g->_out_offsets[_v] : 0;
+            }
+        }
+
+        void increment()
+        {
+            ++_pos;
+            skip();
+        }
+
+        bool equal(edge_iterator const& other) const
+        {
+            return _v == other._v && _pos == other._pos;
+        }
+
+        edge_descriptor dereference() const
+        {
+            const auto& e = _g->_edges[_pos];
+            return edge_descriptor(_v, e.first, e.second);
+        }
+
+        const adj_csr* _g;
+        vertex_t _v;
+        size_t _pos;
+    };
+
+    size_t get_edge_index_range() const { return _edge_index_range; }
+
+    // whether the edge lists are sorted by neighbor (inherited from the
+    // adj_list at construction, see adj_list::set_sorted())
+    bool get_sorted() const { return _sorted; }
+
+    // modification stamp of the adj_list when the snapshot was taken
+    size_t get_stamp() const { return _stamp; }
+
+    // calls f(name, size, capacity) for each internal array, with the number
+    // of bytes used and allocated (see adj_list::visit_memory())
+    template <class F>
+    void visit_memory(F&& f) const
+    {
+        f("frozen_offsets",
+          (_out_offsets.size() + _in_offsets.size()) * sizeof(size_t),
+          (_out_offsets.capacity() + _in_offsets.capacity()) * sizeof(size_t));
+        typedef typename edge_list_t::value_type entry_t;
+        f("frozen_edges", _edges.size() * sizeof(entry_t),
+          _edges.capacity() * sizeof(entry_t));
+    }
+
+    static Vertex null_vertex() { return std::numeric_limits<Vertex>::max(); }
+
+    __attribute__((always_inline))
+    void reverse_edge(edge_descriptor& e) const
+    {
+        auto begin = _edges.begin() + _out_offsets[e.s];
+        auto end = _edges.begin() + _in_offsets[e.s];
+        auto iter = std::find_if(begin, end,
+                                 [&](const auto& oe) -> bool
+                                 { return oe.second == e.idx; });
+        if (iter == end)
+            std::swap(e.s, e.t);
+    }
+
+    // the accessors below are used by the non-member functions
+
+    __attribute__((always_inline))
+    typename edge_list_t::const_iterator out_begin(Vertex v) const
+    {
+        return _edges.begin() + _out_offsets[v];
+    }
+
+    __attribute__((always_inline))
+    typename edge_list_t::const_iterator in_begin(Vertex v) const
+    {
+        return _edges.begin() + _in_offsets[v];
+    }
+
+    __attribute__((always_inline))
+    typename edge_list_t::const_iterator in_end(Vertex v) const
+    {
+        return _edges.begin() + _out_offsets[v + 1];
+    }
+
+    size_t get_num_vertices() const { return _in_offsets.size(); }
+    size_t get_num_edges() const { return _n_edges; }
+
+    static void throw_immutable()
+    {
+        throw graph_tool::GraphException("Cannot modify a frozen graph; "
+                                         "it must be thawed first.");
+    }
+
+private:
+    std::vector<size_t> _out_offsets;   // start of each vertex's out-list,
+                                        // plus the total size at the end
+    std::vector<size_t> _in_offsets;    // start of each vertex's in-list
+    edge_list_t _edges;
+    size_t _n_edges;
+    size_t _edge_index_range;
+    bool _sorted;
+    size_t _stamp;
+};
+
+//========================================================================
+// Graph traits and BGL scaffolding
+//========================================================================
+
+template <class Vertex>
+struct graph_traits<adj_csr<Vertex> >
+{
+    typedef Vertex vertex_descriptor;
+    typedef typename adj_csr<Vertex>::edge_descriptor edge_descriptor;
+    typedef typename adj_csr<Vertex>::edge_iterator edge_iterator;
+    typedef typename adj_csr<Vertex>::adjacency_iterator adjacency_iterator;
+    typedef typename adj_csr<Vertex>::in_adjacency_iterator in_adjacency_iterator;
+
+    typedef typename adj_csr<Vertex>::out_edge_iterator out_edge_iterator;
+    typedef typename adj_csr<Vertex>::in_edge_iterator in_edge_iterator;
+
+    typedef typename adj_csr<Vertex>::vertex_iterator vertex_iterator;
+
+    typedef bidirectional_tag directed_category;
+    typedef allow_parallel_edge_tag edge_parallel_category;
+    typedef adj_list_traversal_tag traversal_category;
+
+    typedef Vertex vertices_size_type;
+    typedef Vertex edges_size_type;
+    typedef size_t degree_size_type;
+
+    static Vertex null_vertex() { return adj_csr<Vertex>::null_vertex(); }
+};
+
+template <class Vertex>
+struct graph_traits<const adj_csr<Vertex> >
+    : public graph_traits<adj_csr<Vertex> >
+{
+};
+
+template <class Vertex>
+struct edge_property_type<adj_csr<Vertex> >
+{
+    typedef void type;
+};
+
+template <class Vertex>
+struct vertex_property_type<adj_csr<Vertex> >
+{
+    typedef void type;
+};
+
+template <class Vertex>
+struct graph_property_type<adj_csr<Vertex> >
+{
+    typedef void type;
+};
+
+//========================================================================
+// Graph access functions
+//========================================================================
+
+template <class Vertex>
+inline __attribute__((always_inline)) __attribute__((flatten))
+std::pair<typename adj_csr<Vertex>::vertex_iterator,
+          typename adj_csr<Vertex>::vertex_iterator>
+vertices(const adj_csr<Vertex>& g)
+{
+    typedef typename adj_csr<Vertex>::vertex_iterator vi_t;
+    return {vi_t(0), vi_t(g.get_num_vertices())};
+}
+
+template <class Vertex>
+inline __attribute__((always_inline)) __attribute__((flatten))
+std::pair<typename adj_csr<Vertex>::edge_iterator,
+          typename adj_csr<Vertex>::edge_iterator>
+edges(const adj_csr<Vertex>& g)
+{
+    typedef typename adj_csr<Vertex>::edge_iterator ei_t;
+    return {ei_t(&g, 0, 0), ei_t(&g, g.get_num_vertices(), 0)};
+}
+
+template <class Vertex>
+inline __attribute__((always_inline))
+Vertex vertex(size_t i, const adj_csr<Vertex>&)
+{
+    return i;
+}
+
+template <class Vertex>
+inline
+std::pair<typename adj_csr<Vertex>::edge_descriptor, bool>
+edge(Vertex s, Vertex t, const adj_csr<Vertex>& g)
+{
+    typedef typename adj_csr<Vertex>::edge_descriptor edge_descriptor;
+    auto end = g.in_begin(s);
+    typename adj_csr<Vertex>::edge_list_t::const_iterator iter;
+    if (g.get_sorted())
+    {
+        iter = std::lower_bound(g.out_begin(s), end, t,
+                                [](const auto& e, Vertex u) -> bool
+                                {return e.first < u;});
+        if (iter != end && iter->first != t)
+            iter = end;
+    }
+    else
+    {
+        iter = std::find_if(g.out_begin(s), end,
+                            [&](const auto& e) -> bool {return e.first == t;});
+    }
+    if (iter != end)
+        return {edge_descriptor(s, t, iter->second), true};
+    return {edge_descriptor(), false};
+}
+
+template <class Vertex>
+inline __attribute__((always_inline))
+size_t out_degree(Vertex v, const adj_csr<Vertex>& g)
+{
+    return g.in_begin(v) - g.out_begin(v);
+}
+
+template <class Vertex>
+inline __attribute__((always_inline))
+size_t in_degree(Vertex v, const adj_csr<Vertex>& g)
+{
+    return g.in_end(v) - g.in_begin(v);
+}
+
+template <class Vertex>
+inline __attribute__((always_inline))
+size_t degree(Vertex v, const adj_csr<Vertex>& g)
+{
+    return g.in_end(v) - g.out_begin(v);
+}
+
+template <class Vertex>
+inline __attribute__((always_inline)) __attribute__((flatten))
+std::pair<typename adj_csr<Vertex>::out_edge_iterator,
+          typename adj_csr<Vertex>::out_edge_iterator>
+out_edges(Vertex v, const adj_csr<Vertex>& g)
+{
+    typedef typename adj_csr<Vertex>::out_edge_iterator ei_t;
+    return {ei_t(v, g.out_begin(v)), ei_t(v, g.in_begin(v))};
+}
+
+template <class Vertex>
+inline __attribute__((always_inline)) __attribute__((flatten))
+std::pair<typename adj_csr<Vertex>::in_edge_iterator,
+          typename adj_csr<Vertex>::in_edge_iterator>
+in_edges(Vertex v, const adj_csr<Vertex>& g)
+{
+    typedef typename adj_csr<Vertex>::in_edge_iterator ei_t;
+    return {ei_t(v, g.in_begin(v)), ei_t(v, g.in_end(v))};
+}
+
+template <class Vertex>
+inline __attribute__((always_inline)) __attribute__((flatten))
+std::pair<typename adj_csr<Vertex>::out_edge_iterator,
+          typename adj_csr<Vertex>::out_edge_iterator>
+_all_edges_out(Vertex v, const adj_csr<Vertex>& g)
+{
+    typedef typename adj_csr<Vertex>::out_edge_iterator ei_t;
+    return {ei_t(v, g.out_begin(v)), ei_t(v, g.in_end(v))};
+}
+
+template <class Vertex>
+inline __attribute__((always_inline)) __attribute__((flatten))
+std::pair<typename adj_csr<Vertex>::in_edge_iterator,
+          typename adj_csr<Vertex>::in_edge_iterator>
+_all_edges_in(Vertex v, const adj_csr<Vertex>& g)
+{
+    typedef typename adj_csr<Vertex>::in_edge_iterator ei_t;
+    return {ei_t(v, g.out_begin(v)), ei_t(v, g.in_end(v))};
+}
+
+template <class Vertex>
+inline __attribute__((always_inline)) __attribute__((flatten))
+std::pair<typename adj_csr<Vertex>::all_edge_iterator,
+          typename adj_csr<Vertex>::all_edge_iterator>
+all_edges(Vertex v, const adj_csr<Vertex>& g)
+{
+    typedef typename adj_csr<Vertex>::all_edge_iterator ei_t;
+    auto pos = g.in_begin(v);
+    return {ei_t(v, g.out_begin(v), pos), ei_t(v, g.in_end(v), pos)};
+}
+
+template <class Vertex>
+inline __attribute__((always_inline)) __attribute__((flatten))
+std::pair<typename adj_csr<Vertex>::all_edge_iterator_reversed,
+          typename adj_csr<Vertex>::all_edge_iterator_reversed>
+_all_edges_reversed(Vertex v, const adj_csr<Vertex>& g)
+{
+    typedef typename adj_csr<Vertex>::all_edge_iterator_reversed ei_t;
+    auto pos = g.in_begin(v);
+    return {ei_t(v, g.out_begin(v), pos), ei_t(v, g.in_end(v), pos)};
+}
+
+template <class Vertex>
+inline __attribute__((always_inline)) __attribute__((flatten))
+std::pair<typename adj_csr<Vertex>::adjacency_iterator,
+          typename adj_csr<Vertex>::adjacency_iterator>
+out_neighbors(Vertex v, const adj_csr<Vertex>& g)
+{
+    typedef typename adj_csr<Vertex>::adjacency_iterator ai_t;
+    return {ai_t(g.out_begin(v)), ai_t(g.in_begin(v))};
+}
+
+template <class Vertex>
+inline __attribute__((always_inline)) __attribute__((flatten))
+std::pair<typename adj_csr<Vertex>::adjacency_iterator,
+          typename adj_csr<Vertex>::adjacency_iterator>
+in_neighbors(Vertex v, const adj_csr<Vertex>& g)
+{
+    typedef typename adj_csr<Vertex>::adjacency_iterator ai_t;
+    return {ai_t(g.in_begin(v)), ai_t(g.in_end(v))};
+}
+
+template <class Vertex>
+inline __attribute__((always_inline)) __attribute__((flatten))
+std::pair<typename adj_csr<Vertex>::adjacency_iterator,
+          typename adj_csr<Vertex>::adjacency_iterator>
+all_neighbors(Vertex v, const adj_csr<Vertex>& g)
+{
+    typedef typename adj_csr<Vertex>::adjacency_iterator ai_t;
+    return {ai_t(g.out_begin(v)), ai_t(g.in_end(v))};
+}
+
+template <class Vertex>
+inline __attribute__((always_inline)) __attribute__((flatten))
+std::pair<typename adj_csr<Vertex>::adjacency_iterator,
+          typename adj_csr<Vertex>::adjacency_iterator>
+adjacent_vertices(Vertex v, const adj_csr<Vertex>& g)
+{
+    return out_neighbors(v, g);
+}
+
+template <class Vertex>
+inline __attribute__((always_inline))
+size_t num_vertices(const adj_csr<Vertex>& g)
+{
+    return g.get_num_vertices();
+}
+
+template <class Vertex>
+inline __attribute__((always_inline))
+size_t num_edges(const adj_csr<Vertex>& g)
+{
+    return g.get_num_edges();
+}
+
+template <class Vertex>
+inline __attribute__((always_inline))
+Vertex source(const typename adj_csr<Vertex>::edge_descriptor& e,
+              const adj_csr<Vertex>&)
+{
+    return e.s;
+}
+
+template <class Vertex>
+inline __attribute__((always_inline))
+Vertex target(const typename adj_csr<Vertex>::edge_descriptor& e,
+              const adj_csr<Vertex>&)
+{
+    return e.t;
+}
+
+//========================================================================
+// Graph manipulation functions (unsupported)
+//========================================================================
+
+template <class Vertex>
+Vertex add_vertex(adj_csr<Vertex>&)
+{
+    adj_csr<Vertex>::throw_immutable();
+    return Vertex();
+}
+
+template <class Vertex, class Pred>
+void clear_vertex(Vertex, adj_csr<Vertex>&, Pred&&)
+{
+    adj_csr<Vertex>::throw_immutable();
+}
+
+template <class Vertex>
+void clear_vertex(Vertex, adj_csr<Vertex>&)
+{
+    adj_csr<Vertex>::throw_immutable();
+}
+
+template <class Vertex>
+void remove_vertex(Vertex, adj_csr<Vertex>&)
+{
+    adj_csr<Vertex>::throw_immutable();
+}
+
+template <class Vertex>
+void remove_vertex_fast(Vertex, adj_csr<Vertex>&)
+{
+    adj_csr<Vertex>::throw_immutable();
+}
+
+template <class Vertex>
+std::pair<typename adj_csr<Vertex>::edge_descriptor, bool>
+add_edge(Vertex, Vertex, adj_csr<Vertex>&)
+{
+    adj_csr<Vertex>::throw_immutable();
+    return {typename adj_csr<Vertex>::edge_descriptor(), false};
+}
+
+template <class Vertex>
+void remove_edge(Vertex, Vertex, adj_csr<Vertex>&)
+{
+    adj_csr<Vertex>::throw_immutable();
+}
+
+template <class Vertex>
+void remove_edge(const typename adj_csr<Vertex>::edge_descriptor&,
+                 adj_csr<Vertex>&)
+{
+    adj_csr<Vertex>::throw_immutable();
+}
+
+//========================================================================
+// Vertex and edge index property maps
+//========================================================================
+
+template <class Vertex>
+struct property_map<adj_csr<Vertex>, vertex_index_t>
+{
+    typedef identity_property_map type;
+    typedef type const_type;
+};
+
+template <class Vertex>
+struct property_map<const adj_csr<Vertex>, vertex_index_t>
+{
+    typedef identity_property_map type;
+    typedef type const_type;
+};
+
+template <class Vertex>
+inline identity_property_map
+get(vertex_index_t, adj_csr<Vertex>&)
+{
+    return identity_property_map();
+}
+
+template <class Vertex>
+inline identity_property_map
+get(vertex_index_t, const adj_csr<Vertex>&)
+{
+    return identity_property_map();
+}
+
+template <class Vertex>
+struct property_map<adj_csr<Vertex>, edge_index_t>
+{
+    typedef adj_edge_index_property_map<Vertex> type;
+    typedef type const_type;
+};
+
+template <class Vertex>
+inline adj_edge_index_property_map<Vertex>
+get(edge_index_t, const adj_csr<Vertex>&)
+{
+    return adj_edge_index_property_map<Vertex>();
+}
+
+} // namespace boost
+
+#endif //GRAPH_ADJACENCY_CSR_HH
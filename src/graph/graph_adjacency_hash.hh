@@ -0,0 +1,190 @@
+// graph-tool -- a general graph modification and manipulation thingy
+//
+// Copyright (C) 2006-2018 Tiago de Paula Peixoto <tiago@skewed.de>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GRAPH_ADJACENCY_HASH_HH
+#define GRAPH_ADJACENCY_HASH_HH
+
+#include <vector>
+#include <limits>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+namespace boost
+{
+namespace detail
+{
+
+// ========================================================================
+// adj_edge_hash
+// ========================================================================
+//
+// An open-addressing hash table that maps the (source, target) pairs of the
+// edges of adj_list to their indexes, so that edge(s, t, g) becomes O(1)
+// instead of O(k) or O(log k). Every edge has its own entry, so that parallel
+// edges are supported; find() returns any one of them.
+//
+// Collisions are resolved by linear probing, and entries are removed by
+// shifting back the remainder of their cluster, so that no tombstones are
+// left behind. The table is grown when it becomes half full. Lookups are
+// thread-safe, but modifications are not.
+
+template <class Vertex>
+class adj_edge_hash
+{
+public:
+    static constexpr Vertex null = std::numeric_limits<Vertex>::max();
+
+    struct entry_t
+    {
+        Vertex s = null;
+        Vertex t = null;
+        Vertex idx = null;
+    };
+
+    adj_edge_hash() : _n(0), _mask(0) {}
+
+    void clear()
+    {
+        _table.clear();
+        _table.shrink_to_fit();
+        _n = 0;
+        _mask = 0;
+    }
+
+    // makes room for n entries without rehashing
+    void reserve(size_t n)
+    {
+        size_t m = 16;
+        while (m < 2 * n)
+            m <<= 1;
+        if (m > _table.size())
+            rehash(m);
+    }
+
+    void insert(Vertex s, Vertex t, Vertex idx)
+    {
+        if (2 * (_n + 1) > _table.size())
+            rehash(std::max(size_t(16), 2 * _table.size()));
+        size_t i = slot(s, t);
+        while (_table[i].s != null)
+            i = (i + 1) & _mask;
+        _table[i] = {s, t, idx};
+        _n++;
+    }
+
+    void erase(Vertex s, Vertex t, Vertex idx)
+    {
+        if (_n == 0)
+            return;
+        size_t i = slot(s, t);
+        while (true)
+        {
+            auto& e = _table[i];
+            if (e.s == null)
+                return;
+            if (e.idx == idx && e.s == s && e.t == t)
+                break;
+            i = (i + 1) & _mask;
+        }
+
+        // shift back the entries of the cluster which would no longer be
+        // reachable from their home slot
+        size_t j = i;
+        while (true)
+        {
+            _table[i] = entry_t();
+            while (true)
+            {
+                j = (j + 1) & _mask;
+                auto& e = _table[j];
+                if (e.s == null)
+                {
+                    _n--;
+                    return;
+                }
+                size_t k = slot(e.s, e.t);
+                if (((j - k) & _mask) >= ((j - i) & _mask))
+                    break;
+            }
+            _table[i] = _table[j];
+            i = j;
+        }
+    }
+
+    // returns the index of an edge from s to t, or null if there is none
+    Vertex find(Vertex s, Vertex t) const
+    {
+        if (_n == 0)
+            return null;
+        size_t i = slot(s, t);
+        while (true)
+        {
+            auto& e = _table[i];
+            if (e.s == null)
+                return null;
+            if (e.s == s && e.t == t)
+                return e.idx;
+            i = (i + 1) & _mask;
+        }
+    }
+
+    size_t size() const { return _n; }
+
+    size_t memory_size() const { return _n * sizeof(entry_t); }
+
+    size_t memory_capacity() const
+    {
+        return _table.capacity() * sizeof(entry_t);
+    }
+
+private:
+    size_t slot(Vertex s, Vertex t) const
+    {
+        // splitmix64 finalizer of the combined key
+        uint64_t x = uint64_t(s) * 0x9e3779b97f4a7c15ULL ^ uint64_t(t);
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        x = x ^ (x >> 31);
+        return x & _mask;
+    }
+
+    void rehash(size_t m)
+    {
+        std::vector<entry_t> table(m);
+        std::swap(table, _table);
+        _mask = m - 1;
+        for (auto& e : table)
+        {
+            if (e.s == null)
+                continue;
+            size_t i = slot(e.s, e.t);
+            while (_table[i].s != null)
+                i = (i + 1) & _mask;
+            _table[i] = e;
+        }
+    }
+
+    std::vector<entry_t> _table;
+    size_t _n;
+    size_t _mask;
+};
+
+} // namespace detail
+} // namespace boost
+
+#endif // GRAPH_ADJACENCY_HASH_HH
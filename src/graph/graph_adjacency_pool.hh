@@ -0,0 +1,233 @@
+// graph-tool -- a general graph modification and manipulation thingy
+//
+// Copyright (C) 2006-2018 Tiago de Paula Peixoto <tiago@skewed.de>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GRAPH_ADJACENCY_POOL_HH
+#define GRAPH_ADJACENCY_POOL_HH
+
+#include <vector>
+#include <array>
+#include <memory>
+#include <new>
+#include <algorithm>
+
+namespace boost
+{
+namespace detail
+{
+
+// ========================================================================
+// adj_edge_pool
+// ========================================================================
+//
+// A slab allocator for the edge lists of adj_list. Memory is obtained from the
+// system in large slabs, which are carved into blocks with sizes given by
+// powers of two (size classes). Freed blocks are kept in per-class free lists,
+// and reused by subsequent allocations of the same class. Blocks larger than
+// the largest size class are obtained directly from operator new.
+//
+// All the memory is returned to the system at once when the pool is
+// destroyed. Like adj_list itself, the pool is not thread-safe.
+
+class adj_edge_pool
+{
+public:
+    static constexpr size_t min_block = 16;       // bytes
+    static constexpr size_t n_classes = 17;       // up to 1 MiB blocks
+    static constexpr size_t slab_size = 4 << 20;  // bytes
+
+    struct stats_t
+    {
+        size_t slab_bytes = 0;      // memory obtained in slabs
+        size_t large_bytes = 0;     // memory in blocks outside the slabs
+        size_t used_bytes = 0;      // memory in blocks currently handed out
+        size_t requested_bytes = 0; // memory actually requested
+        size_t free_bytes = 0;      // memory in the free lists
+        size_t n_slabs = 0;
+    };
+
+    adj_edge_pool()
+        : _pos(nullptr), _end(nullptr)
+    {
+        _free.fill(nullptr);
+    }
+
+    adj_edge_pool(const adj_edge_pool&) = delete;
+    adj_edge_pool& operator=(const adj_edge_pool&) = delete;
+
+    ~adj_edge_pool()
+    {
+        for (auto slab : _slabs)
+            ::operator delete(slab);
+    }
+
+    static size_t get_class(size_t bytes)
+    {
+        size_t k = 0;
+        while ((min_block << k) < bytes)
+            ++k;
+        return k;
+    }
+
+    void* allocate(size_t bytes)
+    {
+        size_t k = get_class(bytes);
+        _stats.requested_bytes += bytes;
+        if (k >= n_classes)
+        {
+            _stats.large_bytes += bytes;
+            return ::operator new(bytes);
+        }
+
+        size_t bsize = min_block << k;
+        _stats.used_bytes += bsize;
+
+        void*& head = _free[k];
+        if (head != nullptr)
+        {
+            void* p = head;
+            head = *reinterpret_cast<void**>(p);
+            _stats.free_bytes -= bsize;
+            return p;
+        }
+
+        if (_pos + bsize > _end)
+            new_slab();
+        void* p = _pos;
+        _pos += bsize;
+        return p;
+    }
+
+    void deallocate(void* p, size_t bytes)
+    {
+        size_t k = get_class(bytes);
+        _stats.requested_bytes -= bytes;
+        if (k >= n_classes)
+        {
+            _stats.large_bytes -= bytes;
+            ::operator delete(p);
+            return;
+        }
+        push_free(p, k);
+        _stats.used_bytes -= min_block << k;
+    }
+
+    const stats_t& get_stats() const { return _stats; }
+
+private:
+    void push_free(void* p, size_t k)
+    {
+        *reinterpret_cast<void**>(p) = _free[k];
+        _free[k] = p;
+        _stats.free_bytes += min_block << k;
+    }
+
+    void new_slab()
+    {
+        // the remainder of the current slab is split into free blocks
+        while (_end - _pos >= std::ptrdiff_t(min_block))
+        {
+            size_t k = get_class(_end - _pos);
+            if ((min_block << k) > size_t(_end - _pos))
+                --k;
+            k = std::min(k, n_classes - 1);
+            push_free(_pos, k);
+            _pos += min_block << k;
+        }
+
+        char* slab = static_cast<char*>(::operator new(slab_size));
+        _slabs.push_back(slab);
+        _pos = slab;
+        _end = slab + slab_size;
+        _stats.slab_bytes += slab_size;
+        _stats.n_slabs++;
+    }
+
+    std::vector<char*> _slabs;
+    std::array<void*, n_classes> _free;
+    char* _pos;
+    char* _end;
+    stats_t _stats;
+};
+
+// Allocator used by the edge lists of adj_list. If no pool is given, it falls
+// back to the default heap allocation. Since all the lists of the same graph
+// share the same pool, the allocator is propagated when the lists are moved or
+// swapped, but not when they are copied, in which case the copy is owned by
+// the default heap, until it is moved to another pool via adj_list.
+//
+// The pool pointer makes every edge list one word larger (i.e. 8 more bytes per
+// vertex, on top of the 32 bytes of the list itself), even when no pool is
+// used. A stateless allocator could only use a single global pool, shared by
+// all graphs, since the lists allocate through their own allocator instance;
+// the memory of one graph could then not be released in bulk, which is the
+// main point of the pool. Since every edge takes 32 bytes with 64-bit
+// indexes (one entry in the out- and one in the in-list), the overhead is small
+// compared to the edges, unless the average degree is very small.
+template <class T>
+struct adj_edge_allocator
+{
+    typedef T value_type;
+    typedef std::true_type propagate_on_container_move_assignment;
+    typedef std::true_type propagate_on_container_swap;
+    typedef std::false_type propagate_on_container_copy_assignment;
+    typedef std::false_type is_always_equal;
+
+    adj_edge_allocator() : _pool(nullptr) {}
+    explicit adj_edge_allocator(adj_edge_pool* pool) : _pool(pool) {}
+
+    template <class U>
+    adj_edge_allocator(const adj_edge_allocator<U>& a) : _pool(a._pool) {}
+
+    T* allocate(size_t n)
+    {
+        if (_pool == nullptr)
+            return std::allocator<T>().allocate(n);
+        return static_cast<T*>(_pool->allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t n)
+    {
+        if (_pool == nullptr)
+            std::allocator<T>().deallocate(p, n);
+        else
+            _pool->deallocate(p, n * sizeof(T));
+    }
+
+    adj_edge_allocator select_on_container_copy_construction() const
+    {
+        return adj_edge_allocator();
+    }
+
+    template <class U>
+    bool operator==(const adj_edge_allocator<U>& a) const
+    {
+        return _pool == a._pool;
+    }
+
+    template <class U>
+    bool operator!=(const adj_edge_allocator<U>& a) const
+    {
+        return _pool != a._pool;
+    }
+
+    adj_edge_pool* _pool;
+};
+
+} // namespace detail
+} // namespace boost
+
+#endif // GRAPH_ADJACENCY_POOL_HH
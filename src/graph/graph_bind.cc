@@ -415,6 +415,23 @@ void ungroup_vector_property(GraphInterface& g, boost::any vector_prop,
                              boost::any prop, size_t pos, bool edge);
 void group_vector_property(GraphInterface& g, boost::any vector_prop,
                            boost::any prop, size_t pos, bool edge);
+python::object get_vector_property_array(GraphInterface& gi, boost::any prop,
+                                         python::object opos, bool edge);
+void set_vector_property_array(GraphInterface& gi, boost::any prop,
+                               python::object oa, python::object opos,
+                               bool edge);
+python::object get_vector_property_ragged(GraphInterface& gi, boost::any prop,
+                                          bool edge);
+void set_vector_property_ragged(GraphInterface& gi, boost::any prop,
+                                python::object ooffsets,
+                                python::object ovalues, bool edge);
+boost::any get_flat_vertex_property(GraphInterface& gi, python::object ovalues,
+                                    python::object ooffsets);
+python::object get_string_property_codes(GraphInterface& gi, boost::any prop,
+                                         bool edge);
+void set_string_property_codes(GraphInterface& gi, boost::any prop,
+                               python::object ocodes,
+                               python::object ocategories, bool edge);
 void property_map_values(GraphInterface& g, boost::any src_prop,
                          boost::any tgt_prop, boost::python::object mapper,
                          bool edge);
@@ -471,6 +488,9 @@ BOOST_PYTHON_MODULE(libgraph_tool_core)
     def("name_demangle", &name_demangle);
 
     def("graph_filtering_enabled", &graph_filtering_enabled);
+    def("compact_index_enabled",
+        +[](){ return sizeof(GraphInterface::multigraph_t::index_t) <
+                      sizeof(GraphInterface::vertex_t);});
     export_openmp();
 
     boost::mpl::for_each<boost::mpl::push_back<scalar_types,string>::type>(export_vector_types());
@@ -488,6 +508,15 @@ BOOST_PYTHON_MODULE(libgraph_tool_core)
         .def("get_reversed", &GraphInterface::get_reversed)
         .def("set_keep_epos", &GraphInterface::set_keep_epos)
         .def("get_keep_epos", &GraphInterface::get_keep_epos)
+        .def("set_sorted", &GraphInterface::set_sorted)
+        .def("get_sorted", &GraphInterface::get_sorted)
+        .def("set_edge_pool", &GraphInterface::set_edge_pool)
+        .def("get_edge_pool", &GraphInterface::get_edge_pool)
+        .def("set_edge_hash", &GraphInterface::set_edge_hash)
+        .def("get_edge_hash", &GraphInterface::get_edge_hash)
+        .def("get_edge_hash_stats", &GraphInterface::get_edge_hash_stats)
+        .def("get_edge_memory_stats", &GraphInterface::get_edge_memory_stats)
+        .def("get_memory_usage", &GraphInterface::get_memory_usage)
         .def("set_vertex_filter_property",
              &GraphInterface::set_vertex_filter_property)
         .def("is_vertex_filter_active", &GraphInterface::is_vertex_filter_active)
@@ -499,8 +528,22 @@ BOOST_PYTHON_MODULE(libgraph_tool_core)
         .def("shift_vertex_property",  &GraphInterface::shift_vertex_property)
         .def("move_vertex_property",  &GraphInterface::move_vertex_property)
         .def("re_index_vertex_property",  &GraphInterface::re_index_vertex_property)
+        .def("permute_vertex_property",  &GraphInterface::permute_vertex_property)
+        .def("compact_vertex_property",  &GraphInterface::compact_vertex_property)
+        .def("compact_edge_property",  &GraphInterface::compact_edge_property)
+        .def("permute_vertices",  &GraphInterface::permute_vertices)
+        .def("remove_vertices",  &GraphInterface::remove_vertices)
+        .def("remove_edges",  &GraphInterface::remove_edges)
+        .def("compact_edge_indexes",  &GraphInterface::compact_edge_indexes)
+        .def("get_view_stamp",  &GraphInterface::get_view_stamp)
+        .def("materialize",  &GraphInterface::materialize)
+        .def("set_materialize_threshold",  &GraphInterface::set_materialize_threshold)
+        .def("get_materialize_threshold",  &GraphInterface::get_materialize_threshold)
         .def("write_to_file", &GraphInterface::write_to_file)
         .def("read_from_file",&GraphInterface::read_from_file)
+        .def("read_property_from_file",
+             &GraphInterface::read_property_from_file)
+        .def("read_csv_edge_list", &GraphInterface::read_csv_edge_list)
         .def("degree_map", &GraphInterface::degree_map)
         .def("clear", &GraphInterface::clear)
         .def("clear_edges", &GraphInterface::clear_edges)
@@ -508,6 +551,9 @@ BOOST_PYTHON_MODULE(libgraph_tool_core)
         .def("get_edge_index", &GraphInterface::get_edge_index)
         .def("get_edge_index_range", &GraphInterface::get_edge_index_range)
         .def("re_index_edges", &GraphInterface::re_index_edges)
+        .def("freeze", &GraphInterface::freeze)
+        .def("thaw", &GraphInterface::thaw)
+        .def("is_frozen", &GraphInterface::is_frozen)
         .def("shrink_to_fit", &GraphInterface::shrink_to_fit)
         .def("get_graph_index", &GraphInterface::get_graph_index)
         .def("copy_vertex_property", &GraphInterface::copy_vertex_property)
@@ -554,6 +600,13 @@ BOOST_PYTHON_MODULE(libgraph_tool_core)
 
     def("group_vector_property", &group_vector_property);
     def("ungroup_vector_property", &ungroup_vector_property);
+    def("get_vector_property_array", &get_vector_property_array);
+    def("set_vector_property_array", &set_vector_property_array);
+    def("get_vector_property_ragged", &get_vector_property_ragged);
+    def("set_vector_property_ragged", &set_vector_property_ragged);
+    def("get_flat_vertex_property", &get_flat_vertex_property);
+    def("get_string_property_codes", &get_string_property_codes);
+    def("set_string_property_codes", &set_string_property_codes);
     def("property_map_values", &property_map_values);
     def("infect_vertex_property", &infect_vertex_property);
     def("edge_endpoint", &edge_endpoint);
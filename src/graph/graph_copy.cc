@@ -243,10 +243,16 @@ GraphInterface::GraphInterface(const GraphInterface& gi, bool keep_ref,
      _vertex_filter_active(false),
      _edge_filter_map(_edge_index),
      _edge_filter_invert(false),
-     _edge_filter_active(false)
+     _edge_filter_active(false),
+     _num_edges_key(),
+     _num_edges(0),
+     _materialize_threshold(gi._materialize_threshold)
 {
     if (keep_ref)
+    {
+        _fg = gi._fg;
         return;
+    }
 
     if (vorder == python::object())
     {
@@ -0,0 +1,158 @@
+// graph-tool -- a general graph modification and manipulation thingy
+//
+// Copyright (C) 2006-2018 Tiago de Paula Peixoto <tiago@skewed.de>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GRAPH_FILTER_BITS_HH
+#define GRAPH_FILTER_BITS_HH
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace graph_tool
+{
+
+// ========================================================================
+// Packed filter masks
+// ========================================================================
+//
+// The vertex and edge filters are property maps with uint8_t values, which are
+// shared with Python, and can be modified from there at any time. For each
+// active filter, the graph keeps in addition a packed copy of the mask, with
+// one bit per entry, and the number of entries which are set. The filtered
+// graph views test and skip over the packed mask, which takes eight times less
+// memory than the original one, and the number of filtered vertices is given
+// by the count, without scanning.
+//
+// The uint8_t masks themselves are kept, since they are the values of the
+// property maps seen from Python, hence the packed copies add one eighth to the
+// memory used by the masks, rather than replacing them.
+//
+// The packed copy is only used while it is known to agree with the original
+// mask, i.e. while it is "active". Writes via PythonPropertyMap::set_value()
+// and via add_vertex()/add_edge() on the filtered views update it entry by
+// entry, through filter_mask_set(). Any other access which may write to the
+// mask deactivates it, and the views then fall back to the original mask:
+//
+//   - numpy arrays pointing to the mask, which are tracked until they are
+//     destroyed, via filter_mask_expose();
+//
+//   - maps passed to C++ functions, via filter_mask_touch(). These may keep
+//     running, and writing to the mask, after the GIL is released (see
+//     GILRelease in graph.hh), hence the packed copy is kept inactive for as
+//     long as the value vector is referenced by anything other than the
+//     graphs which use the mask as a filter and the PythonPropertyMap which
+//     owns it.
+//
+// The mask is packed again when the graph view is obtained (in sync()), once
+// none of the above holds.
+
+struct filter_mask_entry;
+
+class filter_bits
+{
+public:
+    filter_bits() {}
+    ~filter_bits() { detach(); }
+
+    // copies are not attached to any mask, and hence never active
+    filter_bits(const filter_bits&) {}
+    filter_bits& operator=(const filter_bits&)
+    {
+        detach();
+        return *this;
+    }
+
+    // starts or stops tracking the mask stored in the given vector
+    void attach(const void* storage);
+    void detach();
+
+    // brings the packed copy up to date with the mask, if possible, where
+    // holders is the number of references to its value vector
+    void sync(const uint8_t* mask, size_t n, size_t holders);
+
+    // changes a single entry of the packed copy, if it is active
+    void set(size_t i, bool val);
+
+    void deactivate() { _active.store(false, std::memory_order_release); }
+
+    bool is_active() const
+    {
+        return _active.load(std::memory_order_acquire);
+    }
+    bool test(size_t i) const { return (_words[i >> 6] >> (i & 63)) & 1; }
+    const uint64_t* data() const { return _words.data(); }
+    size_t size() const { return _size; }
+    size_t count() const { return _count; }
+
+    // number of set entries in [0, n), with n <= size()
+    size_t count(size_t n) const
+    {
+        size_t c = _count;
+        for (size_t i = n; i < _size; i = (i | 63) + 1)
+        {
+            uint64_t w = _words[i >> 6] >> (i & 63);
+            c -= __builtin_popcountll(w);
+        }
+        return c;
+    }
+
+    // changes whenever the packed copy is modified, and is never repeated
+    size_t get_version() const { return _version; }
+
+private:
+    void pack(const uint8_t* mask, size_t n);
+    void resize(size_t n);
+
+    std::vector<uint64_t> _words;
+    size_t _size = 0;
+    size_t _count = 0;
+    size_t _version = 0;
+    std::atomic<bool> _active{false};
+    std::shared_ptr<filter_mask_entry> _entry;
+};
+
+// These are called by the property maps with uint8_t values, with the address
+// of their value vector. filter_mask_expose() returns a handle which keeps the
+// mask exposed (and its packed copies inactive) while it is alive.
+void filter_mask_set(const void* storage, size_t i, bool val);
+void filter_mask_touch(const void* storage);
+std::shared_ptr<void> filter_mask_expose(const void* storage);
+
+// Returns the first set position of the packed mask in [i, n), or max(i, n) if
+// there is none. If invert is true, the unset positions are searched instead.
+inline size_t bits_find_next(const uint64_t* words, size_t i, size_t n,
+                             bool invert)
+{
+    if (i >= n)
+        return i;
+    const uint64_t skip = invert ? ~uint64_t(0) : 0;
+    while (i < n)
+    {
+        uint64_t w = (words[i >> 6] ^ skip) >> (i & 63);
+        if (w != 0)
+            return std::min(i + __builtin_ctzll(w), n);
+        i = (i | 63) + 1;
+    }
+    return n;
+}
+
+} // namespace graph_tool
+
+#endif // GRAPH_FILTER_BITS_HH
@@ -101,6 +101,15 @@ namespace detail {
 
 struct filt_graph_tag { };
 
+// The vertex iterator of the filtered graph can be replaced for specific
+// vertex predicates (see graph_filtering.hh). It must be constructible from
+// (predicate, begin, end), like filter_iterator, which is the default.
+template <class VertexPredicate, class Iterator>
+struct filt_vertex_iterator
+{
+    typedef filter_iterator<VertexPredicate, Iterator> type;
+};
+
 // This base class is a stupid hack to change overload resolution
 // rules for the source and target functions so that they are a
 // worse match than the source and target functions defined for
@@ -185,9 +194,9 @@ public:
         in_adjacency_iterator;
 
     // VertexListGraph requirements
-    typedef filter_iterator<
+    typedef typename filt_vertex_iterator<
         VertexPredicate, typename Traits::vertex_iterator
-        > vertex_iterator;
+        >::type vertex_iterator;
     typedef typename Traits::vertices_size_type        vertices_size_type;
 
     // EdgeListGraph requirements
@@ -17,6 +17,10 @@
 
 #include "graph_filtering.hh"
 #include "demangle.hh"
+#include "numpy_bind.hh"
+
+#include <atomic>
+#include <mutex>
 
 using namespace graph_tool;
 using namespace graph_tool::detail;
@@ -46,15 +50,225 @@ graph_tool::ActionNotFound::ActionNotFound(const type_info& action,
     }
 }
 
+// Packed filter masks. See graph_filter_bits.hh for details.
+//
+// The masks which have packed copies, or which are exposed to numpy, are kept
+// in the registry below, indexed by the address of their value vectors. Since
+// filtered graphs may be modified by actions which run without the GIL, it is
+// guarded by its own mutex, which is recursive because the entries remove
+// themselves from the registry when they are released.
+
+struct graph_tool::filter_mask_entry
+{
+    vector<filter_bits*> users;
+    size_t exposed = 0;
+};
+
+// (never destroyed, since graphs may outlive them at exit)
+static auto& filter_masks =
+    *new std::unordered_map<const void*, std::weak_ptr<filter_mask_entry>>();
+static auto& filter_masks_mutex = *new std::recursive_mutex();
+static std::atomic<size_t> filter_bits_version(0);
+
+static std::shared_ptr<filter_mask_entry>
+get_filter_mask(const void* storage, bool create)
+{
+    auto iter = filter_masks.find(storage);
+    if (iter != filter_masks.end())
+    {
+        auto entry = iter->second.lock();
+        if (entry != nullptr)
+            return entry;
+    }
+    if (!create)
+        return nullptr;
+    std::shared_ptr<filter_mask_entry>
+        entry(new filter_mask_entry(),
+              [storage](filter_mask_entry* e)
+              {
+                  std::lock_guard<std::recursive_mutex>
+                      lock(filter_masks_mutex);
+                  auto iter = filter_masks.find(storage);
+                  if (iter != filter_masks.end() && iter->second.expired())
+                      filter_masks.erase(iter);
+                  delete e;
+              });
+    filter_masks[storage] = entry;
+    return entry;
+}
+
+void filter_bits::attach(const void* storage)
+{
+    detach();
+    std::lock_guard<std::recursive_mutex> lock(filter_masks_mutex);
+    _entry = get_filter_mask(storage, true);
+    _entry->users.push_back(this);
+}
+
+void filter_bits::detach()
+{
+    std::lock_guard<std::recursive_mutex> lock(filter_masks_mutex);
+    if (_entry)
+    {
+        auto& users = _entry->users;
+        users.erase(std::remove(users.begin(), users.end(), this),
+                    users.end());
+        _entry.reset();
+    }
+    deactivate();
+    vector<uint64_t>().swap(_words);
+    _size = _count = 0;
+}
+
+void filter_bits::sync(const uint8_t* mask, size_t n, size_t holders)
+{
+    std::lock_guard<std::recursive_mutex> lock(filter_masks_mutex);
+    if (!_entry)
+        return;
+
+    // the value vector is referenced by each graph which uses it as a filter,
+    // and by the PythonPropertyMap which owns it; any other reference may be
+    // used to modify it behind our back
+    if (_entry->exposed > 0 || holders > _entry->users.size() + 1)
+    {
+        deactivate();
+        return;
+    }
+
+    if (!is_active())
+    {
+        pack(mask, n);
+        _active.store(true, std::memory_order_release);
+    }
+    else if (n != _size)
+    {
+        // entries which were added since are all zero, since they were not
+        // written to by any untracked means
+        resize(n);
+    }
+}
+
+void filter_bits::set(size_t i, bool val)
+{
+    if (!_active)
+        return;
+    if (i >= _size)
+        resize(i + 1);
+    uint64_t& w = _words[i >> 6];
+    uint64_t b = uint64_t(1) << (i & 63);
+    if (bool(w & b) == val)
+        return;
+    w ^= b;
+    if (val)
+        ++_count;
+    else
+        --_count;
+    _version = ++filter_bits_version;
+}
+
+void filter_bits::pack(const uint8_t* mask, size_t n)
+{
+    _words.assign((n + 63) / 64, 0);
+    size_t i = 0;
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    for (; i + 8 <= n; i += 8)
+    {
+        uint64_t w;
+        memcpy(&w, mask + i, sizeof(w));
+        // reduce each byte to its lowest bit, and gather these bits in the
+        // highest byte
+        w |= w >> 4;
+        w |= w >> 2;
+        w |= w >> 1;
+        w &= 0x0101010101010101ULL;
+        _words[i >> 6] |= ((w * 0x0102040810204080ULL) >> 56) << (i & 63);
+    }
+#endif
+    for (; i < n; ++i)
+    {
+        if (mask[i])
+            _words[i >> 6] |= uint64_t(1) << (i & 63);
+    }
+    _count = 0;
+    for (auto w : _words)
+        _count += __builtin_popcountll(w);
+    _size = n;
+    _version = ++filter_bits_version;
+}
+
+void filter_bits::resize(size_t n)
+{
+    size_t nw = (n + 63) / 64;
+    if (n < _size)
+    {
+        for (size_t j = nw; j < _words.size(); ++j)
+            _count -= __builtin_popcountll(_words[j]);
+        _words.resize(nw);
+        if (n & 63)
+        {
+            uint64_t keep = (uint64_t(1) << (n & 63)) - 1;
+            _count -= __builtin_popcountll(_words.back() & ~keep);
+            _words.back() &= keep;
+        }
+    }
+    else
+    {
+        _words.resize(nw, 0);
+    }
+    _size = n;
+    _version = ++filter_bits_version;
+}
+
+void graph_tool::filter_mask_set(const void* storage, size_t i, bool val)
+{
+    std::lock_guard<std::recursive_mutex> lock(filter_masks_mutex);
+    if (filter_masks.empty())
+        return;
+    auto entry = get_filter_mask(storage, false);
+    if (entry == nullptr)
+        return;
+    for (auto bits : entry->users)
+        bits->set(i, val);
+}
+
+void graph_tool::filter_mask_touch(const void* storage)
+{
+    std::lock_guard<std::recursive_mutex> lock(filter_masks_mutex);
+    if (filter_masks.empty())
+        return;
+    auto entry = get_filter_mask(storage, false);
+    if (entry == nullptr)
+        return;
+    for (auto bits : entry->users)
+        bits->deactivate();
+}
+
+std::shared_ptr<void> graph_tool::filter_mask_expose(const void* storage)
+{
+    std::lock_guard<std::recursive_mutex> lock(filter_masks_mutex);
+    auto entry = get_filter_mask(storage, true);
+    ++entry->exposed;
+    for (auto bits : entry->users)
+        bits->deactivate();
+    return std::shared_ptr<void>(nullptr,
+                                 [entry](void*)
+                                 {
+                                     std::lock_guard<std::recursive_mutex>
+                                         lock(filter_masks_mutex);
+                                     --entry->exposed;
+                                 });
+}
+
 
 // this will check whether a graph is filtered and return the proper view
 // encapsulated
 template <class Graph, class EdgeFilter, class VertexFilter>
 boost::any
 check_filtered(const Graph& g, const EdgeFilter& edge_filter,
-               const bool& e_invert, bool e_active, size_t max_eindex,
-               const VertexFilter& vertex_filter, const bool& v_invert,
-               bool v_active, GraphInterface& gi, bool reverse, bool directed)
+               const bool& e_invert, const filter_bits& e_bits, bool e_active,
+               size_t max_eindex, const VertexFilter& vertex_filter,
+               const bool& v_invert, const filter_bits& v_bits, bool v_active,
+               GraphInterface& gi, bool reverse, bool directed)
 {
 
     auto check_filt = [&](auto&& u) -> boost::any
@@ -65,10 +279,10 @@ check_filtered(const Graph& g, const EdgeFilter& edge_filter,
             {
                 MaskFilter<EdgeFilter>
                     e_filter(const_cast<EdgeFilter&>(edge_filter),
-                             const_cast<bool&>(e_invert));
+                             const_cast<bool&>(e_invert), &e_bits);
                 MaskFilter<VertexFilter>
                     v_filter(const_cast<VertexFilter&>(vertex_filter),
-                             const_cast<bool&>(v_invert));
+                             const_cast<bool&>(v_invert), &v_bits);
                 if (max_eindex > 0)
                     edge_filter.reserve(max_eindex);
                 if (num_vertices(g) > 0)
@@ -120,18 +334,99 @@ check_filtered(const Graph& g, const EdgeFilter& edge_filter,
 }
 
 // gets the correct graph view at run time
-boost::any GraphInterface::get_graph_view() const
+boost::any GraphInterface::get_graph_view(bool frozen) const
 {
+    const_cast<GraphInterface&>(*this).sync_filter_bits();
+    if (frozen && is_frozen())
+    {
+        // the snapshot is taken again if the graph was modified by an
+        // algorithm which does not use it
+        if (_fg->get_stamp() != _mg->get_stamp())
+            const_cast<GraphInterface&>(*this).freeze();
+        return check_filtered(*_fg, _edge_filter_map, _edge_filter_invert,
+                              _edge_filter_bits, _edge_filter_active,
+                              _fg->get_edge_index_range(), _vertex_filter_map,
+                              _vertex_filter_invert, _vertex_filter_bits,
+                              _vertex_filter_active,
+                              const_cast<GraphInterface&>(*this), _reversed,
+                              _directed);
+    }
     boost::any graph =
         check_filtered(*_mg, _edge_filter_map, _edge_filter_invert,
-                       _edge_filter_active, _mg->get_edge_index_range(),
-                       _vertex_filter_map, _vertex_filter_invert,
+                       _edge_filter_bits, _edge_filter_active,
+                       _mg->get_edge_index_range(), _vertex_filter_map,
+                       _vertex_filter_invert, _vertex_filter_bits,
                        _vertex_filter_active,
                        const_cast<GraphInterface&>(*this), _reversed,
                        _directed);
     return graph;
 }
 
+// this brings the packed copies of the active filter masks up to date (if
+// possible), after making sure that the masks cover the whole graph. See
+// graph_filter_bits.hh for details.
+void GraphInterface::sync_filter_bits()
+{
+    if (_vertex_filter_active)
+    {
+        _vertex_filter_map.reserve(num_vertices(*_mg));
+        auto& vmask = _vertex_filter_map.get_storage();
+        _vertex_filter_bits.sync(vmask.data(), vmask.size(),
+                                 _vertex_filter_map.get_storage_ptr()
+                                 .use_count());
+    }
+    if (_edge_filter_active)
+    {
+        _edge_filter_map.reserve(_mg->get_edge_index_range());
+        auto& emask = _edge_filter_map.get_storage();
+        _edge_filter_bits.sync(emask.data(), emask.size(),
+                               _edge_filter_map.get_storage_ptr().use_count());
+    }
+}
+
+// this drops all cached graph views which are built on top of the frozen
+// snapshot, so that they are not reused after it is replaced
+struct clear_frozen_views
+{
+    clear_frozen_views(vector<boost::any>& graph_views)
+        : _graph_views(graph_views) {}
+
+    template <class Graph>
+    void operator()(Graph*) const
+    {
+        if (!std::is_same<typename base_graph<Graph>::type,
+                          GraphInterface::frozen_graph_t>::value)
+            return;
+        size_t index = boost::mpl::find<frozen_graph_views,Graph>::type::pos::value;
+        if (index < _graph_views.size())
+            _graph_views[index] = boost::any();
+    }
+
+    vector<boost::any>& _graph_views;
+};
+
+// builds an immutable compressed-sparse-row snapshot of the graph, which is
+// used by the algorithms dispatched over frozen_graph_views until thaw() is
+// called
+void GraphInterface::freeze()
+{
+    _fg = std::make_shared<frozen_graph_t>(*_mg);
+    boost::mpl::for_each<frozen_graph_views,
+                         std::add_pointer<boost::mpl::_1>>
+        (clear_frozen_views(_graph_views));
+}
+
+// discards the frozen snapshot, re-enabling modifications
+void GraphInterface::thaw()
+{
+    if (!is_frozen())
+        return;
+    _fg.reset();
+    boost::mpl::for_each<frozen_graph_views,
+                         std::add_pointer<boost::mpl::_1>>
+        (clear_frozen_views(_graph_views));
+}
+
 // these test whether or not the vertex and edge filters are active
 bool GraphInterface::is_vertex_filter_active() const
 { return _vertex_filter_active; }
@@ -144,6 +439,7 @@ bool GraphInterface::is_edge_filter_active() const
 // found
 void GraphInterface::re_index_edges()
 {
+    check_thawed();
     _mg->reindex_edges();
 }
 
@@ -153,6 +449,7 @@ void GraphInterface::purge_edges()
 {
     if (!is_edge_filter_active())
         return;
+    check_thawed();
 
     MaskFilter<edge_filter_t> filter(_edge_filter_map, _edge_filter_invert);
     vector<graph_traits<multigraph_t>::edge_descriptor> deleted_edges;
@@ -174,6 +471,7 @@ void GraphInterface::purge_vertices(boost::any aold_index)
 {
     if (!is_vertex_filter_active())
         return;
+    check_thawed();
 
     typedef vprop_map_t<int64_t>::type index_prop_t;
     index_prop_t old_index = any_cast<index_prop_t>(aold_index);
@@ -200,6 +498,326 @@ void GraphInterface::purge_vertices(boost::any aold_index)
         old_index[vertex((N - 1) - i, *_mg)] = old_indexes[i];
 }
 
+// fingerprint of the graph structure, of the directedness and reversal of the
+// view, and of the filter masks, which changes whenever the filtered view
+// might have changed, and can be used to validate data derived from the view.
+// The masks are only scanned if their packed copies are not in use.
+size_t GraphInterface::get_view_stamp()
+{
+    sync_filter_bits();
+    size_t h = _mg->get_stamp();
+    auto combine = [&](size_t x)
+        {
+            h ^= std::hash<size_t>()(x) + 0x9e3779b97f4a7c15 + (h << 6) +
+                (h >> 2);
+        };
+    auto combine_mask = [&](const auto& mask, const filter_bits& bits,
+                            size_t n)
+        {
+            if (bits.is_active())
+            {
+                combine(bits.get_version());
+                return;
+            }
+            n = std::min(n, mask.size());
+            uint64_t mh = 0xcbf29ce484222325;
+            size_t i = 0;
+            for (; i + 8 <= n; i += 8)
+            {
+                uint64_t w;
+                memcpy(&w, mask.data() + i, sizeof(w));
+                mh = (mh ^ w) * 0x100000001b3;
+            }
+            for (; i < n; ++i)
+                mh = (mh ^ mask[i]) * 0x100000001b3;
+            combine(mh);
+        };
+    combine(get_directed());
+    combine(get_reversed());
+    combine(is_vertex_filter_active());
+    if (is_vertex_filter_active())
+    {
+        combine(_vertex_filter_invert);
+        combine_mask(_vertex_filter_map.get_storage(), _vertex_filter_bits,
+                     num_vertices(*_mg));
+    }
+    combine(is_edge_filter_active());
+    if (is_edge_filter_active())
+    {
+        combine(_edge_filter_invert);
+        combine_mask(_edge_filter_map.get_storage(), _edge_filter_bits,
+                     _mg->get_edge_index_range());
+    }
+    return h;
+}
+
+// this collects the vertices and edges of the current filtered view, in the
+// order of the view, and the edges of the induced subgraph in terms of the
+// positions of their endpoints in vorder
+void GraphInterface::get_view_lists(vector<int64_t>& vorder,
+                                    vector<int64_t>& eorder,
+                                    vector<pair<size_t, size_t>>& elist)
+{
+    size_t N = num_vertices(*_mg);
+    bool vactive = is_vertex_filter_active();
+    bool eactive = is_edge_filter_active();
+    auto& vmask = _vertex_filter_map.get_checked().get_storage();
+    auto& emask = _edge_filter_map.get_checked().get_storage();
+    if (vactive)
+        vmask.resize(std::max(vmask.size(), N));
+    if (eactive)
+        emask.resize(std::max(emask.size(), _mg->get_edge_index_range()));
+    bool vinv = _vertex_filter_invert;
+    bool einv = _edge_filter_invert;
+
+    vector<size_t> vindex(N);
+    for (size_t v = 0; v < N; ++v)
+    {
+        if (vactive)
+        {
+            v = mask_find_next(vmask.data(), v, N, vinv);
+            if (v == N)
+                break;
+        }
+        vindex[v] = vorder.size();
+        vorder.push_back(v);
+    }
+
+    for (auto v : vorder)
+    {
+        for (auto e : out_edges_range(size_t(v), *_mg))
+        {
+            if (eactive && !(emask[e.idx] ^ einv))
+                continue;
+            auto u = target(e, *_mg);
+            if (vactive && !(vmask[u] ^ vinv))
+                continue;
+            elist.emplace_back(vindex[v], vindex[u]);
+            eorder.push_back(e.idx);
+        }
+    }
+}
+
+// this will copy the subgraph induced by the current filters into the
+// (empty) graph dst, with the vertices and out-edges in the same relative
+// order as in the filtered view, and return the vertex and edge indexes in
+// this graph of the vertices and edges of dst
+python::tuple GraphInterface::materialize(GraphInterface& dst)
+{
+    if (num_vertices(*dst._mg) > 0)
+        throw ValueException("target graph must be empty");
+
+    vector<int64_t> vorder, eorder;
+    vector<pair<size_t, size_t>> elist;
+    get_view_lists(vorder, eorder, elist);
+
+    auto& tg = *dst._mg;
+    for (size_t i = 0; i < vorder.size(); ++i)
+        add_vertex(tg);
+    tg.add_edges(elist.size(), [&](size_t i) { return elist[i]; },
+                 [](size_t, const auto&) {});
+
+    return python::make_tuple(wrap_vector_owned(vorder),
+                              wrap_vector_owned(eorder));
+}
+
+// this returns a compact copy of the current filtered view, if it keeps at
+// most a fraction _materialize_threshold of the vertices (or of the edges, if
+// only these are filtered), or null otherwise. The copy is cached until the
+// view changes, as given by get_view_stamp().
+std::shared_ptr<materialized_view> GraphInterface::get_materialized_view()
+{
+    bool selective = false;
+    if (is_vertex_filter_active())
+        selective = (get_num_vertices() <=
+                     _materialize_threshold * num_vertices(*_mg));
+    else if (is_edge_filter_active())
+        selective = (get_num_edges() <=
+                     _materialize_threshold * num_edges(*_mg));
+    if (!selective || _materialize_threshold <= 0)
+    {
+        _materialized.reset();
+        return nullptr;
+    }
+
+    size_t stamp = get_view_stamp();
+    if (_materialized && _materialized->stamp == stamp)
+        return _materialized;
+
+    vector<int64_t> vorder, eorder;
+    vector<pair<size_t, size_t>> elist;
+    get_view_lists(vorder, eorder, elist);
+
+    multigraph_t g;
+    for (size_t i = 0; i < vorder.size(); ++i)
+        add_vertex(g);
+    g.add_edges(elist.size(), [&](size_t i) { return elist[i]; },
+                [](size_t, const auto&) {});
+    _materialized = std::make_shared<materialized_view>(g, std::move(vorder),
+                                                        std::move(eorder),
+                                                        stamp);
+    return _materialized;
+}
+
+// copies a vertex or edge property map from the original graph to the compact
+// one (if Scatter is false), or back (otherwise), where idx contains the
+// original indexes of the compact vertices or edges
+template <bool Scatter>
+struct gather_property
+{
+    template <class PropertyMap>
+    void operator()(PropertyMap*, const boost::any& prop, boost::any& mprop,
+                    const vector<int64_t>& idx, bool& found) const
+    {
+        if (found)
+            return;
+        auto* pmap = any_cast<PropertyMap>(&prop);
+        if (pmap == nullptr)
+            return;
+        found = true;
+
+        typedef typename property_traits<PropertyMap>::value_type val_t;
+        size_t n = idx.size();
+        if (!Scatter)
+            mprop = PropertyMap(n);
+        auto& vals = pmap->get_storage();
+        auto& mvals = any_cast<PropertyMap&>(mprop).get_storage();
+        if (n > 0)
+            pmap->reserve(*std::max_element(idx.begin(), idx.end()) + 1);
+
+        // python objects cannot be copied outside of the main thread
+        #pragma omp parallel for schedule(runtime) \
+            if (n > OPENMP_MIN_THRESH &&            \
+                !std::is_same<val_t, python::object>::value)
+        for (size_t i = 0; i < n; ++i)
+        {
+            if (Scatter)
+                vals[idx[i]] = mvals[i];
+            else
+                mvals[i] = vals[idx[i]];
+        }
+    }
+};
+
+boost::any materialized_view::gather(const boost::any& prop) const
+{
+    boost::any mprop;
+    bool found = false;
+    mpl::for_each<writable_vertex_properties, std::add_pointer<mpl::_1>>
+        (std::bind(gather_property<false>(), std::placeholders::_1,
+                   std::cref(prop), std::ref(mprop), std::cref(vorder),
+                   std::ref(found)));
+    mpl::for_each<writable_edge_properties, std::add_pointer<mpl::_1>>
+        (std::bind(gather_property<false>(), std::placeholders::_1,
+                   std::cref(prop), std::ref(mprop), std::cref(eorder),
+                   std::ref(found)));
+    if (!found)
+        return prop;
+    return mprop;
+}
+
+void materialized_view::scatter(const boost::any& mprop,
+                                const boost::any& prop) const
+{
+    boost::any mprop_ = mprop;
+    bool found = false;
+    mpl::for_each<writable_vertex_properties, std::add_pointer<mpl::_1>>
+        (std::bind(gather_property<true>(), std::placeholders::_1,
+                   std::cref(prop), std::ref(mprop_), std::cref(vorder),
+                   std::ref(found)));
+    mpl::for_each<writable_edge_properties, std::add_pointer<mpl::_1>>
+        (std::bind(gather_property<true>(), std::placeholders::_1,
+                   std::cref(prop), std::ref(mprop_), std::cref(eorder),
+                   std::ref(found)));
+}
+
+// this will relabel all the vertices such that vertex v becomes vmap[v]. The
+// edge indexes are not modified, and the vertex property maps need to be
+// permuted separately via permute_vertex_property()
+void GraphInterface::permute_vertices(python::object ovmap)
+{
+    check_thawed();
+    boost::multi_array_ref<int64_t,1> vmap = get_array<int64_t,1>(ovmap);
+    size_t N = num_vertices(*_mg);
+    if (vmap.size() != N)
+        throw ValueException("vertex permutation has the wrong size: " +
+                             lexical_cast<string>(vmap.size()) + " (expected " +
+                             lexical_cast<string>(N) + ")");
+    vector<vertex_t> perm(N);
+    vector<bool> seen(N, false);
+    for (size_t v = 0; v < N; ++v)
+    {
+        auto u = vmap[v];
+        if (u < 0 || size_t(u) >= N || seen[u])
+            throw ValueException("invalid vertex permutation");
+        seen[u] = true;
+        perm[v] = u;
+    }
+    _mg->permute_vertices(perm);
+}
+
+// converts an index map returned by adj_list to an int64 array, where the
+// removed entries are marked with -1
+python::object wrap_index_map(const vector<size_t>& imap, size_t null)
+{
+    vector<int64_t> ret(imap.size());
+    #pragma omp parallel for schedule(runtime) \
+        if (imap.size() > OPENMP_MIN_THRESH)
+    for (size_t i = 0; i < imap.size(); ++i)
+        ret[i] = (imap[i] == null) ? -1 : int64_t(imap[i]);
+    return wrap_vector_owned(ret);
+}
+
+// this will remove all the vertices in the given array at once, in O(V + E)
+// time, and return the mapping of the old vertex indexes to the new ones (or
+// -1 for the removed vertices). The vertex property maps need to be compacted
+// separately via compact_vertex_property()
+python::object GraphInterface::remove_vertices(python::object ovs)
+{
+    check_thawed();
+    boost::multi_array_ref<int64_t,1> vs = get_array<int64_t,1>(ovs);
+    size_t N = num_vertices(*_mg);
+    vector<uint8_t> removed(N, false);
+    for (auto v : vs)
+    {
+        if (v < 0 || size_t(v) >= N)
+            throw ValueException("invalid vertex index: " +
+                                 lexical_cast<string>(v));
+        removed[v] = true;
+    }
+    auto vmap = _mg->remove_vertices(removed);
+    return wrap_index_map(vmap, multigraph_t::null_index());
+}
+
+// this will remove all the edges with the given indexes at once, in O(V + E)
+// time. The edge indexes of the remaining edges are not modified.
+void GraphInterface::remove_edges(python::object oes)
+{
+    check_thawed();
+    boost::multi_array_ref<int64_t,1> es = get_array<int64_t,1>(oes);
+    size_t E = _mg->get_edge_index_range();
+    vector<uint8_t> removed(E, false);
+    for (auto idx : es)
+    {
+        if (idx < 0 || size_t(idx) >= E)
+            throw ValueException("invalid edge index: " +
+                                 lexical_cast<string>(idx));
+        removed[idx] = true;
+    }
+    _mg->remove_edges(removed);
+}
+
+// this will relabel the edge indexes such that they become contiguous, while
+// keeping their order, and return the mapping of the old indexes to the new
+// ones (or -1 for the unused ones). The edge property maps need to be
+// compacted separately via compact_edge_property()
+python::object GraphInterface::compact_edge_indexes()
+{
+    check_thawed();
+    auto emap = _mg->compact_edge_indexes();
+    return wrap_index_map(emap, multigraph_t::null_index());
+}
+
 void GraphInterface::set_vertex_filter_property(boost::any property, bool invert)
 {
     try
@@ -208,12 +826,14 @@ void GraphInterface::set_vertex_filter_property(boost::any property, bool invert
             any_cast<vertex_filter_t::checked_t>(property).get_unchecked();
         _vertex_filter_invert = invert;
         _vertex_filter_active = true;
+        _vertex_filter_bits.attach(&_vertex_filter_map.get_storage());
     }
     catch(bad_any_cast&)
     {
         if (!property.empty())
             throw GraphException("Invalid vertex filter property!");
         _vertex_filter_active = false;
+        _vertex_filter_bits.detach();
     }
 }
 
@@ -225,11 +845,13 @@ void GraphInterface::set_edge_filter_property(boost::any property, bool invert)
             any_cast<edge_filter_t::checked_t>(property).get_unchecked();
         _edge_filter_invert = invert;
         _edge_filter_active = true;
+        _edge_filter_bits.attach(&_edge_filter_map.get_storage());
     }
     catch(bad_any_cast&)
     {
         if (!property.empty())
             throw GraphException("Invalid edge filter property!");
         _edge_filter_active = false;
+        _edge_filter_bits.detach();
     }
 }
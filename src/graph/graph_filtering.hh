@@ -31,6 +31,7 @@
 #include <boost/mpl/if.hpp>
 #include <boost/mpl/logical.hpp>
 #include <boost/mpl/inserter.hpp>
+#include <boost/mpl/contains.hpp>
 #include <boost/mpl/insert_range.hpp>
 #include <boost/mpl/assert.hpp>
 #include <boost/mpl/plus.hpp>
@@ -51,6 +52,9 @@
 #include "mpl_nested_loop.hh"
 
 #include <type_traits>
+#include <tuple>
+#include <cstring>
+#include <boost/iterator/iterator_adaptor.hpp>
 
 namespace graph_tool
 {
@@ -127,7 +131,8 @@ namespace detail
 // The class MaskFilter below is the main filter predicate for the filtered
 // graph view, based on descriptor property maps.  It filters out edges or
 // vertices which are masked according to a property map with bool (actually
-// uint8_t) value type.
+// uint8_t) value type. If given, the packed copy of the mask is tested
+// instead, while it is active (see graph_filter_bits.hh).
 
 template <class DescriptorProperty>
 class MaskFilter
@@ -135,14 +140,19 @@ class MaskFilter
 public:
     typedef typename boost::property_traits<DescriptorProperty>::value_type value_t;
     MaskFilter(){}
-    MaskFilter(DescriptorProperty& filtered_property, bool& invert)
-        : _filtered_property(&filtered_property), _invert(&invert) {}
+    MaskFilter(DescriptorProperty& filtered_property, bool& invert,
+               const filter_bits* bits = nullptr)
+        : _filtered_property(&filtered_property), _invert(&invert),
+          _bits(bits) {}
 
     template <class Descriptor>
     inline bool operator() (Descriptor&& d) const
     {
         // ignore if masked
 
+        if (_bits != nullptr && _bits->is_active())
+            return _bits->test(get(_filtered_property->get_index_map(), d)) ^
+                *_invert;
         return get(*_filtered_property, std::forward<Descriptor>(d)) ^ *_invert;
 
         // This is a critical section. It will be called for every vertex or
@@ -150,12 +160,160 @@ public:
     }
 
     DescriptorProperty& get_filter() { return *_filtered_property; }
-    bool is_inverted() { return *_invert; }
+    const DescriptorProperty& get_filter() const { return *_filtered_property; }
+    bool is_inverted() const { return *_invert; }
+
+    // the packed copy of the mask, if it is in use, or null otherwise
+    const filter_bits* get_bits() const
+    {
+        if (_bits != nullptr && _bits->is_active())
+            return _bits;
+        return nullptr;
+    }
 
 private:
     DescriptorProperty* _filtered_property;
     bool* _invert;
+    const filter_bits* _bits = nullptr;
+};
+
+// The functions below scan a filter mask eight entries at a time, so that
+// long masked-out stretches (as in views which keep only a small fraction of
+// the graph) are skipped quickly. An entry is kept if mask[i] ^ invert is
+// nonzero, as in MaskFilter.
+
+// Returns the first kept position in [i, n), or max(i, n) if there is none.
+inline size_t mask_find_next(const uint8_t* mask, size_t i, size_t n,
+                             bool invert)
+{
+    const uint64_t skip = invert ? 0x0101010101010101ULL : 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        uint64_t w;
+        memcpy(&w, mask + i, sizeof(w));
+        w ^= skip;
+        if (w == 0)
+            continue;
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        return i + __builtin_ctzll(w) / 8;
+#else
+        break;
+#endif
+    }
+    for (; i < n; ++i)
+    {
+        if (mask[i] ^ invert)
+            return i;
+    }
+    return i;
+}
+
+// Returns the number of kept positions in [0, n).
+inline size_t mask_count(const uint8_t* mask, size_t n, bool invert)
+{
+    const uint64_t skip = invert ? 0x0101010101010101ULL : 0;
+    size_t count = 0;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        uint64_t w;
+        memcpy(&w, mask + i, sizeof(w));
+        w ^= skip;
+        // reduce each byte to its lowest bit, which is set if it is nonzero
+        w |= w >> 4;
+        w |= w >> 2;
+        w |= w >> 1;
+        count += __builtin_popcountll(w & 0x0101010101010101ULL);
+    }
+    for (; i < n; ++i)
+    {
+        if (mask[i] ^ invert)
+            ++count;
+    }
+    return count;
+}
+
+// Vertex iterator of the filtered graphs based on MaskFilter, equivalent to
+// filter_iterator, but which uses bits_find_next() or mask_find_next() to jump
+// to the next kept vertex. It relies on the vertex descriptors being the vertex
+// indexes, and on the underlying vertex iterator being random access.
+template <class DescriptorProperty, class Iterator>
+class mask_vertex_iterator
+    : public boost::iterator_adaptor<mask_vertex_iterator<DescriptorProperty,
+                                                          Iterator>,
+                                     Iterator, boost::use_default,
+                                     boost::forward_traversal_tag>
+{
+public:
+    mask_vertex_iterator() {}
+    mask_vertex_iterator(const MaskFilter<DescriptorProperty>& pred,
+                         Iterator begin, Iterator end)
+        : mask_vertex_iterator::iterator_adaptor_(begin), _pred(pred),
+          _end(end)
+    {
+        satisfy();
+    }
+
+private:
+    friend class boost::iterator_core_access;
+
+    void increment()
+    {
+        ++this->base_reference();
+        satisfy();
+    }
+
+    void satisfy()
+    {
+        auto& iter = this->base_reference();
+        if (iter == _end)
+            return;
+        size_t i = *iter;
+        size_t n = i + (_end - iter);
+        size_t m, j;
+        auto bits = _pred.get_bits();
+        if (bits != nullptr)
+        {
+            m = std::min(n, bits->size());
+            j = bits_find_next(bits->data(), i, m, _pred.is_inverted());
+        }
+        else
+        {
+            auto& mask = _pred.get_filter().get_storage();
+            m = std::min(n, mask.size());
+            j = mask_find_next(mask.data(), i, m, _pred.is_inverted());
+        }
+        iter += j - i;
+        if (j < m)
+            return;
+
+        // the mask does not cover the remaining vertices
+        while (iter != _end && !_pred(*iter))
+            ++iter;
+    }
+
+    MaskFilter<DescriptorProperty> _pred;
+    Iterator _end;
+};
+
+} // namespace detail
+} // namespace graph_tool
+
+namespace boost
+{
+template <class DescriptorProperty, class Iterator>
+struct filt_vertex_iterator<graph_tool::detail::MaskFilter<DescriptorProperty>,
+                            Iterator>
+{
+    typedef graph_tool::detail::mask_vertex_iterator<DescriptorProperty,
+                                                     Iterator> type;
 };
+} // namespace boost
+
+namespace graph_tool
+{
+namespace detail
+{
 
 
 // Metaprogramming
@@ -271,12 +429,17 @@ struct get_all_graph_views
               class NeverDirected = boost::mpl::bool_<false>,
               class AlwaysReversed = boost::mpl::bool_<false>,
               class NeverReversed = boost::mpl::bool_<false>,
-              class NeverFiltered = boost::mpl::bool_<false> >
+              class NeverFiltered = boost::mpl::bool_<false>,
+              class WithFrozen = boost::mpl::bool_<false> >
     struct apply
     {
 
         struct base_graphs:
-            boost::mpl::vector1<GraphInterface::multigraph_t> {};
+            boost::mpl::if_<WithFrozen,
+                            boost::mpl::vector2<GraphInterface::multigraph_t,
+                                                GraphInterface::frozen_graph_t>,
+                            boost::mpl::vector1<GraphInterface::multigraph_t>
+                            >::type {};
 
         // reversed graphs
         struct reversed_graphs:
@@ -365,9 +528,28 @@ struct never_filtered_never_reversed:
                                boost::mpl::bool_<false>,boost::mpl::bool_<false>,
                                boost::mpl::bool_<true>,boost::mpl::bool_<true> >::type {};
 
+// all graph views, plus the ones built on top of the frozen snapshot. Since
+// this doubles the number of instantiations, it is only used by the read-only
+// algorithms which traverse the graph many times, and thus benefit from the
+// contiguous adjacency. All other algorithms see the underlying multigraph_t,
+// which remains valid while the graph is frozen.
+struct frozen_graph_views:
+    get_all_graph_views::apply<filt_scalar_type,boost::mpl::bool_<false>,
+                               boost::mpl::bool_<false>,boost::mpl::bool_<false>,
+                               boost::mpl::bool_<false>,boost::mpl::bool_<false>,
+                               boost::mpl::bool_<true> >::type {};
+
+struct frozen_never_directed:
+    get_all_graph_views::apply<filt_scalar_type,boost::mpl::bool_<false>,
+                               boost::mpl::bool_<true>,boost::mpl::bool_<false>,
+                               boost::mpl::bool_<false>,boost::mpl::bool_<false>,
+                               boost::mpl::bool_<true> >::type {};
+
 // sanity check
 typedef boost::mpl::size<all_graph_views>::type n_views;
 BOOST_MPL_ASSERT_RELATION(n_views::value, == , boost::mpl::int_<6>::value);
+typedef boost::mpl::size<frozen_graph_views>::type n_frozen_views;
+BOOST_MPL_ASSERT_RELATION(n_frozen_views::value, == , boost::mpl::int_<12>::value);
 
 // run_action() and gt_dispatch() implementation
 // =============================================
@@ -377,7 +559,8 @@ BOOST_MPL_ASSERT_RELATION(n_views::value, == , boost::mpl::int_<6>::value);
 template <class Action, class Wrap>
 struct action_wrap
 {
-    action_wrap(Action a) : _a(a) {}
+    action_wrap(Action a, bool gil_release)
+        : _a(a), _gil_release(gil_release) {}
 
     template <class Type, class IndexMap>
     auto& uncheck(boost::checked_vector_property_map<Type,IndexMap>& a,
@@ -408,8 +591,8 @@ struct action_wrap
     auto& deference(Type* a) const
     {
         typedef typename std::remove_const<Type>::type type_t;
-        typedef typename boost::mpl::find<detail::all_graph_views, type_t>::type iter_t;
-        typedef typename boost::mpl::end<detail::all_graph_views>::type end_t;
+        typedef typename boost::mpl::find<detail::frozen_graph_views, type_t>::type iter_t;
+        typedef typename boost::mpl::end<detail::frozen_graph_views>::type end_t;
         return deference_dispatch(a, typename std::is_same<iter_t, end_t>::type());
     }
 
@@ -434,10 +617,12 @@ struct action_wrap
     template <class... Ts>
     void operator()(Ts&&... as) const
     {
+        GILRelease gil_release(_gil_release);
         _a(deference(uncheck(std::forward<Ts>(as), Wrap()))...);
     }
 
     Action _a;
+    bool _gil_release;
 };
 
 // this takes a functor and type ranges and iterates through the type
@@ -446,7 +631,7 @@ struct action_wrap
 template <class Action, class Wrap, class... TRS>
 struct action_dispatch
 {
-    action_dispatch(Action a) : _a(a) {}
+    action_dispatch(Action a, bool gil_release) : _a(a, gil_release) {}
 
     template <class... Args>
     void operator()(Args&&... args) const
@@ -465,30 +650,138 @@ struct action_dispatch
 
 } // details namespace
 
+// Compact copy of a filtered view which keeps only a small fraction of the
+// graph (see GraphInterface::get_materialized_view()). The remaining vertices
+// and edges are renumbered contiguously, in the order of the view, into an
+// immutable snapshot, which run_action() can pass to the action instead of the
+// filtered view.
+struct materialized_view
+{
+    typedef GraphInterface::frozen_graph_t graph_t;
+
+    materialized_view(const GraphInterface::multigraph_t& g,
+                      std::vector<int64_t> vorder, std::vector<int64_t> eorder,
+                      size_t stamp)
+        : g(g), rg(this->g), ug(this->g), vorder(std::move(vorder)),
+          eorder(std::move(eorder)), stamp(stamp) {}
+
+    boost::any get_view(bool reversed, bool directed)
+    {
+        if (!directed)
+            return std::ref(ug);
+        if (reversed)
+            return std::ref(rg);
+        return std::ref(g);
+    }
+
+    // returns a compact copy of a vertex or edge property map of the original
+    // graph, or the argument itself if it is not one
+    boost::any gather(const boost::any& prop) const;
+
+    // copies the values of a map returned by gather() back to the original one
+    void scatter(const boost::any& mprop, const boost::any& prop) const;
+
+    graph_t g;
+    boost::reversed_graph<graph_t> rg;
+    boost::undirected_adaptor<graph_t> ug;
+    std::vector<int64_t> vorder; // original indexes of the vertices
+    std::vector<int64_t> eorder; // original indexes of the edges
+    size_t stamp;                // see GraphInterface::get_view_stamp()
+};
+
 // dispatch "Action" across all type combinations
+//
+// If gil_release is true, the GIL is released while the action runs (but not
+// during the type dispatch), so that other python threads are not blocked.
+// This should only be used for actions that do not touch python objects, or
+// that re-acquire the GIL with GILAcquire before doing so.
+//
+// The frozen snapshot is only passed to the action if GraphViews includes its
+// views (e.g. frozen_graph_views or frozen_never_directed).
+//
+// If materialize is true (which requires the frozen views), and the filters
+// keep only a small fraction of the graph, the action runs instead on the
+// cached compact copy of the view returned by
+// GraphInterface::get_materialized_view(). The vertex and edge property maps
+// passed as arguments are gathered into maps of the compact graph before, and
+// scattered back after the action. This should only be used for actions that
+// do not modify the graph, and which receive all their vertex and edge data as
+// such arguments.
+//
+// Thread safety: the graph view is selected while the GIL is still held. If
+// the action runs on the frozen snapshot, a reference to it and to its cached
+// views is kept until the action returns, so that another thread may call
+// freeze() or thaw() in the meantime; the action will simply finish on the
+// old snapshot. The mutable adjacency list is not protected in this way: the
+// graph must not be modified by other threads while a GIL-releasing action
+// runs on it.
 template <class GraphViews = detail::all_graph_views, class Wrap = boost::mpl::false_>
 struct run_action
 {
+    run_action(bool gil_release = false, bool materialize = false)
+        : _gil_release(gil_release), _materialize(materialize) {}
+
     template <class Action, class... TRS>
     auto operator()(GraphInterface& gi, Action a, TRS...)
     {
-        auto dispatch = detail::action_dispatch<Action,Wrap,GraphViews,TRS...>(a);
-        auto wrap = [dispatch, &gi](auto&&... args) { dispatch(gi.get_graph_view(), args...); };
+        auto dispatch =
+            detail::action_dispatch<Action,Wrap,GraphViews,TRS...>(a, _gil_release);
+        auto wrap = [dispatch, &gi, materialize = _materialize](auto&&... args)
+            {
+                if constexpr (frozen)
+                {
+                    std::shared_ptr<materialized_view> mv;
+                    if (materialize)
+                        mv = gi.get_materialized_view();
+                    if (mv)
+                    {
+                        auto margs = std::make_tuple(mv->gather(args)...);
+                        std::apply([&](auto&... mas)
+                                   {
+                                       dispatch(mv->get_view(gi.get_reversed(),
+                                                             gi.get_directed()),
+                                                mas...);
+                                       (mv->scatter(mas, args), ...);
+                                   }, margs);
+                        return;
+                    }
+                }
+                auto gview = gi.get_graph_view(frozen);
+                auto fg = gi.get_frozen_graph_ptr();
+                std::vector<boost::any> views;
+                if (frozen && fg)
+                    views = gi.get_graph_views();
+                dispatch(gview, args...);
+            };
         return wrap;
     }
+
+    static constexpr bool frozen =
+        boost::mpl::contains<GraphViews, GraphInterface::frozen_graph_t>::value ||
+        boost::mpl::contains<GraphViews,
+                             boost::undirected_adaptor<GraphInterface::frozen_graph_t>>::value;
+
+    bool _gil_release;
+    bool _materialize;
 };
 
 template <class Wrap = boost::mpl::false_>
 struct gt_dispatch
 {
+    gt_dispatch(bool gil_release = false) : _gil_release(gil_release) {}
+
     template <class Action, class... TRS>
     auto operator()(Action a, TRS...)
     {
-        return detail::action_dispatch<Action,Wrap,TRS...>(a);
+        return detail::action_dispatch<Action,Wrap,TRS...>(a, _gil_release);
     }
+
+    bool _gil_release;
 };
 
 typedef detail::all_graph_views all_graph_views;
+typedef detail::frozen_graph_views frozen_graph_views;
+typedef detail::frozen_never_directed frozen_never_directed;
 typedef detail::always_directed always_directed;
 typedef detail::never_directed never_directed;
 typedef detail::always_reversed always_reversed;
@@ -501,10 +794,22 @@ typedef detail::never_filtered_never_reversed never_filtered_never_reversed;
 bool graph_filtering_enabled();
 
 
+inline std::shared_ptr<GraphInterface::multigraph_t>
+get_base_graph_ptr(GraphInterface& gi, std::true_type)
+{
+    return gi.get_graph_ptr();
+}
+
+inline std::shared_ptr<GraphInterface::frozen_graph_t>
+get_base_graph_ptr(GraphInterface& gi, std::false_type)
+{
+    return gi.get_frozen_graph_ptr();
+}
+
 template <class Graph, class GraphInit>
 std::shared_ptr<Graph> get_graph_ptr(GraphInterface& gi, GraphInit&, std::true_type)
 {
-    return gi.get_graph_ptr();
+    return get_base_graph_ptr(gi, std::is_same<Graph, GraphInterface::multigraph_t>());
 }
 
 template <class Graph, class GraphInit>
@@ -513,6 +818,37 @@ std::shared_ptr<Graph> get_graph_ptr(GraphInterface&, GraphInit& g, std::false_t
     return std::make_shared<Graph>(g);
 }
 
+// this metafunction returns the underlying adjacency type of a graph view
+template <class Graph>
+struct base_graph
+{
+    typedef Graph type;
+};
+
+template <class Graph>
+struct base_graph<boost::reversed_graph<Graph>>
+{
+    typedef typename base_graph<typename std::remove_const<Graph>::type>::type type;
+};
+
+template <class Graph>
+struct base_graph<boost::undirected_adaptor<Graph>>
+{
+    typedef typename base_graph<typename std::remove_const<Graph>::type>::type type;
+};
+
+template <class Graph, class EdgePredicate, class VertexPredicate>
+struct base_graph<boost::filt_graph<Graph, EdgePredicate, VertexPredicate>>
+{
+    typedef typename base_graph<typename std::remove_const<Graph>::type>::type type;
+};
+
+template <class Graph>
+struct is_base_graph:
+    std::integral_constant<bool,
+                           std::is_same<Graph, GraphInterface::multigraph_t>::value ||
+                           std::is_same<Graph, GraphInterface::frozen_graph_t>::value> {};
+
 // this function retrieves a graph view stored in graph_views, or stores one if
 // non-existent
 template <class Graph>
@@ -520,7 +856,7 @@ typename std::shared_ptr<Graph>
 retrieve_graph_view(GraphInterface& gi, Graph& init)
 {
     typedef typename std::remove_const<Graph>::type g_t;
-    size_t index = boost::mpl::find<detail::all_graph_views,g_t>::type::pos::value;
+    size_t index = boost::mpl::find<detail::frozen_graph_views,g_t>::type::pos::value;
     auto& graph_views = gi.get_graph_views();
     if (index >= graph_views.size())
         graph_views.resize(index + 1);
@@ -529,8 +865,7 @@ retrieve_graph_view(GraphInterface& gi, Graph& init)
     if (gptr == 0)
     {
         std::shared_ptr<g_t> new_g =
-            get_graph_ptr<g_t>(gi, init,
-                               std::is_same<g_t, GraphInterface::multigraph_t>());
+            get_graph_ptr<g_t>(gi, init, is_base_graph<g_t>());
         gview = new_g;
         return new_g;
     }
@@ -554,6 +889,7 @@ add_vertex(boost::filt_graph<Graph,
     auto& filt = g._vertex_pred.get_filter();
     auto cfilt = filt.get_checked();
     cfilt[v] = !g._vertex_pred.is_inverted();
+    graph_tool::filter_mask_set(&filt.get_storage(), v, cfilt[v]);
     return v;
 }
 
@@ -567,6 +903,9 @@ add_edge(Vertex s, Vertex t, filt_graph<Graph,
     auto& filt = g._edge_pred.get_filter();
     auto cfilt = filt.get_checked();
     cfilt[e.first] = !g._edge_pred.is_inverted();
+    graph_tool::filter_mask_set(&filt.get_storage(),
+                                get(filt.get_index_map(), e.first),
+                                cfilt[e.first]);
     return e;
 }
 
@@ -16,14 +16,17 @@
 // along with this program. If not, see <http://www.gnu.org/licenses/>.
 
 #include <boost/python/extract.hpp>
+#include <boost/python/stl_iterator.hpp>
 
 #include <iostream>
+#include <sys/stat.h>
 #include <boost/iostreams/categories.hpp>
 #include <boost/iostreams/filtering_stream.hpp>
 #include <boost/iostreams/filter/gzip.hpp>
 #include <boost/iostreams/filter/bzip2.hpp>
 #include <boost/iostreams/device/file_descriptor.hpp>
 #include <boost/iostreams/device/file.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
 #include <boost/graph/graphml.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/xpressive/xpressive.hpp>
@@ -36,8 +39,6 @@
 #include "graph_python_interface.hh"
 #include "str_repr.hh"
 
-#include "gml.hh"
-
 using namespace std;
 using namespace boost;
 using namespace graph_tool;
@@ -92,6 +93,10 @@ std::ostringstream& operator<<(std::ostringstream& stream, const boost::python::
 #include <boost/graph/graphviz.hpp>
 
 #include "graph_io_binary.hh"
+#include "graph_io_gzip.hh"
+#include "graph_io_csv.hh"
+#include "graph_io_graphml.hh"
+#include "gml.hh"
 
 // the following source & sink provide iostream access to python file-like
 // objects
@@ -279,6 +284,19 @@ struct create_dynamic_map
 // read_from_file(file, pfile, format)
 //==============================================================================
 
+// uncompressed (or gzip-compressed in chunks, see graph_io_gzip.hh) regular
+// files are read directly from memory, instead of through a stream
+bool is_mappable(const string& file, boost::python::object& pfile)
+{
+    if (file == "-" || pfile != boost::python::object() ||
+        boost::ends_with(file, ".bz2"))
+        return false;
+    struct stat st;
+    if (stat(file.c_str(), &st) != 0)
+        return false;
+    return S_ISREG(st.st_mode) && st.st_size > 0;
+}
+
 void build_stream(boost::iostreams::filtering_stream<boost::iostreams::input>& stream,
                   const string& file, boost::python::object& pfile,
                   std::ifstream& file_stream)
@@ -288,7 +306,13 @@ void build_stream(boost::iostreams::filtering_stream<boost::iostreams::input>& s
         stream.push(std::cin);
     else
     {
-        if (pfile == boost::python::object())
+        // regular files gzip-compressed in chunks are decompressed in parallel
+        if (boost::ends_with(file, ".gz") && is_mappable(file, pfile) &&
+            parallel_gunzip_source::is_chunked(file))
+        {
+            stream.push(parallel_gunzip_source(file));
+        }
+        else if (pfile == boost::python::object())
         {
             file_stream.open(file.c_str(), std::ios_base::in |
                              std::ios_base::binary);
@@ -308,23 +332,81 @@ void build_stream(boost::iostreams::filtering_stream<boost::iostreams::input>& s
     stream.exceptions(ios_base::badbit);
 }
 
+// Chunked gzip files are decompressed into memory only up to this size; larger
+// ones are decompressed in batches while being read via a stream.
+constexpr size_t gz_inflate_max_size = size_t(1) << 28;
+
+// Contents of a mappable file, decompressed if it is a chunked gzip file; data
+// is nullptr if the file must be read via a stream instead.
+struct gt_file_data
+{
+    gt_file_data(const string& file, boost::python::object& pfile,
+                 bool enabled = true)
+    {
+        if (!enabled || !is_mappable(file, pfile))
+            return;
+        mfile.open(file);
+        if (boost::ends_with(file, ".gz"))
+        {
+            if (parallel_gunzip(mfile.data(), mfile.size(), buf,
+                                gz_inflate_max_size))
+            {
+                data = buf.data();
+                size = buf.size();
+            }
+            mfile.close();
+        }
+        else
+        {
+            data = mfile.data();
+            size = mfile.size();
+        }
+    }
+
+    boost::iostreams::mapped_file_source mfile;
+    std::vector<char> buf;
+    const char* data = nullptr;
+    size_t size = 0;
+};
+
+property_selection get_selection(boost::python::list ignore,
+                                 boost::python::object only)
+{
+    property_selection sel;
+    for (int i = 0; i < len(ignore); ++i)
+        sel.ignore.insert(boost::python::extract<string>(ignore[i]));
+    if (only != boost::python::object())
+    {
+        sel.restricted = true;
+        for (int i = 0; i < len(only); ++i)
+            sel.only.insert(boost::python::extract<string>(only[i]));
+    }
+    return sel;
+}
 
 boost::python::tuple GraphInterface::read_from_file(string file,
                                                     boost::python::object pfile,
                                                     string format,
                                                     boost::python::list ignore_vp,
                                                     boost::python::list ignore_ep,
-                                                    boost::python::list ignore_gp)
+                                                    boost::python::list ignore_gp,
+                                                    boost::python::object only_vp,
+                                                    boost::python::object only_ep,
+                                                    boost::python::object only_gp)
 {
     if (format != "gt" && format != "dot" && format != "xml" && format != "gml")
         throw ValueException("error reading from file '" + file +
                              "': requested invalid format '" + format + "'");
+    thaw();
     try
     {
         boost::iostreams::filtering_stream<boost::iostreams::input>
             stream;
         std::ifstream file_stream;
-        build_stream(stream, file, pfile, file_stream);
+
+        gt_file_data fdata(file, pfile, format == "gt");
+        if (fdata.data == nullptr)
+            build_stream(stream, file, pfile, file_stream);
 
         std::unordered_set<std::string> ivp, iep, igp;
         for (int i = 0; i < len(ignore_vp); ++i)
@@ -339,23 +421,48 @@ boost::python::tuple GraphInterface::read_from_file(string file,
         dynamic_properties dp(map_creator);
         *_mg = multigraph_t();
 
+        vector<pair<string, boost::any>> agprops, avprops, aeprops;
         if (format == "dot")
+        {
             _directed = read_graphviz(stream, *_mg, dp, "vertex_name", true,
                                       ivp, iep, igp);
+        }
         else if (format == "xml")
-            _directed = read_graphml(stream, *_mg, dp, true, true, true,
-                                     ivp, iep, igp);
+        {
+            graphml_reader reader(*_mg, true, ivp, iep, igp);
+            _directed = reader.run(stream);
+            reader.get_properties(agprops, avprops, aeprops);
+        }
         else if (format == "gml")
-            _directed = read_gml(stream, *_mg, dp, ivp, iep, igp);
-
+        {
+            gml_reader reader(*_mg, ivp, iep, igp);
+            _directed = reader.run(stream);
+            reader.get_properties(agprops, avprops, aeprops);
+        }
 
         boost::python::dict vprops, eprops, gprops;
         if (format == "gt")
         {
-            vector<pair<string, boost::any>> agprops, avprops, aeprops;
-            stream.exceptions(ios_base::badbit | ios_base::failbit | ios_base::eofbit);
-            _directed = read_graph(stream, *_mg, agprops, avprops, aeprops, igp,
-                                   ivp, iep);
+            property_selection sel_vp = get_selection(ignore_vp, only_vp),
+                sel_ep = get_selection(ignore_ep, only_ep),
+                sel_gp = get_selection(ignore_gp, only_gp);
+            if (fdata.data != nullptr)
+            {
+                memory_source src(fdata.data, fdata.size);
+                _directed = read_graph(src, *_mg, agprops, avprops, aeprops,
+                                       sel_gp, sel_vp, sel_ep);
+            }
+            else
+            {
+                stream.exceptions(ios_base::badbit | ios_base::failbit |
+                                  ios_base::eofbit);
+                _directed = read_graph(stream, *_mg, agprops, avprops, aeprops,
+                                       sel_gp, sel_vp, sel_ep);
+            }
+        }
+
+        if (format == "gt" || format == "xml" || format == "gml")
+        {
             for (auto& p : agprops)
                 gprops[p.first] = find_property_map(p.second, _graph_index);
             for (auto& p : avprops)
@@ -394,6 +501,224 @@ boost::python::tuple GraphInterface::read_from_file(string file,
     }
 };
 
+boost::python::object
+GraphInterface::read_property_from_file(string file,
+                                        boost::python::object pfile,
+                                        string key_type, string name)
+{
+    property_type type;
+    if (key_type == "g")
+        type = property_type::Graph;
+    else if (key_type == "v")
+        type = property_type::Vertex;
+    else if (key_type == "e")
+        type = property_type::Edge;
+    else
+        throw ValueException("invalid key type: " + key_type);
+
+    try
+    {
+        boost::any prop;
+        bool found = false;
+
+        gt_file_data fdata(file, pfile);
+        if (fdata.data != nullptr)
+        {
+            memory_source src(fdata.data, fdata.size);
+            found = read_indexed_property(src, *_mg, type, name, prop);
+        }
+
+        if (!found)
+        {
+            // no directory is available, hence the whole file is read,
+            // skipping the remaining properties
+            boost::iostreams::filtering_stream<boost::iostreams::input>
+                stream;
+            std::ifstream file_stream;
+            build_stream(stream, file, pfile, file_stream);
+            stream.exceptions(ios_base::badbit | ios_base::failbit |
+                              ios_base::eofbit);
+
+            property_selection sel, skip_all;
+            sel.restricted = skip_all.restricted = true;
+            sel.only.insert(name);
+
+            multigraph_t g;
+            vector<pair<string, boost::any>> agprops, avprops, aeprops;
+            read_graph(stream, g, agprops, avprops, aeprops,
+                       (type == property_type::Graph) ? sel : skip_all,
+                       (type == property_type::Vertex) ? sel : skip_all,
+                       (type == property_type::Edge) ? sel : skip_all);
+            if ((type == property_type::Vertex &&
+                 num_vertices(g) != num_vertices(*_mg)) ||
+                (type == property_type::Edge &&
+                 num_edges(g) != num_edges(*_mg)))
+                throw ValueException("Error reading property '" + name +
+                                     "': the graph does not match the one in"
+                                     " the file");
+            for (auto* props : {&agprops, &avprops, &aeprops})
+            {
+                if (!props->empty())
+                    prop = props->front().second;
+            }
+            if (prop.empty())
+                throw ValueException("Error reading property '" + name +
+                                     "': not found");
+        }
+
+        switch (type)
+        {
+        case property_type::Graph:
+            return find_property_map(prop, _graph_index);
+        case property_type::Vertex:
+            return find_property_map(prop, _vertex_index);
+        default:
+            return find_property_map(prop, _edge_index);
+        }
+    }
+    catch (ios_base::failure &e)
+    {
+        throw IOException("error reading from file '" + file + "':" + e.what());
+    }
+}
+
+//==============================================================================
+// read_csv_edge_list(file, pfile, ...)
+//==============================================================================
+
+// Reads the edge list in batches of (approximately) batch_size bytes, or all
+// at once if batch_size == 0. Regular files are read directly from memory;
+// otherwise the input is read through a stream, and only the current batch is
+// kept in memory.
+template <class Id>
+void read_csv_batches(GraphInterface::multigraph_t& g, const string& file,
+                      boost::python::object& pfile, const csv_format& fmt,
+                      bool skip_first, bool hashed, boost::any& vmap,
+                      vector<boost::any>& eprops, size_t batch_size)
+{
+    csv_vertex_hash<Id> vertices;
+    size_t row_offset = 0;
+
+    gt_file_data fdata(file, pfile);
+    if (fdata.data != nullptr)
+    {
+        const char* pos = fdata.data;
+        const char* end = fdata.data + fdata.size;
+        if (skip_first)
+            pos = csv_next_line(pos, end);
+        while (pos < end)
+        {
+            const char* bend = end;
+            if (batch_size > 0 && size_t(end - pos) > batch_size)
+                bend = csv_next_line(pos + batch_size, end);
+            csv_add_edges(g, pos, bend - pos, fmt, hashed, vertices, vmap,
+                          eprops, row_offset);
+            pos = bend;
+        }
+        return;
+    }
+
+    boost::iostreams::filtering_stream<boost::iostreams::input> stream;
+    std::ifstream file_stream;
+    build_stream(stream, file, pfile, file_stream);
+
+    size_t block = (batch_size > 0) ? batch_size : (1 << 26);
+    std::vector<char> buf;
+    bool skip = skip_first;
+    bool eof = false;
+    while (!eof)
+    {
+        size_t n = buf.size();
+        buf.resize(n + block);
+        stream.read(buf.data() + n, block);
+        buf.resize(n + stream.gcount());
+        eof = stream.eof();
+
+        const char* begin = buf.data();
+        const char* end = begin + buf.size();
+        if (skip)
+        {
+            const char* next = csv_next_line(begin, end);
+            if (next == end && !eof)
+                continue;
+            buf.erase(buf.begin(), buf.begin() + (next - begin));
+            skip = false;
+            begin = buf.data();
+            end = begin + buf.size();
+        }
+
+        if (batch_size == 0 && !eof)
+            continue;
+
+        // only complete lines are processed; the remainder is kept for the
+        // next batch
+        const char* bend = end;
+        if (!eof)
+        {
+            bend = begin;
+            for (const char* p = end; p > begin; --p)
+            {
+                if (p[-1] == '\n')
+                {
+                    bend = p;
+                    break;
+                }
+            }
+        }
+        csv_add_edges(g, begin, bend - begin, fmt, hashed, vertices, vmap,
+                      eprops, row_offset);
+        buf.erase(buf.begin(), buf.begin() + (bend - begin));
+    }
+}
+
+void GraphInterface::read_csv_edge_list(string file,
+                                        boost::python::object pfile,
+                                        string delimiter, string quotechar,
+                                        bool skip_first, size_t source,
+                                        size_t target, bool string_vals,
+                                        bool hashed,
+                                        boost::python::object ovmap,
+                                        boost::python::object oeprops,
+                                        size_t batch_size)
+{
+    if (delimiter.size() != 1 || quotechar.size() != 1)
+        throw ValueException("CSV delimiter and quote character must be "
+                             "single characters");
+    if (source == target)
+        throw ValueException("Source and target columns must be different");
+
+    csv_format fmt;
+    fmt.delimiter = delimiter[0];
+    fmt.quotechar = quotechar[0];
+    fmt.source = source;
+    fmt.target = target;
+
+    vector<boost::any> eprops;
+    boost::python::stl_input_iterator<boost::any> iter(oeprops), end;
+    for (; iter != end; ++iter)
+        eprops.push_back(*iter);
+    fmt.n_props = eprops.size();
+
+    boost::any vmap;
+    if (hashed || string_vals)
+        vmap = boost::python::extract<boost::any>(ovmap)();
+
+    try
+    {
+        if (string_vals)
+            read_csv_batches<std::string_view>(*_mg, file, pfile, fmt,
+                                               skip_first, true, vmap, eprops,
+                                               batch_size);
+        else
+            read_csv_batches<int64_t>(*_mg, file, pfile, fmt, skip_first,
+                                      hashed, vmap, eprops, batch_size);
+    }
+    catch (ios_base::failure &e)
+    {
+        throw IOException("error reading from file '" + file + "':" + e.what());
+    }
+}
+
 template <class IndexMap>
 string graphviz_insert_index(dynamic_properties& dp, IndexMap index_map,
                              bool insert = true)
@@ -442,9 +767,11 @@ struct do_write_to_binary_file
     void operator()(ostream& stream, Graph& g, IndexMap index_map, size_t N,
                     bool directed, vector<pair<string, boost::any >> & gprops,
                     vector<pair<string, boost::any >> & vprops,
-                    vector<pair<string, boost::any >> & eprops) const
+                    vector<pair<string, boost::any >> & eprops,
+                    bool dict_strings) const
     {
-        write_graph(g, index_map, N, directed, gprops, vprops, eprops, stream);
+        write_graph(g, index_map, N, directed, gprops, vprops, eprops,
+                    dict_strings, stream);
     }
 };
 
@@ -461,7 +788,8 @@ struct generate_index
 };
 
 void GraphInterface::write_to_file(string file, boost::python::object pfile,
-                                   string format, boost::python::list props)
+                                   string format, boost::python::list props,
+                                   bool dict_strings)
 {
     if (format != "gt" && format != "xml" && format != "dot" && format != "gml")
         throw ValueException("error writing to file '" + file +
@@ -480,7 +808,7 @@ void GraphInterface::write_to_file(string file, boost::python::object pfile,
                                  std::ios_base::binary);
                 file_stream.exceptions(ios_base::badbit | ios_base::failbit);
                 if (boost::ends_with(file,".gz"))
-                    stream.push(boost::iostreams::gzip_compressor());
+                    stream.push(parallel_gzip_compressor());
                 if (boost::ends_with(file,".bz2"))
                     stream.push(boost::iostreams::bzip2_compressor());
                 stream.push(file_stream);
@@ -530,7 +858,8 @@ void GraphInterface::write_to_file(string file, boost::python::object pfile,
                                                 directed,
                                                 std::ref(agprops),
                                                 std::ref(avprops),
-                                                std::ref(aeprops)))();
+                                                std::ref(aeprops),
+                                                dict_strings))();
             }
             else
             {
@@ -542,7 +871,8 @@ void GraphInterface::write_to_file(string file, boost::python::object pfile,
                                                 directed,
                                                 std::ref(agprops),
                                                 std::ref(avprops),
-                                                std::ref(aeprops)))();
+                                                std::ref(aeprops),
+                                                dict_strings))();
             }
 
             _directed = directed;
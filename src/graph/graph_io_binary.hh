@@ -19,10 +19,15 @@
 #define GRAPH_IO_BINARY_HH
 
 #include <iostream>
+#include <cstring>
+#include <algorithm>
 #include "graph.hh"
 #include "graph_properties.hh"
 #include "graph_selectors.hh"
 #include <unordered_set>
+#include <unordered_map>
+#include <string_view>
+#include <deque>
 
 namespace graph_tool
 {
@@ -31,6 +36,10 @@ const char* _magic = u8"⛾ gt";
 size_t _magic_length = 6;
 const uint8_t _version = 1;
 
+// files containing dictionary-encoded strings (see below) are written with
+// this version instead, so that older readers reject them
+const uint8_t _dict_string_version = 2;
+
 // deal with endianness
 
 inline bool is_bigendian()
@@ -87,21 +96,124 @@ void write(std::ostream& s, const boost::python::object& v)
 };
 
 
+// Output buffer which keeps track of the number of bytes written, to record the
+// file offsets of the sections.
+class counting_buf: public std::streambuf
+{
+public:
+    counting_buf(std::streambuf* buf): _buf(buf), _count(0) {}
+
+    size_t count() const { return _count; }
+
+protected:
+    int_type overflow(int_type c)
+    {
+        if (traits_type::eq_int_type(c, traits_type::eof()))
+            return traits_type::not_eof(c);
+        _count++;
+        return _buf->sputc(traits_type::to_char_type(c));
+    }
+
+    std::streamsize xsputn(const char* s, std::streamsize n)
+    {
+        std::streamsize m = _buf->sputn(s, n);
+        _count += m;
+        return m;
+    }
+
+    int sync() { return _buf->pubsync(); }
+
+private:
+    std::streambuf* _buf;
+    size_t _count;
+};
+
+// Input sources. Besides std::istream, the data can also be read directly
+// from a memory region (e.g. a memory-mapped file), which implements the same
+// read() and ignore() members. The read_block() functions return a pointer to
+// the next n bytes of the input, which is a copy only if the source is a
+// stream.
+
+class memory_source
+{
+public:
+    memory_source(const char* data, size_t size)
+        : _begin(data), _pos(data), _end(data + size) {}
+
+    memory_source& read(char* buf, size_t n)
+    {
+        std::memcpy(buf, get(n), n);
+        return *this;
+    }
+
+    memory_source& ignore(size_t n)
+    {
+        get(n);
+        return *this;
+    }
+
+    const char* get(size_t n)
+    {
+        if (size_t(_end - _pos) < n)
+            throw IOException("Error reading graph: unexpected end of file");
+        const char* pos = _pos;
+        _pos += n;
+        return pos;
+    }
+
+    size_t tell() const { return _pos - _begin; }
+    size_t size() const { return _end - _begin; }
+
+    void seek(size_t pos)
+    {
+        if (pos > size())
+            throw IOException("Error reading graph: invalid file offset");
+        _pos = _begin + pos;
+    }
+
+private:
+    const char* _begin;
+    const char* _pos;
+    const char* _end;
+};
+
+inline const char* read_block(std::istream& s, size_t n, std::vector<char>& buf)
+{
+    buf.resize(n);
+    s.read(buf.data(), n);
+    return buf.data();
+}
+
+inline const char* read_block(memory_source& s, size_t n, std::vector<char>&)
+{
+    return s.get(n);
+}
+
+// reads the i-th value of type T from an unaligned buffer
 template <bool BE, typename T>
-void read(std::istream& s, T& v)
+T get_value(const char* data, size_t i)
+{
+    T v;
+    std::memcpy(&v, data + i * sizeof(T), sizeof(T));
+    byte_swap<BE>(v);
+    return v;
+}
+
+template <bool BE, typename T, class Stream>
+void read(Stream& s, T& v)
 {
     s.read(reinterpret_cast<char*>(&v), sizeof(T));
     byte_swap<BE>(v);
 };
 
-template <bool BE, typename T>
-void skip(std::istream& s, const T&)
+template <bool BE, typename T, class Stream>
+void skip(Stream& s, const T&)
 {
     s.ignore(sizeof(T));
 };
 
-template <bool BE, typename T>
-void read(std::istream& s, std::vector<T>& v)
+template <bool BE, typename T, class Stream>
+void read(Stream& s, std::vector<T>& v)
 {
     uint64_t size = 0;
     read<BE>(s, size);
@@ -109,20 +221,23 @@ void read(std::istream& s, std::vector<T>& v)
 
     s.read(reinterpret_cast<char*>(v.data()), sizeof(T) * v.size());
 
-    for (auto& x : v)
-        byte_swap<BE>(x);
+    if (BE != is_bigendian())
+    {
+        for (auto& x : v)
+            byte_swap<BE>(x);
+    }
 };
 
-template <bool BE, typename T>
-void skip(std::istream& s, const std::vector<T>&)
+template <bool BE, typename T, class Stream>
+void skip(Stream& s, const std::vector<T>&)
 {
     uint64_t size = 0;
     read<BE>(s, size);
     s.ignore(sizeof(T) * size);
 };
 
-template <bool BE>
-void read(std::istream& s, std::string& v)
+template <bool BE, class Stream>
+void read(Stream& s, std::string& v)
 {
     uint64_t size = 0;
     read<BE>(s, size);
@@ -130,9 +245,19 @@ void read(std::istream& s, std::string& v)
     s.read(&v[0], v.size());
 };
 
-
+// the size is validated against the remaining data before allocating
 template <bool BE>
-void read(std::istream& s, std::vector<std::string>& v)
+void read(memory_source& s, std::string& v)
+{
+    uint64_t size = 0;
+    read<BE>(s, size);
+    const char* data = s.get(size);
+    v.assign(data, size);
+};
+
+
+template <bool BE, class Stream>
+void read(Stream& s, std::vector<std::string>& v)
 {
     uint64_t size = 0;
     read<BE>(s, size);
@@ -142,16 +267,16 @@ void read(std::istream& s, std::vector<std::string>& v)
         read<BE>(s, x);
 };
 
-template <bool BE>
-void skip(std::istream& s, const std::string&)
+template <bool BE, class Stream>
+void skip(Stream& s, const std::string&)
 {
     uint64_t size = 0;
     read<BE>(s, size);
     s.ignore(size);
 };
 
-template <bool BE>
-void read(std::istream& s, boost::python::object& v)
+template <bool BE, class Stream>
+void read(Stream& s, boost::python::object& v)
 {
     std::string buf;
     read<BE>(s, buf);
@@ -159,8 +284,8 @@ void read(std::istream& s, boost::python::object& v)
 };
 
 
-template <bool BE>
-void skip(std::istream& s, const boost::python::object&)
+template <bool BE, class Stream>
+void skip(Stream& s, const boost::python::object&)
 {
     skip<BE>(s, std::string());
 };
@@ -198,27 +323,116 @@ void write_adjacency(Graph& g, const VProp& vindex, uint64_t N,
         write_adjacency_dispatch<uint64_t>(g, vindex, s);
 }
 
+// inserts the edges given by the out-neighbor lists in vdata, where list j
+// belongs to vertex vs[j] (or to vertex j, if vs is empty) and contains
+// eoffs[j + 1] - eoffs[j] entries; the source of each edge is found by a binary
+// search over eoffs
 template <bool BE, class Vint, class Graph>
-void read_adjacency_dispatch(Graph& g, size_t N, std::istream& s)
+void add_adjacency_lists(Graph& g, size_t N, const std::vector<size_t>& vs,
+                         const std::vector<size_t>& eoffs,
+                         const std::vector<const char*>& vdata)
+{
+    size_t M = vdata.size();
+    bool valid = true;
+    #pragma omp parallel for schedule(runtime) if (M > OPENMP_MIN_THRESH) \
+        reduction(&&:valid)
+    for (size_t j = 0; j < M; ++j)
+    {
+        for (size_t i = 0; i < eoffs[j + 1] - eoffs[j]; ++i)
+        {
+            if (get_value<BE, Vint>(vdata[j], i) >= N)
+                valid = false;
+        }
+    }
+    if (!valid)
+        throw IOException("error reading graph: vertex index not in range");
+
+    g.add_edges(eoffs[M],
+                [&](size_t i)
+                {
+                    size_t j = std::upper_bound(eoffs.begin(),
+                                                eoffs.begin() + M + 1, i)
+                        - eoffs.begin() - 1;
+                    size_t v = vs.empty() ? j : vs[j];
+                    size_t u = get_value<BE, Vint>(vdata[j], i - eoffs[j]);
+                    return std::make_pair(v, u);
+                },
+                [](size_t, const auto&) {});
+}
+
+// The edges are inserted via adj_list::add_edges(), which builds the out- and
+// in-edge lists in parallel, with the same ordering and edge indexes as
+// individual insertions. For a memory source, the out-neighbor lists are only
+// located, and all edges are inserted at once. Otherwise, the lists are read
+// into a buffer of bounded size, and inserted each time it is full, such that
+// the input is never held in memory as a whole.
+template <bool BE, class Vint, class Graph, class Stream>
+void read_adjacency_dispatch(Graph& g, size_t N, Stream& s)
 {
-    typedef typename graph_traits<Graph>::vertex_descriptor vertex_t;
+    std::vector<size_t> vs;
+    std::vector<size_t> eoffs = {0};
+    std::vector<const char*> vdata;
 
-    for (vertex_t v = 0; v < N; ++v)
+    if constexpr (std::is_same<Stream, memory_source>::value)
     {
-        std::vector<Vint> us;
-        read<BE>(s, us);
-        for (vertex_t u : us)
+        eoffs.reserve(N + 1);
+        vdata.reserve(N);
+        for (size_t v = 0; v < N; ++v)
+        {
+            uint64_t k = 0;
+            read<BE>(s, k);
+            if (k > (s.size() - s.tell()) / sizeof(Vint))
+                throw IOException("error reading graph: invalid adjacency length");
+            vdata.push_back(s.get(k * sizeof(Vint)));
+            eoffs.push_back(eoffs.back() + k);
+        }
+        add_adjacency_lists<BE, Vint>(g, N, vs, eoffs, vdata);
+    }
+    else
+    {
+        constexpr size_t batch_size = (size_t(1) << 26) / sizeof(Vint);
+        std::vector<char> buf;
+        auto flush = [&]()
+            {
+                for (size_t j = 0; j < vs.size(); ++j)
+                    vdata.push_back(buf.data() + eoffs[j] * sizeof(Vint));
+                add_adjacency_lists<BE, Vint>(g, N, vs, eoffs, vdata);
+                vs.clear();
+                eoffs.resize(1);
+                vdata.clear();
+                buf.clear();
+            };
+
+        for (size_t v = 0; v < N; ++v)
         {
-            if (u >= N)
-                throw IOException("error reading graph: vertex index not in range");
-            add_edge(v, u, g);
+            uint64_t k = 0;
+            read<BE>(s, k);
+            // the lists are split across batches if necessary, hence a
+            // corrupt length leads to the end of the input being reached,
+            // instead of an allocation of that size
+            while (k > 0)
+            {
+                size_t n = std::min(k, uint64_t(batch_size - eoffs.back()));
+                if (n == 0)
+                {
+                    flush();
+                    continue;
+                }
+                size_t pos = buf.size();
+                buf.resize(pos + n * sizeof(Vint));
+                s.read(buf.data() + pos, n * sizeof(Vint));
+                vs.push_back(v);
+                eoffs.push_back(eoffs.back() + n);
+                k -= n;
+            }
         }
+        flush();
     }
 }
 
 
-template <bool BE, class Graph>
-bool read_adjacency(Graph& g, std::istream& s)
+template <bool BE, class Graph, class Stream>
+bool read_adjacency(Graph& g, Stream& s)
 {
     uint8_t directed = false;
     read<BE>(s, directed);
@@ -271,6 +485,9 @@ struct graph_range_traits
     template <class Graph>
     static graph_range get_range(Graph&) { return graph_range(); }
 
+    template <class Graph>
+    static size_t get_size(Graph&) { return 1; }
+
     static property_type get_property_id() { return property_type::Graph; }
 };
 
@@ -285,6 +502,9 @@ struct vertex_range_traits
     IterRange<typename boost::graph_traits<Graph>::vertex_iterator>
     static get_range(Graph& g) { return vertices_range(g); }
 
+    template <class Graph>
+    static size_t get_size(Graph& g) { return num_vertices(g); }
+
     static property_type get_property_id() { return property_type::Vertex; }
 };
 
@@ -299,27 +519,112 @@ struct edge_range_traits
     IterRange<typename boost::graph_traits<Graph>::edge_iterator>
     static get_range(Graph& g) { return edges_range(g); }
 
+    template <class Graph>
+    static size_t get_size(Graph& g) { return num_edges(g); }
+
     static property_type get_property_id() { return property_type::Edge; }
 };
 
 
+// Dictionary-encoded strings
+//
+// If requested, vertex and edge string properties with few distinct values are
+// written with the value type index _dict_string_index instead, as a
+// dictionary of the
+// distinct values, followed by the code (i.e. dictionary position) of every
+// value. The dictionary is stored as a number of entries (uint64_t) followed
+// by the strings, and the codes as unsigned integers of the smallest width (1,
+// 2, 4 or 8 bytes) which fits the number of entries, given by a byte
+// preceding them. This encoding is used whenever it takes less space.
+
+constexpr uint8_t _dict_string_index = 0x0f;
+
+inline uint8_t get_code_width(size_t n)
+{
+    if (n <= (size_t(1) << 8))
+        return 1;
+    if (n <= (size_t(1) << 16))
+        return 2;
+    if (n <= (size_t(1) << 32))
+        return 4;
+    return 8;
+}
+
+inline void write_code(std::ostream& s, uint64_t c, uint8_t width)
+{
+    switch (width)
+    {
+    case 1: write(s, uint8_t(c)); break;
+    case 2: write(s, uint16_t(c)); break;
+    case 4: write(s, uint32_t(c)); break;
+    default: write(s, uint64_t(c));
+    }
+}
+
+// writes the dictionary-encoded values, if this takes less space than writing
+// them directly, and returns whether this was done
+template <class RangeTraits, class Graph, class PropertyMap>
+bool write_dict_strings(Graph& g, PropertyMap& prop, std::ostream& s)
+{
+    // the keys point to the strings in dict, which are never moved
+    std::unordered_map<std::string_view, uint64_t> codes;
+    std::deque<std::string> dict;
+    size_t n = 0, plain_size = 0, dict_size = sizeof(uint64_t) + 1;
+    for (auto x : RangeTraits::get_range(g))
+    {
+        const std::string& v = prop[x];
+        plain_size += sizeof(uint64_t) + v.size();
+        auto iter = codes.find(v);
+        if (iter == codes.end())
+        {
+            dict.push_back(v);
+            codes.emplace(dict.back(), dict.size() - 1);
+            dict_size += sizeof(uint64_t) + v.size();
+        }
+        n++;
+    }
+    uint8_t width = get_code_width(dict.size());
+    dict_size += n * width;
+    if (dict_size >= plain_size)
+        return false;
+
+    write(s, _dict_string_index);
+    write(s, uint64_t(dict.size()));
+    for (auto& v : dict)
+        write(s, v);
+    write(s, width);
+    for (auto x : RangeTraits::get_range(g))
+        write_code(s, codes.find(prop[x])->second, width);
+    return true;
+}
+
 template <class RangeTraits>
 struct write_property_dispatch
 {
     template <class T, class Graph>
     void operator()(T, Graph& g, boost::any& aprop, bool& found,
-                    std::ostream& s) const
+                    uint8_t& type, bool dict_strings, std::ostream& s) const
     {
         try
         {
             typedef typename property_map_type::apply<T, typename RangeTraits::index_map_t>::type pmap_t;
             pmap_t prop = any_cast<pmap_t>(aprop);
+            found = true;
+            if constexpr (std::is_same<T, std::string>::value &&
+                          !std::is_same<RangeTraits, graph_range_traits>::value)
+            {
+                if (dict_strings && write_dict_strings<RangeTraits>(g, prop, s))
+                {
+                    type = _dict_string_index;
+                    return;
+                }
+            }
             typedef typename mpl::find<val_types, T>::type pos;
             uint8_t val = mpl::distance<typename mpl::begin<val_types>::type, pos>::type::value;
             write(s, val);
+            type = val;
             for (auto x : RangeTraits::get_range(g))
                 write(s, prop[x]);
-            found = true;
         }
         catch (const boost::bad_any_cast&) {}
     }
@@ -327,7 +632,7 @@ struct write_property_dispatch
 
     template <class Graph>
     void operator()(size_t, Graph& g, boost::any& aprop, bool& found,
-                    std::ostream& s) const
+                    uint8_t& type, bool, std::ostream& s) const
     {
         try
         {
@@ -336,6 +641,7 @@ struct write_property_dispatch
             typedef typename mpl::find<val_types, int64_t>::type pos;
             uint8_t val = mpl::distance<typename mpl::begin<val_types>::type, pos>::type::value;
             write(s, val);
+            type = val;
             int64_t y;
             for (auto x : vertices_range(g))
             {
@@ -353,6 +659,7 @@ struct write_property_dispatch
             typedef typename mpl::find<val_types, int64_t>::type pos;
             uint8_t val = mpl::distance<typename mpl::begin<val_types>::type, pos>::type::value;
             write(s, val);
+            type = val;
             int64_t y;
             for (auto x : edges_range(g))
             {
@@ -367,47 +674,74 @@ struct write_property_dispatch
 };
 
 
+// returns the index of the value type that was written
 template <class RangeTraits, class Graph>
-void write_property(Graph& g, std::string& name, boost::any& prop, std::ostream& s)
+uint8_t write_property(Graph& g, std::string& name, boost::any& prop,
+                       bool dict_strings, std::ostream& s)
 {
     property_type pt = RangeTraits::get_property_id();
     write(s, pt);
     write(s, name);
     bool found = false;
+    uint8_t type = 0;
     mpl::for_each<val_types>(std::bind(write_property_dispatch<RangeTraits>(),
                                        std::placeholders::_1, std::ref(g),
                                        std::ref(prop), std::ref(found),
+                                       std::ref(type), dict_strings,
                                        std::ref(s)));
     if (!found)
         throw GraphException("Error writing graph: unknown property map type (this is a bug)");
+    return type;
 }
 
 
 template <bool BE, class RangeTraits>
 struct read_property_dispatch
 {
-    template <class T, class Graph>
+    template <class T, class Graph, class Stream>
     void operator()(T, Graph& g, boost::any& aprop, uint8_t val, bool ignore,
-                    bool& found, std::istream& s) const
+                    bool& found, Stream& s) const
     {
         typedef typename mpl::find<val_types, T>::type pos;
         if (mpl::distance<typename mpl::begin<val_types>::type, pos>::type::value == val)
         {
             typedef typename property_map_type::apply<T, typename RangeTraits::index_map_t>::type pmap_t;
             pmap_t prop(RangeTraits::get_index_map(g));
-            if (!ignore)
+            if constexpr (std::is_arithmetic<T>::value)
             {
-                for (auto x : RangeTraits::get_range(g))
-                    read<BE>(s, prop[x]);
-                aprop = prop;
+                // scalar values are contiguous, and are read as a single
+                // block
+                size_t n = RangeTraits::get_size(g);
+                if (!ignore)
+                {
+                    std::vector<char> buf;
+                    const char* data = read_block(s, n * sizeof(T), buf);
+                    size_t i = 0;
+                    for (auto x : RangeTraits::get_range(g))
+                        prop[x] = get_value<BE, T>(data, i++);
+                    aprop = prop;
+                }
+                else
+                {
+                    s.ignore(n * sizeof(T));
+                }
             }
             else
             {
-                T y;
-                for (auto x : RangeTraits::get_range(g))
+                if (!ignore)
+                {
+                    for (auto x : RangeTraits::get_range(g))
+                        read<BE>(s, prop[x]);
+                    aprop = prop;
+                }
+                else
                 {
-                    (void)x;
-                    skip<BE>(s, y);
+                    T y;
+                    for (auto x : RangeTraits::get_range(g))
+                    {
+                        (void)x;
+                        skip<BE>(s, y);
+                    }
                 }
             }
             found = true;
@@ -415,18 +749,84 @@ struct read_property_dispatch
     }
 };
 
-template <bool BE, class RangeTraits, class Graph>
+template <bool BE, class RangeTraits, class Graph, class Stream>
+void read_dict_strings(Graph& g, boost::any& aprop, bool ignore, Stream& s)
+{
+    size_t n = RangeTraits::get_size(g);
+    uint64_t k = 0;
+    read<BE>(s, k);
+    if (k > n)
+        throw IOException("Error reading graph: invalid dictionary size");
+    std::vector<std::string> dict(k);
+    for (auto& v : dict)
+        read<BE>(s, v);
+    uint8_t width = 0;
+    read<BE>(s, width);
+    if (width != get_code_width(k))
+        throw IOException("Error reading graph: invalid dictionary code width");
+
+    std::vector<char> buf;
+    const char* data = read_block(s, n * width, buf);
+    if (ignore)
+        return;
+
+    typedef typename property_map_type::apply
+        <std::string, typename RangeTraits::index_map_t>::type pmap_t;
+    pmap_t prop(RangeTraits::get_index_map(g));
+    size_t i = 0;
+    for (auto x : RangeTraits::get_range(g))
+    {
+        uint64_t c;
+        switch (width)
+        {
+        case 1: c = get_value<BE, uint8_t>(data, i); break;
+        case 2: c = get_value<BE, uint16_t>(data, i); break;
+        case 4: c = get_value<BE, uint32_t>(data, i); break;
+        default: c = get_value<BE, uint64_t>(data, i);
+        }
+        if (c >= k)
+            throw IOException("Error reading graph: invalid dictionary code");
+        prop[x] = dict[c];
+        ++i;
+    }
+    aprop = prop;
+}
+
+// Selection of the properties of a given type which are read from a file:
+// those in 'ignore' are skipped and, if 'restricted' is true, also those not
+// in 'only'.
+struct property_selection
+{
+    std::unordered_set<std::string> ignore;
+    std::unordered_set<std::string> only;
+    bool restricted = false;
+
+    bool skip(const std::string& name) const
+    {
+        return (ignore.find(name) != ignore.end() ||
+                (restricted && only.find(name) == only.end()));
+    }
+};
+
+template <bool BE, class RangeTraits, class Graph, class Stream>
 std::pair<std::string, boost::any>
-read_property(Graph& g, const std::unordered_set<std::string>& ignore,
-              std::istream& s)
+read_property(Graph& g, const property_selection& sel, Stream& s)
 {
     boost::any prop;
     bool found = false;
     std::string name;
     read<BE>(s, name);
-    bool skip = ignore.find(name) != ignore.end();
+    bool skip = sel.skip(name);
     uint8_t val = 0;
     read<BE>(s, val);
+    if constexpr (!std::is_same<RangeTraits, graph_range_traits>::value)
+    {
+        if (val == _dict_string_index)
+        {
+            read_dict_strings<BE, RangeTraits>(g, prop, skip, s);
+            return make_pair(name, prop);
+        }
+    }
     mpl::for_each<val_types>(std::bind(read_property_dispatch<BE, RangeTraits>(),
                                        std::placeholders::_1, std::ref(g),
                                        std::ref(prop), val, skip, std::ref(found),
@@ -438,14 +838,145 @@ read_property(Graph& g, const std::unordered_set<std::string>& ignore,
 }
 
 
+// Directory footer
+//
+// After the last property, the file may contain a directory with the offset of
+// each section, which allows the properties to be located (and read
+// individually) without parsing the preceding ones. Since the readers stop
+// after the last property, the footer is ignored by older versions. Its layout
+// is:
+//
+//     uint64 number of entries
+//     (uint8 property type, string name, uint8 value type, uint64 offset)*
+//     uint64 adjacency offset, uint64 N, uint64 E, uint64 directory offset
+//     char[8] _index_magic
+//
+// where the offsets are counted from the beginning of the file, and point to
+// the beginning of each property record.
+
+const char* _index_magic = "gt-index";
+constexpr size_t _index_magic_length = 8;
+constexpr size_t _index_trailer_length = 4 * sizeof(uint64_t) +
+    _index_magic_length;
+
+struct gt_directory
+{
+    struct entry
+    {
+        property_type type;
+        std::string name;
+        uint8_t value_type;
+        uint64_t offset;
+    };
+
+    std::vector<entry> entries;
+    uint64_t adjacency = 0;
+    uint64_t N = 0;
+    uint64_t E = 0;
+    uint64_t offset = 0; // beginning of the directory, i.e. end of the last
+                         // property
+
+    // end of the i-th property record
+    uint64_t get_end(size_t i) const
+    {
+        return (i + 1 < entries.size()) ? entries[i + 1].offset : offset;
+    }
+};
+
+inline void write_directory(const gt_directory& dir, std::ostream& s)
+{
+    uint64_t n = dir.entries.size();
+    write(s, n);
+    for (auto& e : dir.entries)
+    {
+        write(s, e.type);
+        write(s, e.name);
+        write(s, e.value_type);
+        write(s, e.offset);
+    }
+    write(s, dir.adjacency);
+    write(s, dir.N);
+    write(s, dir.E);
+    write(s, dir.offset);
+    s.write(_index_magic, _index_magic_length);
+}
+
+// reads the directory entries, and checks that they are consistent with the
+// rest of the file, where pos is the beginning of the adjacency
+template <bool BE>
+bool read_directory_entries(memory_source& s, gt_directory& dir, size_t pos)
+{
+    s.seek(s.size() - _index_trailer_length);
+    read<BE>(s, dir.adjacency);
+    read<BE>(s, dir.N);
+    read<BE>(s, dir.E);
+    read<BE>(s, dir.offset);
+    size_t footer_end = s.size() - _index_trailer_length;
+    if (dir.adjacency < pos || dir.offset < dir.adjacency ||
+        dir.offset + sizeof(uint64_t) > footer_end)
+        return false;
+    s.seek(dir.offset);
+    uint64_t n = 0;
+    read<BE>(s, n);
+
+    // each entry takes at least this many bytes, which bounds the number of
+    // entries that can fit in the footer, before anything is allocated
+    constexpr size_t entry_size = sizeof(property_type) + sizeof(uint64_t) +
+        sizeof(uint8_t) + sizeof(uint64_t);
+    size_t footer_size = footer_end - s.tell();
+    if (n > footer_size / entry_size)
+        return false;
+    dir.entries.resize(n);
+    uint64_t last = dir.adjacency;
+    for (auto& e : dir.entries)
+    {
+        read<BE>(s, e.type);
+        uint64_t len = 0;
+        read<BE>(s, len);
+        if (len > footer_end - s.tell())
+            return false;
+        e.name.assign(s.get(len), len);
+        read<BE>(s, e.value_type);
+        read<BE>(s, e.offset);
+        if (e.offset <= last || e.offset >= dir.offset)
+            return false;
+        last = e.offset;
+    }
+    return s.tell() == footer_end;
+}
+
+// reads the directory from the end of the file, if it exists. Files written
+// without a directory may end with the magic string by chance, hence if the
+// directory does not check out, it is simply ignored.
+template <bool BE>
+bool read_directory(memory_source& s, gt_directory& dir)
+{
+    size_t pos = s.tell();
+    if (s.size() < pos + _index_trailer_length)
+        return false;
+    s.seek(s.size() - _index_magic_length);
+    bool found = (strncmp(s.get(_index_magic_length), _index_magic,
+                          _index_magic_length) == 0 &&
+                  read_directory_entries<BE>(s, dir, pos));
+    if (!found)
+        dir.entries.clear();
+    s.seek(pos);
+    return found;
+}
+
 template <class Graph, class VProp>
 void write_graph(Graph& g, const VProp& vindex, size_t N, bool directed,
                  std::vector<std::pair<std::string, boost::any>>& gprops,
                  std::vector<std::pair<std::string, boost::any>>& vprops,
-                 std::vector<std::pair<std::string, boost::any>>& eprops, std::ostream& s)
+                 std::vector<std::pair<std::string, boost::any>>& eprops,
+                 bool dict_strings, std::ostream& os)
 {
+    counting_buf buf(os.rdbuf());
+    std::ostream s(&buf);
+    s.exceptions(os.exceptions());
+
     s.write(_magic, _magic_length);
-    write(s, _version);
+    write(s, dict_strings ? _dict_string_version : _version);
     uint8_t big_end = is_bigendian();
     write(s, big_end);
     string comment = "graph-tool binary file (http:://graph-tool.skewed.de)"
@@ -458,49 +989,107 @@ void write_graph(Graph& g, const VProp& vindex, size_t N, bool directed,
         lexical_cast<std::string>(eprops.size()) + " edge props";
     write(s, comment);
 
+    gt_directory dir;
+    dir.adjacency = buf.count();
+    dir.N = N;
+    dir.E = num_edges(g);
+
     write_adjacency(g, vindex, N, directed, s);
     uint64_t nprops = gprops.size() + vprops.size() + eprops.size();
     write(s, nprops);
+
+    auto put_entry = [&](property_type type, std::string& name)
+        {
+            dir.entries.push_back({type, name, 0, buf.count()});
+        };
     for (auto& p : gprops)
-        write_property<graph_range_traits>(g, p.first, p.second, s);
+    {
+        put_entry(property_type::Graph, p.first);
+        dir.entries.back().value_type =
+            write_property<graph_range_traits>(g, p.first, p.second,
+                                               dict_strings, s);
+    }
     for (auto& p : vprops)
-        write_property<vertex_range_traits>(g, p.first, p.second, s);
+    {
+        put_entry(property_type::Vertex, p.first);
+        dir.entries.back().value_type =
+            write_property<vertex_range_traits>(g, p.first, p.second,
+                                                dict_strings, s);
+    }
     for (auto& p : eprops)
-        write_property<edge_range_traits>(g, p.first, p.second, s);
+    {
+        put_entry(property_type::Edge, p.first);
+        dir.entries.back().value_type =
+            write_property<edge_range_traits>(g, p.first, p.second,
+                                              dict_strings, s);
+    }
+
+    dir.offset = buf.count();
+    write_directory(dir, s);
+    s.flush();
 }
 
-template <bool BE, class Graph>
+template <bool BE, class Graph, class Stream>
 bool read_graph_dispatch(Graph& g,
                          std::vector<std::pair<std::string, boost::any>>& gprops,
                          std::vector<std::pair<std::string, boost::any>>& vprops,
                          std::vector<std::pair<std::string, boost::any>>& eprops,
-                         const std::unordered_set<std::string>& ignore_gp,
-                         const std::unordered_set<std::string>& ignore_vp,
-                         const std::unordered_set<std::string>& ignore_ep,
-                         std::istream& s)
+                         const property_selection& sel_gp,
+                         const property_selection& sel_vp,
+                         const property_selection& sel_ep,
+                         Stream& s)
 {
+    // if the data is in memory, the skipped properties can be jumped over
+    // with the help of the directory
+    gt_directory dir;
+    bool indexed = false;
+    if constexpr (std::is_same<Stream, memory_source>::value)
+        indexed = read_directory<BE>(s, dir);
+
     bool directed = read_adjacency<BE>(g, s);
     uint64_t nprops;
     read<BE>(s, nprops);
+    if (indexed && dir.entries.size() != nprops)
+        indexed = false;
     for (size_t i = 0; i < nprops; ++i)
     {
+        if constexpr (std::is_same<Stream, memory_source>::value)
+        {
+            if (indexed)
+            {
+                auto& e = dir.entries[i];
+                const property_selection* sel = nullptr;
+                switch (e.type)
+                {
+                case property_type::Graph:  sel = &sel_gp; break;
+                case property_type::Vertex: sel = &sel_vp; break;
+                case property_type::Edge:   sel = &sel_ep; break;
+                }
+                if (sel != nullptr && sel->skip(e.name))
+                {
+                    s.seek(dir.get_end(i));
+                    continue;
+                }
+            }
+        }
+
         property_type pt;
         read<BE>(s, pt);
         std::pair<std::string, boost::any> p;
         switch (pt)
         {
         case property_type::Graph:
-            p = read_property<BE, graph_range_traits>(g, ignore_gp, s);
+            p = read_property<BE, graph_range_traits>(g, sel_gp, s);
             if (!p.second.empty())
                 gprops.push_back(p);
             break;
         case property_type::Vertex:
-            p = read_property<BE, vertex_range_traits>(g, ignore_vp, s);
+            p = read_property<BE, vertex_range_traits>(g, sel_vp, s);
             if (!p.second.empty())
                 vprops.push_back(p);
             break;
         case property_type::Edge:
-            p = read_property<BE, edge_range_traits>(g, ignore_ep, s);
+            p = read_property<BE, edge_range_traits>(g, sel_ep, s);
             if (!p.second.empty())
                 eprops.push_back(p);
             break;
@@ -512,15 +1101,9 @@ bool read_graph_dispatch(Graph& g,
     return directed;
 }
 
-
-template <class Graph>
-bool read_graph(std::istream& s, Graph& g,
-                std::vector<std::pair<std::string, boost::any>>& gprops,
-                std::vector<std::pair<std::string, boost::any>>& vprops,
-                std::vector<std::pair<std::string, boost::any>>& eprops,
-                const std::unordered_set<std::string>& ignore_gp = std::unordered_set<std::string>(),
-                const std::unordered_set<std::string>& ignore_vp = std::unordered_set<std::string>(),
-                const std::unordered_set<std::string>& ignore_ep = std::unordered_set<std::string>())
+// reads the header, and returns whether the file is big-endian
+template <class Stream>
+bool read_header(Stream& s)
 {
     char magic[_magic_length];
     s.read(magic, _magic_length);
@@ -528,20 +1111,85 @@ bool read_graph(std::istream& s, Graph& g,
         throw IOException("Error reading graph: Invalid magic number");
     uint8_t version = 0;
     read<false>(s, version);
-    if (version != _version)
+    if (version != _version && version != _dict_string_version)
         throw IOException("Error reading graph: Invalid format version " +
                           boost::lexical_cast<std::string>(version));
     uint8_t big_end = 0;
     read<false>(s, big_end);
     string comment;
     read<false>(s, comment);
+    return big_end;
+}
 
-    if (big_end)
-        return read_graph_dispatch<true>(g, gprops, vprops, eprops, ignore_gp,
-                                         ignore_vp, ignore_ep, s);
+template <class Stream, class Graph>
+bool read_graph(Stream& s, Graph& g,
+                std::vector<std::pair<std::string, boost::any>>& gprops,
+                std::vector<std::pair<std::string, boost::any>>& vprops,
+                std::vector<std::pair<std::string, boost::any>>& eprops,
+                const property_selection& sel_gp = property_selection(),
+                const property_selection& sel_vp = property_selection(),
+                const property_selection& sel_ep = property_selection())
+{
+    if (read_header(s))
+        return read_graph_dispatch<true>(g, gprops, vprops, eprops, sel_gp,
+                                         sel_vp, sel_ep, s);
+    else
+        return read_graph_dispatch<false>(g, gprops, vprops, eprops, sel_gp,
+                                          sel_vp, sel_ep, s);
+}
+
+template <bool BE, class Graph>
+bool read_indexed_property_dispatch(memory_source& s, Graph& g,
+                                    property_type type,
+                                    const std::string& name, boost::any& prop)
+{
+    gt_directory dir;
+    if (!read_directory<BE>(s, dir))
+        return false;
+    for (auto& e : dir.entries)
+    {
+        if (e.type != type || e.name != name)
+            continue;
+        if ((type == property_type::Vertex && num_vertices(g) != dir.N) ||
+            (type == property_type::Edge && num_edges(g) != dir.E))
+            throw ValueException("Error reading property '" + name + "': the "
+                                 "graph does not match the one in the file");
+        s.seek(e.offset);
+        property_type pt;
+        read<BE>(s, pt);
+        property_selection sel;
+        switch (pt)
+        {
+        case property_type::Graph:
+            prop = read_property<BE, graph_range_traits>(g, sel, s).second;
+            break;
+        case property_type::Vertex:
+            prop = read_property<BE, vertex_range_traits>(g, sel, s).second;
+            break;
+        case property_type::Edge:
+            prop = read_property<BE, edge_range_traits>(g, sel, s).second;
+            break;
+        default:
+            throw IOException("Error reading graph: invalid property type " +
+                              boost::lexical_cast<std::string>(uint8_t(pt)));
+        }
+        return true;
+    }
+    throw ValueException("Error reading property '" + name + "': not found");
+}
+
+// Reads a single property from a file with a directory footer, by seeking
+// directly to its offset. The property values are stored according to the
+// vertices and edges of g, which must correspond to the graph stored in the
+// file. Returns false if the file has no directory.
+template <class Graph>
+bool read_indexed_property(memory_source& s, Graph& g, property_type type,
+                           const std::string& name, boost::any& prop)
+{
+    if (read_header(s))
+        return read_indexed_property_dispatch<true>(s, g, type, name, prop);
     else
-        return read_graph_dispatch<false>(g, gprops, vprops, eprops, ignore_gp,
-                                          ignore_vp, ignore_ep, s);
+        return read_indexed_property_dispatch<false>(s, g, type, name, prop);
 }
 
 } // namespace graph_tool
@@ -0,0 +1,559 @@
+// graph-tool -- a general graph modification and manipulation thingy
+//
+// Copyright (C) 2006-2018 Tiago de Paula Peixoto <tiago@skewed.de>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GRAPH_IO_CSV_HH
+#define GRAPH_IO_CSV_HH
+
+#include "config.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <functional>
+#include <cstring>
+
+#include <boost/lexical_cast.hpp>
+#include <boost/mpl/vector.hpp>
+#include <boost/mpl/for_each.hpp>
+
+#ifdef _OPENMP
+# include <omp.h>
+#endif
+
+#include "graph.hh"
+#include "graph_properties.hh"
+#include "graph_exceptions.hh"
+#include "openmp_lock.hh"
+
+namespace graph_tool
+{
+
+// ========================================================================
+// CSV edge lists
+// ========================================================================
+//
+// The input is processed in batches of complete lines. Each batch is split at
+// line boundaries into chunks, which are parsed in parallel into the vertex
+// values and the (unconverted) edge property values of each row. The vertices
+// are then hashed concurrently, the edges are inserted all at once via
+// adj_list::add_edges(), and finally the property values are converted and
+// stored in parallel. Since only the current batch is kept in parsed form, the
+// memory overhead is bounded by the batch size. Quoted values may contain
+// delimiters and (doubled) quote characters, but not line breaks, since the
+// input is split at every one of them; a quoted value which is not closed in
+// the same line is therefore rejected, instead of being silently cut.
+
+struct csv_format
+{
+    char delimiter = ',';
+    char quotechar = '"';
+    size_t source = 0;   // column of the source vertices
+    size_t target = 1;   // column of the target vertices
+    size_t n_props = 0;  // number of edge property columns
+};
+
+// Rows parsed from one chunk of a batch. The vertex values are of type
+// int64_t, or std::string_view if they are arbitrary strings. The property
+// values are views of the input (or of the arena, if they needed to be
+// unescaped), or null views if the row has no value for the property.
+template <class Id>
+struct csv_chunk
+{
+    std::vector<Id> source, target;
+    std::vector<std::string_view> values;
+    std::deque<std::string> arena;
+    std::string error;
+
+    size_t size() const { return source.size(); }
+};
+
+// returns the beginning of the line after the one containing pos
+inline const char* csv_next_line(const char* pos, const char* end)
+{
+    auto nl = static_cast<const char*>(memchr(pos, '\n', end - pos));
+    return (nl == nullptr) ? end : nl + 1;
+}
+
+// splits the line [pos, end) into fields, and returns false if a quoted field
+// is not closed before the end of the line
+inline bool csv_split_line(const char* pos, const char* end,
+                           const csv_format& fmt,
+                           std::deque<std::string>& arena,
+                           std::vector<std::string_view>& fields)
+{
+    fields.clear();
+    while (true)
+    {
+        const char* fend;
+        if (pos < end && *pos == fmt.quotechar)
+        {
+            const char* begin = pos + 1;
+            const char* close = begin;
+            bool escaped = false;
+            while (close < end)
+            {
+                if (*close == fmt.quotechar)
+                {
+                    if (close + 1 < end && close[1] == fmt.quotechar)
+                    {
+                        escaped = true;
+                        close += 2;
+                        continue;
+                    }
+                    break;
+                }
+                ++close;
+            }
+            if (close == end)
+                return false;
+            const char* next = std::min(close + 1, end);
+            fend = next;
+            while (fend < end && *fend != fmt.delimiter)
+                ++fend;
+            if (!escaped && next == fend)
+            {
+                fields.emplace_back(begin, close - begin);
+            }
+            else
+            {
+                // anything following the closing quote is kept, as done by
+                // python's csv module
+                auto& s = arena.emplace_back();
+                for (const char* c = begin; c < close; ++c)
+                {
+                    s.push_back(*c);
+                    if (*c == fmt.quotechar)
+                        ++c;
+                }
+                s.append(next, fend);
+                fields.emplace_back(s);
+            }
+        }
+        else
+        {
+            fend = static_cast<const char*>(memchr(pos, fmt.delimiter,
+                                                   end - pos));
+            if (fend == nullptr)
+                fend = end;
+            fields.emplace_back(pos, fend - pos);
+        }
+        if (fend >= end)
+            break;
+        pos = fend + 1;
+    }
+    return true;
+}
+
+// removes leading and trailing ASCII whitespace, which python's int() and
+// float() ignore as well (e.g. in "0, 1")
+inline std::string_view csv_trim(std::string_view s)
+{
+    constexpr const char* space = " \t\n\v\f\r";
+    size_t first = s.find_first_not_of(space);
+    if (first == std::string_view::npos)
+        return std::string_view();
+    return s.substr(first, s.find_last_not_of(space) - first + 1);
+}
+
+inline bool csv_convert(std::string_view s, int64_t& val)
+{
+    s = csv_trim(s);
+    return boost::conversion::try_lexical_convert(s.data(), s.size(), val);
+}
+
+inline bool csv_convert(std::string_view s, std::string_view& val)
+{
+    val = s;
+    return true;
+}
+
+// parses the lines in [pos, end) into chunk
+template <class Id>
+void csv_parse_chunk(const char* pos, const char* end, const csv_format& fmt,
+                     csv_chunk<Id>& chunk)
+{
+    std::vector<std::string_view> fields;
+    while (pos < end)
+    {
+        const char* next = csv_next_line(pos, end);
+        const char* lend = (next > pos && next[-1] == '\n') ? next - 1 : next;
+        if (lend > pos && lend[-1] == '\r')
+            --lend;
+        if (lend == pos)
+        {
+            pos = next; // blank lines are skipped
+            continue;
+        }
+
+        if (!csv_split_line(pos, lend, fmt, chunk.arena, fields))
+        {
+            chunk.error = "Unterminated quoted value in edge list (quoted "
+                "values may not contain line breaks): " +
+                std::string(pos, lend);
+            return;
+        }
+        if (fields.size() <= std::max(fmt.source, fmt.target))
+        {
+            chunk.error = "Invalid line in edge list (too few columns): " +
+                std::string(pos, lend);
+            return;
+        }
+
+        Id s, t;
+        for (auto [v, c] : {std::make_pair(&s, fmt.source),
+                            std::make_pair(&t, fmt.target)})
+        {
+            if (!csv_convert(fields[c], *v))
+            {
+                chunk.error = "Invalid vertex value: " + std::string(fields[c]);
+                return;
+            }
+        }
+        chunk.source.push_back(s);
+        chunk.target.push_back(t);
+
+        size_t row = chunk.values.size();
+        chunk.values.resize(row + fmt.n_props);
+        for (size_t c = 0; c < fields.size(); ++c)
+        {
+            if (c == fmt.source || c == fmt.target)
+                continue;
+            size_t j = c - (c > fmt.source) - (c > fmt.target);
+            if (j < fmt.n_props)
+                chunk.values[row + j] = fields[c];
+        }
+        pos = next;
+    }
+}
+
+// Hash table mapping vertex values to vertex indexes, which can be filled
+// concurrently, and extended incrementally, one batch at a time. As in
+// add_edge_list_hashed(), the new vertices of each batch are given indexes in
+// the order in which they first appear in the input. The string values are
+// copied into the table, hence the input buffer can be discarded after each
+// batch.
+template <class Value>
+class csv_vertex_hash
+{
+public:
+    csv_vertex_hash()
+        : _shards(n_shards), _storage(n_shards), _pending(n_shards),
+          _locks(n_shards) {}
+
+    // register value r, found at position pos of the input
+    void insert(const Value& r, size_t pos)
+    {
+        size_t k = get_shard(r);
+        ::scoped_lock lock(_locks[k]);
+        auto& shard = _shards[k];
+        auto iter = shard.find(r);
+        if (iter == shard.end())
+        {
+            Value key = r;
+            if constexpr (std::is_same<Value, std::string_view>::value)
+                key = _storage[k].emplace_back(r);
+            auto& item = *shard.emplace(key, entry{pos, false}).first;
+            _pending[k].push_back(&item);
+        }
+        else if (!iter->second.assigned)
+        {
+            iter->second.idx = std::min(iter->second.idx, pos);
+        }
+    }
+
+    // give the values inserted since the last call the vertex indexes
+    // starting from N, and return them in the order of their indexes
+    std::vector<Value> assign(size_t N)
+    {
+        std::vector<item_t*> items;
+        for (auto& pending : _pending)
+        {
+            items.insert(items.end(), pending.begin(), pending.end());
+            pending.clear();
+        }
+        std::sort(items.begin(), items.end(),
+                  [](auto a, auto b) { return a->second.idx < b->second.idx; });
+        std::vector<Value> vals;
+        vals.reserve(items.size());
+        for (size_t i = 0; i < items.size(); ++i)
+        {
+            items[i]->second = entry{N + i, true};
+            vals.push_back(items[i]->first);
+        }
+        return vals;
+    }
+
+    size_t operator[](const Value& r) const
+    {
+        return _shards[get_shard(r)].find(r)->second.idx;
+    }
+
+private:
+    struct entry
+    {
+        size_t idx;     // vertex index if assigned, otherwise input position
+        bool assigned;
+    };
+
+    typedef std::unordered_map<Value, entry> shard_t;
+    typedef typename shard_t::value_type item_t;
+
+    static constexpr size_t shard_bits = 8;
+    static constexpr size_t n_shards = 1 << shard_bits;
+
+    static size_t get_shard(const Value& r)
+    {
+        // the hashes of integers are not scrambled by std::hash
+        uint64_t h = std::hash<Value>()(r);
+        return (h * 11400714819323198485ULL) >> (64 - shard_bits);
+    }
+
+    std::vector<shard_t> _shards;
+    std::vector<std::deque<std::string>> _storage;
+    std::vector<std::vector<item_t*>> _pending;
+    std::vector<openmp_mutex> _locks;
+};
+
+// property value types which can be read from CSV columns
+typedef boost::mpl::vector7<uint8_t, int16_t, int32_t, int64_t, double,
+                            long double, std::string> csv_value_types;
+
+template <class Value>
+bool csv_convert(std::string_view s, Value& val)
+{
+    s = csv_trim(s);
+    return boost::conversion::try_lexical_convert(s.data(), s.size(), val);
+}
+
+inline bool csv_convert(std::string_view s, std::string& val)
+{
+    val.assign(s.data(), s.size());
+    return true;
+}
+
+inline bool csv_convert(std::string_view s, uint8_t& val)
+{
+    s = csv_trim(s);
+    for (auto v : {"1", "true", "True", "TRUE"})
+    {
+        if (s == v)
+        {
+            val = true;
+            return true;
+        }
+    }
+    for (auto v : {"0", "false", "False", "FALSE"})
+    {
+        if (s == v)
+        {
+            val = false;
+            return true;
+        }
+    }
+    return false;
+}
+
+// function which converts and stores the value of the edge with the given
+// index, and returns false if the value is invalid
+typedef std::function<bool(size_t, std::string_view)> csv_column_writer;
+
+inline csv_column_writer get_csv_column_writer(boost::any& aprop,
+                                               size_t E)
+{
+    csv_column_writer writer;
+    boost::mpl::for_each<csv_value_types>
+        ([&](auto val)
+         {
+             typedef decltype(val) val_t;
+             typedef typename eprop_map_t<val_t>::type pmap_t;
+             if (aprop.type() != typeid(pmap_t))
+                 return;
+             auto pmap = boost::any_cast<pmap_t>(aprop);
+             pmap.reserve(E);
+             writer = [pmap](size_t ei, std::string_view s)
+                 {
+                     return csv_convert(s, pmap.get_storage()[ei]);
+                 };
+         });
+    if (!writer)
+        throw ValueException("Invalid edge property type for CSV column");
+    return writer;
+}
+
+// stores the values of the vertices added to the graph in the vertex property
+// map, which is of type int64_t or string
+template <class Value>
+void csv_put_vertex_values(boost::any& avmap, size_t N,
+                           const std::vector<Value>& vals)
+{
+    typedef typename std::conditional<std::is_same<Value, int64_t>::value,
+                                      int64_t, std::string>::type val_t;
+    typedef typename vprop_map_t<val_t>::type vmap_t;
+    auto vmap = boost::any_cast<vmap_t>(avmap);
+    vmap.reserve(N + vals.size());
+    auto& storage = vmap.get_storage();
+    #pragma omp parallel for schedule(runtime) \
+        if (vals.size() > OPENMP_MIN_THRESH)
+    for (size_t i = 0; i < vals.size(); ++i)
+        storage[N + i] = val_t(vals[i]);
+}
+
+// Parses the batch of complete lines in [data, data + size), and adds the
+// corresponding edges and vertices to the graph. If hashed == false, the
+// vertex values are taken as indexes. The edge property values are stored
+// in eprops. The number of rows read so far is kept in row_offset.
+template <class Id, class Graph>
+void csv_add_edges(Graph& g, const char* data, size_t size,
+                   const csv_format& fmt, bool hashed,
+                   csv_vertex_hash<Id>& vertices, boost::any& avmap,
+                   std::vector<boost::any>& eprops, size_t& row_offset)
+{
+    constexpr size_t min_chunk_size = 1 << 16;
+    size_t n_chunks = 1;
+#ifdef _OPENMP
+    n_chunks = 4 * omp_get_max_threads();
+#endif
+    n_chunks = std::max(size_t(1), std::min(n_chunks, size / min_chunk_size));
+
+    const char* end = data + size;
+    std::vector<const char*> bounds = {data};
+    for (size_t i = 1; i < n_chunks; ++i)
+    {
+        const char* pos = std::max(data + i * (size / n_chunks),
+                                   bounds.back());
+        bounds.push_back(csv_next_line(pos, end));
+    }
+    bounds.push_back(end);
+    n_chunks = bounds.size() - 1;
+
+    std::vector<csv_chunk<Id>> chunks(n_chunks);
+    #pragma omp parallel for schedule(dynamic) if (n_chunks > 1)
+    for (size_t i = 0; i < n_chunks; ++i)
+        csv_parse_chunk(bounds[i], bounds[i + 1], fmt, chunks[i]);
+
+    std::vector<size_t> offset(n_chunks + 1);
+    for (size_t i = 0; i < n_chunks; ++i)
+    {
+        if (!chunks[i].error.empty())
+            throw ValueException(chunks[i].error);
+        offset[i + 1] = offset[i] + chunks[i].size();
+    }
+    size_t E = offset.back();
+    if (E == 0)
+        return;
+
+    std::vector<std::pair<size_t, size_t>> edges(E);
+    if (hashed)
+    {
+        #pragma omp parallel for schedule(dynamic) if (n_chunks > 1)
+        for (size_t i = 0; i < n_chunks; ++i)
+        {
+            auto& chunk = chunks[i];
+            for (size_t r = 0; r < chunk.size(); ++r)
+            {
+                size_t pos = 2 * (row_offset + offset[i] + r);
+                vertices.insert(chunk.source[r], pos);
+                vertices.insert(chunk.target[r], pos + 1);
+            }
+        }
+
+        size_t N = num_vertices(g);
+        auto vals = vertices.assign(N);
+        for (size_t i = 0; i < vals.size(); ++i)
+            add_vertex(g);
+        csv_put_vertex_values(avmap, N, vals);
+
+        #pragma omp parallel for schedule(dynamic) if (n_chunks > 1)
+        for (size_t i = 0; i < n_chunks; ++i)
+        {
+            auto& chunk = chunks[i];
+            for (size_t r = 0; r < chunk.size(); ++r)
+                edges[offset[i] + r] = {vertices[chunk.source[r]],
+                                        vertices[chunk.target[r]]};
+        }
+    }
+    else if constexpr (std::is_same<Id, int64_t>::value)
+    {
+        size_t N = 0;
+        bool valid = true;
+        #pragma omp parallel for schedule(dynamic) if (n_chunks > 1) \
+            reduction(max:N) reduction(&&:valid)
+        for (size_t i = 0; i < n_chunks; ++i)
+        {
+            auto& chunk = chunks[i];
+            for (size_t r = 0; r < chunk.size(); ++r)
+            {
+                int64_t s = chunk.source[r];
+                int64_t t = chunk.target[r];
+                if (s < 0 || t < 0)
+                {
+                    valid = false;
+                    continue;
+                }
+                N = std::max(N, size_t(std::max(s, t)) + 1);
+                edges[offset[i] + r] = {size_t(s), size_t(t)};
+            }
+        }
+        if (!valid)
+            throw ValueException("Invalid vertex index in edge list");
+        while (num_vertices(g) < N)
+            add_vertex(g);
+    }
+
+    std::vector<size_t> eidx(E);
+    g.add_edges(E,
+                [&](size_t i) { return edges[i]; },
+                [&](size_t i, const auto& e) { eidx[i] = e.idx; });
+    std::vector<std::pair<size_t, size_t>>().swap(edges);
+
+    std::vector<csv_column_writer> writers;
+    for (auto& aprop : eprops)
+        writers.push_back(get_csv_column_writer(aprop,
+                                                g.get_edge_index_range()));
+
+    std::string err;
+    #pragma omp parallel for schedule(dynamic) if (n_chunks > 1)
+    for (size_t i = 0; i < n_chunks; ++i)
+    {
+        auto& chunk = chunks[i];
+        for (size_t r = 0; r < chunk.size(); ++r)
+        {
+            size_t ei = eidx[offset[i] + r];
+            for (size_t j = 0; j < fmt.n_props; ++j)
+            {
+                auto& val = chunk.values[r * fmt.n_props + j];
+                if (val.data() == nullptr)
+                    continue;
+                if (!writers[j](ei, val))
+                {
+                    #pragma omp critical
+                    err = "Invalid edge property value: " + std::string(val);
+                }
+            }
+        }
+    }
+    if (!err.empty())
+        throw ValueException(err);
+
+    row_offset += E;
+}
+
+} // namespace graph_tool
+
+#endif // GRAPH_IO_CSV_HH
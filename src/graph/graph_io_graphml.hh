@@ -0,0 +1,666 @@
+// graph-tool -- a general graph modification and manipulation thingy
+//
+// Copyright (C) 2006-2018 Tiago de Paula Peixoto <tiago@skewed.de>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GRAPH_IO_GRAPHML_HH
+#define GRAPH_IO_GRAPHML_HH
+
+#include "config.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <exception>
+#include <unordered_map>
+#include <unordered_set>
+#include <cstring>
+#include <expat.h>
+
+#include <boost/graph/graphml.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/mpl/find.hpp>
+#include <boost/mpl/for_each.hpp>
+
+#include "graph.hh"
+#include "graph_properties.hh"
+#include "graph_util.hh"
+#include "graph_io_binary.hh"
+#include "base64.hh"
+
+namespace graph_tool
+{
+
+// ========================================================================
+// GraphML reader
+// ========================================================================
+//
+// The file is parsed by expat in a single pass. The vertices and edges are
+// only numbered and buffered as they are found, and the raw text of the
+// <data> values is appended to a buffer of the corresponding property column,
+// i.e. of each key and element kind. Whenever the buffered data exceed
+// graphml_flush_size, and at the end of the file, the buffered edges are
+// inserted all at once via adj_list::add_edges(), and the values of each
+// column are converted and written directly to the typed property maps, in
+// parallel. Hence, besides the graph and its properties, the memory usage is
+// bounded regardless of the file size.
+
+constexpr size_t graphml_flush_size = 1 << 26;
+
+class graphml_reader
+{
+public:
+    typedef GraphInterface::multigraph_t graph_t;
+    typedef std::vector<std::pair<std::string, boost::any>> props_t;
+
+    // the graph g must be empty
+    graphml_reader(graph_t& g, bool store_ids,
+                   const std::unordered_set<std::string>& ignore_vp,
+                   const std::unordered_set<std::string>& ignore_ep,
+                   const std::unordered_set<std::string>& ignore_gp)
+        : _g(g), _store_ids(store_ids), _ignore{ignore_gp, ignore_vp, ignore_ep}
+    {}
+
+    // parses the file, and returns whether the graph is directed
+    bool run(std::istream& in)
+    {
+        const int buffer_size = 1 << 16;
+        std::unique_ptr<std::remove_pointer<XML_Parser>::type,
+                        decltype(&XML_ParserFree)>
+            parser(XML_ParserCreateNS(0, '|'), &XML_ParserFree);
+        _parser = parser.get();
+        XML_SetElementHandler(_parser, &on_start_element, &on_end_element);
+        XML_SetCharacterDataHandler(_parser, &on_character_data);
+        XML_SetUserData(_parser, this);
+
+        bool done = false;
+        while (!done)
+        {
+            void* buf = XML_GetBuffer(_parser, buffer_size);
+            if (buf == nullptr)
+                throw boost::parse_error("out of memory");
+            in.read(static_cast<char*>(buf), buffer_size);
+            size_t n = in.gcount();
+            done = in.eof() || n == 0;
+            if (!XML_ParseBuffer(_parser, n, done))
+            {
+                if (_error)
+                    std::rethrow_exception(_error);
+                throw boost::parse_error(location() +
+                                         XML_ErrorString(XML_GetErrorCode(_parser)));
+            }
+            if (_buffered > graphml_flush_size)
+                flush();
+        }
+        flush();
+        return _directed;
+    }
+
+    void get_properties(props_t& gprops, props_t& vprops, props_t& eprops)
+    {
+        for (auto& col : _columns)
+        {
+            if (col.map.empty())
+                continue;
+            switch (col.kind)
+            {
+            case graph_elem:
+                gprops.emplace_back(col.name, col.map);
+                break;
+            case vertex_elem:
+                vprops.emplace_back(col.name, col.map);
+                break;
+            case edge_elem:
+                eprops.emplace_back(col.name, col.map);
+                break;
+            }
+        }
+    }
+
+private:
+    enum elem_kind
+    {
+        graph_elem,
+        vertex_elem,
+        edge_elem
+    };
+
+    // the kinds of keys; not all of these are supported
+    enum key_kind
+    {
+        graph_key,
+        node_key,
+        edge_key,
+        hyperedge_key,
+        port_key,
+        endpoint_key,
+        all_key
+    };
+
+    struct entry
+    {
+        size_t key; // vertex or edge index
+        size_t pos;
+        size_t len;
+    };
+
+    struct column
+    {
+        elem_kind kind;
+        std::string name;
+        std::string type;
+        boost::any map;
+        std::string text;
+        std::vector<entry> entries;
+        bool has_default = false;
+        std::string default_value;
+        size_t default_from = 0;
+    };
+
+    struct key_info
+    {
+        key_kind kind = all_key;
+        std::string name;
+        std::string type;
+        int column[3] = {-1, -1, -1};
+    };
+
+    std::string location()
+    {
+        return "on line " +
+            boost::lexical_cast<std::string>(XML_GetCurrentLineNumber(_parser)) +
+            ", column " +
+            boost::lexical_cast<std::string>(XML_GetCurrentColumnNumber(_parser)) +
+            ": ";
+    }
+
+    static std::string_view local_name(const XML_Char* name)
+    {
+        std::string_view s(name);
+        std::string_view ns = "http://graphml.graphdrawing.org/xmlns|";
+        if (s.substr(0, ns.size()) == ns)
+            s.remove_prefix(ns.size());
+        return s;
+    }
+
+    // returns the index of the column of the given key and element kind, or
+    // a negative value if it is ignored; keys with the same name share the
+    // same column
+    int get_column(key_info& key, elem_kind kind)
+    {
+        int& c = key.column[kind];
+        if (c == -1)
+        {
+            auto iter = _column_index[kind].find(key.name);
+            if (_ignore[kind].find(key.name) != _ignore[kind].end())
+            {
+                c = -2;
+            }
+            else if (iter != _column_index[kind].end())
+            {
+                c = iter->second;
+            }
+            else
+            {
+                c = _columns.size();
+                _columns.emplace_back();
+                _columns.back().kind = kind;
+                _columns.back().name = key.name;
+                _columns.back().type = key.type;
+                _column_index[kind][key.name] = c;
+            }
+        }
+        return c;
+    }
+
+    key_info& get_id_key(elem_kind kind)
+    {
+        auto& key = _id_keys[kind];
+        key.name = (kind == vertex_elem) ? "_graphml_vertex_id" :
+            "_graphml_edge_id";
+        key.type = "string";
+        return key;
+    }
+
+    void put_value(int c, size_t k, std::string_view val)
+    {
+        if (c < 0)
+            return;
+        auto& col = _columns[c];
+        col.entries.push_back({k, col.text.size(), val.size()});
+        col.text.append(val);
+        _buffered += val.size() + sizeof(entry);
+    }
+
+    size_t handle_vertex(const std::string& id)
+    {
+        if (_canonical_vertices)
+        {
+            size_t v;
+            if (id.size() < 2 ||
+                !boost::conversion::try_lexical_convert(id.data() + 1,
+                                                        id.size() - 1, v))
+                throw boost::parse_error(location() + "invalid vertex: " + id);
+            _N = std::max(_N, v + 1);
+            return v;
+        }
+
+        auto iter = _vertex.find(id);
+        if (iter != _vertex.end())
+            return iter->second;
+        size_t v = _N++;
+        _vertex.emplace(id, v);
+        if (_store_ids)
+            put_value(get_column(get_id_key(vertex_elem), vertex_elem), v, id);
+        return v;
+    }
+
+    size_t handle_edge(const std::string& id, const std::string& s,
+                       const std::string& t)
+    {
+        size_t u = handle_vertex(s);
+        size_t v = handle_vertex(t);
+        size_t e = _E++;
+        _edges.emplace_back(u, v);
+        _buffered += sizeof(std::pair<size_t, size_t>);
+        if (_store_ids && !_canonical_edges)
+            put_value(get_column(get_id_key(edge_elem), edge_elem), e, id);
+        return e;
+    }
+
+    void set_directed(const char* value)
+    {
+        if (!_directed)
+            _directed = (std::strcmp(value, "directed") == 0);
+    }
+
+    void start_element(std::string_view name, const XML_Char** atts)
+    {
+        if (name == "edge")
+        {
+            std::string id, source, target;
+            for (; *atts; atts += 2)
+            {
+                std::string_view att = atts[0];
+                if (att == "id")
+                    id = atts[1];
+                else if (att == "source")
+                    source = atts[1];
+                else if (att == "target")
+                    target = atts[1];
+                else if (att == "directed")
+                    set_directed(atts[1]);
+            }
+            _active = handle_edge(id, source, target);
+            _active_kind = edge_elem;
+        }
+        else if (name == "node")
+        {
+            std::string id;
+            for (; *atts; atts += 2)
+            {
+                if (std::string_view(atts[0]) == "id")
+                    id = atts[1];
+            }
+            _active = handle_vertex(id);
+            _active_kind = vertex_elem;
+        }
+        else if (name == "data")
+        {
+            for (; *atts; atts += 2)
+            {
+                if (std::string_view(atts[0]) == "key")
+                    _active_key = atts[1];
+            }
+            _in_text = true;
+        }
+        else if (name == "default")
+        {
+            _in_text = true;
+        }
+        else if (name == "key")
+        {
+            std::string id;
+            key_info key;
+            for (; *atts; atts += 2)
+            {
+                std::string_view att = atts[0];
+                std::string_view value = atts[1];
+                if (att == "id")
+                    id = value;
+                else if (att == "attr.name")
+                    key.name = value;
+                else if (att == "attr.type")
+                    key.type = value;
+                else if (att == "for")
+                {
+                    if (value == "graph") key.kind = graph_key;
+                    else if (value == "node") key.kind = node_key;
+                    else if (value == "edge") key.kind = edge_key;
+                    else if (value == "hyperedge") key.kind = hyperedge_key;
+                    else if (value == "port") key.kind = port_key;
+                    else if (value == "endpoint") key.kind = endpoint_key;
+                    else if (value == "all") key.kind = all_key;
+                    else
+                        throw boost::parse_error(location() +
+                                                 "unrecognized key kind '" +
+                                                 std::string(value) + "'");
+                }
+            }
+            _keys[id] = key;
+            _active_key = id;
+        }
+        else if (name == "graph")
+        {
+            for (; *atts; atts += 2)
+            {
+                std::string_view att = atts[0];
+                std::string_view value = atts[1];
+                if (att == "edgedefault")
+                    set_directed(atts[1]);
+                else if (att == "parse.nodeids")
+                    _canonical_vertices = (value == "canonical");
+                else if (att == "parse.edgeids")
+                    _canonical_edges = (value == "canonical");
+            }
+            _active_kind = graph_elem;
+        }
+        _text.clear();
+    }
+
+    void end_element(std::string_view name)
+    {
+        if (name == "data")
+        {
+            _in_text = false;
+            auto iter = _keys.find(_active_key);
+            if (iter == _keys.end())
+                throw boost::parse_error(location() + "undefined key \"" +
+                                         _active_key + "\"");
+            size_t k = (_active_kind == graph_elem) ? 0 : _active;
+            put_value(get_column(iter->second, _active_kind), k, _text);
+        }
+        else if (name == "default")
+        {
+            _in_text = false;
+            auto& key = _keys[_active_key];
+            std::vector<elem_kind> kinds;
+            switch (key.kind)
+            {
+            case graph_key:
+                kinds = {graph_elem};
+                break;
+            case node_key:
+                kinds = {vertex_elem};
+                break;
+            case edge_key:
+                kinds = {edge_elem};
+                break;
+            case all_key:
+                kinds = {graph_elem, vertex_elem, edge_elem};
+                break;
+            default:
+                return;
+            }
+            for (auto kind : kinds)
+            {
+                int c = get_column(key, kind);
+                if (c < 0)
+                    continue;
+                auto& col = _columns[c];
+                col.has_default = true;
+                col.default_value = _text;
+                switch (kind)
+                {
+                case graph_elem:
+                    col.default_from = 0;
+                    break;
+                case vertex_elem:
+                    col.default_from = _N;
+                    break;
+                case edge_elem:
+                    col.default_from = _E;
+                    break;
+                }
+            }
+        }
+        else if (name == "node" || name == "edge")
+        {
+            _active_kind = graph_elem;
+        }
+    }
+
+    // The exceptions are not propagated through expat, but stored, and the
+    // parser is stopped.
+
+    static void on_start_element(void* user_data, const XML_Char* name,
+                                 const XML_Char** atts)
+    {
+        auto self = static_cast<graphml_reader*>(user_data);
+        try
+        {
+            self->start_element(local_name(name), atts);
+        }
+        catch (...)
+        {
+            self->_error = std::current_exception();
+            XML_StopParser(self->_parser, XML_FALSE);
+        }
+    }
+
+    static void on_end_element(void* user_data, const XML_Char* name)
+    {
+        auto self = static_cast<graphml_reader*>(user_data);
+        try
+        {
+            self->end_element(local_name(name));
+        }
+        catch (...)
+        {
+            self->_error = std::current_exception();
+            XML_StopParser(self->_parser, XML_FALSE);
+        }
+    }
+
+    static void on_character_data(void* user_data, const XML_Char* s, int len)
+    {
+        auto self = static_cast<graphml_reader*>(user_data);
+        if (self->_in_text)
+            self->_text.append(s, len);
+    }
+
+    // Property value conversion
+
+    template <class Value>
+    static Value convert(const std::string& val)
+    {
+        if constexpr (std::is_same<Value, uint8_t>::value)
+        {
+            if (val == "true" || val == "True")
+                return 1;
+            if (val == "false" || val == "False")
+                return 0;
+            return uint8_t(boost::lexical_cast<int>(val));
+        }
+        else if constexpr (std::is_same<Value, boost::python::object>::value)
+        {
+            return boost::lexical_cast<Value>(base64_decode(val));
+        }
+        else if constexpr (std::is_same<Value, std::string>::value)
+        {
+            return val;
+        }
+        else
+        {
+            return boost::lexical_cast<Value>(val);
+        }
+    }
+
+    std::string invalid_value(const column& col, const std::string& val)
+    {
+        return "invalid value \"" + val + "\" for key \"" + col.name +
+            "\" of type \"" + col.type + "\"";
+    }
+
+    template <class Value, class RangeTraits>
+    void put_column(column& col, size_t n0, size_t n)
+    {
+        typedef typename RangeTraits::index_map_t index_map_t;
+        typedef typename property_map_type::apply<Value, index_map_t>::type
+            pmap_t;
+
+        size_t d0 = std::max(n0, col.default_from);
+        bool has_default = col.has_default && d0 < n;
+        if (col.map.empty())
+        {
+            if (col.entries.empty() && !has_default)
+                return;
+            col.map = pmap_t(RangeTraits::get_index_map(_g));
+        }
+        auto pmap = boost::any_cast<pmap_t>(col.map);
+        pmap.reserve(n);
+        auto& storage = pmap.get_storage();
+
+        constexpr bool parallel =
+            !std::is_same<Value, boost::python::object>::value;
+
+        if (has_default)
+        {
+            Value val;
+            try
+            {
+                val = convert<Value>(col.default_value);
+            }
+            catch (boost::bad_lexical_cast&)
+            {
+                throw boost::parse_error(invalid_value(col, col.default_value));
+            }
+            #pragma omp parallel for schedule(runtime) \
+                if (parallel && n - d0 > OPENMP_MIN_THRESH)
+            for (size_t i = d0; i < n; ++i)
+                storage[i] = val;
+
+            // the default is applied only once to each element (the graph
+            // column is converted again at every flush)
+            col.default_from = n;
+        }
+
+        parallel_error error;
+        #pragma omp parallel for schedule(runtime) \
+            if (parallel && col.entries.size() > OPENMP_MIN_THRESH)
+        for (size_t i = 0; i < col.entries.size(); ++i)
+        {
+            const auto& e = col.entries[i];
+            std::string val = col.text.substr(e.pos, e.len);
+            try
+            {
+                storage[e.key] = convert<Value>(val);
+            }
+            catch (boost::bad_lexical_cast&)
+            {
+                error.set(std::make_exception_ptr
+                          (boost::parse_error(invalid_value(col, val))));
+            }
+            catch (...)
+            {
+                error.set(std::current_exception());
+            }
+        }
+        error.check();
+    }
+
+    void convert_column(column& col)
+    {
+        bool found = false;
+        boost::mpl::for_each<boost::prop_value_types>
+            ([&](auto v)
+             {
+                 typedef decltype(v) val_t;
+                 typedef typename boost::mpl::find<boost::prop_value_types,
+                                                   val_t>::type::pos pos_t;
+                 if (found || col.type != boost::prop_type_names[pos_t::value])
+                     return;
+                 found = true;
+                 switch (col.kind)
+                 {
+                 case graph_elem:
+                     put_column<val_t, graph_range_traits>(col, 0, 1);
+                     break;
+                 case vertex_elem:
+                     put_column<val_t, vertex_range_traits>(col, _flushed_N,
+                                                            _N);
+                     break;
+                 case edge_elem:
+                     put_column<val_t, edge_range_traits>(col, _flushed_E, _E);
+                     break;
+                 }
+             });
+        if (!found)
+            throw boost::parse_error("unrecognized type \"" + col.type +
+                                     "\" for key \"" + col.name + "\"");
+        col.text.clear();
+        col.entries.clear();
+    }
+
+    // inserts the buffered vertices and edges in the graph, and converts the
+    // buffered property values
+    void flush()
+    {
+        while (num_vertices(_g) < _N)
+            add_vertex(_g);
+        _g.add_edges(_edges.size(),
+                     [&](size_t i) { return _edges[i]; },
+                     [](size_t, const auto&) {});
+        _edges.clear();
+
+        for (auto& col : _columns)
+            convert_column(col);
+
+        _flushed_N = _N;
+        _flushed_E = _E;
+        _buffered = 0;
+    }
+
+    graph_t& _g;
+    bool _store_ids;
+    std::unordered_set<std::string> _ignore[3];
+    XML_Parser _parser = nullptr;
+    std::exception_ptr _error;
+
+    std::unordered_map<std::string, key_info> _keys;
+    key_info _id_keys[3];
+    std::vector<column> _columns;
+    std::unordered_map<std::string, int> _column_index[3];
+    std::unordered_map<std::string, size_t> _vertex;
+    std::vector<std::pair<size_t, size_t>> _edges;
+    size_t _N = 0, _E = 0;
+    size_t _flushed_N = 0, _flushed_E = 0;
+    size_t _buffered = 0;
+
+    bool _directed = false;
+    bool _canonical_vertices = false;
+    bool _canonical_edges = false;
+
+    size_t _active = 0;
+    elem_kind _active_kind = graph_elem;
+    std::string _active_key;
+    bool _in_text = false;
+    std::string _text;
+};
+
+} // namespace graph_tool
+
+#endif // GRAPH_IO_GRAPHML_HH
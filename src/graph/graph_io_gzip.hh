@@ -0,0 +1,328 @@
+// graph-tool -- a general graph modification and manipulation thingy
+//
+// Copyright (C) 2006-2018 Tiago de Paula Peixoto <tiago@skewed.de>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GRAPH_IO_GZIP_HH
+#define GRAPH_IO_GZIP_HH
+
+#include "config.h"
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <limits>
+#include <cstring>
+#include <zlib.h>
+
+#include <boost/iostreams/concepts.hpp>
+#include <boost/iostreams/operations.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#ifdef _OPENMP
+# include <omp.h>
+#endif
+
+#include "graph_exceptions.hh"
+
+namespace graph_tool
+{
+
+// ========================================================================
+// Chunked gzip files
+// ========================================================================
+//
+// The data is split into chunks of fixed size, which are compressed
+// independently (and in parallel) as separate gzip members. The concatenation
+// of gzip members is itself a valid gzip file, hence the output can be read by
+// any gzip decompressor. Each member carries its total compressed size in a
+// "GT" extra header field (similarly to the BGZF format), which allows the
+// members to be located without decompressing, and thus to be decompressed in
+// parallel as well.
+
+constexpr size_t gz_header_size = 20;
+constexpr size_t gz_trailer_size = 8;
+
+inline void gz_put_le(char* p, uint64_t x, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+        p[i] = char((x >> (8 * i)) & 0xff);
+}
+
+inline uint64_t gz_get_le(const char* p, size_t n)
+{
+    uint64_t x = 0;
+    for (size_t i = 0; i < n; ++i)
+        x |= uint64_t(uint8_t(p[i])) << (8 * i);
+    return x;
+}
+
+// compresses data[0:n] into a single gzip member, which is written to out;
+// returns false on failure
+inline bool gz_compress_member(const char* data, size_t n, int level,
+                               std::vector<char>& out)
+{
+    z_stream zs;
+    std::memset(&zs, 0, sizeof(zs));
+    if (deflateInit2(&zs, level, Z_DEFLATED, -MAX_WBITS, 8,
+                     Z_DEFAULT_STRATEGY) != Z_OK)
+        return false;
+    size_t bound = deflateBound(&zs, n);
+    out.resize(gz_header_size + bound + gz_trailer_size);
+    zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+    zs.avail_in = n;
+    zs.next_out = reinterpret_cast<Bytef*>(out.data() + gz_header_size);
+    zs.avail_out = bound;
+    int ret = deflate(&zs, Z_FINISH);
+    size_t m = zs.total_out;
+    deflateEnd(&zs);
+    if (ret != Z_STREAM_END)
+        return false;
+
+    size_t size = gz_header_size + m + gz_trailer_size;
+    const char header[] = {'\x1f', '\x8b', 8, 4, 0, 0, 0, 0, 0, '\xff',
+                           8, 0, 'G', 'T', 4, 0};
+    std::memcpy(out.data(), header, sizeof(header));
+    gz_put_le(out.data() + 16, size, 4);
+
+    char* trailer = out.data() + gz_header_size + m;
+    uLong crc = crc32(0, reinterpret_cast<const Bytef*>(data), n);
+    gz_put_le(trailer, crc, 4);
+    gz_put_le(trailer + 4, n, 4);
+    out.resize(size);
+    return true;
+}
+
+// Output filter for boost::iostreams, which writes chunked gzip files. Up to
+// one chunk per thread is compressed at a time.
+class parallel_gzip_compressor
+    : public boost::iostreams::multichar_output_filter
+{
+public:
+    parallel_gzip_compressor(int level = Z_DEFAULT_COMPRESSION,
+                             size_t chunk_size = 1 << 20)
+        : _level(level), _chunk_size(chunk_size), _nchunks(1)
+    {
+    #ifdef _OPENMP
+        _nchunks = omp_get_max_threads();
+    #endif
+    }
+
+    template <class Sink>
+    std::streamsize write(Sink& sink, const char* s, std::streamsize n)
+    {
+        _buf.insert(_buf.end(), s, s + n);
+        if (_buf.size() >= _chunk_size * _nchunks)
+            flush_chunks(sink, false);
+        return n;
+    }
+
+    template <class Sink>
+    void close(Sink& sink)
+    {
+        flush_chunks(sink, true);
+        _buf.clear();
+    }
+
+private:
+    template <class Sink>
+    void flush_chunks(Sink& sink, bool last)
+    {
+        size_t N = _buf.size() / _chunk_size;
+        if (last && _buf.size() % _chunk_size > 0)
+            N++;
+        std::vector<std::vector<char>> out(N);
+        bool ok = true;
+        #pragma omp parallel for schedule(dynamic) if (N > 1) \
+            reduction(&&:ok)
+        for (size_t i = 0; i < N; ++i)
+        {
+            size_t pos = i * _chunk_size;
+            size_t n = std::min(_chunk_size, _buf.size() - pos);
+            ok = ok && gz_compress_member(_buf.data() + pos, n, _level,
+                                          out[i]);
+        }
+        if (!ok)
+            throw IOException("error compressing data");
+        for (auto& o : out)
+            boost::iostreams::write(sink, o.data(), o.size());
+        _buf.erase(_buf.begin(),
+                   _buf.begin() + std::min(N * _chunk_size, _buf.size()));
+    }
+
+    int _level;
+    size_t _chunk_size;
+    size_t _nchunks;
+    std::vector<char> _buf;
+};
+
+// Locates the members of the chunked gzip file in data[0:size], and stores
+// their positions in pos, and the offsets of their decompressed contents in
+// offs (which has one more element, the total decompressed size). Returns
+// false if the data is not a chunked gzip file (e.g. an ordinary gzip file), in
+// which case it must be decompressed via a stream.
+inline bool gz_locate_members(const char* data, size_t size,
+                              std::vector<size_t>& pos,
+                              std::vector<size_t>& offs)
+{
+    const char header[] = {'\x1f', '\x8b', 8, 4};
+    const char extra[] = {8, 0, 'G', 'T', 4, 0};
+
+    pos.clear();
+    offs = {0};
+    for (size_t p = 0; p < size;)
+    {
+        if (size - p < gz_header_size + gz_trailer_size ||
+            std::memcmp(data + p, header, sizeof(header)) != 0 ||
+            std::memcmp(data + p + 10, extra, sizeof(extra)) != 0)
+            return false;
+        size_t m = gz_get_le(data + p + 16, 4);
+        if (m < gz_header_size + gz_trailer_size || m > size - p)
+            return false;
+        pos.push_back(p);
+        p += m;
+        offs.push_back(offs.back() + gz_get_le(data + p - 4, 4));
+    }
+    return true;
+}
+
+// Decompresses the i-th member located by gz_locate_members() into
+// out[0:offs[i+1]-offs[i]]; returns false if it is corrupted
+inline bool gz_inflate_member(const char* data, size_t size,
+                              const std::vector<size_t>& pos,
+                              const std::vector<size_t>& offs, size_t i,
+                              char* out)
+{
+    size_t N = pos.size();
+    const char* member = data + pos[i];
+    size_t m = ((i + 1 < N) ? pos[i + 1] : size) - pos[i];
+    size_t n = offs[i + 1] - offs[i];
+
+    z_stream zs;
+    std::memset(&zs, 0, sizeof(zs));
+    if (inflateInit2(&zs, -MAX_WBITS) != Z_OK)
+        return false;
+    zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(member)) +
+        gz_header_size;
+    zs.avail_in = m - gz_header_size - gz_trailer_size;
+    zs.next_out = reinterpret_cast<Bytef*>(out);
+    zs.avail_out = n;
+    int ret = inflate(&zs, Z_FINISH);
+    size_t total = zs.total_out;
+    inflateEnd(&zs);
+
+    uLong crc = crc32(0, reinterpret_cast<const Bytef*>(out), n);
+    return (ret == Z_STREAM_END && total == n &&
+            crc == gz_get_le(member + m - gz_trailer_size, 4));
+}
+
+// decompresses the members [first, last) into out, in parallel
+inline void gz_inflate_members(const char* data, size_t size,
+                               const std::vector<size_t>& pos,
+                               const std::vector<size_t>& offs, size_t first,
+                               size_t last, char* out)
+{
+    bool ok = true;
+    #pragma omp parallel for schedule(dynamic) if (last - first > 1) \
+        reduction(&&:ok)
+    for (size_t i = first; i < last; ++i)
+        ok = ok && gz_inflate_member(data, size, pos, offs, i,
+                                     out + offs[i] - offs[first]);
+    if (!ok)
+        throw IOException("error decompressing data: corrupted gzip member");
+}
+
+// Decompresses the chunked gzip file in data[0:size] into out, in parallel.
+// Returns false if the data is not a chunked gzip file, or if its decompressed
+// size is larger than max_size, in which case it must be decompressed via a
+// stream (e.g. with parallel_gunzip_source below).
+inline bool parallel_gunzip(const char* data, size_t size,
+                            std::vector<char>& out,
+                            size_t max_size = std::numeric_limits<size_t>::max())
+{
+    std::vector<size_t> pos, offs;
+    if (!gz_locate_members(data, size, pos, offs) || offs.back() > max_size)
+        return false;
+    out.resize(offs.back());
+    gz_inflate_members(data, size, pos, offs, 0, pos.size(), out.data());
+    return true;
+}
+
+// Input device for boost::iostreams, which decompresses a chunked gzip file in
+// batches of one member per thread. Only the current batch is kept in memory,
+// hence files of any size can be read.
+class parallel_gunzip_source
+{
+public:
+    typedef char char_type;
+    typedef boost::iostreams::source_tag category;
+
+    // the file must be a chunked gzip file, as given by is_chunked()
+    parallel_gunzip_source(const std::string& file)
+        : _state(std::make_shared<state>())
+    {
+        _state->mfile.open(file);
+        gz_locate_members(_state->mfile.data(), _state->mfile.size(),
+                          _state->pos, _state->offs);
+        _state->batch = 1;
+    #ifdef _OPENMP
+        _state->batch = omp_get_max_threads();
+    #endif
+    }
+
+    static bool is_chunked(const std::string& file)
+    {
+        boost::iostreams::mapped_file_source mfile(file);
+        std::vector<size_t> pos, offs;
+        return gz_locate_members(mfile.data(), mfile.size(), pos, offs);
+    }
+
+    std::streamsize read(char* s, std::streamsize n)
+    {
+        auto& st = *_state;
+        if (st.bpos == st.buf.size())
+        {
+            if (st.next == st.pos.size())
+                return -1;
+            size_t last = std::min(st.next + st.batch, st.pos.size());
+            st.buf.resize(st.offs[last] - st.offs[st.next]);
+            gz_inflate_members(st.mfile.data(), st.mfile.size(), st.pos,
+                               st.offs, st.next, last, st.buf.data());
+            st.next = last;
+            st.bpos = 0;
+        }
+        n = std::min(n, std::streamsize(st.buf.size() - st.bpos));
+        std::memcpy(s, st.buf.data() + st.bpos, n);
+        st.bpos += n;
+        return n;
+    }
+
+private:
+    // the device is copied by the stream, hence its state is shared
+    struct state
+    {
+        boost::iostreams::mapped_file_source mfile;
+        std::vector<size_t> pos, offs;
+        size_t batch = 1;
+        size_t next = 0;     // next member to be decompressed
+        std::vector<char> buf;
+        size_t bpos = 0;     // read position in buf
+    };
+    std::shared_ptr<state> _state;
+};
+
+} // graph_tool namespace
+
+#endif // GRAPH_IO_GZIP_HH
@@ -0,0 +1,92 @@
+// graph-tool -- a general graph modification and manipulation thingy
+//
+// Copyright (C) 2006-2018 Tiago de Paula Peixoto <tiago@skewed.de>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GRAPH_MEMORY_HH
+#define GRAPH_MEMORY_HH
+
+#include <string>
+#include <vector>
+#include <type_traits>
+
+namespace graph_tool
+{
+
+// ========================================================================
+// Memory accounting
+// ========================================================================
+//
+// get_memory_usage(x, m) accumulates in m the heap memory owned by x (not
+// including sizeof(x) itself), both the part which is actually used (size),
+// and the part which is allocated (capacity). The difference between the two
+// is what would be released by shrink_to_fit(). Nested containers are visited
+// recursively. The memory of Python objects is managed by the interpreter, and
+// is not accounted for.
+
+struct mem_usage_t
+{
+    size_t size = 0;
+    size_t capacity = 0;
+
+    mem_usage_t& operator+=(const mem_usage_t& m)
+    {
+        size += m.size;
+        capacity += m.capacity;
+        return *this;
+    }
+};
+
+template <class T>
+void get_memory_usage(const T&, mem_usage_t&)
+{
+    // scalars and unknown types own no heap memory
+}
+
+template <class CharT, class Traits, class Alloc>
+void get_memory_usage(const std::basic_string<CharT, Traits, Alloc>& s,
+                      mem_usage_t& m)
+{
+    static const size_t sso = std::basic_string<CharT, Traits, Alloc>()
+        .capacity();
+    if (s.capacity() <= sso)
+        return;     // short string, stored inline
+    m.size += (s.size() + 1) * sizeof(CharT);
+    m.capacity += (s.capacity() + 1) * sizeof(CharT);
+}
+
+template <class T, class Alloc>
+void get_memory_usage(const std::vector<T, Alloc>& v, mem_usage_t& m)
+{
+    m.size += v.size() * sizeof(T);
+    m.capacity += v.capacity() * sizeof(T);
+    if constexpr (!std::is_scalar<T>::value)
+    {
+        for (auto& x : v)
+            get_memory_usage(x, m);
+    }
+}
+
+template <class T>
+mem_usage_t get_memory_usage(const T& x)
+{
+    mem_usage_t m;
+    get_memory_usage(x, m);
+    return m;
+}
+
+} // graph_tool namespace
+
+#endif // GRAPH_MEMORY_HH
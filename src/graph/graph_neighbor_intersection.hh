@@ -0,0 +1,204 @@
+// graph-tool -- a general graph modification and manipulation thingy
+//
+// Copyright (C) 2006-2018 Tiago de Paula Peixoto <tiago@skewed.de>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GRAPH_NEIGHBOR_INTERSECTION_HH
+#define GRAPH_NEIGHBOR_INTERSECTION_HH
+
+#include <array>
+#include <iterator>
+#include <algorithm>
+#include <type_traits>
+
+#include "graph_adjacency.hh"
+#include "graph_adjacency_csr.hh"
+#include "graph_reverse.hh"
+#include "graph_adaptor.hh"
+#include "graph_filtered.hh"
+
+namespace graph_tool
+{
+
+// ========================================================================
+// Merge-based neighborhood intersections
+// ========================================================================
+//
+// If the adjacency is kept sorted (see adj_list::set_sorted()), the
+// neighborhood of a vertex in an unfiltered graph view is given by at most two
+// sorted runs: the out- (or in-) list for directed views, or both lists for
+// the undirected one. Membership tests against a neighborhood can then be done
+// by advancing a cursor in each run, instead of marking and unmarking the
+// neighbors in a vector of size O(V).
+
+// Returns the first position in [begin, end) not smaller than x, like
+// std::lower_bound(), but in O(log d) time, where d is the distance to the
+// result. Hence, a sequence of increasing searches through the whole range
+// costs O(n) overall, but is much faster if only a few elements are searched.
+template <class Iter, class T>
+Iter gallop_lower_bound(Iter begin, Iter end, const T& x)
+{
+    size_t n = end - begin;
+    if (n == 0 || !(begin[0] < x))
+        return begin;
+    size_t i = 0, step = 1;
+    while (i + step < n && begin[i + step] < x)
+    {
+        i += step;
+        step *= 2;
+    }
+    return std::lower_bound(begin + i + 1, begin + std::min(i + step, n), x);
+}
+
+// Graph views whose neighborhoods can be decomposed into sorted runs. Filtered
+// views are excluded, since their iterators are not random access.
+template <class Graph>
+struct has_neighbor_runs: public std::true_type {};
+
+template <class Graph, class EP, class VP>
+struct has_neighbor_runs<boost::filt_graph<Graph, EP, VP>>
+    : public std::false_type {};
+
+template <class Vertex>
+bool has_sorted_neighbors(const boost::adj_list<Vertex>& g)
+{
+    return g.get_sorted();
+}
+
+template <class Vertex>
+bool has_sorted_neighbors(const boost::adj_csr<Vertex>& g)
+{
+    return g.get_sorted();
+}
+
+template <class Graph, class GRef>
+bool has_sorted_neighbors(const boost::reversed_graph<Graph, GRef>& g)
+{
+    return has_sorted_neighbors(g._g);
+}
+
+template <class Graph>
+bool has_sorted_neighbors(const boost::undirected_adaptor<Graph>& g)
+{
+    return has_sorted_neighbors(g.original_graph());
+}
+
+template <class Graph, class EP, class VP>
+bool has_sorted_neighbors(const boost::filt_graph<Graph, EP, VP>&)
+{
+    return false;
+}
+
+// Returns the sorted runs (as iterator pairs) whose union is the multiset of
+// out-neighbors (or in-neighbors) of v in g.
+template <class Vertex, class Graph>
+auto get_neighbor_runs(Vertex v, const Graph& g)
+{
+    return std::array<decltype(out_neighbors(v, g)), 1>{{out_neighbors(v, g)}};
+}
+
+template <class Vertex, class Graph>
+auto get_in_neighbor_runs(Vertex v, const Graph& g)
+{
+    return std::array<decltype(in_neighbors(v, g)), 1>{{in_neighbors(v, g)}};
+}
+
+template <class Vertex, class Graph, class GRef>
+auto get_neighbor_runs(Vertex v, const boost::reversed_graph<Graph, GRef>& g)
+{
+    return get_in_neighbor_runs(v, g._g);
+}
+
+template <class Vertex, class Graph>
+auto get_neighbor_runs(Vertex v, const boost::undirected_adaptor<Graph>& g)
+{
+    auto& u = g.original_graph();
+    return std::array<decltype(out_neighbors(v, u)), 2>
+        {{out_neighbors(v, u), in_neighbors(v, u)}};
+}
+
+// Keeps one cursor per run of a neighborhood S, which are moved forward as
+// increasing values are queried.
+template <class Runs>
+class neighbor_runs_cursor
+{
+public:
+    neighbor_runs_cursor(const Runs& runs)
+        : _runs(runs)
+    {
+        reset();
+    }
+
+    void reset()
+    {
+        for (size_t i = 0; i < _runs.size(); ++i)
+            _pos[i] = _runs[i].first;
+    }
+
+    // returns true if x belongs to S; successive calls must be made with
+    // non-decreasing values of x (until the next reset())
+    template <class Value>
+    bool contains(const Value& x)
+    {
+        bool found = false;
+        for (size_t i = 0; i < _runs.size(); ++i)
+        {
+            _pos[i] = gallop_lower_bound(_pos[i], _runs[i].second, x);
+            if (_pos[i] != _runs[i].second && *_pos[i] == x)
+                found = true;
+        }
+        return found;
+    }
+
+    // true if all values larger than the last query are outside S
+    bool exhausted() const
+    {
+        for (size_t i = 0; i < _runs.size(); ++i)
+        {
+            if (_pos[i] != _runs[i].second)
+                return false;
+        }
+        return true;
+    }
+
+private:
+    const Runs& _runs;
+    std::array<typename Runs::value_type::first_type,
+               std::tuple_size<Runs>::value> _pos;
+};
+
+// Calls f(w) for each element w of the multiset given by the sorted runs A
+// (with multiplicity) that belongs to the set given by the sorted runs S.
+template <class ARuns, class SRuns, class F>
+void for_each_common(const ARuns& a_runs, const SRuns& s_runs, F&& f)
+{
+    neighbor_runs_cursor<SRuns> cursor(s_runs);
+    for (auto& run : a_runs)
+    {
+        for (auto iter = run.first; iter != run.second; ++iter)
+        {
+            auto w = *iter;
+            if (cursor.contains(w))
+                f(w);
+            else if (cursor.exhausted())
+                break;
+        }
+        cursor.reset();
+    }
+}
+
+} // graph_tool namespace
+
+#endif // GRAPH_NEIGHBOR_INTERSECTION_HH
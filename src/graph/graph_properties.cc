@@ -148,6 +148,128 @@ void GraphInterface::re_index_vertex_property(boost::any map,
 
 }
 
+struct do_permute_vertex_property
+{
+    template <class PropertyMap, class Vec>
+    void operator()(PropertyMap, const GraphInterface::multigraph_t& g,
+                    boost::any map, const Vec& vmap, bool& found) const
+    {
+        try
+        {
+            PropertyMap pmap = any_cast<PropertyMap>(map);
+            typedef typename property_traits<PropertyMap>::value_type val_t;
+            size_t N = num_vertices(g);
+            auto& vals = pmap.get_storage();
+            if (vals.size() < N)
+                vals.resize(N);
+            std::remove_reference_t<decltype(vals)> temp(vals.size(),
+                                                         vals.get_allocator());
+
+            // python objects cannot be copied outside of the main thread
+            #pragma omp parallel for schedule(runtime) \
+                if (N > OPENMP_MIN_THRESH &&            \
+                    !std::is_same<val_t, python::object>::value)
+            for (size_t v = 0; v < N; ++v)
+                temp[vmap[v]] = std::move(vals[v]);
+            for (size_t v = N; v < vals.size(); ++v)
+                temp[v] = std::move(vals[v]);
+            vals.swap(temp);
+            found = true;
+        }
+        catch (bad_any_cast&) {}
+    }
+};
+
+// this function will permute the values of a vertex property map, such that
+// the value of vertex v is moved to vertex vmap[v]
+void GraphInterface::permute_vertex_property(boost::any prop,
+                                             python::object ovmap) const
+{
+    boost::multi_array_ref<int64_t,1> vmap = get_array<int64_t,1>(ovmap);
+    bool found = false;
+    mpl::for_each<writable_vertex_properties>
+        (std::bind(do_permute_vertex_property(), std::placeholders::_1,
+                   std::ref(*_mg), prop, vmap, std::ref(found)));
+    if (!found)
+        throw GraphException("invalid writable property map");
+}
+
+struct do_compact_property
+{
+    template <class PropertyMap, class Vec>
+    void operator()(PropertyMap, boost::any map, const Vec& imap, size_t n,
+                    bool& found) const
+    {
+        if (found)
+            return;
+        try
+        {
+            PropertyMap pmap = any_cast<PropertyMap>(map);
+            typedef typename property_traits<PropertyMap>::value_type val_t;
+            auto& vals = pmap.get_storage();
+            size_t N = std::min(size_t(imap.size()), vals.size());
+            std::remove_reference_t<decltype(vals)> temp(n,
+                                                         vals.get_allocator());
+
+            // python objects cannot be copied outside of the main thread
+            #pragma omp parallel for schedule(runtime) \
+                if (N > OPENMP_MIN_THRESH &&            \
+                    !std::is_same<val_t, python::object>::value)
+            for (size_t i = 0; i < N; ++i)
+            {
+                if (imap[i] >= 0)
+                    temp[imap[i]] = std::move(vals[i]);
+            }
+            vals.swap(temp);
+            found = true;
+        }
+        catch (bad_any_cast&) {}
+    }
+};
+
+// the index mappings passed to do_compact_property() may only contain -1 or
+// valid indexes of the compacted property map
+void check_index_map(const boost::multi_array_ref<int64_t,1>& imap, size_t n)
+{
+    for (auto i : imap)
+    {
+        if (i < -1 || i >= int64_t(n))
+            throw ValueException("invalid index mapping: " +
+                                 lexical_cast<string>(i));
+    }
+}
+
+// this function will compact the values of a vertex property map after the
+// removal of vertices, such that the value of vertex v is moved to vertex
+// vmap[v], unless vmap[v] < 0, in which case it is discarded
+void GraphInterface::compact_vertex_property(boost::any prop,
+                                             python::object ovmap) const
+{
+    boost::multi_array_ref<int64_t,1> vmap = get_array<int64_t,1>(ovmap);
+    check_index_map(vmap, num_vertices(*_mg));
+    bool found = false;
+    mpl::for_each<writable_vertex_properties>
+        (std::bind(do_compact_property(), std::placeholders::_1, prop, vmap,
+                   num_vertices(*_mg), std::ref(found)));
+    if (!found)
+        throw GraphException("invalid writable property map");
+}
+
+// same as above, for edge property maps and the index mapping returned by
+// compact_edge_indexes()
+void GraphInterface::compact_edge_property(boost::any prop,
+                                           python::object oemap) const
+{
+    boost::multi_array_ref<int64_t,1> emap = get_array<int64_t,1>(oemap);
+    check_index_map(emap, _mg->get_edge_index_range());
+    bool found = false;
+    mpl::for_each<writable_edge_properties>
+        (std::bind(do_compact_property(), std::placeholders::_1, prop, emap,
+                   _mg->get_edge_index_range(), std::ref(found)));
+    if (!found)
+        throw GraphException("invalid writable property map");
+}
+
 } // graph_tool namespace
 
 
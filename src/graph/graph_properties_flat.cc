@@ -0,0 +1,444 @@
+// graph-tool -- a general graph modification and manipulation thingy
+//
+// Copyright (C) 2006-2018 Tiago de Paula Peixoto <tiago@skewed.de>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "graph.hh"
+#include "graph_properties.hh"
+#include "graph_filtering.hh"
+#include "graph_selectors.hh"
+#include "graph_util.hh"
+#include "numpy_bind.hh"
+#include "hash_map_wrap.hh"
+
+#include <boost/python/extract.hpp>
+
+using namespace std;
+using namespace boost;
+using namespace graph_tool;
+
+// Conversion between vector-valued or string property maps and flat numpy
+// arrays, which is done in a single pass, without creating intermediary scalar
+// property maps for each component (as done by ungroup_vector_property()).
+
+// Returns the vertex or edge indexes of the (possibly filtered) graph in
+// increasing order, which is also the order used by PropertyMap.fa.
+template <class Graph>
+vector<size_t> get_key_indexes(Graph& g, bool edge)
+{
+    vector<size_t> idxs;
+    if (!edge)
+    {
+        for (auto v : vertices_range(g))
+            idxs.push_back(v);
+    }
+    else
+    {
+        auto eindex = get(edge_index_t(), g);
+        for (auto e : edges_range(g))
+            idxs.push_back(eindex[e]);
+        std::sort(idxs.begin(), idxs.end());
+    }
+    return idxs;
+}
+
+// Copies the components given by pos to the rows of a two-dimensional array;
+// missing components are set to zero.
+struct do_get_vector_array
+{
+    template <class Graph, class VectorProp>
+    void operator()(Graph& g, VectorProp prop, bool edge,
+                    const vector<int64_t>& pos, python::object& ret) const
+    {
+        typedef typename property_traits<VectorProp>::value_type::value_type
+            val_t;
+        auto idxs = get_key_indexes(g, edge);
+        auto& vals = prop.get_storage();
+        size_t N = idxs.size();
+
+        boost::multi_array<val_t, 2> a(boost::extents[pos.size()][N]);
+
+        #pragma omp parallel for default(shared) schedule(runtime) \
+            if (N > OPENMP_MIN_THRESH)
+        for (size_t i = 0; i < N; ++i)
+        {
+            size_t k = idxs[i];
+            for (size_t j = 0; j < pos.size(); ++j)
+            {
+                size_t l = pos[j];
+                if (k < vals.size() && l < vals[k].size())
+                    a[j][i] = vals[k][l];
+                else
+                    a[j][i] = val_t();
+            }
+        }
+        ret = wrap_multi_array_owned(a);
+    }
+};
+
+struct do_set_vector_array
+{
+    template <class Graph, class VectorProp>
+    void operator()(Graph& g, VectorProp prop, bool edge,
+                    const vector<int64_t>& pos, python::object oa) const
+    {
+        typedef typename property_traits<VectorProp>::value_type::value_type
+            val_t;
+        auto idxs = get_key_indexes(g, edge);
+        size_t N = idxs.size();
+
+        auto a = get_array<val_t, 2>(oa);
+        if (a.shape()[0] != pos.size() || a.shape()[1] != N)
+            throw ValueException("array of shape (" +
+                                 lexical_cast<string>(a.shape()[0]) + ", " +
+                                 lexical_cast<string>(a.shape()[1]) +
+                                 ") cannot be assigned to " +
+                                 lexical_cast<string>(pos.size()) +
+                                 " components of " + lexical_cast<string>(N) +
+                                 " property values");
+
+        size_t max_pos = 0;
+        for (auto l : pos)
+        {
+            if (l < 0)
+                throw ValueException("invalid component index: " +
+                                     lexical_cast<string>(l));
+            max_pos = std::max(max_pos, size_t(l));
+        }
+
+        auto& vals = prop.get_storage();
+        if (!idxs.empty() && vals.size() <= idxs.back())
+            vals.resize(idxs.back() + 1);
+
+        #pragma omp parallel for default(shared) schedule(runtime) \
+            if (N > OPENMP_MIN_THRESH)
+        for (size_t i = 0; i < N; ++i)
+        {
+            auto& x = vals[idxs[i]];
+            if (x.size() <= max_pos)
+                x.resize(max_pos + 1);
+            for (size_t j = 0; j < pos.size(); ++j)
+                x[pos[j]] = a[j][i];
+        }
+    }
+};
+
+// Ragged representation: the values of the i-th vertex or edge are
+// values[offsets[i]:offsets[i+1]].
+struct do_get_vector_ragged
+{
+    template <class Graph, class VectorProp>
+    void operator()(Graph& g, VectorProp prop, bool edge,
+                    python::object& ret) const
+    {
+        typedef typename property_traits<VectorProp>::value_type::value_type
+            val_t;
+        auto idxs = get_key_indexes(g, edge);
+        auto& vals = prop.get_storage();
+        size_t N = idxs.size();
+
+        vector<int64_t> offsets(N + 1, 0);
+        for (size_t i = 0; i < N; ++i)
+        {
+            size_t k = idxs[i];
+            offsets[i + 1] = offsets[i] + ((k < vals.size()) ?
+                                           vals[k].size() : 0);
+        }
+
+        vector<val_t> values(offsets.back());
+
+        #pragma omp parallel for default(shared) schedule(runtime) \
+            if (N > OPENMP_MIN_THRESH)
+        for (size_t i = 0; i < N; ++i)
+        {
+            size_t k = idxs[i];
+            if (k < vals.size())
+                std::copy(vals[k].begin(), vals[k].end(),
+                          values.begin() + offsets[i]);
+        }
+
+        ret = python::make_tuple(wrap_vector_owned(offsets),
+                                 wrap_vector_owned(values));
+    }
+};
+
+struct do_set_vector_ragged
+{
+    template <class Graph, class VectorProp>
+    void operator()(Graph& g, VectorProp prop, bool edge,
+                    python::object ooffsets, python::object ovalues) const
+    {
+        typedef typename property_traits<VectorProp>::value_type::value_type
+            val_t;
+        auto idxs = get_key_indexes(g, edge);
+        size_t N = idxs.size();
+
+        auto offsets = get_array<int64_t, 1>(ooffsets);
+        auto values = get_array<val_t, 1>(ovalues);
+
+        if (offsets.shape()[0] != N + 1)
+            throw ValueException("offsets array must have " +
+                                 lexical_cast<string>(N + 1) + " elements");
+        if (offsets[0] != 0 || offsets[N] != int64_t(values.shape()[0]))
+            throw ValueException("offsets must span the whole values array");
+        for (size_t i = 0; i < N; ++i)
+        {
+            if (offsets[i + 1] < offsets[i])
+                throw ValueException("offsets must be non-decreasing");
+        }
+
+        auto& vals = prop.get_storage();
+        if (!idxs.empty() && vals.size() <= idxs.back())
+            vals.resize(idxs.back() + 1);
+
+        #pragma omp parallel for default(shared) schedule(runtime) \
+            if (N > OPENMP_MIN_THRESH)
+        for (size_t i = 0; i < N; ++i)
+        {
+            auto& x = vals[idxs[i]];
+            x.resize(offsets[i + 1] - offsets[i]);
+            for (size_t j = 0; j < x.size(); ++j)
+                x[j] = values[offsets[i] + j];
+        }
+    }
+};
+
+template <class Action>
+void dispatch_vector_property(GraphInterface& gi, boost::any prop, bool edge,
+                              Action&& a)
+{
+    if (edge)
+        run_action<graph_tool::detail::always_directed_never_reversed>()
+            (gi, [&](auto& g, auto p) { a(g, p); },
+             edge_scalar_vector_properties())(prop);
+    else
+        run_action<graph_tool::detail::always_directed_never_reversed>()
+            (gi, [&](auto& g, auto p) { a(g, p); },
+             vertex_scalar_vector_properties())(prop);
+}
+
+python::object get_vector_property_array(GraphInterface& gi, boost::any prop,
+                                         python::object opos, bool edge)
+{
+    auto apos = get_array<int64_t, 1>(opos);
+    vector<int64_t> pos(apos.begin(), apos.end());
+    for (auto l : pos)
+    {
+        if (l < 0)
+            throw ValueException("invalid component index: " +
+                                 lexical_cast<string>(l));
+    }
+    python::object ret;
+    dispatch_vector_property
+        (gi, prop, edge,
+         [&](auto& g, auto p)
+         { do_get_vector_array()(g, p, edge, pos, ret); });
+    return ret;
+}
+
+void set_vector_property_array(GraphInterface& gi, boost::any prop,
+                               python::object oa, python::object opos,
+                               bool edge)
+{
+    auto apos = get_array<int64_t, 1>(opos);
+    vector<int64_t> pos(apos.begin(), apos.end());
+    dispatch_vector_property
+        (gi, prop, edge,
+         [&](auto& g, auto p)
+         { do_set_vector_array()(g, p, edge, pos, oa); });
+}
+
+python::object get_vector_property_ragged(GraphInterface& gi, boost::any prop,
+                                          bool edge)
+{
+    python::object ret;
+    dispatch_vector_property
+        (gi, prop, edge,
+         [&](auto& g, auto p)
+         { do_get_vector_ragged()(g, p, edge, ret); });
+    return ret;
+}
+
+void set_vector_property_ragged(GraphInterface& gi, boost::any prop,
+                                python::object ooffsets,
+                                python::object ovalues, bool edge)
+{
+    dispatch_vector_property
+        (gi, prop, edge,
+         [&](auto& g, auto p)
+         { do_set_vector_ragged()(g, p, edge, ooffsets, ovalues); });
+}
+
+// Returns a flat vertex property map over the given float64 array, which is
+// either two-dimensional, with one row per vertex index, or one-dimensional
+// with the ragged layout given by the offsets array. Nothing is copied, and the
+// arrays are kept alive by the map.
+boost::any get_flat_vertex_property(GraphInterface& gi, python::object ovalues,
+                                    python::object ooffsets)
+{
+    size_t N = gi.get_num_vertices(false);
+
+    auto check_array = [](python::object& oa, const string& name)
+        {
+            PyArrayObject* pa = (PyArrayObject*) oa.ptr();
+            if (!PyArray_Check(oa.ptr()) || !PyArray_IS_C_CONTIGUOUS(pa) ||
+                !PyArray_ISWRITEABLE(pa))
+                throw ValueException(name + " must be a writable, "
+                                     "C-contiguous numpy array");
+        };
+    check_array(ovalues, "values");
+
+    auto handle = std::shared_ptr<void>
+        (new python::object(python::make_tuple(ovalues, ooffsets)),
+         [](void* p)
+         {
+             GILAcquire gil;
+             delete static_cast<python::object*>(p);
+         });
+
+    if (ooffsets.is_none())
+    {
+        auto a = get_array<double, 2>(ovalues);
+        if (a.shape()[0] != N)
+            throw ValueException("values array has " +
+                                 lexical_cast<string>(a.shape()[0]) +
+                                 " rows, but the graph has " +
+                                 lexical_cast<string>(N) + " vertices");
+        return vertex_flat_vector_map_t(a.data(), a.shape()[1],
+                                        gi.get_vertex_index(), handle);
+    }
+
+    check_array(ooffsets, "offsets");
+    auto offsets = get_array<int64_t, 1>(ooffsets);
+    auto values = get_array<double, 1>(ovalues);
+    if (offsets.shape()[0] != N + 1)
+        throw ValueException("offsets array must have " +
+                             lexical_cast<string>(N + 1) + " elements");
+    if (offsets[0] != 0 || offsets[N] != int64_t(values.shape()[0]))
+        throw ValueException("offsets must span the whole values array");
+    for (size_t i = 0; i < N; ++i)
+    {
+        if (offsets[i + 1] < offsets[i])
+            throw ValueException("offsets must be non-decreasing");
+    }
+    return vertex_flat_vector_map_t(values.data(), offsets.data(),
+                                    gi.get_vertex_index(), handle);
+}
+
+// Dictionary encoding of string property maps: each distinct value is given an
+// integer code, in order of first appearance. This is much more compact for
+// low-cardinality labels, and allows comparisons to be done on the codes. Note
+// that this only produces an encoded copy: the property maps themselves still
+// store one std::string per element.
+struct do_get_string_codes
+{
+    template <class Graph, class StringProp>
+    void operator()(Graph& g, StringProp prop, bool edge,
+                    python::object& ret) const
+    {
+        auto idxs = get_key_indexes(g, edge);
+        auto& vals = prop.get_storage();
+        if (!idxs.empty() && vals.size() <= idxs.back())
+            vals.resize(idxs.back() + 1);
+
+        gt_hash_map<std::string, int64_t> dict;
+        vector<int64_t> codes(idxs.size());
+        python::list categories;
+        for (size_t i = 0; i < idxs.size(); ++i)
+        {
+            auto& x = vals[idxs[i]];
+            auto iter = dict.find(x);
+            if (iter == dict.end())
+            {
+                iter = dict.insert({x, dict.size()}).first;
+                categories.append(x);
+            }
+            codes[i] = iter->second;
+        }
+        ret = python::make_tuple(wrap_vector_owned(codes), categories);
+    }
+};
+
+struct do_set_string_codes
+{
+    template <class Graph, class StringProp>
+    void operator()(Graph& g, StringProp prop, bool edge,
+                    python::object ocodes, python::object ocategories) const
+    {
+        auto idxs = get_key_indexes(g, edge);
+        size_t N = idxs.size();
+
+        auto codes = get_array<int64_t, 1>(ocodes);
+        if (codes.shape()[0] != N)
+            throw ValueException("codes array must have " +
+                                 lexical_cast<string>(N) + " elements");
+
+        vector<std::string> categories;
+        for (int i = 0; i < python::len(ocategories); ++i)
+            categories.push_back(python::extract<std::string>(ocategories[i]));
+
+        for (size_t i = 0; i < N; ++i)
+        {
+            if (codes[i] < 0 || size_t(codes[i]) >= categories.size())
+                throw ValueException("invalid code: " +
+                                     lexical_cast<string>(codes[i]));
+        }
+
+        auto& vals = prop.get_storage();
+        if (!idxs.empty() && vals.size() <= idxs.back())
+            vals.resize(idxs.back() + 1);
+
+        #pragma omp parallel for default(shared) schedule(runtime) \
+            if (N > OPENMP_MIN_THRESH)
+        for (size_t i = 0; i < N; ++i)
+            vals[idxs[i]] = categories[codes[i]];
+    }
+};
+
+template <class Action>
+void dispatch_string_property(GraphInterface& gi, boost::any prop, bool edge,
+                              Action&& a)
+{
+    if (edge)
+        run_action<graph_tool::detail::always_directed_never_reversed>()
+            (gi, [&](auto& g, auto p) { a(g, p); },
+             boost::mpl::vector<eprop_map_t<std::string>::type>())(prop);
+    else
+        run_action<graph_tool::detail::always_directed_never_reversed>()
+            (gi, [&](auto& g, auto p) { a(g, p); },
+             boost::mpl::vector<vprop_map_t<std::string>::type>())(prop);
+}
+
+python::object get_string_property_codes(GraphInterface& gi, boost::any prop,
+                                         bool edge)
+{
+    python::object ret;
+    dispatch_string_property
+        (gi, prop, edge,
+         [&](auto& g, auto p)
+         { do_get_string_codes()(g, p, edge, ret); });
+    return ret;
+}
+
+void set_string_property_codes(GraphInterface& gi, boost::any prop,
+                               python::object ocodes,
+                               python::object ocategories, bool edge)
+{
+    dispatch_string_property
+        (gi, prop, edge,
+         [&](auto& g, auto p)
+         { do_set_string_codes()(g, p, edge, ocodes, ocategories); });
+}
@@ -18,23 +18,85 @@
 #ifndef GRAPH_PROPERTIES_GROUP_HH
 #define GRAPH_PROPERTIES_GROUP_HH
 
+#include <limits>
+#include <type_traits>
+#include <typeinfo>
+#include <cmath>
+#include <boost/numeric/conversion/cast.hpp>
+
 namespace graph_tool
 {
 
+// Groups a scalar property map into the component pos of a vector property
+// map, or ungroups it (if Group is false). The property maps are accessed
+// unchecked, after being resized upfront, so that the values can be written in
+// parallel without synchronization. Python objects, however, can only be
+// handled in the main thread, so the loop is serial if they are involved.
+// Conversion failures inside the loop are recorded, and raised after it.
+
+template <class PropertyMap>
+PropertyMap get_reserved(PropertyMap map, size_t)
+{
+    return map; // index maps
+}
+
+template <class Value, class IndexMap>
+auto get_reserved(boost::checked_vector_property_map<Value, IndexMap> map,
+                  size_t n)
+{
+    return map.get_unchecked(n);
+}
+
+template <class Value, class IndexMap>
+auto get_reserved(boost::unchecked_vector_property_map<Value, IndexMap> map,
+                  size_t n)
+{
+    map.reserve(n);
+    return map;
+}
+
 template <class Group = boost::mpl::true_, class Edge = boost::mpl::false_>
 struct do_group_vector_property
 {
 
     template <class Graph, class VectorPropertyMap, class PropertyMap>
     void operator()(Graph& g, VectorPropertyMap vector_map, PropertyMap map,
-                    size_t pos) const
+                    size_t pos, size_t edge_index_range) const
     {
-        parallel_vertex_loop
-            (g,
-             [&](auto v)
-             {
-                 this->dispatch_descriptor(g, vector_map, map, v, pos, Edge());
-             });
+        typedef typename boost::property_traits<VectorPropertyMap>::value_type
+            ::value_type vval_t;
+        typedef typename boost::property_traits<PropertyMap>::value_type val_t;
+        constexpr bool is_python =
+            std::is_same<vval_t, boost::python::object>::value ||
+            std::is_same<val_t, boost::python::object>::value;
+        constexpr size_t thres = is_python ?
+            std::numeric_limits<size_t>::max() : OPENMP_MIN_THRESH;
+
+        size_t n = Edge::value ? edge_index_range : num_vertices(g);
+        auto uvector_map = get_reserved(vector_map, n);
+        auto umap = get_reserved(map, n);
+
+        parallel_error error;
+        auto f = [&](auto v)
+            {
+                try
+                {
+                    this->dispatch_descriptor(g, uvector_map, umap, v, pos,
+                                              Edge());
+                }
+                catch (std::bad_cast& e)
+                {
+                    error.set(std::make_exception_ptr
+                              (ValueException(std::string("Cannot convert property value: ") +
+                                              e.what())));
+                }
+                catch (...)
+                {
+                    error.set(std::current_exception());
+                }
+            };
+        parallel_vertex_loop<Graph, decltype(f)&, thres>(g, f);
+        error.check();
     }
 
     template <class Graph, class VectorPropertyMap, class PropertyMap,
@@ -82,20 +144,46 @@ struct do_group_vector_property
     template <class RetVal, class Value>
     inline void convert(const Value& v, RetVal& r)  const
     {
-        r = boost::lexical_cast<RetVal>(v);
+        // numeric conversions are done directly, instead of via strings, but
+        // fail in the same cases, i.e. for values out of range, and for
+        // fractional or NaN values converted to integers
+        if constexpr (std::is_arithmetic<Value>::value &&
+                      std::is_arithmetic<RetVal>::value)
+        {
+            if constexpr (std::is_floating_point<Value>::value &&
+                          std::is_integral<RetVal>::value)
+            {
+                if (!(std::trunc(v) == v))
+                    throw boost::bad_lexical_cast(typeid(Value),
+                                                  typeid(RetVal));
+            }
+            if constexpr (std::is_floating_point<Value>::value &&
+                          std::is_floating_point<RetVal>::value)
+            {
+                // infinities and NaNs are representable in every precision
+                if (!std::isfinite(v))
+                {
+                    r = static_cast<RetVal>(v);
+                    return;
+                }
+            }
+            r = boost::numeric_cast<RetVal>(v);
+        }
+        else
+        {
+            r = boost::lexical_cast<RetVal>(v);
+        }
     }
 
     template <class RetVal>
     inline void convert(const boost::python::object& v, RetVal& r)  const
     {
-        #pragma omp critical
         r = boost::python::extract<RetVal>(v);
     }
 
     template <class Value>
     inline void convert(const Value& v, boost::python::object& r)  const
     {
-        #pragma omp critical
         r = boost::python::object(v);
     }
 
@@ -107,7 +195,6 @@ struct do_group_vector_property
 
     inline void convert(const boost::python::object& v, boost::python::object& r)  const
     {
-       #pragma omp critical
         r = v;
     }
 
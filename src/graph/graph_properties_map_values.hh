@@ -18,29 +18,145 @@
 #ifndef GRAPH_PROPERTIES_MAP_VALUES_HH
 #define GRAPH_PROPERTIES_MAP_VALUES_HH
 
+#include <atomic>
 #include <unordered_map>
 #include <boost/python/extract.hpp>
 
+#include "hash_map_wrap.hh"
+#include "numpy_bind.hh"
+
 namespace graph_tool
 {
 
 using namespace boost;
 
+// Maps the values of src to tgt, according to mapper, which can be a
+// dictionary, a numpy array used as a lookup table (if the source values are
+// integers), or any callable object. Dictionaries and arrays are converted
+// once, and the mapping is then done in parallel; callables are invoked once
+// per distinct value. Unless the values are python objects, the GIL is released
+// during the mapping, and re-acquired only to call the mapper.
 struct do_map_values
 {
 
     template <class Graph, class SrcProp, class TgtProp>
-    void operator()(Graph& g, SrcProp src, TgtProp tgt, python::object& mapper) const
+    void operator()(Graph& g, SrcProp src, TgtProp tgt, python::object& mapper,
+                    size_t edge_index_range) const
     {
         typedef typename graph_traits<Graph>::vertex_descriptor vertex_t;
         typedef typename property_traits<SrcProp>::key_type key_type;
         typedef typename property_traits<SrcProp>::value_type src_value_type;
         typedef typename property_traits<TgtProp>::value_type tgt_value_type;
+        typedef typename std::is_same<key_type, vertex_t>::type is_vertex;
+
+        size_t n = is_vertex::value ? num_vertices(g) : edge_index_range;
+        tgt.reserve(n);
+
+        bool is_dict = PyDict_Check(mapper.ptr());
+        bool is_array = PyArray_Check(mapper.ptr());
+
+        if constexpr (!std::is_same<src_value_type, python::object>::value &&
+                      !std::is_same<tgt_value_type, python::object>::value)
+        {
+            if (is_dict && map_dict(g, src, tgt, mapper, is_vertex()))
+                return;
+
+            if constexpr (std::is_integral<src_value_type>::value &&
+                          std::is_arithmetic<tgt_value_type>::value)
+            {
+                if (is_array)
+                {
+                    map_array(g, src, tgt, mapper, is_vertex());
+                    return;
+                }
+            }
+        }
+
+        python::object f = mapper;
+        if (is_dict || is_array)
+            f = mapper.attr("__getitem__");
 
         std::unordered_map<src_value_type, tgt_value_type> value_map;
+        dispatch(g, src, tgt, value_map, f, is_vertex());
+    }
+
+    template <class Graph, class F>
+    void parallel_key_loop(Graph& g, F&& f, std::true_type) const
+    {
+        parallel_vertex_loop(g, f);
+    }
+
+    template <class Graph, class F>
+    void parallel_key_loop(Graph& g, F&& f, std::false_type) const
+    {
+        parallel_edge_loop(g, f);
+    }
+
+    template <class Graph, class SrcProp, class TgtProp, class IsVertex>
+    bool map_dict(Graph& g, SrcProp& src, TgtProp& tgt, python::object& mapper,
+                  IsVertex) const
+    {
+        typedef typename property_traits<SrcProp>::value_type src_value_type;
+        typedef typename property_traits<TgtProp>::value_type tgt_value_type;
 
-        dispatch(g, src, tgt, value_map, mapper, std::is_same<key_type, vertex_t>());
+        gt_hash_map<src_value_type, tgt_value_type> value_map;
+        python::list items = python::dict(mapper).items();
+        for (int i = 0; i < python::len(items); ++i)
+        {
+            python::extract<src_value_type> k(items[i][0]);
+            python::extract<tgt_value_type> x(items[i][1]);
+            if (!k.check() || !x.check())
+                return false; // fall back to calling the dictionary
+            value_map[k()] = x();
+        }
 
+        GILRelease gil_release;
+        std::atomic<bool> missing(false);
+        parallel_key_loop
+            (g,
+             [&](auto v)
+             {
+                 auto iter = value_map.find(src[v]);
+                 if (iter == value_map.end())
+                 {
+                     missing = true;
+                     return;
+                 }
+                 tgt[v] = iter->second;
+             }, IsVertex());
+        if (missing)
+            throw ValueException("property value not found in mapping "
+                                 "dictionary");
+        return true;
+    }
+
+    template <class Graph, class SrcProp, class TgtProp, class IsVertex>
+    void map_array(Graph& g, SrcProp& src, TgtProp& tgt, python::object& mapper,
+                   IsVertex) const
+    {
+        typedef typename property_traits<TgtProp>::value_type tgt_value_type;
+
+        auto table = get_array<tgt_value_type, 1>(mapper);
+        int64_t M = table.shape()[0];
+
+        GILRelease gil_release;
+        std::atomic<bool> out_of_bounds(false);
+        parallel_key_loop
+            (g,
+             [&](auto v)
+             {
+                 int64_t k = src[v];
+                 if (k < 0 || k >= M)
+                 {
+                     out_of_bounds = true;
+                     return;
+                 }
+                 tgt[v] = table[k];
+             }, IsVertex());
+        if (out_of_bounds)
+            throw ValueException("property value out of bounds of the mapping "
+                                 "array (of size " +
+                                 boost::lexical_cast<std::string>(M) + ")");
     }
 
     template <class Graph, class SrcProp, class TgtProp, class ValueMap>
@@ -61,13 +177,18 @@ struct do_map_values
     void dispatch_descriptor(SrcProp& src, TgtProp& tgt, ValueMap& value_map,
                              python::object& mapper, Range&& range) const
     {
+        typedef typename property_traits<SrcProp>::value_type src_value_type;
         typedef typename property_traits<TgtProp>::value_type tgt_value_type;
+        GILRelease gil_release
+            (!std::is_same<src_value_type, python::object>::value &&
+             !std::is_same<tgt_value_type, python::object>::value);
         for (const auto& v : range)
         {
             const auto& k = src[v];
             const auto& iter = value_map.find(k);
             if (iter == value_map.end())
             {
+                GILAcquire gil;
                 value_map[k] = tgt[v] =
                     boost::python::extract<tgt_value_type>(mapper(k));
             }
@@ -34,7 +34,8 @@ void edge_property_map_values(GraphInterface& g, boost::any src_prop,
 {
     run_action<graph_tool::detail::always_directed_never_reversed>()
         (g, std::bind(do_map_values(), std::placeholders::_1, std::placeholders::_2,
-                      std::placeholders::_3, std::ref(mapper)),
+                      std::placeholders::_3, std::ref(mapper),
+                      g.get_edge_index_range()),
          edge_properties(), writable_edge_properties())
         (src_prop, tgt_prop);
 }
@@ -45,13 +45,15 @@ void ungroup_vector_property(GraphInterface& g, boost::any vector_prop,
     if (edge)
         run_action<graph_tool::detail::always_directed_never_reversed>()
             (g, bind(do_group_vector_property<boost::mpl::false_,boost::mpl::true_>(),
-                     std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, pos),
+                     std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, pos,
+                     g.get_edge_index_range()),
              edge_vector_properties(), writable_edge_properties())
             (vector_prop, prop);
     else
         run_action<graph_tool::detail::always_directed_never_reversed>()
             (g, bind(do_group_vector_property<boost::mpl::false_,boost::mpl::false_>(),
-                     std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, pos),
+                     std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, pos,
+                     g.get_edge_index_range()),
              vertex_vector_properties(), writable_vertex_properties())
             (vector_prop, prop);
 }
@@ -23,6 +23,7 @@
 #include <boost/python.hpp>
 #include <boost/python/stl_iterator.hpp>
 #include <set>
+#include <atomic>
 
 
 using namespace std;
@@ -148,6 +149,7 @@ struct add_new_vertex
 
 python::object add_vertex(GraphInterface& gi, size_t n)
 {
+    gi.check_thawed();
     python::object v;
     run_action<>()(gi, std::bind(add_new_vertex(), std::placeholders::_1,
                                  std::ref(gi), n, std::ref(v)))();
@@ -157,6 +159,7 @@ python::object add_vertex(GraphInterface& gi, size_t n)
 
 void remove_vertex_array(GraphInterface& gi, const python::object& oindex, bool fast)
 {
+    gi.check_thawed();
     boost::multi_array_ref<int64_t,1> index = get_array<int64_t,1>(oindex);
     auto& g = gi.get_graph();
     if (fast)
@@ -173,6 +176,7 @@ void remove_vertex_array(GraphInterface& gi, const python::object& oindex, bool
 
 void remove_vertex(GraphInterface& gi, size_t v, bool fast)
 {
+    gi.check_thawed();
     auto& g = gi.get_graph();
     if (fast)
     {
@@ -195,6 +199,7 @@ struct do_clear_vertex
 
 void clear_vertex(GraphInterface& gi, size_t v)
 {
+    gi.check_thawed();
     run_action<>()(gi, std::bind(do_clear_vertex(), std::placeholders::_1, v))();
 }
 
@@ -212,6 +217,7 @@ struct add_new_edge
 
 python::object add_edge(GraphInterface& gi, size_t s, size_t t)
 {
+    gi.check_thawed();
     python::object new_e;
     run_action<>()(gi, std::bind(add_new_edge(), std::placeholders::_1, std::ref(gi),
                                  s, t, std::ref(new_e)))();
@@ -220,6 +226,7 @@ python::object add_edge(GraphInterface& gi, size_t s, size_t t)
 
 void remove_edge(GraphInterface& gi, EdgeBase& e)
 {
+    gi.check_thawed();
     e.check_valid();
     auto edge = e.get_descriptor();
     run_action<>()(gi, [&](auto& g) { remove_edge(edge, g); })();
@@ -233,6 +240,21 @@ struct get_edge_dispatch
                     bool all_edges, boost::python::list& es) const
     {
         auto gp = retrieve_graph_view<Graph>(gi, g);
+
+        // edge() takes O(1) time via the edge hash index, if it is up to
+        // date, or O(log k) time if the adjacency is sorted. It only finds the
+        // first edge in the unfiltered graph, hence it is not used if edges
+        // are filtered.
+        auto& mg = gi.get_graph();
+        if (!all_edges && !gi.is_edge_filter_active() &&
+            (mg.is_edge_hash_synced() || mg.get_sorted()))
+        {
+            auto ret = edge(vertex(s, g), vertex(t, g), g);
+            if (ret.second)
+                es.append(PythonEdge<Graph>(gp, ret.first));
+            return;
+        }
+
         size_t k_t = graph_tool::is_directed(g) ?
             in_degreeS()(t, g) : out_degree(t, g);
         if (out_degree(s, g) <= k_t)
@@ -481,6 +503,269 @@ python::object get_degree_list(GraphInterface& gi, python::object ovlist,
     return ret;
 }
 
+// Returns the index of an edge between each (source, target) pair in the
+// array pairs of shape (N, 2), or -1 if there is none. The lookups are done in
+// parallel. If the edge hash index is enabled, it is first brought up to date,
+// so that each lookup is O(1).
+python::object get_edge_index_list(GraphInterface& gi, python::object opairs)
+{
+    auto pairs = get_array<int64_t,2>(opairs);
+    if (pairs.shape()[0] > 0 && pairs.shape()[1] != 2)
+        throw ValueException("vertex pairs must be given as an array of "
+                             "shape (N, 2)");
+    size_t N = pairs.shape()[0];
+
+    gi.get_graph().sync_edge_hash();
+
+    std::vector<int64_t> eidx(N);
+    run_action<>(true)
+        (gi,
+         [&](auto& g)
+         {
+             for (size_t i = 0; i < N; ++i)
+             {
+                 for (size_t j = 0; j < 2; ++j)
+                 {
+                     auto v = pairs[i][j];
+                     if (v < 0 || !is_valid_vertex(size_t(v), g))
+                         throw ValueException("invalid vertex: " +
+                                              lexical_cast<string>(v));
+                 }
+             }
+
+             // with an active edge filter, edge() only tests the first of
+             // several parallel edges, hence the out-edges are scanned instead
+             bool efilt = gi.is_edge_filter_active();
+             auto edge_index = get(edge_index_t(), g);
+             #pragma omp parallel for schedule(runtime) \
+                 if (N > OPENMP_MIN_THRESH)
+             for (size_t i = 0; i < N; ++i)
+             {
+                 auto s = vertex(pairs[i][0], g);
+                 auto t = vertex(pairs[i][1], g);
+                 eidx[i] = -1;
+                 if (!efilt)
+                 {
+                     auto ret = edge(s, t, g);
+                     if (ret.second)
+                         eidx[i] = edge_index[ret.first];
+                     continue;
+                 }
+                 for (auto e : out_edges_range(s, g))
+                 {
+                     if (target(e, g) == t)
+                     {
+                         eidx[i] = edge_index[e];
+                         break;
+                     }
+                 }
+             }
+         })();
+    return wrap_vector_owned(eidx);
+}
+
+// calls f with a functor returning the edge range of a vertex, according to
+// the given mode: "out", "in" or "all"
+template <class F>
+void dispatch_edge_range(const string& mode, F&& f)
+{
+    if (mode == "out")
+        f([](auto v, const auto& g) { return out_edges_range(v, g); });
+    else if (mode == "in")
+        f([](auto v, const auto& g) { return in_edges_range(v, g); });
+    else if (mode == "all")
+        f([](auto v, const auto& g) { return all_edges_range(v, g); });
+    else
+        throw ValueException("invalid mode: " + mode);
+}
+
+// Returns the neighborhoods of all vertices in vlist in CSR form, as a tuple
+// (offsets, neighbors, edge_ids, weights): the neighbors of vlist[i] are
+// neighbors[offsets[i]:offsets[i+1]], and the edge indexes and weights at the
+// same positions correspond to the edges leading to them. If efilt is given,
+// only edges for which it is nonzero are considered. If eprop is empty, the
+// weights are None.
+python::object get_neighborhood_list(GraphInterface& gi, python::object ovlist,
+                                     string mode, boost::any aefilt,
+                                     boost::any eprop)
+{
+    python::object ret;
+    auto vlist = get_array<uint64_t,1>(ovlist);
+
+    typedef eprop_map_t<uint8_t>::type efilt_t;
+    bool filtered = !aefilt.empty();
+    efilt_t efilt_c;
+    if (filtered)
+        efilt_c = any_cast<efilt_t>(aefilt);
+    auto efilt = efilt_c.get_unchecked(filtered ? gi.get_edge_index_range() : 0);
+
+    typedef UnityPropertyMap<size_t,
+                             graph_traits<GraphInterface::multigraph_t>::edge_descriptor>
+        empty_t;
+    if (eprop.empty())
+    {
+        eprop = empty_t();
+    }
+    else
+    {
+        if (!belongs<edge_scalar_properties>()(eprop))
+            throw ValueException("edge weight property map must be of scalar type");
+    }
+
+    typedef mpl::push_back<edge_scalar_properties,
+                           empty_t>::type eprops_t;
+
+    dispatch_edge_range
+        (mode,
+         [&](auto erange)
+         {
+             run_action<>(true)
+                 (gi,
+                  [&](auto& g, auto& ew)
+                  {
+                      typedef typename std::decay<decltype(ew)>::type ew_t;
+                      typedef typename ew_t::value_type val_t;
+                      constexpr bool weighted =
+                          !std::is_same<ew_t, empty_t>::value;
+
+                      size_t N = vlist.size();
+                      for (auto v : vlist)
+                      {
+                          if (!is_valid_vertex(v, g))
+                              throw ValueException("invalid vertex: " +
+                                                   lexical_cast<string>(v));
+                      }
+
+                      auto edge_index = get(edge_index_t(), g);
+
+                      std::vector<uint64_t> offsets(N + 1);
+                      #pragma omp parallel for schedule(runtime) \
+                          if (N > OPENMP_MIN_THRESH)
+                      for (size_t i = 0; i < N; ++i)
+                      {
+                          size_t k = 0;
+                          for (auto e : erange(vlist[i], g))
+                          {
+                              if (!filtered || efilt[e])
+                                  ++k;
+                          }
+                          offsets[i + 1] = k;
+                      }
+                      for (size_t i = 0; i < N; ++i)
+                          offsets[i + 1] += offsets[i];
+
+                      std::vector<uint64_t> nbrs(offsets[N]);
+                      std::vector<uint64_t> eids(offsets[N]);
+                      std::vector<val_t> ws(weighted ? offsets[N] : 0);
+                      #pragma omp parallel for schedule(runtime) \
+                          if (N > OPENMP_MIN_THRESH)
+                      for (size_t i = 0; i < N; ++i)
+                      {
+                          auto v = vlist[i];
+                          size_t pos = offsets[i];
+                          for (auto e : erange(v, g))
+                          {
+                              if (filtered && !efilt[e])
+                                  continue;
+                              auto s = source(e, g);
+                              nbrs[pos] = (s == v) ? target(e, g) : s;
+                              eids[pos] = edge_index[e];
+                              if (weighted)
+                                  ws[pos] = ew[e];
+                              ++pos;
+                          }
+                      }
+
+                      GILAcquire gil;
+                      python::object ows;
+                      if (weighted)
+                          ows = wrap_vector_owned(ws);
+                      ret = python::make_tuple(wrap_vector_owned(offsets),
+                                               wrap_vector_owned(nbrs),
+                                               wrap_vector_owned(eids),
+                                               ows);
+                  }, eprops_t())(eprop);
+         });
+
+    return ret;
+}
+
+// Returns the vertices at each distance d = 0, ..., k from the vertices in
+// vlist, as a tuple (offsets, vertices): the vertices at distance d are
+// vertices[offsets[d]:offsets[d+1]], sorted by index. Each frontier is
+// expanded in parallel.
+python::object get_khop_list(GraphInterface& gi, python::object ovlist,
+                             size_t k, string mode, boost::any aefilt)
+{
+    python::object ret;
+    auto vlist = get_array<uint64_t,1>(ovlist);
+
+    typedef eprop_map_t<uint8_t>::type efilt_t;
+    bool filtered = !aefilt.empty();
+    efilt_t efilt_c;
+    if (filtered)
+        efilt_c = any_cast<efilt_t>(aefilt);
+    auto efilt = efilt_c.get_unchecked(filtered ? gi.get_edge_index_range() : 0);
+
+    dispatch_edge_range
+        (mode,
+         [&](auto erange)
+         {
+             run_action<>(true)
+                 (gi,
+                  [&](auto& g)
+                  {
+                      std::vector<std::atomic<bool>> visited(num_vertices(g));
+                      std::vector<uint64_t> offsets = {0};
+                      std::vector<uint64_t> vs;
+                      for (auto v : vlist)
+                      {
+                          if (!is_valid_vertex(v, g))
+                              throw ValueException("invalid vertex: " +
+                                                   lexical_cast<string>(v));
+                          if (!visited[v].exchange(true))
+                              vs.push_back(v);
+                      }
+                      std::sort(vs.begin(), vs.end());
+                      offsets.push_back(vs.size());
+
+                      for (size_t d = 0; d < k; ++d)
+                      {
+                          size_t begin = offsets[d];
+                          size_t end = offsets[d + 1];
+                          #pragma omp parallel if (end - begin > OPENMP_MIN_THRESH)
+                          {
+                              std::vector<uint64_t> next;
+                              #pragma omp for schedule(runtime)
+                              for (size_t i = begin; i < end; ++i)
+                              {
+                                  auto v = vs[i];
+                                  for (auto e : erange(v, g))
+                                  {
+                                      if (filtered && !efilt[e])
+                                          continue;
+                                      auto s = source(e, g);
+                                      auto u = (s == v) ? target(e, g) : s;
+                                      if (!visited[u].exchange(true))
+                                          next.push_back(u);
+                                  }
+                              }
+                              #pragma omp critical
+                              vs.insert(vs.end(), next.begin(), next.end());
+                          }
+                          std::sort(vs.begin() + end, vs.end());
+                          offsets.push_back(vs.size());
+                      }
+
+                      GILAcquire gil;
+                      ret = python::make_tuple(wrap_vector_owned(offsets),
+                                               wrap_vector_owned(vs));
+                  })();
+         });
+
+    return ret;
+}
+
 //
 // Below are the functions with will properly register all the types to python,
 // for every filter, type, etc.
@@ -635,6 +920,51 @@ do_get_edge_index(GraphInterface& g)
         (g.get_edge_index());
 }
 
+// value vectors of property maps which are shared by copy_map(), which are
+// only accessed while holding the GIL (never destroyed, since maps may outlive
+// it at exit)
+static auto& cow_storages =
+    *new std::unordered_map<const void*, std::weak_ptr<void>>();
+static size_t cow_prune_size = 1024;
+
+void cow_share(const std::shared_ptr<void>& storage)
+{
+    cow_storages[storage.get()] = storage;
+
+    // entries of vectors which were destroyed while shared are dropped from
+    // time to time
+    if (cow_storages.size() > cow_prune_size)
+    {
+        for (auto iter = cow_storages.begin(); iter != cow_storages.end();)
+        {
+            if (iter->second.expired())
+                iter = cow_storages.erase(iter);
+            else
+                ++iter;
+        }
+        cow_prune_size = std::max(size_t(1024), 2 * cow_storages.size());
+    }
+}
+
+bool cow_is_shared(const void* storage)
+{
+    auto iter = cow_storages.find(storage);
+    if (iter == cow_storages.end())
+        return false;
+    if (iter->second.expired())
+    {
+        // the address was reused
+        cow_storages.erase(iter);
+        return false;
+    }
+    return true;
+}
+
+void cow_release(const void* storage)
+{
+    cow_storages.erase(storage);
+}
+
 void do_add_edge_list(GraphInterface& gi, python::object aedge_list,
                       python::object eprops);
 
@@ -713,6 +1043,9 @@ void export_python_interface()
     def("get_out_neighbors_list", get_out_neighbors_list);
     def("get_in_neighbors_list", get_in_neighbors_list);
     def("get_degree_list", get_degree_list);
+    def("get_edge_index_list", get_edge_index_list);
+    def("get_neighborhood_list", get_neighborhood_list);
+    def("get_khop_list", get_khop_list);
 
     def("get_vertex_index", get_vertex_index);
     def("get_edge_index", do_get_edge_index);
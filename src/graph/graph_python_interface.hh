@@ -47,6 +47,7 @@ namespace std
 #include "demangle.hh"
 #include "numpy_bind.hh"
 #include "coroutine.hh"
+#include "graph_memory.hh"
 
 // This file includes a simple python interface for the internally kept
 // graph. It defines a PythonVertex, PythonEdge and PythonIterator template
@@ -442,6 +443,17 @@ struct return_reference
     };
 };
 
+// Copy-on-write sharing of property map values. PythonPropertyMap::copy_map()
+// returns a map which shares the values with the original one, if these are
+// not referenced from anywhere else. The shared value vectors are registered
+// below, and each PythonPropertyMap which holds one of them copies it (via
+// unshare()) before it can be modified, i.e. before a value is written or
+// returned by reference, before the map is passed to C++ code, and before a
+// numpy array is created for it.
+void cow_share(const std::shared_ptr<void>& storage);
+bool cow_is_shared(const void* storage);
+void cow_release(const void* storage);
+
 template <class PropertyMap>
 class PythonPropertyMap
 {
@@ -460,6 +472,8 @@ public:
     reference get_value(const PythonDescriptor& key)
     {
         key.check_valid();
+        if (std::is_reference<reference>::value)
+            unshare();
         return get(_pmap, key.get_descriptor());
     }
 
@@ -478,7 +492,12 @@ public:
                             std::true_type)
     {
         key.check_valid();
+        unshare();
         put(_pmap, key.get_descriptor(), val);
+        if constexpr (std::is_same<value_type, uint8_t>::value)
+            filter_mask_set(&_pmap.get_storage(),
+                            get(_pmap.get_index_map(), key.get_descriptor()),
+                            val);
     }
 
     template <class PythonDescriptor>
@@ -503,13 +522,84 @@ public:
                                                value_type>::type::pos::value];
     }
 
-    boost::any get_map() const
+    // the map may be written to by the C++ code which receives it, hence the
+    // packed copies of filter masks are not used while it holds a copy of the
+    // map (see graph_filter_bits.hh)
+    boost::any get_map()
+    {
+        unshare();
+        touch_filter_mask(_pmap);
+        return _pmap;
+    }
+
+    template <class PMap>
+    static void touch_filter_mask(const PMap& pmap)
+    {
+        if constexpr (std::is_same<value_type, uint8_t>::value)
+            filter_mask_touch(&pmap.get_storage());
+    }
+
+    // returns an independent copy of the property map, with the same index
+    // map, which shares the values with this one until either is modified, or
+    // otherwise obtained by copying the values in bulk
+    boost::any copy_map() const
+    {
+        typename boost::mpl::or_<
+            std::is_same<PropertyMap,
+                         GraphInterface::vertex_index_map_t>,
+            std::is_same<PropertyMap,
+                         GraphInterface::edge_index_map_t> >::type is_index;
+        return copy_map_dispatch(is_index);
+    }
+
+    boost::any copy_map_dispatch(boost::mpl::bool_<true>) const
     {
         return _pmap;
     }
 
-    boost::any get_dynamic_map() const
+    boost::any copy_map_dispatch(boost::mpl::bool_<false>) const
     {
+        auto& store = _pmap.get_storage_ptr();
+        if ((store.use_count() == 1 || cow_is_shared(store.get())) &&
+            _pmap.get_mmap_arena() == nullptr)
+        {
+            cow_share(store);
+            return _pmap;
+        }
+        return _pmap.copy();
+    }
+
+    // takes a private copy of the values, if they are shared with other maps
+    // by copy_map()
+    void unshare()
+    {
+        typename boost::mpl::or_<
+            std::is_same<PropertyMap,
+                         GraphInterface::vertex_index_map_t>,
+            std::is_same<PropertyMap,
+                         GraphInterface::edge_index_map_t> >::type is_index;
+        unshare_dispatch(is_index);
+    }
+
+    void unshare_dispatch(boost::mpl::bool_<true>)
+    {
+    }
+
+    void unshare_dispatch(boost::mpl::bool_<false>)
+    {
+        auto& store = _pmap.get_storage_ptr();
+        if (!cow_is_shared(store.get()))
+            return;
+        if (store.use_count() > 1)
+            _pmap = _pmap.copy();
+        else
+            cow_release(store.get());
+    }
+
+    boost::any get_dynamic_map()
+    {
+        unshare();
+        touch_filter_mask(_pmap);
         return (boost::dynamic_property_map*)
             (new boost::detail::dynamic_property_map_adaptor<PropertyMap>
              (_pmap));
@@ -531,8 +621,23 @@ public:
 
     boost::python::object get_array_dispatch(size_t size, boost::mpl::bool_<false>)
     {
+        unshare();
         _pmap.resize(size);
-        return wrap_vector_not_owned(_pmap.get_storage());
+        auto& vals = _pmap.get_storage();
+        auto a = wrap_vector_not_owned(vals);
+        if (vals.empty())
+            return a;
+
+        // the array holds a reference to the values, hence they are not shared
+        // by copy_map() while it exists
+        std::shared_ptr<void> handle = _pmap.get_storage_ptr();
+        if constexpr (std::is_same<value_type, uint8_t>::value)
+            handle = std::shared_ptr<void>(nullptr,
+                                           [handle,
+                                            h = filter_mask_expose(&vals)]
+                                           (void*) {});
+        set_array_handle(a, std::move(handle));
+        return a;
     }
 
     boost::python::object get_array_dispatch(size_t, boost::mpl::bool_<true>)
@@ -558,6 +663,7 @@ public:
 
     void reserve_dispatch(size_t size, boost::mpl::bool_<false>)
     {
+        unshare();
         _pmap.reserve(size);
     }
 
@@ -577,6 +683,7 @@ public:
 
     void resize_dispatch(size_t size, boost::mpl::bool_<false>)
     {
+        unshare();
         _pmap.resize(size);
     }
 
@@ -596,6 +703,7 @@ public:
 
     void shrink_to_fit_dispatch(boost::mpl::bool_<false>)
     {
+        unshare();
         _pmap.shrink_to_fit();
     }
 
@@ -612,6 +720,10 @@ public:
 
     void swap_dispatch(PythonPropertyMap& other, std::true_type)
     {
+        unshare();
+        other.unshare();
+        touch_filter_mask(_pmap);
+        touch_filter_mask(other._pmap);
         _pmap.swap(other._pmap);
     }
 
@@ -640,6 +752,139 @@ public:
         return size_t(_pmap.get_storage().data());
     }
 
+    // heap memory used and allocated by the values, in bytes
+    boost::python::tuple get_memory_usage()
+    {
+        typename boost::mpl::or_<
+            std::is_same<PropertyMap,
+                         GraphInterface::vertex_index_map_t>,
+            std::is_same<PropertyMap,
+                         GraphInterface::edge_index_map_t> >::type is_index;
+        return get_memory_usage_dispatch(is_index);
+    }
+
+    boost::python::tuple get_memory_usage_dispatch(boost::mpl::bool_<true>)
+    {
+        return boost::python::make_tuple(0, 0);
+    }
+
+    boost::python::tuple get_memory_usage_dispatch(boost::mpl::bool_<false>)
+    {
+        auto m = graph_tool::get_memory_usage(_pmap.get_storage());
+        return boost::python::make_tuple(m.size, m.capacity);
+    }
+
+    // whether the values are currently shared with another map by copy_map()
+    bool is_shared()
+    {
+        typename boost::mpl::or_<
+            std::is_same<PropertyMap,
+                         GraphInterface::vertex_index_map_t>,
+            std::is_same<PropertyMap,
+                         GraphInterface::edge_index_map_t> >::type is_index;
+        return is_shared_dispatch(is_index);
+    }
+
+    bool is_shared_dispatch(boost::mpl::bool_<true>)
+    {
+        return false;
+    }
+
+    bool is_shared_dispatch(boost::mpl::bool_<false>)
+    {
+        auto& store = _pmap.get_storage_ptr();
+        return store.use_count() > 1 && cow_is_shared(store.get());
+    }
+
+    // moves the values to memory-mapped files created in the directory dir,
+    // or back to the heap if dir is empty; if the values are already mapped
+    // in the same directory, only the access pattern hint is changed
+    void set_mmap(const std::string& dir, const std::string& advice)
+    {
+        typename boost::mpl::or_<
+            std::is_same<PropertyMap,
+                         GraphInterface::vertex_index_map_t>,
+            std::is_same<PropertyMap,
+                         GraphInterface::edge_index_map_t> >::type is_index;
+        set_mmap_dispatch(dir, advice, is_index);
+    }
+
+    void set_mmap_dispatch(const std::string&, const std::string&,
+                           boost::mpl::bool_<true>)
+    {
+        throw ValueException("index property maps cannot be memory-mapped");
+    }
+
+    void set_mmap_dispatch(const std::string& dir, const std::string& advice,
+                           boost::mpl::bool_<false>)
+    {
+        mmap_arena::advice_t adv;
+        if (advice == "normal")
+            adv = mmap_arena::NORMAL;
+        else if (advice == "sequential")
+            adv = mmap_arena::SEQUENTIAL;
+        else if (advice == "random")
+            adv = mmap_arena::RANDOM;
+        else
+            throw ValueException("invalid access pattern: " + advice);
+
+        unshare();
+        auto arena = _pmap.get_mmap_arena();
+        if (dir.empty())
+        {
+            if (arena != nullptr)
+                _pmap.set_mmap_arena(nullptr);
+            return;
+        }
+
+        if (arena != nullptr && arena->get_dir() == dir)
+        {
+            auto& vals = _pmap.get_storage();
+            arena->advise(vals.data(),
+                          vals.capacity() * sizeof(typename PropertyMap::value_type),
+                          adv);
+            return;
+        }
+        _pmap.set_mmap_arena(std::make_shared<mmap_arena>(dir, adv));
+    }
+
+    // returns the directory and access pattern of the memory-mapped storage,
+    // or None if the values are in the heap
+    boost::python::object get_mmap()
+    {
+        typename boost::mpl::or_<
+            std::is_same<PropertyMap,
+                         GraphInterface::vertex_index_map_t>,
+            std::is_same<PropertyMap,
+                         GraphInterface::edge_index_map_t> >::type is_index;
+        return get_mmap_dispatch(is_index);
+    }
+
+    boost::python::object get_mmap_dispatch(boost::mpl::bool_<true>)
+    {
+        return boost::python::object();
+    }
+
+    boost::python::object get_mmap_dispatch(boost::mpl::bool_<false>)
+    {
+        auto arena = _pmap.get_mmap_arena();
+        if (arena == nullptr)
+            return boost::python::object();
+        std::string advice;
+        switch (arena->get_advice())
+        {
+        case mmap_arena::SEQUENTIAL:
+            advice = "sequential";
+            break;
+        case mmap_arena::RANDOM:
+            advice = "random";
+            break;
+        default:
+            advice = "normal";
+        }
+        return boost::python::make_tuple(arena->get_dir(), advice);
+    }
+
 private:
     PropertyMap _pmap; // hold an internal copy, since it's cheap
 };
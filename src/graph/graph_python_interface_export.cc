@@ -61,11 +61,16 @@ struct export_vertex_property_map
             .def("value_type", &pmap_t::get_type)
             .def("get_map", &pmap_t::get_map)
             .def("get_dynamic_map", &pmap_t::get_dynamic_map)
+            .def("copy_map", &pmap_t::copy_map)
             .def("get_array", &pmap_t::get_array)
             .def("is_writable", &pmap_t::is_writable)
             .def("reserve", &pmap_t::reserve)
             .def("resize", &pmap_t::resize)
             .def("shrink_to_fit", &pmap_t::shrink_to_fit)
+            .def("get_memory_usage", &pmap_t::get_memory_usage)
+            .def("is_shared", &pmap_t::is_shared)
+            .def("set_mmap", &pmap_t::set_mmap)
+            .def("get_mmap", &pmap_t::get_mmap)
             .def("swap", &pmap_t::swap)
             .def("data_ptr", &pmap_t::data_ptr);
 
@@ -145,11 +150,16 @@ struct export_edge_property_map
             .def("value_type", &pmap_t::get_type)
             .def("get_map", &pmap_t::get_map)
             .def("get_dynamic_map", &pmap_t::get_dynamic_map)
+            .def("copy_map", &pmap_t::copy_map)
             .def("get_array", &pmap_t::get_array)
             .def("is_writable", &pmap_t::is_writable)
             .def("reserve", &pmap_t::reserve)
             .def("resize", &pmap_t::resize)
             .def("shrink_to_fit", &pmap_t::shrink_to_fit)
+            .def("get_memory_usage", &pmap_t::get_memory_usage)
+            .def("is_shared", &pmap_t::is_shared)
+            .def("set_mmap", &pmap_t::set_mmap)
+            .def("get_mmap", &pmap_t::get_mmap)
             .def("swap", &pmap_t::swap)
             .def("data_ptr", &pmap_t::data_ptr);
 
@@ -195,11 +205,14 @@ struct export_graph_property_map
             .def("__setitem__", &pmap_t::template set_value<GraphInterface>)
             .def("get_map", &pmap_t::get_map)
             .def("get_dynamic_map", &pmap_t::get_dynamic_map)
+            .def("copy_map", &pmap_t::copy_map)
             .def("get_array", &pmap_t::get_array)
             .def("is_writable", &pmap_t::is_writable)
             .def("reserve", &pmap_t::reserve)
             .def("resize", &pmap_t::resize)
-            .def("shrink_to_fit", &pmap_t::shrink_to_fit);
+            .def("shrink_to_fit", &pmap_t::shrink_to_fit)
+            .def("get_memory_usage", &pmap_t::get_memory_usage)
+            .def("is_shared", &pmap_t::is_shared);
     }
 };
 
@@ -19,10 +19,12 @@
 #include "graph.hh"
 #include "graph_util.hh"
 #include "graph_python_interface.hh"
+#include "openmp_lock.hh"
 
 #include <boost/python.hpp>
 #include <boost/python/stl_iterator.hpp>
 #include <set>
+#include <cmath>
 
 
 using namespace std;
@@ -32,6 +34,463 @@ using namespace graph_tool;
 namespace graph_tool
 {
 
+//
+// Bulk insertion
+// ==============
+//
+// Edges given as numpy arrays are inserted directly into the underlying
+// adj_list, via adj_list::add_edges(), which builds the edge lists with a
+// parallel counting sort instead of calling add_edge() for every row. This
+// bypasses the graph views, and hence is only done if the graph is neither
+// filtered (in which case the filters would need to be updated for the new
+// edges) nor reversed; otherwise the edges are inserted one by one.
+
+bool use_bulk_insertion(GraphInterface& gi)
+{
+    return (!gi.is_vertex_filter_active() && !gi.is_edge_filter_active() &&
+            !(gi.get_directed() && gi.get_reversed()));
+}
+
+// whether x is not a valid vertex index
+template <class Value>
+bool invalid_index(Value x)
+{
+    if constexpr (std::is_floating_point_v<Value>)
+    {
+        if (std::isnan(x))
+            return true;
+    }
+    if constexpr (std::is_signed_v<Value>)
+        return x < 0;
+    return false;
+}
+
+// resize the edge property maps such that they can be written to concurrently,
+// and return whether this is actually safe, i.e. none of them holds python
+// objects
+bool reserve_edge_properties(python::object& oeprops, size_t n)
+{
+    bool parallel = true;
+    python::stl_input_iterator<boost::any> iter(oeprops), end;
+    for (; iter != end; ++iter)
+    {
+        boost::any aprop = *iter;
+        boost::mpl::for_each<writable_edge_properties>
+            ([&](auto pmap)
+             {
+                 typedef decltype(pmap) pmap_t;
+                 if (typeid(pmap_t) != aprop.type())
+                     return;
+                 pmap = any_cast<pmap_t>(aprop);
+                 pmap.reserve(n);
+                 typedef typename property_traits<pmap_t>::value_type val_t;
+                 if (std::is_same<val_t, python::object>::value)
+                     parallel = false;
+             });
+    }
+    return parallel;
+}
+
+template <class ValueList>
+struct add_edge_list_bulk
+{
+    void operator()(GraphInterface& gi, python::object& aedge_list,
+                    python::object& eprops, bool& found) const
+    {
+        boost::mpl::for_each<ValueList>(std::bind(dispatch(), std::ref(gi),
+                                                  std::ref(aedge_list),
+                                                  std::ref(eprops),
+                                                  std::ref(found),
+                                                  std::placeholders::_1));
+    }
+
+    struct dispatch
+    {
+        template <class Value>
+        void operator()(GraphInterface& gi, python::object& aedge_list,
+                        python::object& oeprops, bool& found, Value) const
+        {
+            if (found)
+                return;
+            try
+            {
+                boost::multi_array_ref<Value, 2> edge_list = get_array<Value, 2>(aedge_list);
+
+                if (edge_list.shape()[1] < 2)
+                    throw GraphException("Second dimension in edge list must be of size (at least) two");
+
+                auto& g = gi.get_graph();
+                size_t E = edge_list.shape()[0];
+
+                size_t N = 0;
+                bool valid = true;
+                #pragma omp parallel for schedule(runtime) \
+                    if (E > OPENMP_MIN_THRESH) reduction(max:N) \
+                    reduction(&&:valid)
+                for (size_t i = 0; i < E; ++i)
+                {
+                    for (size_t j = 0; j < 2; ++j)
+                    {
+                        Value x = edge_list[i][j];
+                        if (invalid_index(x))
+                            valid = false;
+                        else
+                            N = std::max(N, size_t(x) + 1);
+                    }
+                }
+
+                if (!valid)
+                    throw ValueException("Invalid vertex index in edge list");
+
+                while (num_vertices(g) < N)
+                    add_vertex(g);
+
+                typedef GraphInterface::edge_t edge_t;
+                vector<DynamicPropertyMapWrap<Value, edge_t>> eprops;
+                python::stl_input_iterator<boost::any> iter(oeprops), end;
+                for (; iter != end; ++iter)
+                    eprops.emplace_back(*iter, writable_edge_properties());
+
+                size_t n_props = std::min(eprops.size(), edge_list.shape()[1] - 2);
+
+                bool parallel =
+                    reserve_edge_properties(oeprops,
+                                            g.get_edge_index_range() + E);
+
+                parallel_error error;
+                g.add_edges(E,
+                            [&](size_t i)
+                            {
+                                return std::make_pair(size_t(edge_list[i][0]),
+                                                      size_t(edge_list[i][1]));
+                            },
+                            [&](size_t i, const edge_t& e)
+                            {
+                                for (size_t j = 0; j < n_props; ++j)
+                                {
+                                    try
+                                    {
+                                        put(eprops[j], e, edge_list[i][j + 2]);
+                                    }
+                                    catch (bad_lexical_cast&)
+                                    {
+                                        error.set(std::make_exception_ptr
+                                                  (ValueException("Invalid edge property value: " +
+                                                                  lexical_cast<string>(edge_list[i][j + 2]))));
+                                    }
+                                    catch (...)
+                                    {
+                                        error.set(std::current_exception());
+                                    }
+                                }
+                            }, parallel);
+
+                error.check();
+                found = true;
+            }
+            catch (InvalidNumpyConversion& e) {}
+        }
+    };
+};
+
+// Hash table mapping vertex values to vertex indexes, which can be filled
+// concurrently. It is split into shards which are locked independently, and
+// the vertex indexes are only assigned after all values have been inserted,
+// following the order in which they first appear in the edge list.
+template <class Value>
+class concurrent_vertex_hash
+{
+public:
+    concurrent_vertex_hash() : _shards(n_shards), _locks(n_shards) {}
+
+    // register value r, found at position pos of the edge list
+    void insert(const Value& r, size_t pos)
+    {
+        size_t k = get_shard(r);
+        ::scoped_lock lock(_locks[k]);
+        auto& shard = _shards[k];
+        auto iter = shard.find(r);
+        if (iter == shard.end())
+            shard.emplace(r, pos);
+        else
+            iter->second = std::min(iter->second, pos);
+    }
+
+    // replace the positions by vertex indexes starting from N, and return the
+    // values in the order of their indexes
+    vector<Value> assign(size_t N)
+    {
+        vector<std::pair<const Value, size_t>*> items;
+        for (auto& shard : _shards)
+            for (auto& item : shard)
+                items.push_back(&item);
+        std::sort(items.begin(), items.end(),
+                  [](auto a, auto b) { return a->second < b->second; });
+        vector<Value> vals;
+        vals.reserve(items.size());
+        for (size_t i = 0; i < items.size(); ++i)
+        {
+            items[i]->second = N + i;
+            vals.push_back(items[i]->first);
+        }
+        return vals;
+    }
+
+    size_t operator[](const Value& r) const
+    {
+        return _shards[get_shard(r)].find(r)->second;
+    }
+
+private:
+    static constexpr size_t shard_bits = 8;
+    static constexpr size_t n_shards = 1 << shard_bits;
+
+    static size_t get_shard(const Value& r)
+    {
+        // the hashes of integers are not scrambled by std::hash
+        uint64_t h = std::hash<Value>()(r);
+        return (h * 11400714819323198485ULL) >> (64 - shard_bits);
+    }
+
+    vector<unordered_map<Value, size_t>> _shards;
+    vector<openmp_mutex> _locks;
+};
+
+// add the vertices in the hash table, after it has been filled, and set their
+// values in vmap
+template <class Graph, class Value, class VProp>
+void add_hashed_vertices(Graph& g, concurrent_vertex_hash<Value>& vertices,
+                         VProp& vmap)
+{
+    size_t N = num_vertices(g);
+    auto vals = vertices.assign(N);
+    for (size_t i = 0; i < vals.size(); ++i)
+        add_vertex(g);
+
+    typedef typename property_traits<VProp>::value_type val_t;
+    vmap.reserve(num_vertices(g));
+    auto umap = vmap.get_unchecked();
+    parallel_error error;
+    #pragma omp parallel for schedule(runtime) \
+        if (!std::is_same<val_t, python::object>::value && \
+            vals.size() > OPENMP_MIN_THRESH)
+    for (size_t i = 0; i < vals.size(); ++i)
+    {
+        try
+        {
+            umap[N + i] = lexical_cast<val_t>(vals[i]);
+        }
+        catch (bad_lexical_cast&)
+        {
+            error.set(std::make_exception_ptr
+                      (ValueException("Invalid vertex value: " +
+                                      lexical_cast<string>(vals[i]))));
+        }
+        catch (...)
+        {
+            error.set(std::current_exception());
+        }
+    }
+    error.check();
+}
+
+template <class ValueList>
+struct add_edge_list_hash_bulk
+{
+    template <class VProp>
+    void operator()(GraphInterface& gi, python::object& aedge_list,
+                    VProp& vmap, bool& found, bool use_str,
+                    python::object& eprops) const
+    {
+        boost::mpl::for_each<ValueList>(std::bind(dispatch(), std::ref(gi),
+                                                  std::ref(aedge_list), std::ref(vmap),
+                                                  std::ref(found), std::ref(eprops),
+                                                  std::placeholders::_1));
+        if (!found && use_str)
+            dispatch()(gi, aedge_list, vmap, found, eprops, std::string());
+    }
+
+    struct dispatch
+    {
+        template <class VProp, class Value>
+        void operator()(GraphInterface& gi, python::object& aedge_list,
+                        VProp& vmap, bool& found, python::object& oeprops,
+                        Value) const
+        {
+            if (found)
+                return;
+            try
+            {
+                boost::multi_array_ref<Value, 2> edge_list = get_array<Value, 2>(aedge_list);
+
+                if (edge_list.shape()[1] < 2)
+                    throw GraphException("Second dimension in edge list must be of size (at least) two");
+
+                auto& g = gi.get_graph();
+                size_t E = edge_list.shape()[0];
+
+                // NaN values cannot be hashed consistently, and are left to
+                // the serial insertion (nothing has been modified yet)
+                concurrent_vertex_hash<Value> vertices;
+                bool valid = true;
+                #pragma omp parallel for schedule(runtime) \
+                    if (E > OPENMP_MIN_THRESH) reduction(&&:valid)
+                for (size_t i = 0; i < E; ++i)
+                {
+                    for (size_t j = 0; j < 2; ++j)
+                    {
+                        const Value& r = edge_list[i][j];
+                        bool nan = false;
+                        if constexpr (std::is_floating_point_v<Value>)
+                            nan = std::isnan(r);
+                        if (nan)
+                            valid = false;
+                        else
+                            vertices.insert(r, 2 * i + j);
+                    }
+                }
+                if (!valid)
+                    return;
+
+                add_hashed_vertices(g, vertices, vmap);
+
+                typedef GraphInterface::edge_t edge_t;
+                vector<DynamicPropertyMapWrap<Value, edge_t>> eprops;
+                python::stl_input_iterator<boost::any> iter(oeprops), end;
+                for (; iter != end; ++iter)
+                    eprops.emplace_back(*iter, writable_edge_properties());
+
+                size_t n_props = std::min(eprops.size(), edge_list.shape()[1] - 2);
+
+                bool parallel =
+                    reserve_edge_properties(oeprops,
+                                            g.get_edge_index_range() + E);
+
+                parallel_error error;
+                g.add_edges(E,
+                            [&](size_t i)
+                            {
+                                return std::make_pair(vertices[edge_list[i][0]],
+                                                      vertices[edge_list[i][1]]);
+                            },
+                            [&](size_t i, const edge_t& e)
+                            {
+                                for (size_t j = 0; j < n_props; ++j)
+                                {
+                                    try
+                                    {
+                                        put(eprops[j], e, edge_list[i][j + 2]);
+                                    }
+                                    catch (bad_lexical_cast&)
+                                    {
+                                        error.set(std::make_exception_ptr
+                                                  (ValueException("Invalid edge property value: " +
+                                                                  lexical_cast<string>(edge_list[i][j + 2]))));
+                                    }
+                                    catch (...)
+                                    {
+                                        error.set(std::current_exception());
+                                    }
+                                }
+                            }, parallel);
+
+                error.check();
+                found = true;
+            }
+            catch (InvalidNumpyConversion& e) {}
+        }
+
+        // The string values need to be extracted from the python rows, which
+        // is done serially. Only the hashing and the construction of the edge
+        // lists are done in parallel, the latter only if no edge properties
+        // are given, since their values are python objects.
+        template <class VProp>
+        void operator()(GraphInterface& gi, python::object& edge_list,
+                        VProp& vmap, bool& found, python::object& oeprops,
+                        std::string) const
+        {
+            if (found)
+                return;
+
+            auto& g = gi.get_graph();
+
+            typedef GraphInterface::edge_t edge_t;
+            vector<DynamicPropertyMapWrap<python::object, edge_t>> eprops;
+            python::stl_input_iterator<boost::any> piter(oeprops), pend;
+            for (; piter != pend; ++piter)
+                eprops.emplace_back(*piter, writable_edge_properties());
+
+            vector<std::string> ids;
+            vector<python::object> vals;
+            vector<size_t> vals_pos = {0};
+            python::stl_input_iterator<python::object> iter(edge_list), end;
+            for (; iter != end; ++iter)
+            {
+                const auto& row = *iter;
+                python::stl_input_iterator<python::object> eiter(row), eend;
+                size_t i = 0;
+                for(; eiter != eend; ++eiter)
+                {
+                    if (i >= eprops.size() + 2)
+                        break;
+                    const auto& val = *eiter;
+                    if (i < 2)
+                        ids.push_back(python::extract<std::string>(val));
+                    else
+                        vals.push_back(val);
+                    i++;
+                }
+                if (i < 2)
+                    throw ValueException("Edge list rows must have at least two values");
+                vals_pos.push_back(vals.size());
+            }
+
+            size_t E = ids.size() / 2;
+
+            concurrent_vertex_hash<std::string> vertices;
+            #pragma omp parallel for schedule(runtime) if (E > OPENMP_MIN_THRESH)
+            for (size_t i = 0; i < ids.size(); ++i)
+                vertices.insert(ids[i], i);
+
+            add_hashed_vertices(g, vertices, vmap);
+
+            reserve_edge_properties(oeprops, g.get_edge_index_range() + E);
+
+            parallel_error error;
+            g.add_edges(E,
+                        [&](size_t i)
+                        {
+                            return std::make_pair(vertices[ids[2 * i]],
+                                                  vertices[ids[2 * i + 1]]);
+                        },
+                        [&](size_t i, const edge_t& e)
+                        {
+                            for (size_t j = vals_pos[i]; j < vals_pos[i + 1]; ++j)
+                            {
+                                const auto& val = vals[j];
+                                try
+                                {
+                                    put(eprops[j - vals_pos[i]], e, val);
+                                }
+                                catch (bad_lexical_cast&)
+                                {
+                                    error.set(std::make_exception_ptr
+                                              (ValueException("Invalid edge property value: " +
+                                                              python::extract<string>(python::str(val))())));
+                                }
+                                catch (...)
+                                {
+                                    error.set(std::current_exception());
+                                }
+                            }
+                        }, eprops.empty());
+
+            error.check();
+            found = true;
+        }
+    };
+};
+
 template <class ValueList>
 struct add_edge_list
 {
@@ -99,13 +558,17 @@ struct add_edge_list
 void do_add_edge_list(GraphInterface& gi, python::object aedge_list,
                       python::object eprops)
 {
+    gi.check_thawed();
     typedef mpl::vector<bool, char, uint8_t, uint16_t, uint32_t, uint64_t,
                         int8_t, int16_t, int32_t, int64_t, uint64_t, double,
                         long double> vals_t;
     bool found = false;
-    run_action<>()(gi, std::bind(add_edge_list<vals_t>(), std::placeholders::_1,
-                                 aedge_list, std::ref(eprops),
-                                 std::ref(found)))();
+    if (use_bulk_insertion(gi))
+        add_edge_list_bulk<vals_t>()(gi, aedge_list, eprops, found);
+    else
+        run_action<>()(gi, std::bind(add_edge_list<vals_t>(),
+                                     std::placeholders::_1, aedge_list,
+                                     std::ref(eprops), std::ref(found)))();
     if (!found)
         throw GraphException("Invalid type for edge list; must be two-dimensional with a scalar type");
 }
@@ -352,10 +815,26 @@ void do_add_edge_list_hashed(GraphInterface& gi, python::object aedge_list,
                              boost::any& vertex_map, bool is_str,
                              python::object eprops)
 {
+    gi.check_thawed();
     typedef mpl::vector<bool, char, uint8_t, uint16_t, uint32_t, uint64_t,
                         int8_t, int16_t, int32_t, int64_t, uint64_t, double,
                         long double> vals_t;
     bool found = false;
+    if (use_bulk_insertion(gi))
+    {
+        boost::mpl::for_each<writable_vertex_properties>
+            ([&](auto vmap)
+             {
+                 typedef decltype(vmap) vmap_t;
+                 if (found || typeid(vmap_t) != vertex_map.type())
+                     return;
+                 vmap = any_cast<vmap_t>(vertex_map);
+                 add_edge_list_hash_bulk<vals_t>()(gi, aedge_list, vmap, found,
+                                                   is_str, eprops);
+             });
+        if (found)
+            return;
+    }
     run_action<graph_tool::all_graph_views, boost::mpl::true_>()
         (gi, std::bind(add_edge_list_hash<vals_t>(), std::placeholders::_1,
                        aedge_list, std::placeholders::_2, std::ref(found),
@@ -425,6 +904,7 @@ struct add_edge_list_iter
 void do_add_edge_list_iter(GraphInterface& gi, python::object edge_list,
                            python::object eprops)
 {
+    gi.check_thawed();
     run_action<>()
         (gi, std::bind(add_edge_list_iter(), std::placeholders::_1,
                        std::ref(edge_list), std::ref(eprops)))();
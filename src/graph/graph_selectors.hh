@@ -30,6 +30,7 @@
 
 #include "graph_adaptor.hh"
 #include "graph_properties.hh"
+#include "flat_vector_property_map.hh"
 #include "graph.hh"
 
 namespace graph_tool
@@ -702,6 +703,15 @@ struct vertex_floating_vector_properties:
                                   GraphInterface::vertex_index_map_t,
                                   boost::mpl::bool_<false> >::type {};
 
+// floating vector-valued vertex properties, together with the flat maps over
+// numpy arrays (see flat_vector_property_map.hh), as used for vertex positions
+typedef flat_vector_property_map<double, GraphInterface::vertex_index_map_t>
+    vertex_flat_vector_map_t;
+
+struct vertex_position_properties:
+        boost::mpl::push_back<vertex_floating_vector_properties,
+                              vertex_flat_vector_map_t>::type {};
+
 struct edge_scalar_properties:
         property_map_types::apply<scalar_types,
                                   GraphInterface::edge_index_map_t>::type {};
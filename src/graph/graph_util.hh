@@ -44,6 +44,7 @@ namespace boost { namespace python { namespace detail {
 
 #include <functional>
 #include <random>
+#include <exception>
 
 #include "graph_selectors.hh"
 #include "graph_reverse.hh"
@@ -183,6 +184,31 @@ void graph_copy(const GraphOrig& g, GraphTarget& gt)
 // Parallel loops
 // ==============
 
+// Exceptions cannot propagate out of an OpenMP parallel region, hence the
+// first one raised inside it is stored with set(), and rethrown by check()
+// after the region ends.
+class parallel_error
+{
+public:
+    void set(std::exception_ptr e)
+    {
+        #pragma omp critical (parallel_error)
+        {
+            if (!_e)
+                _e = e;
+        }
+    }
+
+    void check()
+    {
+        if (_e)
+            std::rethrow_exception(_e);
+    }
+
+private:
+    std::exception_ptr _e;
+};
+
 template <class Graph, class F>
 void parallel_vertex_loop_no_spawn(const Graph& g, F&& f)
 {
@@ -274,21 +274,23 @@ double log_n_permutations(const vector<int32_t>& b)
     return n;
 }
 
-vector<int32_t> unlabel_partition(vector<int32_t> b)
+template <class Vec>
+vector<int32_t> unlabel_partition(const Vec& b)
 {
     std::vector<int32_t> map(b.size(), -1);
+    std::vector<int32_t> c(b.size());
     size_t pos = 0;
-    for (auto& bi : b)
+    for (size_t i = 0; i < b.size(); ++i)
     {
-        auto& x = map[bi];
+        auto& x = map[b[i]];
         if (x == -1)
         {
             x = pos;
             ++pos;
         }
-        bi = x;
+        c[i] = x;
     }
-    return b;
+    return c;
 }
 
 void collect_partitions(boost::any& ob, PartitionHist& h, double update,
@@ -299,12 +301,12 @@ void collect_partitions(boost::any& ob, PartitionHist& h, double update,
     auto& v = b.get_storage();
     if (unlabel)
     {
-        auto vc = unlabel_partition(v);
-        h[vc] += update;
+        h[unlabel_partition(v)] += update;
     }
     else
     {
-        h[v] += update;
+        // the histogram keys use the default allocator
+        h[vector<int32_t>(v.begin(), v.end())] += update;
     }
 }
 
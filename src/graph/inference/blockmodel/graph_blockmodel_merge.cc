@@ -48,7 +48,9 @@ python::object do_merge_sweep(python::object omerge_state,
            (omerge_state,
             [&](auto& s)
             {
+                GILRelease gil_release;
                 auto ret_ = merge_sweep(s, rng);
+                gil_release.restore();
                 ret = tuple_apply([&](auto&... args){ return python::make_tuple(args...); }, ret_);
             });
     };
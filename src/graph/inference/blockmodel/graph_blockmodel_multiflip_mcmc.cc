@@ -48,7 +48,9 @@ python::object do_multiflip_mcmc_sweep(python::object omcmc_state,
            (omcmc_state,
             [&](auto& s)
             {
+                GILRelease gil_release;
                 auto ret_ = mcmc_sweep(s, rng);
+                gil_release.restore();
                 ret = tuple_apply([&](auto&... args){ return python::make_tuple(args...); }, ret_);
             });
     };
@@ -106,12 +108,14 @@ python::object do_multiflip_mcmc_sweep_parallel(python::object omcmc_states,
 
     std::vector<std::tuple<double, size_t, size_t>> rets(N);
 
+    GILRelease gil_release;
     #pragma omp parallel for schedule(runtime)
     for (size_t i = 0; i < N; ++i)
     {
         auto& rng_ = parallel_rng<rng_t>::get(rng);
         rets[i] = sweeps[i]->run(rng_);
     }
+    gil_release.restore();
 
     python::list orets;
     for (auto& ret : rets)
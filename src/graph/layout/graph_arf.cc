@@ -37,10 +37,10 @@ void arf_layout(GraphInterface& g, boost::any pos, boost::any weight, double d,
 
     if(weight.empty())
         weight = weight_map_t();
-    run_action<graph_tool::detail::never_directed>()
+    run_action<graph_tool::detail::never_directed>(true)
         (g, std::bind(get_arf_layout(), std::placeholders::_1, std::placeholders::_2,
                       std::placeholders::_3, a, d, dt, epsilon, max_iter, dim),
-         vertex_floating_vector_properties(), edge_props_t())(pos, weight);
+         vertex_position_properties(), edge_props_t())(pos, weight);
 }
 
 #include <boost/python.hpp>
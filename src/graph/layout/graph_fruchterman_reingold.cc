@@ -170,20 +170,20 @@ void fruchterman_reingold_layout(GraphInterface& g, boost::any pos,
     if(weight.empty())
         weight = weight_map_t();
     if (square)
-        run_action<graph_tool::detail::never_directed>()
+        run_action<graph_tool::detail::never_directed>(true)
             (g,
              std::bind(get_layout<square_topology<> >(), std::placeholders::_1,
                        std::placeholders::_2, std::placeholders::_3, make_pair(a, r), scale,
                        grid, make_pair(ti, tf), max_iter),
-             vertex_floating_vector_properties(), edge_props_t())
+             vertex_position_properties(), edge_props_t())
             (pos, weight);
     else
-        run_action<graph_tool::detail::never_directed>()
+        run_action<graph_tool::detail::never_directed>(true)
             (g,
              std::bind(get_layout<circle_topology<> >(), std::placeholders::_1,
                        std::placeholders::_2, std::placeholders::_3, make_pair(a, r),
                        scale, grid, make_pair(ti, tf), max_iter),
-             vertex_floating_vector_properties(), edge_props_t()) (pos, weight);
+             vertex_position_properties(), edge_props_t()) (pos, weight);
 }
 
 #include <boost/python.hpp>
@@ -62,7 +62,7 @@ void sfdp_layout(GraphInterface& g, boost::any pos, boost::any vweight,
     typedef vprop_map_t<uint8_t>::type pin_map_t;
     pin_map_t pin_map = any_cast<pin_map_t>(pin);
 
-    run_action<graph_tool::detail::never_directed>()
+    run_action<graph_tool::detail::never_directed>(true)
         (g,
          std::bind(get_sfdp_layout(C, K, p, theta, gamma, mu, mu_p, init_step,
                                    step_schedule, max_level, epsilon,
@@ -72,7 +72,7 @@ void sfdp_layout(GraphInterface& g, boost::any pos, boost::any vweight,
                    pin_map.get_unchecked(num_vertices(g.get_graph())),
                    groups.get_unchecked(num_vertices(g.get_graph())), verbose,
                    std::ref(rng)),
-         vertex_floating_vector_properties(), vertex_props_t(), edge_props_t())
+         vertex_position_properties(), vertex_props_t(), edge_props_t())
         (pos, vweight, eweight);
 }
 
@@ -84,13 +84,15 @@ struct do_propagate_pos
                     boost::any acvmap, PosMap pos, boost::any acpos,
                     double delta, RNG& rng) const
     {
-        typename PosMap::checked_t cpos =
-            any_cast<typename PosMap::checked_t>(acpos);
+        typedef typename property_traits<PosMap>::value_type pos_t;
+        typedef typename pos_t::value_type val_t;
+
+        // the positions of the coarse graph are always a property map
+        typename vprop_map_t<pos_t>::type cpos =
+            any_cast<typename vprop_map_t<pos_t>::type>(acpos);
         typename VertexMap::checked_t cvmap =
             any_cast<typename VertexMap::checked_t>(acvmap);
         typedef typename property_traits<VertexMap>::value_type c_t;
-        typedef typename property_traits<PosMap>::value_type pos_t;
-        typedef typename pos_t::value_type val_t;
 
         uniform_real_distribution<val_t> noise(-delta, delta);
         gt_hash_map<c_t, pos_t> cmap;
@@ -125,7 +127,7 @@ void propagate_pos(GraphInterface& gi, GraphInterface& cgi, boost::any vmap,
                        std::placeholders::_1, std::placeholders::_2, std::placeholders::_3,
                        cvmap, std::placeholders::_4, cpos, delta, std::ref(rng)),
          all_graph_views(), all_graph_views(),
-         vmaps_t(), vertex_floating_vector_properties())
+         vmaps_t(), vertex_position_properties())
         (gi.get_graph_view(), cgi.get_graph_view(), vmap, pos);
 }
 
@@ -184,7 +186,7 @@ void propagate_pos_mivs(GraphInterface& gi, boost::any mivs, boost::any pos,
         (gi, std::bind(do_propagate_pos_mivs(),
                        std::placeholders::_1, std::placeholders::_2, std::placeholders::_3,
                        delta, std::ref(rng)),
-         vertex_scalar_properties(), vertex_floating_vector_properties())
+         vertex_scalar_properties(), vertex_position_properties())
         (mivs, pos);
 }
 
@@ -215,13 +217,16 @@ struct do_avg_dist
 };
 
 
+typedef mpl::push_back<vertex_scalar_vector_properties,
+                       vertex_flat_vector_map_t>::type vertex_pos_props_t;
+
 double avg_dist(GraphInterface& gi, boost::any pos)
 {
     double d;
     run_action<>()
         (gi, std::bind(do_avg_dist(), std::placeholders::_1,
                        std::placeholders::_2, std::ref(d)),
-         vertex_scalar_vector_properties()) (pos);
+         vertex_pos_props_t()) (pos);
     return d;
 }
 
@@ -245,7 +250,7 @@ void sanitize_pos(GraphInterface& gi, boost::any pos)
 {
     run_action<>()
         (gi, std::bind(do_sanitize_pos(), std::placeholders::_1, std::placeholders::_2),
-         vertex_scalar_vector_properties()) (pos);
+         vertex_pos_props_t()) (pos);
 }
 
 #include <boost/python.hpp>
@@ -18,6 +18,7 @@
 #ifndef GRAPH_FDP_HH
 #define GRAPH_FDP_HH
 
+#include <array>
 #include <limits>
 #include <iostream>
 
@@ -42,7 +43,7 @@ class QuadTree
 {
 public:
     QuadTree(const Pos& ll, const Pos& ur, int max_level)
-        :_ll(ll), _ur(ur), _cm(2, 0), _count(0),
+        :_ll(ll), _ur(ur), _cm{0, 0}, _count(0),
          _max_level(max_level)
     {
         _w = sqrt(power(_ur[0] - _ll[0], 2) +
@@ -219,12 +220,12 @@ struct get_sfdp_layout
 
     template <class Graph, class PosMap, class VertexWeightMap,
               class EdgeWeightMap, class PinMap, class GroupMap, class RNG>
-    void operator()(Graph& g, PosMap pos, VertexWeightMap vweight,
+    void operator()(Graph& g, PosMap opos, VertexWeightMap vweight,
                     EdgeWeightMap eweight, PinMap pin, GroupMap group,
                     bool verbose, RNG& rng) const
     {
-        typedef typename property_traits<PosMap>::value_type pos_t;
         typedef typename property_traits<PosMap>::value_type::value_type val_t;
+        typedef std::array<val_t, 2> pos_t;
 
         typedef typename property_traits<VertexWeightMap>::value_type vweight_t;
 
@@ -232,12 +233,17 @@ struct get_sfdp_layout
         vector<vweight_t> group_size;
         vector<size_t> vertices;
 
+        // the positions are kept contiguously during the layout, instead of
+        // in a separately allocated vector for each vertex
+        vector<pos_t> pos(num_vertices(g));
+
         int HN = 0;
         for (auto v : vertices_range(g))
         {
             if (pin[v] == 0)
                 vertices.push_back(v);
-            pos[v].resize(2, 0);
+            opos[v].resize(2, 0);
+            pos[v] = {opos[v][0], opos[v][1]};
             if (gamma != 0 || mu != 0)
             {
                 size_t s = group[v];
@@ -247,7 +253,6 @@ struct get_sfdp_layout
                     group_cm.resize(s + 1);
                     group_size.resize(s + 1, 0);
                 }
-                group_cm[s].resize(2, 0);
                 group_size[s] += get(vweight, v);
 
                 for (size_t j = 0; j < 2; ++j)
@@ -260,7 +265,6 @@ struct get_sfdp_layout
         {
             if (group_size[s] == 0)
                 continue;
-            group_cm[s].resize(2, 0);
             for (size_t j = 0; j < 2; ++j)
                 group_cm[s][j] /= group_size[s];
         }
@@ -277,8 +281,10 @@ struct get_sfdp_layout
             E0 = E;
             E = 0;
 
-            pos_t ll(2, numeric_limits<val_t>::max()),
-                ur(2, -numeric_limits<val_t>::max());
+            pos_t ll = {numeric_limits<val_t>::max(),
+                        numeric_limits<val_t>::max()},
+                ur = {-numeric_limits<val_t>::max(),
+                      -numeric_limits<val_t>::max()};
             for (auto v : vertices_range(g))
             {
                 for (size_t j = 0; j < 2; ++j)
@@ -321,7 +327,8 @@ struct get_sfdp_layout
                 (vertices,
                  [&](size_t, auto v)
                  {
-                     pos_t diff(2, 0), pos_u(2, 0), ftot(2, 0), cm(2, 0);
+                     pos_t diff = {0, 0}, pos_u = {0, 0}, ftot = {0, 0},
+                         cm = {0, 0};
 
                      // global repulsive forces
                      Q.push_back(&qt);
@@ -479,6 +486,12 @@ struct get_sfdp_layout
                 }
             }
         }
+
+        for (auto v : vertices_range(g))
+        {
+            opos[v][0] = pos[v][0];
+            opos[v][1] = pos[v][1];
+        }
     }
 };
 
@@ -0,0 +1,177 @@
+// graph-tool -- a general graph modification and manipulation thingy
+//
+// Copyright (C) 2006-2018 Tiago de Paula Peixoto <tiago@skewed.de>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef MMAP_ALLOCATOR_HH
+#define MMAP_ALLOCATOR_HH
+
+#include <memory>
+#include <string>
+#include <cerrno>
+#include <cstring>
+#include <type_traits>
+
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "graph_exceptions.hh"
+
+namespace graph_tool
+{
+
+// ========================================================================
+// File-backed storage
+// ========================================================================
+//
+// A mmap_arena places each allocation in its own temporary file, created in a
+// given directory and mapped in memory. The files are unlinked right after
+// creation, so they disappear when the memory is released (or the process
+// terminates). Since the mappings are shared, the kernel writes their pages
+// back to the files, instead of swap, and only keeps in RAM the parts which
+// are being used. This allows property maps larger than the available memory
+// to be used, as long as they are accessed with some locality. The blocks of
+// the files are reserved when they are created, since writing to a page of a
+// sparse file for which the filesystem has no space left would raise SIGBUS,
+// instead of an error which can be handled.
+
+class mmap_arena
+{
+public:
+    enum advice_t
+    {
+        NORMAL = MADV_NORMAL,
+        SEQUENTIAL = MADV_SEQUENTIAL,
+        RANDOM = MADV_RANDOM
+    };
+
+    mmap_arena(const std::string& dir, advice_t advice = NORMAL)
+        : _dir(dir), _advice(advice) {}
+
+    void* allocate(size_t bytes)
+    {
+        if (bytes == 0)
+            return nullptr;
+        std::string path = _dir + "/graph-tool-mmap-XXXXXX";
+        int fd = mkstemp(&path[0]);
+        if (fd == -1)
+            throw GraphException("error creating file in '" + _dir + "': " +
+                                 strerror(errno));
+        unlink(path.c_str());
+        int err = posix_fallocate(fd, 0, bytes);
+        if (err != 0)
+        {
+            close(fd);
+            throw GraphException("error allocating " + std::to_string(bytes) +
+                                 " bytes in '" + _dir + "': " +
+                                 strerror(err));
+        }
+        void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd,
+                       0);
+        err = errno;
+        close(fd); // the mapping keeps the file alive
+        if (p == MAP_FAILED)
+            throw GraphException("error mapping file in '" + _dir + "': " +
+                                 strerror(err));
+        madvise(p, bytes, _advice);
+        return p;
+    }
+
+    void deallocate(void* p, size_t bytes)
+    {
+        if (p != nullptr)
+            munmap(p, bytes);
+    }
+
+    // changes the access pattern hint for the allocation at p, and for the
+    // subsequent ones
+    void advise(void* p, size_t bytes, advice_t advice)
+    {
+        _advice = advice;
+        if (p != nullptr)
+            madvise(p, bytes, _advice);
+    }
+
+    const std::string& get_dir() const { return _dir; }
+    advice_t get_advice() const { return _advice; }
+
+private:
+    std::string _dir;
+    advice_t _advice;
+};
+
+// Allocator used for the storage of property maps. It uses the regular heap,
+// unless a mmap_arena is attached. The arena is carried along with the memory
+// it allocated when containers are moved, copied or swapped.
+template <class T>
+class storage_allocator
+{
+public:
+    typedef T value_type;
+    typedef std::true_type propagate_on_container_copy_assignment;
+    typedef std::true_type propagate_on_container_move_assignment;
+    typedef std::true_type propagate_on_container_swap;
+    typedef std::false_type is_always_equal;
+
+    template <class U>
+    struct rebind { typedef storage_allocator<U> other; };
+
+    storage_allocator() = default;
+
+    storage_allocator(std::shared_ptr<mmap_arena> arena)
+        : _arena(std::move(arena)) {}
+
+    template <class U>
+    storage_allocator(const storage_allocator<U>& a)
+        : _arena(a.get_arena()) {}
+
+    T* allocate(size_t n)
+    {
+        if (_arena == nullptr)
+            return std::allocator<T>().allocate(n);
+        return static_cast<T*>(_arena->allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t n)
+    {
+        if (_arena == nullptr)
+            std::allocator<T>().deallocate(p, n);
+        else
+            _arena->deallocate(p, n * sizeof(T));
+    }
+
+    const std::shared_ptr<mmap_arena>& get_arena() const { return _arena; }
+
+private:
+    std::shared_ptr<mmap_arena> _arena;
+};
+
+template <class T, class U>
+bool operator==(const storage_allocator<T>& a, const storage_allocator<U>& b)
+{
+    return a.get_arena() == b.get_arena();
+}
+
+template <class T, class U>
+bool operator!=(const storage_allocator<T>& a, const storage_allocator<U>& b)
+{
+    return !(a == b);
+}
+
+} // namespace graph_tool
+
+#endif // MMAP_ALLOCATOR_HH
@@ -18,6 +18,7 @@
 #ifndef NUMPY_BIND_HH
 #define NUMPY_BIND_HH
 
+#include <memory>
 #include <vector>
 #include <boost/python.hpp>
 
@@ -62,8 +63,8 @@ typedef boost::mpl::map<
     boost::mpl::pair<std::complex<long double>, boost::mpl::int_<NPY_CLONGDOUBLE> > 
     > numpy_types;
 
-template <class ValueType>
-boost::python::object wrap_vector_owned(const std::vector<ValueType>& vec)
+template <class ValueType, class Alloc = std::allocator<ValueType>>
+boost::python::object wrap_vector_owned(const std::vector<ValueType, Alloc>& vec)
 {
     size_t val_type = boost::mpl::at<numpy_types,ValueType>::type::value;
     npy_intp size[1];
@@ -87,8 +88,8 @@ boost::python::object wrap_vector_owned(const std::vector<ValueType>& vec)
     return o;
 }
 
-template <class ValueType>
-boost::python::object wrap_vector_not_owned(std::vector<ValueType>& vec)
+template <class ValueType, class Alloc = std::allocator<ValueType>>
+boost::python::object wrap_vector_not_owned(std::vector<ValueType, Alloc>& vec)
 {
     PyArrayObject* ndarray;
     size_t val_type = boost::mpl::at<numpy_types,ValueType>::type::value;
@@ -104,6 +105,22 @@ boost::python::object wrap_vector_not_owned(std::vector<ValueType>& vec)
     return o;
 }
 
+// makes the array keep the given handle alive, until it is destroyed together
+// with every view of it
+inline void set_array_handle(boost::python::object& array,
+                             std::shared_ptr<void> handle)
+{
+    auto destroy = [](PyObject* capsule)
+        {
+            delete static_cast<std::shared_ptr<void>*>
+                (PyCapsule_GetPointer(capsule, nullptr));
+        };
+    PyObject* capsule =
+        PyCapsule_New(new std::shared_ptr<void>(std::move(handle)), nullptr,
+                      destroy);
+    PyArray_SetBaseObject((PyArrayObject*) array.ptr(), capsule);
+}
+
 template <class ValueType, size_t Dim>
 boost::python::object wrap_vector_owned(const std::vector<std::array<ValueType, Dim>>& vec)
 {
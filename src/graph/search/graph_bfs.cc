@@ -35,12 +35,13 @@ using namespace graph_tool;
 class BFSVisitorWrapper
 {
 public:
-    BFSVisitorWrapper(GraphInterface& gi, python::object vis)
+    BFSVisitorWrapper(GraphInterface& gi, python::object& vis)
         : _gi(gi), _vis(vis) {}
 
     template <class Vertex, class Graph>
     void initialize_vertex(Vertex u, Graph& g)
     {
+        GILAcquire gil;
         auto gp = retrieve_graph_view<Graph>(_gi, g);
         _vis.attr("initialize_vertex")(PythonVertex<Graph>(gp, u));
     }
@@ -48,6 +49,7 @@ public:
     template <class Vertex, class Graph>
     void discover_vertex(Vertex u, Graph& g)
     {
+        GILAcquire gil;
         auto gp = retrieve_graph_view<Graph>(_gi, g);
         _vis.attr("discover_vertex")(PythonVertex<Graph>(gp, u));
     }
@@ -55,6 +57,7 @@ public:
     template <class Vertex, class Graph>
     void examine_vertex(Vertex u, Graph& g)
     {
+        GILAcquire gil;
         auto gp = retrieve_graph_view<Graph>(_gi, g);
         _vis.attr("examine_vertex")(PythonVertex<Graph>(gp, u));
     }
@@ -62,6 +65,7 @@ public:
     template <class Edge, class Graph>
     void examine_edge(Edge e, Graph& g)
     {
+        GILAcquire gil;
         auto gp = retrieve_graph_view<Graph>(_gi, g);
         _vis.attr("examine_edge")(PythonEdge<Graph>(gp, e));
     }
@@ -69,6 +73,7 @@ public:
     template <class Edge, class Graph>
     void tree_edge(Edge e, Graph& g)
     {
+        GILAcquire gil;
         auto gp = retrieve_graph_view<Graph>(_gi, g);
         _vis.attr("tree_edge")(PythonEdge<Graph>(gp, e));
     }
@@ -76,6 +81,7 @@ public:
     template <class Edge, class Graph>
     void non_tree_edge(Edge e, Graph& g)
     {
+        GILAcquire gil;
         auto gp = retrieve_graph_view<Graph>(_gi, g);
         _vis.attr("non_tree_edge")(PythonEdge<Graph>(gp, e));
     }
@@ -83,6 +89,7 @@ public:
     template <class Edge, class Graph>
     void gray_target(Edge e, Graph& g)
     {
+        GILAcquire gil;
         auto gp = retrieve_graph_view<Graph>(_gi, g);
         _vis.attr("gray_target")(PythonEdge<Graph>(gp, e));
     }
@@ -90,6 +97,7 @@ public:
     template <class Edge, class Graph>
     void black_target(Edge e, Graph& g)
     {
+        GILAcquire gil;
         auto gp = retrieve_graph_view<Graph>(_gi, g);
         _vis.attr("black_target")(PythonEdge<Graph>(gp, e));
     }
@@ -97,13 +105,14 @@ public:
     template <class Vertex, class Graph>
     void finish_vertex(Vertex u, Graph& g)
     {
+        GILAcquire gil;
         auto gp = retrieve_graph_view<Graph>(_gi, g);
         _vis.attr("finish_vertex")(PythonVertex<Graph>(gp, u));
     }
 
 private:
     GraphInterface& _gi;
-    boost::python::object _vis;
+    boost::python::object& _vis;
 };
 
 template <class Graph, class Visitor>
@@ -130,7 +139,7 @@ void do_bfs(Graph& g, size_t s, Visitor&& vis)
 
 void bfs_search(GraphInterface& gi, size_t s, python::object vis)
 {
-    run_action<graph_tool::all_graph_views,mpl::true_>()
+    run_action<graph_tool::all_graph_views,mpl::true_>(true)
         (gi, [&](auto &g){ do_bfs(g, s, BFSVisitorWrapper(gi, vis)); })();
 }
 
@@ -192,7 +201,7 @@ boost::python::object bfs_search_array(GraphInterface& g, size_t s)
 {
     std::vector<std::array<size_t, 2>> edges;
     BFSArrayVisitor vis(edges);
-    run_action<graph_tool::all_graph_views,mpl::true_>()
+    run_action<graph_tool::all_graph_views,mpl::true_>(true)
         (g, [&](auto &g){ do_bfs(g, s, vis); })();
     return wrap_vector_owned<size_t,2>(edges);
 }
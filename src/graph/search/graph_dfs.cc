@@ -27,25 +27,28 @@ using namespace graph_tool;
 class DFSVisitorWrapper
 {
 public:
-    DFSVisitorWrapper(GraphInterface& gi, python::object vis)
+    DFSVisitorWrapper(GraphInterface& gi, python::object& vis)
         : _gi(gi), _vis(vis) {}
 
 
     template <class Vertex, class Graph>
     void initialize_vertex(Vertex u, Graph& g)
     {
+        GILAcquire gil;
         auto gp = retrieve_graph_view<Graph>(_gi, g);
         _vis.attr("initialize_vertex")(PythonVertex<Graph>(gp, u));
     }
     template <class Vertex, class Graph>
     void start_vertex(Vertex u, Graph& g)
     {
+        GILAcquire gil;
         auto gp = retrieve_graph_view<Graph>(_gi, g);
         _vis.attr("start_vertex")(PythonVertex<Graph>(gp, u));
     }
     template <class Vertex, class Graph>
     void discover_vertex(Vertex u, Graph& g)
     {
+        GILAcquire gil;
         auto gp = retrieve_graph_view<Graph>(_gi, g);
         _vis.attr("discover_vertex")(PythonVertex<Graph>(gp, u));
     }
@@ -53,6 +56,7 @@ public:
     template <class Edge, class Graph>
     void examine_edge(Edge e, Graph& g)
     {
+        GILAcquire gil;
         auto gp = retrieve_graph_view<Graph>(_gi, g);
         _vis.attr("examine_edge")(PythonEdge<Graph>(gp, e));
     }
@@ -60,6 +64,7 @@ public:
     template <class Edge, class Graph>
     void tree_edge(Edge e, Graph& g)
     {
+        GILAcquire gil;
         auto gp = retrieve_graph_view<Graph>(_gi, g);
         _vis.attr("tree_edge")(PythonEdge<Graph>(gp, e));
     }
@@ -67,6 +72,7 @@ public:
     template <class Edge, class Graph>
     void back_edge(Edge e, Graph& g)
     {
+        GILAcquire gil;
         auto gp = retrieve_graph_view<Graph>(_gi, g);
         _vis.attr("back_edge")(PythonEdge<Graph>(gp, e));
     }
@@ -74,6 +80,7 @@ public:
     template <class Edge, class Graph>
     void forward_or_cross_edge(Edge e, Graph& g)
     {
+        GILAcquire gil;
         auto gp = retrieve_graph_view<Graph>(_gi, g);
         _vis.attr("forward_or_cross_edge")(PythonEdge<Graph>(gp, e));
     }
@@ -81,13 +88,14 @@ public:
     template <class Vertex, class Graph>
     void finish_vertex(Vertex u, Graph& g)
     {
+        GILAcquire gil;
         auto gp = retrieve_graph_view<Graph>(_gi, g);
         _vis.attr("finish_vertex")(PythonVertex<Graph>(gp, u));
     }
 
 private:
     GraphInterface& _gi;
-    python::object _vis;
+    python::object& _vis;
 };
 
 template <class Graph, class Visitor>
@@ -104,7 +112,7 @@ void do_dfs(Graph& g, size_t s, Visitor&& vis)
 
 void dfs_search(GraphInterface& gi, size_t s, python::object vis)
 {
-    run_action<graph_tool::all_graph_views, mpl::true_>()
+    run_action<graph_tool::all_graph_views, mpl::true_>(true)
         (gi, [&](auto &g) { do_dfs(g, s, DFSVisitorWrapper(gi, vis));})();
 }
 
@@ -167,7 +175,7 @@ boost::python::object dfs_search_array(GraphInterface& g, size_t s)
 {
     std::vector<std::array<size_t, 2>> edges;
     DFSArrayVisitor vis(edges);
-    run_action<graph_tool::all_graph_views,mpl::true_>()
+    run_action<graph_tool::all_graph_views,mpl::true_>(true)
         (g, [&](auto &g){ do_dfs(g, s, vis); })();
     return wrap_vector_owned<size_t,2>(edges);
 }
@@ -278,14 +278,13 @@ struct do_bfs_search
 {
     template <class Graph, class VertexIndexMap, class DistMap, class PredMap>
     void operator()(const Graph& g, size_t source,
-                    boost::python::object otarget_list,
+                    boost::multi_array_ref<int64_t, 1>& target_list,
                     VertexIndexMap vertex_index, DistMap dist_map,
                     PredMap pred_map, long double max_dist,
                     std::vector<size_t>& reached) const
     {
         typedef typename property_traits<DistMap>::value_type dist_t;
 
-        auto target_list = get_array<int64_t, 1>(otarget_list);
         gt_hash_set<std::size_t> tgt(target_list.begin(),
                                      target_list.end());
 
@@ -333,13 +332,11 @@ struct do_djk_search
     template <class Graph, class VertexIndexMap, class DistMap, class PredMap,
               class WeightMap>
     void operator()(const Graph& g, size_t source,
-                    boost::python::object otarget_list,
+                    boost::multi_array_ref<int64_t, 1>& target_list,
                     VertexIndexMap vertex_index, DistMap dist_map,
                     PredMap pred_map, WeightMap weight, long double max_dist,
                     std::vector<size_t>& reached, bool dag) const
     {
-        auto target_list = get_array<int64_t, 1>(otarget_list);
-
         typedef typename property_traits<DistMap>::value_type dist_t;
 
         constexpr dist_t inf = (std::is_floating_point<dist_t>::value) ?
@@ -452,11 +449,13 @@ void get_dists(GraphInterface& gi, size_t source, boost::python::object tgt,
         ::apply<int64_t, GraphInterface::vertex_index_map_t>::type pred_map_t;
 
     pred_map_t pmap = any_cast<pred_map_t>(pred_map);
+    auto target_list = get_array<int64_t, 1>(tgt);
 
     if (weight.empty())
     {
-        run_action<>()
-            (gi, std::bind(do_bfs_search(), std::placeholders::_1, source, tgt, gi.get_vertex_index(),
+        run_action<graph_tool::frozen_graph_views>(true)
+            (gi, std::bind(do_bfs_search(), std::placeholders::_1, source,
+                           std::ref(target_list), gi.get_vertex_index(),
                            std::placeholders::_2, pmap.get_unchecked(num_vertices(gi.get_graph())),
                            max_dist, std::ref(reached)),
              writable_vertex_scalar_properties())
@@ -466,7 +465,7 @@ void get_dists(GraphInterface& gi, size_t source, boost::python::object tgt,
     {
         if (bf)
         {
-            run_action<>()
+            run_action<>(true)
                 (gi, std::bind(do_bf_search(), std::placeholders::_1, source,
                                std::placeholders::_2, pmap.get_unchecked(num_vertices(gi.get_graph())),
                                std::placeholders::_3),
@@ -476,8 +475,9 @@ void get_dists(GraphInterface& gi, size_t source, boost::python::object tgt,
         }
         else
         {
-            run_action<>()
-                (gi, std::bind(do_djk_search(), std::placeholders::_1, source, tgt, gi.get_vertex_index(),
+            run_action<graph_tool::frozen_graph_views>(true)
+                (gi, std::bind(do_djk_search(), std::placeholders::_1, source,
+                               std::ref(target_list), gi.get_vertex_index(),
                                std::placeholders::_2, pmap.get_unchecked(num_vertices(gi.get_graph())),
                                std::placeholders::_3, max_dist, std::ref(reached), dag),
                  writable_vertex_scalar_properties(),
@@ -540,7 +540,7 @@ void do_get_all_preds(GraphInterface& gi, boost::any adist, boost::any apred,
     if (aweight.empty())
         aweight = weight_map_t();
 
-    run_action<>()
+    run_action<>(true)
         (gi, [&](auto& g, auto dist, auto weight)
              {get_all_preds(g, dist, pred.get_unchecked(num_vertices(g)),
                             weight, preds.get_unchecked(num_vertices(g)),
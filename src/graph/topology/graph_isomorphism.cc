@@ -89,7 +89,7 @@ bool check_isomorphism(GraphInterface& gi1, GraphInterface& gi2,
         return false;
     if (gi1.get_directed())
     {
-        gt_dispatch<>()
+        gt_dispatch<>(true)
             (std::bind(check_iso(),
                        std::placeholders::_1, std::placeholders::_2,
                        inv_map1, inv_map2, max_inv, iso_map,
@@ -100,7 +100,7 @@ bool check_isomorphism(GraphInterface& gi1, GraphInterface& gi2,
     }
     else
     {
-        gt_dispatch<>()
+        gt_dispatch<>(true)
             (std::bind(check_iso(),
                        std::placeholders::_1, std::placeholders::_2,
                        inv_map1, inv_map2, max_inv, iso_map,
@@ -119,7 +119,7 @@ void get_kruskal_spanning_tree(GraphInterface& gi, boost::any weight_map,
     typedef mpl::push_back<writable_edge_scalar_properties, cweight_t>::type
         weight_maps;
 
-    run_action<graph_tool::detail::never_directed>()
+    run_action<graph_tool::detail::never_directed>(true)
         (gi, std::bind(get_kruskal_min_span_tree(), std::placeholders::_1, gi.get_vertex_index(),
                        std::placeholders::_2, std::placeholders::_3),
          weight_maps(), writable_edge_scalar_properties())(weight_map, tree_map);
@@ -136,7 +136,7 @@ void get_prim_spanning_tree(GraphInterface& gi, size_t root,
     typedef mpl::push_back<writable_edge_scalar_properties, cweight_t>::type
         weight_maps;
 
-    run_action<graph_tool::detail::never_directed>()
+    run_action<graph_tool::detail::never_directed>(true)
         (gi, std::bind(get_prim_min_span_tree(), std::placeholders::_1, root,
                        gi.get_vertex_index(), std::placeholders::_2, std::placeholders::_3),
          weight_maps(), tree_properties())(weight_map, tree_map);
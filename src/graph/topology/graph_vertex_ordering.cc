@@ -0,0 +1,85 @@
+// graph-tool -- a general graph modification and manipulation thingy
+//
+// Copyright (C) 2006-2018 Tiago de Paula Peixoto <tiago@skewed.de>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#include <boost/python.hpp>
+
+#include "graph_tool.hh"
+#include "graph_vertex_ordering.hh"
+
+using namespace std;
+using namespace boost;
+using namespace graph_tool;
+
+void do_vertex_ordering(GraphInterface& gi, string method, boost::any arank,
+                        size_t window, size_t max_deg)
+{
+    typedef vprop_map_t<int64_t>::type rank_t;
+    size_t N = num_vertices(gi.get_graph());
+    auto rank = any_cast<rank_t>(arank).get_unchecked(N);
+    for (size_t v = 0; v < N; ++v)
+        rank[v] = -1;
+
+    gt_dispatch<>()
+        ([&](auto& g)
+         {
+             vector<size_t> order;
+             if (method == "rcm")
+                 rcm_ordering(g, order);
+             else if (method == "degree")
+                 degree_ordering(g, order);
+             else if (method == "window")
+                 window_ordering(g, order, window, max_deg);
+             else
+                 throw ValueException("invalid ordering method: " + method);
+             for (size_t i = 0; i < order.size(); ++i)
+                 rank[order[i]] = i;
+         },
+         all_graph_views())
+        (gi.get_graph_view());
+
+    // filtered vertices are placed at the end, in their current order
+    size_t pos = 0;
+    for (size_t v = 0; v < N; ++v)
+    {
+        if (rank[v] >= 0)
+            pos++;
+    }
+    for (size_t v = 0; v < N; ++v)
+    {
+        if (rank[v] < 0)
+            rank[v] = pos++;
+    }
+}
+
+python::object do_edge_span(GraphInterface& gi, boost::any rank)
+{
+    pair<double, double> span;
+    gt_dispatch<>()
+        ([&](auto& g, auto r)
+         {
+             span = get_edge_span(g, r);
+         },
+         all_graph_views(), vertex_scalar_properties())
+        (gi.get_graph_view(), rank);
+    return python::make_tuple(span.first, span.second);
+}
+
+void export_vertex_ordering()
+{
+    python::def("vertex_ordering", &do_vertex_ordering);
+    python::def("edge_span", &do_edge_span);
+};
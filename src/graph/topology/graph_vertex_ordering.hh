@@ -0,0 +1,221 @@
+// graph-tool -- a general graph modification and manipulation thingy
+//
+// Copyright (C) 2006-2018 Tiago de Paula Peixoto <tiago@skewed.de>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 3
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef GRAPH_VERTEX_ORDERING_HH
+#define GRAPH_VERTEX_ORDERING_HH
+
+#include "graph_util.hh"
+
+#include <queue>
+
+namespace graph_tool
+{
+using namespace std;
+using namespace boost;
+
+// All the functions below compute a sequence of vertices (in the new order)
+// which is then converted to a "rank" property map, i.e. the new position of
+// each vertex. Vertices which are filtered out are not included. In all
+// cases the graph is treated as undirected.
+
+template <class Graph>
+size_t total_degree(typename graph_traits<Graph>::vertex_descriptor v,
+                    const Graph& g)
+{
+    size_t k = 0;
+    for (auto u : all_neighbors_range(v, g))
+    {
+        (void) u;
+        ++k;
+    }
+    return k;
+}
+
+template <class Graph, class Deg>
+void get_degree_sequence(const Graph& g, Deg& deg, vector<size_t>& vs)
+{
+    deg.resize(num_vertices(g), 0);
+    vs.clear();
+    for (auto v : vertices_range(g))
+        vs.push_back(v);
+
+    #pragma omp parallel for schedule(runtime) if (vs.size() > OPENMP_MIN_THRESH)
+    for (size_t i = 0; i < vs.size(); ++i)
+        deg[vs[i]] = total_degree(vs[i], g);
+}
+
+// descending degree order
+template <class Graph>
+void degree_ordering(const Graph& g, vector<size_t>& order)
+{
+    vector<size_t> deg;
+    get_degree_sequence(g, deg, order);
+    std::stable_sort(order.begin(), order.end(),
+                     [&](auto u, auto v) { return deg[u] > deg[v]; });
+}
+
+// reverse Cuthill-McKee order. Each component is traversed in BFS order,
+// starting from its vertex of smallest degree, and the unvisited neighbors of
+// each vertex are visited in ascending degree order.
+template <class Graph>
+void rcm_ordering(const Graph& g, vector<size_t>& order)
+{
+    vector<size_t> deg, vs;
+    get_degree_sequence(g, deg, vs);
+    std::stable_sort(vs.begin(), vs.end(),
+                     [&](auto u, auto v) { return deg[u] < deg[v]; });
+
+    vector<bool> visited(num_vertices(g), false);
+    vector<size_t> ns;
+    order.clear();
+    for (auto s : vs)
+    {
+        if (visited[s])
+            continue;
+        size_t pos = order.size();
+        order.push_back(s);
+        visited[s] = true;
+        while (pos < order.size())
+        {
+            auto v = order[pos++];
+            ns.clear();
+            for (auto u : all_neighbors_range(v, g))
+            {
+                if (visited[u])
+                    continue;
+                visited[u] = true;
+                ns.push_back(u);
+            }
+            std::stable_sort(ns.begin(), ns.end(),
+                             [&](auto u, auto w) { return deg[u] < deg[w]; });
+            order.insert(order.end(), ns.begin(), ns.end());
+        }
+    }
+    std::reverse(order.begin(), order.end());
+}
+
+// Greedy window ordering in the spirit of Gorder (Wei et al., SIGMOD 2016):
+// each new vertex is the one with the largest number of direct links and
+// common neighbors with the last `window` placed vertices. Neighborhoods
+// larger than `max_deg` are not traversed for common neighbors, to avoid a
+// quadratic cost for hubs.
+template <class Graph>
+void window_ordering(const Graph& g, vector<size_t>& order, size_t window,
+                     size_t max_deg)
+{
+    vector<size_t> deg, vs;
+    get_degree_sequence(g, deg, vs);
+    std::stable_sort(vs.begin(), vs.end(),
+                     [&](auto u, auto v) { return deg[u] > deg[v]; });
+
+    size_t N = num_vertices(g);
+    vector<int64_t> score(N, 0);
+    vector<bool> placed(N, false);
+
+    // lazy max-heap of (score, vertex); stale entries are skipped or
+    // re-inserted when popped
+    std::priority_queue<pair<int64_t, size_t>> queue;
+
+    auto update = [&](size_t v, int64_t delta)
+        {
+            auto inc = [&](size_t u)
+                {
+                    if (placed[u])
+                        return;
+                    score[u] += delta;
+                    if (delta > 0)
+                        queue.emplace(score[u], u);
+                };
+            for (auto u : all_neighbors_range(v, g))
+            {
+                inc(u);
+                if (deg[u] > max_deg)
+                    continue;
+                for (auto w : all_neighbors_range(u, g))
+                {
+                    if (w != v)
+                        inc(w);
+                }
+            }
+        };
+
+    order.clear();
+    auto vi = vs.begin();
+    while (order.size() < vs.size())
+    {
+        size_t v = graph_traits<Graph>::null_vertex();
+        while (!queue.empty())
+        {
+            auto top = queue.top();
+            queue.pop();
+            auto u = top.second;
+            if (placed[u])
+                continue;
+            if (top.first != score[u])
+            {
+                if (score[u] > 0)
+                    queue.emplace(score[u], u);
+                continue;
+            }
+            v = u;
+            break;
+        }
+
+        if (v == graph_traits<Graph>::null_vertex())
+        {
+            // start a new region from the highest-degree unplaced vertex
+            while (placed[*vi])
+                ++vi;
+            v = *vi;
+        }
+
+        placed[v] = true;
+        order.push_back(v);
+        update(v, 1);
+        if (order.size() > window)
+            update(order[order.size() - window - 1], -1);
+    }
+}
+
+// average gap |rank[s] - rank[t]| over all edges, and the average of
+// log2(1 + |rank[s] - rank[t]|), which is a proxy for the number of cache
+// lines touched during a traversal
+template <class Graph, class RankMap>
+pair<double, double> get_edge_span(const Graph& g, RankMap rank)
+{
+    double span = 0, lspan = 0;
+    size_t E = 0;
+    #pragma omp parallel if (num_vertices(g) > OPENMP_MIN_THRESH) \
+        reduction(+:span, lspan, E)
+    parallel_edge_loop_no_spawn
+        (g,
+         [&](const auto& e)
+         {
+             double d = std::abs(double(rank[source(e, g)]) -
+                                 double(rank[target(e, g)]));
+             span += d;
+             lspan += std::log2(1 + d);
+             E++;
+         });
+    if (E == 0)
+        return {0., 0.};
+    return {span / E, lspan / E};
+}
+
+} // graph_tool namespace
+
+#endif // GRAPH_VERTEX_ORDERING_HH
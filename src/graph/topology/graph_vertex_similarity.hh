@@ -19,57 +19,74 @@
 #define GRAPH_VERTEX_SIMILARITY_HH
 
 #include "graph_util.hh"
+#include "graph_neighbor_intersection.hh"
 
 namespace graph_tool
 {
 using namespace std;
 using namespace boost;
 
-template <class Graph, class Vertex, class Mark>
-double dice(Vertex u, Vertex v, bool self_loop, Mark& mark, Graph& g)
+// calls f(w, shared) for each neighbor w of v (with multiplicity), where shared
+// is true if w is also a neighbor of u, or if w == u and self_loop == true. If
+// the adjacency is sorted, the neighborhoods are intersected by merging,
+// otherwise the neighbors of u are marked.
+template <class Graph, class Vertex, class Mark, class F>
+void for_each_shared_neighbor(Vertex u, Vertex v, bool self_loop, Mark& mark,
+                              Graph& g, F&& f)
 {
-    size_t count = 0;
+    if constexpr (has_neighbor_runs<std::remove_const_t<Graph>>::value)
+    {
+        if (has_sorted_neighbors(g))
+        {
+            auto u_runs = get_neighbor_runs(u, g);
+            neighbor_runs_cursor<decltype(u_runs)> cursor(u_runs);
+            for (auto& run : get_neighbor_runs(v, g))
+            {
+                for (auto w : make_iterator_range(run.first, run.second))
+                    f(w, cursor.contains(w) || (self_loop && w == u));
+                cursor.reset();
+            }
+            return;
+        }
+    }
+
     for (auto w : adjacent_vertices_range(u, g))
         mark[w] = true;
     if (self_loop)
         mark[u] = true;
     for (auto w : adjacent_vertices_range(v, g))
-    {
-        if (mark[w])
-            count++;
-    }
+        f(w, bool(mark[w]));
     for (auto w : adjacent_vertices_range(u, g))
         mark[w] = false;
     if (self_loop)
         mark[u] = false;
+}
+
+template <class Graph, class Vertex, class Mark>
+double dice(Vertex u, Vertex v, bool self_loop, Mark& mark, Graph& g)
+{
+    size_t count = 0;
+    for_each_shared_neighbor(u, v, self_loop, mark, g,
+                             [&](auto, bool shared)
+                             {
+                                 if (shared)
+                                     count++;
+                             });
     return 2 * count / double(out_degree(u, g) + out_degree(v, g));
 }
 
 template <class Graph, class Vertex, class Mark>
 double jaccard(Vertex u, Vertex v, bool self_loop, Mark& mark, Graph& g)
 {
-    size_t count = 0, total = 0;
-    for (auto w : adjacent_vertices_range(u, g))
-    {
-        mark[w] = true;
-        total++;
-    }
-
-    if (self_loop)
-        mark[u] = true;
-
-    for (auto w : adjacent_vertices_range(v, g))
-    {
-        if (mark[w])
-            count++;
-        else
-            total++;
-    }
-
-    for (auto w : adjacent_vertices_range(u, g))
-        mark[w] = false;
-    if (self_loop)
-        mark[u] = false;
+    size_t count = 0, total = out_degree(u, g);
+    for_each_shared_neighbor(u, v, self_loop, mark, g,
+                             [&](auto, bool shared)
+                             {
+                                 if (shared)
+                                     count++;
+                                 else
+                                     total++;
+                             });
     return count / double(total);
 }
 
@@ -77,20 +94,16 @@ template <class Graph, class Vertex, class Mark>
 double inv_log_weighted(Vertex u, Vertex v, Mark& mark, Graph& g)
 {
     double count = 0;
-    for (auto w : adjacent_vertices_range(u, g))
-        mark[w] = true;
-    for (auto w : adjacent_vertices_range(v, g))
-    {
-        if (mark[w])
-        {
-            if (graph_tool::is_directed(g))
-                count += 1. / log(in_degreeS()(w, g));
-            else
-                count += 1. / log(out_degree(w, g));
-        }
-    }
-    for (auto w : adjacent_vertices_range(u, g))
-        mark[w] = false;
+    for_each_shared_neighbor(u, v, false, mark, g,
+                             [&](auto w, bool shared)
+                             {
+                                 if (!shared)
+                                     return;
+                                 if (graph_tool::is_directed(g))
+                                     count += 1. / log(in_degreeS()(w, g));
+                                 else
+                                     count += 1. / log(out_degree(w, g));
+                             });
     return count;
 }
 
@@ -177,6 +177,8 @@ def _prop(t, g, prop):
         pmap = prop
     if pmap is None:
         return libcore.any()
+    if isinstance(pmap, (numpy.ndarray, tuple)):
+        return _flat_prop(t, g, pmap)
     if t != prop.key_type():
         names = {'e': 'edge', 'v': 'vertex', 'g': 'graph'}
         raise ValueError("Expected '%s' property map, got '%s'" %
@@ -190,6 +192,21 @@ def _prop(t, g, prop):
     return pmap._get_any()
 
 
+def _flat_prop(t, g, prop):
+    """Return a vertex property map which refers to the values of a
+    two-dimensional ``float64`` array with one row per vertex index, or of a
+    pair ``(offsets, values)`` of one-dimensional arrays, where the values of
+    vertex ``i`` are ``values[offsets[i]:offsets[i+1]]``. The arrays are not
+    copied, and any change to the property map is seen through them."""
+    if t != "v":
+        raise ValueError("Only vertex property maps can be given as arrays")
+    if isinstance(prop, tuple):
+        offsets, values = prop
+    else:
+        offsets, values = None, prop
+    return libcore.get_flat_vertex_property(g._Graph__graph, values, offsets)
+
+
 def _degree(g, name):
     """Retrieve the degree type from string, or returns the corresponding
     property map."""
@@ -244,6 +261,15 @@ def _python_type(type_name):
         return str
     return object
 
+def _numpy_type(type_name):
+    types = {"bool": numpy.uint8,
+             "int16_t": numpy.int16,
+             "int32_t": numpy.int32,
+             "int64_t": numpy.int64,
+             "double": numpy.float64,
+             "long double": numpy.longdouble}
+    return types.get(_type_alias(type_name), None)
+
 def _gt_type(obj):
     if isinstance(obj, numpy.dtype):
         t = obj.type
@@ -293,6 +319,7 @@ def show_config():
     print("install prefix:", info.install_prefix)
     print("python dir:", info.python_dir)
     print("graph filtering:", libcore.graph_filtering_enabled())
+    print("compact index:", libcore.compact_index_enabled())
     print("openmp:", libcore.openmp_enabled())
     print("uname:", " ".join(os.uname()))
 
@@ -740,6 +767,13 @@ class PropertyMap(object):
             a = numpy.array(a)
             return a
 
+        if "vector" in self.value_type() and self.__is_flat_vector():
+            g = self.get_graph()
+            return libcore.get_vector_property_array(g._Graph__graph,
+                                                     _prop(self.key_type(), g, self),
+                                                     numpy.asarray(pos, dtype="int64"),
+                                                     self.key_type() == "e")
+
         p = ungroup_vector_property(self, pos)
         a = numpy.array([x.fa for x in p])
         return a
@@ -772,6 +806,17 @@ class PropertyMap(object):
                     self[v] = a[j]
             return
 
+        if self.__is_flat_vector():
+            if pos is None:
+                pos = range(a.shape[0])
+            g = self.get_graph()
+            a = numpy.asarray(a, dtype=_numpy_type(self.value_type()[7:-1]))
+            libcore.set_vector_property_array(g._Graph__graph,
+                                              _prop(self.key_type(), g, self),
+                                              a, numpy.asarray(pos, dtype="int64"),
+                                              self.key_type() == "e")
+            return
+
         val = self.value_type()[7:-1]
         ps = []
         for i in range(a.shape[0]):
@@ -792,6 +837,100 @@ class PropertyMap(object):
                     ps[-1][v] = a[i, j]
         group_vector_property(ps, val, self, pos)
 
+    def get_codes(self):
+        r"""Return a tuple ``(codes, categories)`` with a dictionary encoding of a
+        string property map, where ``categories`` is a list with the distinct
+        values, in order of first appearance, and ``codes`` is an array such
+        that ``categories[codes[i]]`` is the value of the ``i``-th vertex or
+        edge (in the same order as in :attr:`~PropertyMap.fa`).
+
+        This is a compact representation for properties with few distinct
+        values, and comparisons can be done directly on the integer codes.
+
+        Notes
+        -----
+        The encoding is a copy of the values, and does not change how the
+        property map itself is stored. String property maps keep one
+        ``std::string`` per vertex or edge, which takes 32 bytes with libstdc++
+        even if the value is short enough to avoid a separate heap allocation,
+        i.e. several times more than the codes. Other functions on string
+        properties, such as :func:`~graph_tool.group_vector_property`, also
+        still operate on the individual strings.
+
+        Examples
+        --------
+        >>> g = gt.Graph()
+        >>> g.add_vertex(4)
+        <...>
+        >>> label = g.new_vp("string", vals=["a", "b", "a", "c"])
+        >>> codes, categories = label.get_codes()
+        >>> print(codes, categories)
+        [0 1 0 2] ['a', 'b', 'c']
+        >>> u = gt.GraphView(g, vfilt=codes == categories.index("a"))
+        >>> print(u.num_vertices())
+        2
+        """
+        if self.key_type() == "g" or self.value_type() != "string":
+            raise ValueError("Cannot encode property map of type '%s'." %
+                             self.value_type())
+        g = self.get_graph()
+        return libcore.get_string_property_codes(g._Graph__graph,
+                                                 _prop(self.key_type(), g, self),
+                                                 self.key_type() == "e")
+
+    def set_codes(self, codes, categories):
+        r"""Set the values of a string property map from the dictionary encoding
+        ``(codes, categories)``, as returned by
+        :meth:`~PropertyMap.get_codes`."""
+        if self.key_type() == "g" or self.value_type() != "string":
+            raise ValueError("Cannot set codes to property map of type '%s'." %
+                             self.value_type())
+        g = self.get_graph()
+        codes = numpy.asarray(codes, dtype="int64")
+        libcore.set_string_property_codes(g._Graph__graph,
+                                          _prop(self.key_type(), g, self),
+                                          codes, [str(c) for c in categories],
+                                          self.key_type() == "e")
+
+    def __is_flat_vector(self):
+        vt = self.value_type()
+        return (self.key_type() != "g" and vt.startswith("vector<") and
+                _numpy_type(vt[7:-1]) is not None)
+
+    def get_ragged_array(self):
+        r"""Return a tuple ``(offsets, values)`` with copies of the entries of
+        the vector-valued property map in a flattened form, where the values of
+        the ``i``-th vertex or edge (in the same order as in
+        :attr:`~PropertyMap.fa`) are given by
+        ``values[offsets[i]:offsets[i+1]]``.
+
+        Contrary to :meth:`~PropertyMap.get_2d_array`, the vectors can have
+        different lengths. Only vector property maps of numeric types are
+        supported."""
+        if not self.__is_flat_vector():
+            raise ValueError("Cannot create ragged array from property map of type '%s'." %
+                             self.value_type())
+        g = self.get_graph()
+        return libcore.get_vector_property_ragged(g._Graph__graph,
+                                                  _prop(self.key_type(), g, self),
+                                                  self.key_type() == "e")
+
+    def set_ragged_array(self, offsets, values):
+        r"""Set the entries of the vector-valued property map from the flattened
+        representation ``(offsets, values)``, as returned by
+        :meth:`~PropertyMap.get_ragged_array`."""
+        if not self.__is_flat_vector():
+            raise ValueError("Cannot set ragged array to property map of type '%s'." %
+                             self.value_type())
+        g = self.get_graph()
+        offsets = numpy.asarray(offsets, dtype="int64")
+        values = numpy.asarray(values,
+                               dtype=_numpy_type(self.value_type()[7:-1]))
+        libcore.set_vector_property_ragged(g._Graph__graph,
+                                           _prop(self.key_type(), g, self),
+                                           offsets, values,
+                                           self.key_type() == "e")
+
     def is_writable(self):
         """Return True if the property is writable."""
         return self.__map.is_writable()
@@ -830,6 +969,48 @@ class PropertyMap(object):
         self.__map.resize(size)
         self.__map.shrink_to_fit()
 
+    def memory_usage(self):
+        """Return a tuple ``(size, capacity)`` with the number of bytes occupied by
+        the values, and allocated by the underlying container, including the
+        memory owned by nested vectors and strings (but not by Python
+        objects). The difference between the two is the memory that would be
+        released by :meth:`~PropertyMap.shrink_to_fit`."""
+        return self.__map.get_memory_usage()
+
+    def set_mmap(self, dir, advice="normal"):
+        """Move the values of the property map to memory-mapped files created in the
+        directory ``dir``, or back to main memory if ``dir`` is ``None``.
+
+        The files are deleted as soon as they are created, and exist only as
+        long as the property map. Since the operating system keeps in memory
+        only the parts of the files that are being accessed, this allows
+        vertex and edge property maps larger than the available memory to be
+        used by all algorithms, as well as via the :attr:`~PropertyMap.a` and
+        :attr:`~PropertyMap.fa` arrays. This is mostly useful for scalar value
+        types, since the contents of strings and vectors remain in main memory.
+
+        The parameter ``advice`` is a hint about the access pattern that will be
+        used, and can be either ``"normal"``, ``"sequential"`` or
+        ``"random"``. If the values are already mapped in ``dir``, only the hint
+        is changed.
+
+        .. note::
+
+           Arrays previously obtained via :attr:`~PropertyMap.a` or
+           :attr:`~PropertyMap.fa` are invalidated by this operation.
+        """
+        if self.key_type() == "g":
+            raise ValueError("graph property maps cannot be memory-mapped")
+        self.__map.set_mmap("" if dir is None else str(dir), advice)
+
+    def get_mmap(self):
+        """Return a tuple ``(dir, advice)`` with the directory and access pattern hint
+        of the memory-mapped storage set by :meth:`~PropertyMap.set_mmap`, or
+        ``None`` if the values are in main memory."""
+        if self.key_type() == "g":
+            return None
+        return self.__map.get_mmap()
+
     def swap(self, other):
         """Swap internal storage with ``other``."""
         if self.key_type() != other.key_type():
@@ -923,8 +1104,8 @@ def _check_prop_writable(prop, name=None):
 
 
 def _check_prop_scalar(prop, name=None, floating=False):
-    scalars = ["bool", "int16_t", "int32_t", "int64_t", "unsigned long",
-               "double", "long double"]
+    scalars = ["bool", "int16_t", "int32_t", "int64_t", "unsigned int",
+               "unsigned long", "double", "long double"]
     if floating:
         scalars = ["double", "long double"]
 
@@ -935,8 +1116,8 @@ def _check_prop_scalar(prop, name=None, floating=False):
 
 
 def _check_prop_vector(prop, name=None, scalar=True, floating=False):
-    scalars = ["bool", "int16_t", "int32_t", "int64_t", "unsigned long",
-               "double", "long double"]
+    scalars = ["bool", "int16_t", "int32_t", "int64_t", "unsigned int",
+               "unsigned long", "double", "long double"]
     if not scalar:
         scalars += ["string"]
     if floating:
@@ -1103,8 +1284,18 @@ def map_property_values(src_prop, tgt_prop, map_func):
         Source property map.
     tgt_prop : :class:`~graph_tool.PropertyMap`
         Target property map.
-    map_func : function or callable object
-        Function mapping values of ``src_prop`` to values of ``tgt_prop``.
+    map_func : function, callable object, ``dict`` or :class:`~numpy.ndarray`
+        Function mapping values of ``src_prop`` to values of ``tgt_prop``. If a
+        ``dict`` is given, the values are mapped according to its items. If an
+        array is given, and the values of ``src_prop`` are integers, they are
+        used as indexes into the array.
+
+    Notes
+    -----
+    Dictionaries and arrays are converted only once, and the mapping is
+    then done in parallel, without involving the Python interpreter. A
+    callable, on the other hand, is called once for each distinct value of
+    ``src_prop``.
 
     Returns
     -------
@@ -1130,6 +1321,13 @@ def map_property_values(src_prop, tgt_prop, map_func):
     if k == "g":
         tgt_prop[g] = map_func(src_prop[g])
         return
+    if isinstance(map_func, numpy.ndarray):
+        vt = _numpy_type(tgt_prop.value_type())
+        if (vt is not None and
+            src_prop.value_type() in ["bool", "int16_t", "int32_t", "int64_t"]):
+            map_func = numpy.ascontiguousarray(map_func, dtype=vt)
+        else:
+            map_func = map_func.__getitem__
     u = GraphView(g, directed=True, reversed=g.is_reversed(),
                   skip_properties=True)
     libcore.property_map_values(u._Graph__graph,
@@ -1534,6 +1732,11 @@ class Graph(object):
     :class:`~graph_tool.PropertyMap` specifying the ordering of the vertices in
     the copied graph.
 
+    Unless ``vorder`` is given or filtered elements are pruned, the copy
+    shares the adjacency lists and the property values with ``g``, and each of
+    them is only copied once it is modified in either graph, so that copying is
+    cheap.
+
     The graph is implemented as an `adjacency list`_, where both vertex and edge
     lists are C++ STL vectors.
 
@@ -1551,6 +1754,7 @@ class Graph(object):
                                "edge_filter": (None, False),
                                "vertex_filter": (None, False),
                                "directed": True}
+        self.__materialized = None
         if g is None:
             self.__graph = libcore.GraphInterface()
             self.set_directed(directed)
@@ -1592,7 +1796,7 @@ class Graph(object):
 
                 nvfilt = nefilt = None
                 for k, m in g.properties.items():
-                    nmap = self.copy_property(m, g=gv)
+                    nmap = self.__clone_property(m, gv)
                     self.properties[k] = nmap
                     if m is vfilt:
                         nvfilt = nmap
@@ -1600,10 +1804,10 @@ class Graph(object):
                         nefilt = nmap
                 if vfilt is not None:
                     if nvfilt is None:
-                        nvfilt = self.copy_property(vfilt, g=gv)
+                        nvfilt = self.__clone_property(vfilt, gv)
                 if efilt is not None:
                     if nefilt is None:
-                        nefilt = self.copy_property(efilt, g=gv)
+                        nefilt = self.__clone_property(efilt, gv)
                 self.set_filters(nefilt, nvfilt,
                                  inverted_edges=g.get_edge_filter()[1],
                                  inverted_vertices=g.get_vertex_filter()[1])
@@ -1783,7 +1987,7 @@ class Graph(object):
         return v
 
     def edge(self, s, t, all_edges=False, add_missing=False):
-        """Return the edge from vertex ``s`` to ``t``, if it exists. If
+        r"""Return the edge from vertex ``s`` to ``t``, if it exists. If
         ``all_edges=True`` then a list is returned with all the parallel edges
         from ``s`` to ``t``, otherwise only one edge is returned.
 
@@ -1793,6 +1997,11 @@ class Graph(object):
         This operation will take :math:`O(min(k(s), k(t)))` time, where
         :math:`k(s)` and :math:`k(t)` are the out-degree and in-degree (or
         out-degree if undirected) of vertices :math:`s` and :math:`t`.
+        If ``all_edges == False`` and the edges are not filtered, it will take
+        :math:`O(1)` time instead if the edge hash index is enabled and up to
+        date (see :meth:`~graph_tool.Graph.set_edge_hash`), or
+        :math:`O(\log k(s))` time if the adjacency is sorted (see
+        :meth:`~graph_tool.Graph.set_sorted_adjacency`).
 
         """
         s = self.vertex(int(s))
@@ -1823,6 +2032,31 @@ class Graph(object):
         """
         return libcore.get_edges(self.__graph)
 
+    def edge_index_of(self, pairs):
+        r"""Return a :class:`numpy.ndarray` with the index of an edge from
+        ``s`` to ``t`` for every pair ``(s, t)`` in ``pairs``, which should be
+        an array of shape ``(N, 2)``, or ``-1`` if no such edge exists. If
+        there are parallel edges, the index of any one of them is returned.
+
+        The lookups are done in parallel. They take :math:`O(\log k)` time
+        each if :meth:`~graph_tool.Graph.set_sorted_adjacency` is enabled, and
+        :math:`O(1)` time if :meth:`~graph_tool.Graph.set_edge_hash` is
+        enabled, or :math:`O(k)` otherwise, where :math:`k` is the out-degree
+        of ``s``.
+
+        Examples
+        --------
+        >>> g = gt.Graph()
+        >>> g.add_edge_list([(0, 1), (0, 2), (1, 2), (2, 3)])
+        >>> g.edge_index_of([(0, 2), (2, 0), (2, 3)])
+        array([ 1, -1,  3])
+
+        """
+        pairs = numpy.asarray(pairs, dtype="int64")
+        if pairs.size == 0:
+            pairs = pairs.reshape((0, 2))
+        return libcore.get_edge_index_list(self.__graph, pairs)
+
     def get_edges(self):
         """Return a :class:`numpy.ndarray` containing the edges. The shape of
         the array will be ``(E, 3)``, where ``E`` is the number of edges, and
@@ -1945,6 +2179,69 @@ class Graph(object):
                                        numpy.asarray(vs, dtype="uint64"),
                                        _prop("e", self, eweight), False)
 
+    def get_neighborhoods(self, vs, mode="out", efilt=None, eweight=None):
+        """Return the neighborhoods of all vertices in the list ``vs`` in
+        compressed sparse row form, as a tuple ``(offsets, neighbors, edge_ids,
+        weights)`` of :class:`numpy.ndarray`. The neighbors of ``vs[i]`` are
+        ``neighbors[offsets[i]:offsets[i+1]]``, and ``edge_ids`` and
+        ``weights`` contain, at the same positions, the index and weight of the
+        corresponding edges.
+
+        The parameter ``mode`` selects the ``"out"``, ``"in"`` or ``"all"``
+        edges of each vertex. If given, only the edges for which the boolean edge
+        :class:`~graph_tool.PropertyMap` ``efilt`` is ``True`` are
+        considered. If the edge :class:`~graph_tool.PropertyMap` ``eweight`` is
+        not given, ``weights`` is ``None``.
+
+        The neighborhoods are computed in parallel.
+
+        Examples
+        --------
+        >>> g = gt.Graph()
+        >>> g.add_edge_list([(0, 1), (0, 2), (1, 2), (2, 3)])
+        >>> offsets, neighbors, edge_ids, weights = g.get_neighborhoods([0, 2])
+        >>> offsets
+        array([0, 2, 3], dtype=uint64)
+        >>> neighbors
+        array([1, 2, 3], dtype=uint64)
+        >>> edge_ids
+        array([0, 1, 3], dtype=uint64)
+
+        """
+        if efilt is not None and efilt.value_type() != "bool":
+            raise ValueError("edge filter must be of boolean type")
+        return libcore.get_neighborhood_list(self.__graph,
+                                             numpy.asarray(vs, dtype="uint64"),
+                                             mode, _prop("e", self, efilt),
+                                             _prop("e", self, eweight))
+
+    def get_khop_frontiers(self, vs, k, mode="out", efilt=None):
+        r"""Return the vertices at each distance :math:`d = 0, \dots, k` from the
+        vertices in the list ``vs``, as a tuple ``(offsets, vertices)`` of
+        :class:`numpy.ndarray`. The vertices at distance ``d`` are
+        ``vertices[offsets[d]:offsets[d+1]]``, sorted by index.
+
+        The parameters ``mode`` and ``efilt`` have the same meaning as in
+        :meth:`~graph_tool.Graph.get_neighborhoods`. Each frontier is expanded
+        in parallel.
+
+        Examples
+        --------
+        >>> g = gt.Graph()
+        >>> g.add_edge_list([(0, 1), (0, 2), (1, 2), (2, 3)])
+        >>> offsets, vertices = g.get_khop_frontiers([0], 2)
+        >>> offsets
+        array([0, 1, 3, 4], dtype=uint64)
+        >>> vertices
+        array([0, 1, 2, 3], dtype=uint64)
+
+        """
+        if efilt is not None and efilt.value_type() != "bool":
+            raise ValueError("edge filter must be of boolean type")
+        return libcore.get_khop_list(self.__graph,
+                                     numpy.asarray(vs, dtype="uint64"),
+                                     int(k), mode, _prop("e", self, efilt))
+
     def add_vertex(self, n=1):
         """Add a vertex to the graph, and return it. If ``n != 1``, ``n``
         vertices are inserted and an iterator over the new vertices is returned.
@@ -1988,8 +2285,9 @@ class Graph(object):
                    g.remove_vertex(v)
 
            Alternatively (and preferably), a list (or iterable) may be passed
-           directly as the ``vertex`` parameter, and the above is performed
-           internally (in C++).
+           directly as the ``vertex`` parameter, in which case all vertices are
+           removed at once in :math:`O(V + E)` time, if ``fast == False``
+           (see :meth:`~graph_tool.Graph.remove_vertices`).
 
         .. warning::
 
@@ -2009,6 +2307,9 @@ class Graph(object):
                 vs = numpy.asarray([int(v) for v in vertex], dtype="int64")
             if len(vs) == 0:
                 return
+            if not fast:
+                self.remove_vertices(vs)
+                return
             vs = numpy.unique(vs)[::-1]
             vmax, vmin = vs[0], vs[-1]
         else:
@@ -2042,6 +2343,46 @@ class Graph(object):
         else:
             libcore.remove_vertex(self.__graph, vertex, fast)
 
+    def remove_vertices(self, vertices, compact_edges=False):
+        r"""Remove all the vertices in ``vertices`` at once, together with their
+        edges, and return a :class:`~numpy.ndarray` mapping the old vertex
+        indexes to the new ones (with the value ``-1`` for the removed
+        vertices), which can be used to update external arrays. The parameter
+        ``vertices`` can be an iterable of vertices (or vertex indexes), or a
+        boolean vertex property map marking the vertices to be removed.
+
+        The remaining vertices keep their relative order, and all the vertex
+        property maps associated with the graph are compacted accordingly. The
+        indexes of the removed edges are made available for new edges, and the
+        remaining edges keep their indexes, unless ``compact_edges == True``,
+        in which case :meth:`~graph_tool.Graph.compact_edge_indexes` is called
+        as well, and the tuple ``(vmap, emap)`` is returned with both index
+        mappings.
+
+        This operation is :math:`O(V + E)`, and is performed in parallel.
+
+        .. warning::
+
+           This operation invalidates all existing vertex descriptors, and edge
+           descriptors of edges incident on the removed vertices (or all edge
+           descriptors, if ``compact_edges == True``).
+        """
+        if isinstance(vertices, PropertyMap):
+            vs = numpy.flatnonzero(vertices.a)
+        else:
+            try:
+                vs = numpy.asarray(vertices, dtype="int64")
+            except TypeError:
+                vs = numpy.asarray([int(v) for v in vertices], dtype="int64")
+        vs = numpy.asarray(vs, dtype="int64").ravel()
+        pmaps = self.__writable_vertex_properties()
+        vmap = self.__graph.remove_vertices(vs)
+        for pmap in pmaps:
+            self.__graph.compact_vertex_property(_prop("v", self, pmap), vmap)
+        if compact_edges:
+            return vmap, self.compact_edge_indexes()
+        return vmap
+
     def clear_vertex(self, vertex):
         """Remove all in and out-edges from the given vertex."""
         libcore.clear_vertex(self.__graph, int(vertex))
@@ -2076,6 +2417,54 @@ class Graph(object):
         """
         return libcore.remove_edge(self.__graph, edge)
 
+    def remove_edges(self, edges, compact=False):
+        r"""Remove all the edges in ``edges`` at once. The parameter ``edges``
+        can be an iterable of edges (or edge indexes), or a boolean edge
+        property map marking the edges to be removed.
+
+        The remaining edges keep their indexes and their relative order. If
+        ``compact == True``, :meth:`~graph_tool.Graph.compact_edge_indexes` is
+        called afterwards, and its return value is returned.
+
+        This operation is :math:`O(V + E)`, and is performed in parallel.
+        """
+        if isinstance(edges, PropertyMap):
+            es = numpy.flatnonzero(edges.a)
+        elif isinstance(edges, numpy.ndarray):
+            es = edges
+        else:
+            eindex = self.edge_index
+            es = [int(e) if isinstance(e, (int, numpy.integer)) else eindex[e]
+                  for e in edges]
+        es = numpy.asarray(es, dtype="int64").ravel()
+        self.__graph.remove_edges(es)
+        if compact:
+            return self.compact_edge_indexes()
+
+    def compact_edge_indexes(self):
+        r"""Relabel the edge indexes such that they lie contiguously in the
+        range :math:`[0, E-1]`, while preserving their relative order, and
+        return a :class:`~numpy.ndarray` mapping the old edge indexes to the
+        new ones (with the value ``-1`` for unused indexes). All the edge
+        property maps associated with the graph are compacted accordingly,
+        unlike with :meth:`~graph_tool.Graph.reindex_edges`.
+
+        This operation is :math:`O(V + E)`.
+
+        .. warning::
+
+           This operation invalidates all existing edge descriptors.
+        """
+        emap = self.__graph.compact_edge_indexes()
+        for pmap_ in self.__known_properties.values():
+            pmap = pmap_()
+            if (pmap is not None and
+                pmap.key_type() == "e" and
+                pmap.is_writable()):
+                self.__graph.compact_edge_property(_prop("e", self, pmap),
+                                                   emap)
+        return emap
+
     def add_edge_list(self, edge_list, hashed=False, string_vals=False,
                       eprops=None):
         """Add a list of edges to the graph, given by ``edge_list``, which can
@@ -2098,6 +2487,16 @@ class Graph(object):
         maps that will be filled with the remaining values at each row, if there
         are more than two.
 
+        .. note::
+
+           If ``edge_list`` is a :class:`~numpy.ndarray` (or ``string_vals ==
+           True``), and the graph is neither filtered nor reversed, the edges
+           are not inserted one by one, but all at once, and the edge lists are
+           built in parallel (if enabled). In this case negative or NaN vertex
+           indexes are not accepted. If the graph is frozen (see
+           :meth:`~graph_tool.Graph.freeze`), a :class:`RuntimeError` is
+           raised, as for any other modification.
+
         """
         if eprops is None:
             eprops = ()
@@ -2140,6 +2539,234 @@ class Graph(object):
         enabled."""
         return self.__graph.get_keep_epos()
 
+    def set_sorted_adjacency(self, sorted=True):
+        r"""If ``sorted == True``, the out- and in-edges of every vertex are
+        sorted by their neighbors (and then by their indexes), and are kept
+        sorted as the graph is modified. This makes :meth:`~Graph.edge` lookups
+        take :math:`O(\log k)` time instead of :math:`O(k)` (unless the edges
+        are filtered, or ``all_edges == True``), and allows
+        neighborhoods to be intersected by merging, which speeds up algorithms
+        such as :func:`~graph_tool.clustering.local_clustering` and
+        :func:`~graph_tool.topology.vertex_similarity`. The price is that edge
+        insertion (and removal with :meth:`~Graph.set_fast_edge_removal`
+        enabled) becomes :math:`O(k)`, and the ordering of the edges no longer
+        reflects their insertion order. If ``sorted == False``, the current
+        ordering is kept, but no longer maintained."""
+        self.__graph.set_sorted(sorted)
+
+    def get_sorted_adjacency(self):
+        r"""Return whether the adjacency lists are currently kept sorted."""
+        return self.__graph.get_sorted()
+
+    def set_edge_hash(self, ehash=True):
+        r"""If ``ehash == True``, an index of all the edges keyed by their
+        source and target is built and kept, which makes :meth:`~Graph.edge`
+        and :meth:`~Graph.edge_index_of` lookups take :math:`O(1)` time. The
+        index is updated incrementally by :meth:`~Graph.add_edge`,
+        :meth:`~Graph.remove_edge` and :meth:`~Graph.add_vertex`. After any
+        other modification (e.g. vertex removal or bulk insertion), it is
+        rebuilt in :math:`O(E)` time by the next call to
+        :meth:`~Graph.edge_index_of`, and is ignored by :meth:`~Graph.edge`
+        until then. The memory it uses and the time taken to build it are
+        given by :meth:`~Graph.get_edge_hash_stats`. If ``ehash == False``, the
+        index is discarded."""
+        self.__graph.set_edge_hash(ehash)
+
+    def get_edge_hash(self):
+        r"""Return whether the edge hash index is enabled (see
+        :meth:`~graph_tool.Graph.set_edge_hash`)."""
+        return self.__graph.get_edge_hash()
+
+    def get_edge_hash_stats(self):
+        r"""Return a dictionary describing the edge hash index (see
+        :meth:`~graph_tool.Graph.set_edge_hash`).
+
+        The key ``"enabled"`` says whether the index exists. If it does,
+        ``"entries"`` is the number of indexed edges, ``"used_bytes"`` and
+        ``"reserved_bytes"`` are the memory occupied by the entries and
+        allocated for the table, ``"synced"`` says whether the index is up to
+        date, ``"n_builds"`` is the number of times it was built from scratch,
+        and ``"build_time"`` is the time taken by the last build, in seconds.
+        """
+        return self.__graph.get_edge_hash_stats()
+
+    def set_edge_pool(self, pool=True):
+        r"""If ``pool == True``, the adjacency lists of the vertices will be
+        allocated from a memory pool owned by the graph, instead of the general
+        heap. The pool obtains memory from the system in large blocks, which
+        reduces the memory fragmentation caused by the many small reallocations
+        during the construction of large graphs. Its memory is released all at
+        once by :meth:`~graph_tool.Graph.shrink_to_fit` (which compacts the
+        adjacency into a new pool), or when the graph is cleared or
+        destroyed."""
+        self.__graph.set_edge_pool(pool)
+
+    def get_edge_pool(self):
+        r"""Return whether the adjacency lists are allocated from a memory pool
+        (see :meth:`~graph_tool.Graph.set_edge_pool`)."""
+        return self.__graph.get_edge_pool()
+
+    def memory_usage(self):
+        r"""Return a dictionary with the memory usage of the graph and its
+        property maps, broken down by component.
+
+        Each value is a tuple ``(size, capacity)`` with the number of bytes
+        which are actually used, and which are allocated, respectively. The
+        difference between the two is the slack which would be released by
+        :meth:`~graph_tool.Graph.shrink_to_fit`.
+
+        The keys are:
+
+        ``"vertex_list"``, ``"edge_lists"``
+            The adjacency lists. If :meth:`~graph_tool.Graph.set_edge_pool` is
+            enabled, the capacity of the edge lists is the memory reserved by
+            the pool.
+        ``"edge_positions"``
+            The edge positions kept by :meth:`~graph_tool.Graph.set_fast_edge_removal`.
+        ``"free_indexes"``
+            The indexes of removed edges, available for reuse.
+        ``"edge_hash"``
+            The edge index kept by :meth:`~graph_tool.Graph.set_edge_hash`, if
+            it is enabled.
+        ``"frozen_offsets"``, ``"frozen_edges"``
+            The snapshot created by :meth:`~graph_tool.Graph.freeze`, if it
+            exists.
+        ``"vertex_filter"``, ``"edge_filter"``
+            The filter masks, if they are active.
+        ``"vp[name]"``, ``"ep[name]"``, ``"gp[name]"``
+            The internal property maps (see :meth:`~graph_tool.PropertyMap.memory_usage`).
+        ``"other_properties"``
+            The remaining (non-internal) property maps of the graph which are
+            still alive.
+        ``"total"``
+            The sum of the above, where property maps which share the storage
+            of the filter masks are counted only once.
+        ``"shared"``
+            The part of ``"total"`` which is currently shared with copies of the
+            graph, i.e. the adjacency lists and property values which are not
+            yet modified since the graph was copied with
+            :meth:`~graph_tool.Graph.copy` (or vice versa). It is also counted
+            in the ``"total"`` of the copies, hence it should be subtracted
+            from all but one of them when adding up their memory usage.
+
+        Memory owned by Python objects (e.g. the values of ``object``
+        property maps) is not included.
+        """
+        usage = dict(self.__graph.get_memory_usage())
+
+        # property maps may share their storage with the filter masks
+        filter_ptrs = set()
+        for filt in [self.get_vertex_filter()[0], self.get_edge_filter()[0]]:
+            if filt is not None:
+                filter_ptrs.add(filt.data_ptr())
+        shared = {}
+        cow_shared = list(usage.pop("shared"))
+        def account(pmap):
+            m = pmap.memory_usage()
+            if pmap.key_type() != "g" and pmap.data_ptr() in filter_ptrs:
+                shared[pmap.data_ptr()] = m
+            elif pmap._PropertyMap__map.is_shared():
+                cow_shared[0] += m[0]
+                cow_shared[1] += m[1]
+            return m
+
+        internal = set()
+        for (t, name), pmap in self.__properties.items():
+            usage["%sp[%s]" % (t, name)] = account(pmap)
+            internal.add(id(pmap))
+
+        other = [0, 0]
+        for pmap_ in list(self.__known_properties.values()):
+            pmap = pmap_()
+            if pmap is None or id(pmap) in internal:
+                continue
+            m = account(pmap)
+            other[0] += m[0]
+            other[1] += m[1]
+        usage["other_properties"] = tuple(other)
+
+        total = [0, 0]
+        for m in list(usage.values()) + [(-m[0], -m[1]) for m in shared.values()]:
+            total[0] += m[0]
+            total[1] += m[1]
+        usage["total"] = tuple(total)
+        usage["shared"] = tuple(cow_shared)
+        return usage
+
+    def get_edge_memory_stats(self):
+        r"""Return a dictionary with the memory usage (in bytes) of the adjacency
+        lists.
+
+        The key ``"edge_bytes"`` is the memory actually occupied by edge
+        entries, ``"capacity_bytes"`` is the memory allocated for the lists,
+        and ``"reserved_bytes"`` is the memory obtained from the system. The
+        ``"fragmentation"`` value is the fraction of the reserved memory which
+        is not occupied by edge entries. If the memory pool is enabled, the
+        keys ``"slab_bytes"``, ``"large_bytes"``, ``"used_bytes"``,
+        ``"free_bytes"`` and ``"n_slabs"`` describe its state.
+        """
+        return self.__graph.get_edge_memory_stats()
+
+    def freeze(self):
+        r"""Build an immutable, compressed-sparse-row snapshot of the graph,
+        which will be used by some read-only algorithms until
+        :meth:`~graph_tool.Graph.thaw` is called.
+
+        In this representation, all adjacency lists are stored contiguously in
+        memory, which improves cache locality and speeds up read-only
+        algorithms that traverse large graphs. The snapshot is used exactly by
+        the following functions:
+
+        - :func:`~graph_tool.centrality.pagerank`,
+          :func:`~graph_tool.centrality.eigenvector`,
+          :func:`~graph_tool.centrality.katz`,
+          :func:`~graph_tool.centrality.hits` and
+          :func:`~graph_tool.centrality.closeness`;
+        - :func:`~graph_tool.topology.shortest_distance` with a given
+          ``source`` (unless ``negative_weights == True``), and hence
+          :func:`~graph_tool.topology.shortest_path`;
+        - :func:`~graph_tool.clustering.local_clustering` and
+          :func:`~graph_tool.clustering.global_clustering`.
+
+        All other algorithms use the regular adjacency lists, which are kept
+        unchanged. The vertex and edge indexes are unchanged, hence all
+        property maps remain valid.
+
+        While the graph is frozen, any attempt to add or remove vertices or
+        edges will raise a :class:`RuntimeError`. If the graph is nevertheless
+        modified in place by some other function (e.g. by
+        :func:`~graph_tool.generation.random_rewire`), the snapshot is taken
+        again before it is next used. The snapshot requires additional memory
+        of size :math:`O(V + E)`.
+
+        .. note::
+
+           Only the functions listed above use the snapshot. All other
+           functions, including the visitor-based searches in
+           :mod:`~graph_tool.search`, the all-pairs distances and
+           :func:`~graph_tool.centrality.betweenness`, are unaffected by this
+           method (other than being prevented from modifying the graph), and
+           run as fast as without it.
+        """
+        self.__graph.freeze()
+
+    def thaw(self):
+        r"""Discard the snapshot created by :meth:`~graph_tool.Graph.freeze`,
+        and allow the graph to be modified again.
+
+        This may be called while algorithms are running on the snapshot in
+        other threads; these will finish using the old snapshot, which is
+        freed only afterwards. The same applies if the graph is frozen again.
+        The graph must not be modified, however, while algorithms are running
+        on it in other threads.
+        """
+        self.__graph.thaw()
+
+    def is_frozen(self):
+        r"""Return whether the graph is currently frozen (see
+        :meth:`~graph_tool.Graph.freeze`)."""
+        return self.__graph.is_frozen()
+
     def clear(self):
         """Remove all vertices and edges from the graph."""
         self.__graph.clear()
@@ -2282,6 +2909,51 @@ class Graph(object):
         """
         self.__graph.re_index_edges()
 
+    def reorder_vertices(self, order):
+        """Relabel the vertices of the graph, such that vertex ``v`` receives the
+        index ``order[v]``. The parameter ``order`` must be a vertex property map
+        or an array containing a permutation of the vertex indexes, such as the
+        one returned by :func:`~graph_tool.topology.vertex_ordering`.
+
+        All vertex property maps associated with the graph are permuted
+        accordingly. The edge indexes are not modified, hence the edge property
+        maps remain valid.
+
+        This operation is :math:`O(V + E)`, and is performed in parallel.
+
+        .. warning::
+
+           This operation invalidates all existing vertex and edge descriptors,
+           and the internal ordering of the vertices of any
+           :class:`~graph_tool.GraphView` based on this graph.
+        """
+        if isinstance(order, PropertyMap):
+            order = order.get_array()
+        vmap = numpy.array(order, dtype="int64")
+        pmaps = self.__writable_vertex_properties()
+        self.__graph.permute_vertices(vmap)
+        for pmap in pmaps:
+            self.__graph.permute_vertex_property(_prop("v", self, pmap), vmap)
+
+    def __writable_vertex_properties(self):
+        # the known writable vertex property maps, and the vertex filter (which
+        # need not be known), with each storage listed only once, since it is
+        # modified in place
+        pmaps = [pmap_() for pmap_ in self.__known_properties.values()]
+        pmaps.append(self.get_vertex_filter()[0])
+        ret = []
+        ptrs = set()
+        for pmap in pmaps:
+            if (pmap is None or pmap.key_type() != "v" or
+                not pmap.is_writable()):
+                continue
+            ptr = pmap.data_ptr()
+            if ptr in ptrs:
+                continue
+            if ptr != 0:
+                ptrs.add(ptr)
+            ret.append(pmap)
+        return ret
 
     def shrink_to_fit(self):
         """Force the physical capacity of the underlying containers to match the graph's
@@ -2363,6 +3035,23 @@ class Graph(object):
     new_gp = _copy_func(new_graph_property, "new_gp")
     new_gp.__doc__ = "Alias to :func:`~graph_tool.Graph.new_graph_property`."
 
+    def __clone_property(self, src, g):
+        # Copy of a property map of g, which must have exactly the same vertex
+        # and edge indexes as this graph. In this case the values can be copied
+        # in bulk, instead of iterating over the vertices and edges of both
+        # graphs.
+        if src.key_type() == "g" or not src.is_writable():
+            return self.copy_property(src, g=g)
+        if src.key_type() == "v":
+            pmap = new_vertex_property(src.value_type(),
+                                       self.__graph.get_vertex_index(),
+                                       src._PropertyMap__map.copy_map())
+        else:
+            pmap = new_edge_property(src.value_type(),
+                                     self.__graph.get_edge_index(),
+                                     src._PropertyMap__map.copy_map())
+        return PropertyMap(pmap, self, src.key_type())
+
     # property map copying
     @_require("src", PropertyMap)
     @_require("tgt", (PropertyMap, type(None)))
@@ -2448,7 +3137,7 @@ class Graph(object):
         return fmt
 
     def load(self, file_name, fmt="auto", ignore_vp=None, ignore_ep=None,
-             ignore_gp=None):
+             ignore_gp=None, only_vp=None, only_ep=None, only_gp=None):
         """Load graph from ``file_name`` (which can be either a string or a file-like
         object). The format is guessed from ``file_name``, or can be specified
         by ``fmt``, which can be either "gt", "graphml", "xml", "dot" or "gml".
@@ -2458,6 +3147,12 @@ class Graph(object):
         ``ignore_gp``, should contain a list of property names (vertex, edge or
         graph, respectively) which should be ignored when reading the file.
 
+        If provided, the parameters ``only_vp``, ``only_ep`` and ``only_gp``
+        should contain a list of property names (vertex, edge or graph,
+        respectively) which should be the only ones read from the file. This is
+        only supported by the "gt" format. For regular files saved with a
+        directory footer, the remaining properties are not read at all.
+
         .. warning::
 
            The only file formats which are capable of perfectly preserving the
@@ -2486,13 +3181,27 @@ class Graph(object):
             ignore_ep = []
         if ignore_gp is None:
             ignore_gp = []
+        only = [only_vp, only_ep, only_gp]
+        if any(o is not None for o in only) and fmt != "gt":
+            raise ValueError("the parameters only_vp, only_ep and only_gp " +
+                             "are only supported by the 'gt' format")
+        # internal properties used to store the graph state are always read
+        only[0] = (None if only_vp is None else
+                   list(only_vp) + ["_Graph__save__vfilter"])
+        only[1] = (None if only_ep is None else
+                   list(only_ep) + ["_Graph__save__efilter"])
+        only[2] = (None if only_gp is None else
+                   list(only_gp) + ["_Graph__save__vfilter",
+                                    "_Graph__save__efilter",
+                                    "_Graph__reversed"])
         if isinstance(file_name, (str, unicode)):
             props = self.__graph.read_from_file(_c_str(file_name), None,
                                                 _c_str(fmt), ignore_vp,
-                                                ignore_ep, ignore_gp)
+                                                ignore_ep, ignore_gp, *only)
         else:
             props = self.__graph.read_from_file("", file_name, _c_str(fmt),
-                                                ignore_vp, ignore_ep, ignore_gp)
+                                                ignore_vp, ignore_ep, ignore_gp,
+                                                *only)
         for name, prop in props[0].items():
             self.vertex_properties[name] = PropertyMap(prop, self, "v")
         for name, prop in props[1].items():
@@ -2514,12 +3223,57 @@ class Graph(object):
             del self.graph_properties["_Graph__reversed"]
         self.shrink_to_fit()
 
-    def save(self, file_name, fmt="auto"):
+    def load_property(self, file_name, name, key_type="v"):
+        """Load the property map called ``name`` from the "gt" file
+        ``file_name`` (which can be either a string or a file-like object), and
+        return it as a :class:`~graph_tool.PropertyMap` of this graph. The
+        parameter ``key_type`` can be either ``"v"``, ``"e"`` or ``"g"``,
+        for vertex, edge or graph properties, respectively.
+
+        The graph must correspond to the one stored in the file, e.g. it should
+        have been loaded from it. If the file is a regular file saved with a
+        directory footer, only the requested property is read from it;
+        otherwise the entire file needs to be parsed.
+
+        """
+        if key_type not in ["v", "e", "g"]:
+            raise ValueError("invalid key type: " + str(key_type))
+        if isinstance(file_name, (str, unicode)):
+            file_name = os.path.expanduser(file_name)
+            with open(file_name): # throw the appropriate exception, if not found
+                pass
+            if file_name.endswith(".xz"):
+                try:
+                    file_name = lzma.open(file_name, mode="rb")
+                except NameError:
+                    raise NotImplementedError("lzma compression is only available in Python >= 3.3")
+        if isinstance(file_name, (str, unicode)):
+            prop = self.__graph.read_property_from_file(_c_str(file_name), None,
+                                                        key_type, _c_str(name))
+        else:
+            prop = self.__graph.read_property_from_file("", file_name,
+                                                        key_type, _c_str(name))
+        return PropertyMap(prop, self, key_type)
+
+    def save(self, file_name, fmt="auto", dict_strings=False):
         """Save graph to ``file_name`` (which can be either a string or a file-like
         object). The format is guessed from the ``file_name``, or can be
         specified by ``fmt``, which can be either "gt", "graphml", "xml", "dot"
         or "gml".  (Note that "graphml" and "xml" are synonyms).
 
+        If ``file_name`` ends with ".gz", ".bz2" or ".xz", the file is
+        compressed accordingly. Files ending with ".gz" are compressed in
+        independent chunks, using all available threads. The result is an
+        ordinary gzip file, but files in the "gt" format written this way can
+        also be decompressed in parallel by :meth:`~graph_tool.Graph.load`.
+
+        If ``dict_strings == True`` and the format is "gt", vertex and edge
+        string property maps with few distinct values are written as a
+        dictionary of the distinct values, followed by the code of each value,
+        whenever this takes less space. The file is then written with version
+        ``0x02`` of the format, which cannot be read by older versions of
+        graph-tool.
+
         .. warning::
 
            The only file formats which are capable of perfectly preserving the
@@ -2566,9 +3320,11 @@ class Graph(object):
             f = open(file_name, "w") # throw the appropriate exception, if
                                      # unable to open
             f.close()
-            u.__graph.write_to_file(_c_str(file_name), None, _c_str(fmt), props)
+            u.__graph.write_to_file(_c_str(file_name), None, _c_str(fmt), props,
+                                    dict_strings)
         else:
-            u.__graph.write_to_file("", file_name, _c_str(fmt), props)
+            u.__graph.write_to_file("", file_name, _c_str(fmt), props,
+                                    dict_strings)
 
 
     # Directedness
@@ -2846,6 +3602,99 @@ class Graph(object):
         self.__graph.purge_edges()
         self.set_edge_filter(None)
 
+    def materialize(self, threshold=None):
+        """Return a new unfiltered graph containing only the vertices and edges
+        of the current filtered view, together with vertex and edge property
+        maps of type ``int64_t`` containing the corresponding indexes in the
+        original graph.
+
+        Algorithms that iterate many times over a very selective view spend
+        most of their time skipping filtered vertices and edges. Running them on
+        the materialized graph avoids this overhead, at the cost of a copy of
+        the remaining topology, which is done in :math:`O(V + E)` time. The
+        result is cached as long as the filters, their values, the
+        directedness and reversal of the view, and the underlying graph remain
+        unchanged. Every call returns a new copy of the cached graph, hence it
+        can be freely modified.
+
+        If ``threshold`` is given, the view is materialized only if the fraction
+        of remaining vertices is not larger than ``threshold``. Otherwise,
+        ``None`` is returned.
+
+        The vertices and edges of the materialized graph are ordered in the same
+        way as in the view, hence property maps can be transferred in both
+        directions with :meth:`~graph_tool.Graph.copy_property`, e.g.
+        ``u.copy_property(prop, g=self, full=False)`` and
+        ``self.copy_property(uprop, tgt=prop, g=u, full=False)``.
+
+        The graph properties, as well as the reversed state of the view, are
+        not copied.
+
+        Only a few algorithms materialize the view by themselves, as described
+        in :meth:`~graph_tool.Graph.set_materialize_threshold`. For all others,
+        this method can be used to run them on the compact copy.
+
+        Examples
+        --------
+        >>> g = gt.collection.data["polblogs"]
+        >>> u = gt.GraphView(g, vfilt=g.vp.value.a == 0)
+        >>> m, vmap, emap = u.materialize()
+        >>> print(m.num_vertices() == u.num_vertices(), m.num_edges() == u.num_edges())
+        True True
+        """
+        if (threshold is not None and
+            self.num_vertices() > threshold * self.num_vertices(ignore_filter=True)):
+            return None
+        stamp = self.__graph.get_view_stamp()
+        if self.__materialized is not None and self.__materialized[0] == stamp:
+            u, vorder, eorder = self.__materialized[1]
+            u = Graph(u)
+        else:
+            u = Graph(directed=self.is_directed())
+            vorder, eorder = self.__graph.materialize(u.__graph)
+            self.__materialized = (stamp, (Graph(u), vorder, eorder))
+        vmap = u.new_vertex_property("int64_t", vals=vorder)
+        emap = u.new_edge_property("int64_t", vals=eorder)
+        return u, vmap, emap
+
+    def set_materialize_threshold(self, threshold):
+        """Set the largest fraction of remaining vertices (or of remaining edges,
+        if only the edges are filtered) for which the filtered view is
+        materialized automatically by the algorithms that traverse it many
+        times.
+
+        These algorithms, namely
+        :func:`~graph_tool.centrality.pagerank`,
+        :func:`~graph_tool.centrality.eigenvector`,
+        :func:`~graph_tool.centrality.katz`,
+        :func:`~graph_tool.centrality.closeness`,
+        :func:`~graph_tool.clustering.local_clustering` and
+        :func:`~graph_tool.clustering.global_clustering`, then run on a compact
+        copy of the view, as returned by :meth:`~graph_tool.Graph.materialize`,
+        and the property maps passed to them are copied to it and back. The
+        copy is cached until the view changes. The results are the same as for
+        the view itself, up to rounding.
+
+        The default threshold is ``0.05``. A threshold of ``0`` disables the
+        automatic materialization.
+
+        .. note::
+
+           No other function materializes the view automatically. This
+           includes :func:`~graph_tool.topology.shortest_distance` and
+           :func:`~graph_tool.centrality.betweenness`, which receive vertex
+           indexes (sources, targets or pivots) that would need to be
+           translated to the compact copy. These, and any other function, can
+           still be run explicitly on the graph returned by
+           :meth:`~graph_tool.Graph.materialize`.
+        """
+        self.__graph.set_materialize_threshold(threshold)
+
+    def get_materialize_threshold(self):
+        """Get the threshold set by
+        :meth:`~graph_tool.Graph.set_materialize_threshold`."""
+        return self.__graph.get_materialize_threshold()
+
     def get_filter_state(self):
         """Return a copy of the filter state of the graph."""
         self.__filter_state["directed"] = self.is_directed()
@@ -2924,7 +3773,7 @@ class Graph(object):
     base = property(__get_base, doc="Base graph (self).")
 
 def load_graph(file_name, fmt="auto", ignore_vp=None, ignore_ep=None,
-               ignore_gp=None):
+               ignore_gp=None, only_vp=None, only_ep=None, only_gp=None):
     """Load a graph from ``file_name`` (which can be either a string or a file-like object).
 
     The format is guessed from ``file_name``, or can be specified by ``fmt``,
@@ -2935,6 +3784,11 @@ def load_graph(file_name, fmt="auto", ignore_vp=None, ignore_ep=None,
     ``ignore_gp``, should contain a list of property names (vertex, edge or
     graph, respectively) which should be ignored when reading the file.
 
+    If provided, the parameters ``only_vp``, ``only_ep`` and ``only_gp`` should
+    contain a list of property names (vertex, edge or graph, respectively)
+    which should be the only ones read from the file (only supported by the
+    "gt" format).
+
     .. warning::
 
        The only file formats which are capable of perfectly preserving the
@@ -2943,13 +3797,15 @@ def load_graph(file_name, fmt="auto", ignore_vp=None, ignore_ep=None,
 
     """
     g = Graph()
-    g.load(file_name, fmt, ignore_vp, ignore_ep, ignore_gp)
+    g.load(file_name, fmt, ignore_vp, ignore_ep, ignore_gp, only_vp, only_ep,
+           only_gp)
     return g
 
 def load_graph_from_csv(file_name, directed=True, eprop_types=None,
                         eprop_names=None, string_vals=True, hashed=False,
                         skip_first=False, ecols=(0,1),
-                        csv_options={"delimiter": ",","quotechar": '"'}):
+                        csv_options={"delimiter": ",","quotechar": '"'},
+                        batch_size=None, hash_type="object"):
     """Load a graph from a :mod:`csv` file containing a list of edges and edge
     properties.
 
@@ -2981,6 +3837,15 @@ def load_graph_from_csv(file_name, directed=True, eprop_types=None,
         Line columns used as source and target for the edges.
     csv_options : ``dict`` (optional, default: ``{"delimiter": ",", "quotechar": '"'}``)
         Options to be passed to the :func:`csv.reader` parser.
+    batch_size : ``int`` (optional, default: ``None``)
+        If given, the file is parsed in batches of approximately this number of
+        bytes, such that only one batch at a time is kept in memory in parsed
+        form. Otherwise the whole file is parsed at once, which is faster.
+    hash_type : ``str`` (optional, default: ``"object"``)
+        Value type of the vertex property map with the vertex names, if
+        ``hashed == True`` and ``string_vals == False``. If this is
+        ``"int64_t"``, the names are not converted to python objects, which is
+        faster and uses less memory.
 
     Returns
     -------
@@ -2989,7 +3854,84 @@ def load_graph_from_csv(file_name, directed=True, eprop_types=None,
         internal edge property maps. If ``hashed == True``, it will also contain
         an internal vertex property map with the vertex names.
 
+    Notes
+    -----
+    If ``file_name`` is a path, ``csv_options`` contains at most the
+    ``"delimiter"`` and ``"quotechar"`` options, and all edge properties are
+    scalars or strings, the file is parsed natively, in parallel (if
+    enabled). In this case, quoted values may not contain line breaks, and a
+    :class:`ValueError` is raised if a quoted value is not closed in the same
+    line; such files can still be read by passing an open file object as
+    ``file_name``. Otherwise, the file is parsed with the :mod:`csv` module.
+
     """
+    _csv_options = {"delimiter": ",", "quotechar": '"'}
+    _csv_options.update(csv_options)
+    native = (isinstance(file_name, (str, unicode)) and
+              set(_csv_options.keys()) <= set(["delimiter", "quotechar"]) and
+              set(len(v) for v in _csv_options.values()) == set([1]) and
+              len(ecols) == 2 and ecols[0] != ecols[1])
+    if native:
+        file_name = os.path.expanduser(file_name)
+        if eprop_types is None:
+            # the number of columns is determined from the first row
+            if file_name.endswith(".xz"):
+                f = lzma.open(file_name, mode="rt")
+            elif file_name.endswith(".gz"):
+                f = gzip.open(file_name, mode="rt")
+            elif file_name.endswith(".bz2"):
+                f = bz2.open(file_name, mode="rt")
+            else:
+                f = open(file_name, "r")
+            with f:
+                r = csv.reader(f, **_csv_options)
+                if skip_first:
+                    next(r, None)
+                line = next(r, [])
+            etypes = ["string" for x in line[2:]]
+        else:
+            etypes = [_type_alias(t) for t in eprop_types]
+        # the builtin all() is shadowed by the graph_tool.all module
+        native = set(etypes) <= set(["bool", "int16_t", "int32_t", "int64_t",
+                                     "double", "long double", "string"])
+    if native:
+        g = Graph(directed=directed)
+        eprops = [g.new_ep(t) for t in etypes]
+        pfile = None
+        if file_name.endswith(".xz"):
+            try:
+                pfile = lzma.open(file_name, mode="rb")
+            except NameError:
+                raise NotImplementedError("lzma compression is only available in Python >= 3.3")
+        hashed = hashed or string_vals
+        if string_vals:
+            name = g.new_vp("string")
+        elif hashed:
+            name = g.new_vp("int64_t")
+        else:
+            name = None
+        if pfile is not None:
+            file_name = ""
+        g._Graph__graph.read_csv_edge_list(_c_str(file_name), pfile,
+                                           _c_str(_csv_options["delimiter"]),
+                                           _c_str(_csv_options["quotechar"]),
+                                           skip_first, ecols[0], ecols[1],
+                                           string_vals, hashed,
+                                           _prop("v", g, name) if hashed else None,
+                                           [_prop("e", g, p) for p in eprops],
+                                           batch_size if batch_size else 0)
+        for i, p in enumerate(eprops):
+            if eprop_names:
+                ename = eprop_names[i]
+            else:
+                ename = "c%d" % i
+            g.ep[ename] = p
+        if name is not None and not string_vals and hash_type != "int64_t":
+            name = g.new_vp(hash_type, vals=name.fa.tolist())
+        if name is not None:
+            g.vp.name = name
+        return g
+
     if isinstance(file_name, (str, unicode)):
         if file_name.endswith(".xz"):
             try:
@@ -3002,8 +3944,6 @@ def load_graph_from_csv(file_name, directed=True, eprop_types=None,
             file_name = bz2.open(file_name, mode="r")
         else:
             file_name = open(file_name, "r")
-    _csv_options = {"delimiter": ",", "quotechar": '"'}
-    _csv_options.update(csv_options)
     r = csv.reader(file_name, **_csv_options)
     if skip_first:
         next(r)
@@ -3045,6 +3985,8 @@ def load_graph_from_csv(file_name, directed=True, eprop_types=None,
             ename = "c%d" % i
         g.ep[ename] = p
 
+    if name is not None and not string_vals and hash_type != "object":
+        name = g.new_vp(hash_type, vals=[name[v] for v in g.vertices()])
     if name is not None:
         g.vp.name = name
     return g
@@ -89,6 +89,34 @@ __all__ = ["graph_draw", "graphviz_draw", "fruchterman_reingold_layout",
            "get_hierarchy_control_points", "default_cm"]
 
 
+def _check_pos(g, pos, dim=None):
+    """Check that ``pos`` is either a floating vector property map, or a writable
+    C-contiguous ``float64`` array of shape ``(N, dim)``, where ``N`` is the
+    number of vertices of the unfiltered graph."""
+    if not isinstance(pos, numpy.ndarray):
+        _check_prop_vector(pos, name="pos", floating=True)
+        return
+    N = g.num_vertices(ignore_filter=True)
+    if (pos.dtype != numpy.float64 or pos.ndim != 2 or pos.shape[0] != N or
+        (dim is not None and pos.shape[1] != dim) or
+        not pos.flags.c_contiguous or not pos.flags.writeable):
+        raise ValueError("'pos' array must be a writable, C-contiguous " +
+                         "float64 array of shape (%d, %s), got %s array of shape %s" %
+                         (N, "d" if dim is None else str(dim), pos.dtype,
+                          str(pos.shape)))
+
+
+def _pos_property(g, pos):
+    """Return a vector property map with the coordinates given by ``pos``, if it
+    is an array, or ``pos`` itself otherwise."""
+    if not isinstance(pos, numpy.ndarray):
+        return pos
+    _check_pos(g, pos)
+    ppos = g.new_vertex_property("vector<double>")
+    ppos.set_2d_array(pos[g.get_vertices()].T)
+    return ppos
+
+
 def random_layout(g, shape=None, pos=None, dim=2):
     r"""Performs a random layout of the graph.
 
@@ -101,16 +129,19 @@ def random_layout(g, shape=None, pos=None, dim=2):
         match `dim`, and each element can be either a pair specifying a range,
         or a single value specifying a range starting from zero. If None is
         passed, a square of linear size :math:`\sqrt{N}` is used.
-    pos : :class:`~graph_tool.PropertyMap` (optional, default: ``None``)
-        Vector vertex property maps where the coordinates should be stored.
+    pos : :class:`~graph_tool.PropertyMap` or :class:`numpy.ndarray` (optional, default: ``None``)
+        Vector vertex property maps where the coordinates should be stored. It
+        can also be a ``float64`` array of shape ``(N, dim)``, where ``N`` is
+        the number of vertices of the unfiltered graph, and the row ``i``
+        contains the coordinates of the vertex with index ``i``.
     dim : int (optional, default: ``2``)
         Number of coordinates per vertex.
 
     Returns
     -------
-    pos : :class:`~graph_tool.PropertyMap`
+    pos : :class:`~graph_tool.PropertyMap` or :class:`numpy.ndarray`
         A vector-valued vertex property map with the coordinates of the
-        vertices.
+        vertices, or the array given as ``pos``.
 
     Notes
     -----
@@ -134,9 +165,13 @@ def random_layout(g, shape=None, pos=None, dim=2):
 
     if pos is None:
         pos = g.new_vertex_property("vector<double>")
-    _check_prop_vector(pos, name="pos")
-
-    pos = ungroup_vector_property(pos, list(range(0, dim)))
+    flat = isinstance(pos, numpy.ndarray)
+    if flat:
+        _check_pos(g, pos, dim)
+        vs = g.get_vertices()
+    else:
+        _check_prop_vector(pos, name="pos")
+        pos = ungroup_vector_property(pos, list(range(0, dim)))
 
     if shape is None:
         shape = [sqrt(g.num_vertices())] * dim
@@ -151,10 +186,14 @@ def random_layout(g, shape=None, pos=None, dim=2):
         d = r[1] - r[0]
 
         # deal with filtering
-        p = pos[i].fa
-        pos[i].fa = numpy.random.random(len(p)) * d + r[0]
+        if flat:
+            pos[vs, i] = numpy.random.random(len(vs)) * d + r[0]
+        else:
+            p = pos[i].fa
+            pos[i].fa = numpy.random.random(len(p)) * d + r[0]
 
-    pos = group_vector_property(pos)
+    if not flat:
+        pos = group_vector_property(pos)
     return pos
 
 
@@ -248,16 +287,17 @@ def fruchterman_reingold_layout(g, weight=None, a=None, r=1., scale=None,
         displacement at each iteration.
     n_iter : int (optional, default: ``100``)
         Total number of iterations.
-    pos : :class:`~graph_tool.PropertyMap` (optional, default: ``None``)
+    pos : :class:`~graph_tool.PropertyMap` or :class:`numpy.ndarray` (optional, default: ``None``)
         Vector vertex property maps where the coordinates should be stored. If
         provided, this will also be used as the initial position of the
-        vertices.
+        vertices. It can also be an array of shape ``(N, 2)``, as accepted by
+        :func:`random_layout`, which is then updated in place.
 
     Returns
     -------
-    pos : :class:`~graph_tool.PropertyMap`
+    pos : :class:`~graph_tool.PropertyMap` or :class:`numpy.ndarray`
         A vector-valued vertex property map with the coordinates of the
-        vertices.
+        vertices, or the array given as ``pos``.
 
     Notes
     -----
@@ -297,7 +337,7 @@ def fruchterman_reingold_layout(g, weight=None, a=None, r=1., scale=None,
 
     if pos is None:
         pos = random_layout(g, dim=2)
-    _check_prop_vector(pos, name="pos", floating=True)
+    _check_pos(g, pos, 2)
 
     if a is None:
         a = float(g.num_vertices())
@@ -339,16 +379,18 @@ def arf_layout(g, weight=None, d=0.5, a=10, dt=0.001, epsilon=1e-6,
     max_iter : int (optional, default: ``1000``)
         Maximum number of iterations. If this value is ``0``, it runs until
         convergence.
-    pos : :class:`~graph_tool.PropertyMap` (optional, default: ``None``)
-        Vector vertex property maps where the coordinates should be stored.
+    pos : :class:`~graph_tool.PropertyMap` or :class:`numpy.ndarray` (optional, default: ``None``)
+        Vector vertex property maps where the coordinates should be stored. It
+        can also be an array of shape ``(N, dim)``, as accepted by
+        :func:`random_layout`, which is then updated in place.
     dim : int (optional, default: ``2``)
         Number of coordinates per vertex.
 
     Returns
     -------
-    pos : :class:`~graph_tool.PropertyMap`
+    pos : :class:`~graph_tool.PropertyMap` or :class:`numpy.ndarray`
         A vector-valued vertex property map with the coordinates of the
-        vertices.
+        vertices, or the array given as ``pos``.
 
     Notes
     -----
@@ -389,7 +431,7 @@ def arf_layout(g, weight=None, d=0.5, a=10, dt=0.001, epsilon=1e-6,
 
     if pos is None:
         pos = random_layout(g, dim=dim)
-    _check_prop_vector(pos, name="pos", floating=True)
+    _check_pos(g, pos, dim)
 
     ug = GraphView(g, directed=False)
     libgraph_tool_layout.arf_layout(ug._Graph__graph, _prop("v", g, pos),
@@ -425,8 +467,11 @@ def _coarse_graph(g, vweight, eweight, mivs=False, groups=None):
     return cg, cc, vcount, ecount, c, mivs
 
 
-def _propagate_pos(g, cg, c, cc, cpos, delta, mivs):
-    pos = g.new_vertex_property(cpos.value_type())
+def _propagate_pos(g, cg, c, cc, cpos, delta, mivs, pos=None):
+    if pos is None:
+        pos = g.new_vertex_property(cpos.value_type())
+    else:
+        pos[g.get_vertices()] = 0
 
     if mivs is not None:
         g = GraphView(g, vfilt=mivs)
@@ -462,7 +507,7 @@ def _avg_edge_distance(g, pos):
 
 def coarse_graphs(g, method="hybrid", mivs_thres=0.9, ec_thres=0.75,
                   weighted_coarse=False, eweight=None, vweight=None,
-                  groups=None, verbose=False):
+                  groups=None, verbose=False, pos=None):
     cg = [[g, None, None, None, None, None]]
     if weighted_coarse:
         cg[-1][2], cg[-1][3] = vweight, eweight
@@ -485,7 +530,8 @@ def coarse_graphs(g, method="hybrid", mivs_thres=0.9, ec_thres=0.75,
             print(u[0].num_vertices())
     cg.reverse()
     Ks = []
-    pos = random_layout(cg[0][0], dim=2)
+    fpos = pos  # array with the positions of the finest level, if given
+    pos = random_layout(cg[0][0], dim=2, pos=fpos if len(cg) == 1 else None)
     for i in range(len(cg)):
         if i == 0:
             u = cg[i][0]
@@ -517,10 +563,11 @@ def coarse_graphs(g, method="hybrid", mivs_thres=0.9, ec_thres=0.75,
                 print("propagating...", end=' ')
                 print(mivs.a.sum() if mivs is not None else "")
             pos = _propagate_pos(cg[i + 1][0], u, c, cc, pos,
-                                 Ks[i] / 1000., mivs)
+                                 Ks[i] / 1000., mivs,
+                                 fpos if i == len(cg) - 2 else None)
 
 def coarse_graph_stack(g, c, coarse_stack, eweight=None, vweight=None,
-                       weighted_coarse=True, verbose=False):
+                       weighted_coarse=True, verbose=False, pos=None):
     cg = [[g, c, None, None]]
     if weighted_coarse:
         cg[-1][2], cg[-1][3] = vweight, eweight
@@ -535,7 +582,8 @@ def coarse_graph_stack(g, c, coarse_stack, eweight=None, vweight=None,
             print(u.num_vertices())
     cg.reverse()
     Ks = []
-    pos = random_layout(cg[0][0], dim=2)
+    fpos = pos  # array with the positions of the finest level, if given
+    pos = random_layout(cg[0][0], dim=2, pos=fpos if len(cg) == 1 else None)
     for i in range(len(cg)):
         if i == 0:
             u = cg[i][0]
@@ -566,7 +614,8 @@ def coarse_graph_stack(g, c, coarse_stack, eweight=None, vweight=None,
             if verbose:
                 print("propagating...")
             pos = _propagate_pos(cg[i + 1][0], u, c, u.vertex_index.copy("int"),
-                                 pos, Ks[i] / 1000., None)
+                                 pos, Ks[i] / 1000., None,
+                                 fpos if i == len(cg) - 2 else None)
 
 
 def sfdp_layout(g, vweight=None, eweight=None, pin=None, groups=None, C=0.2,
@@ -622,8 +671,11 @@ def sfdp_layout(g, vweight=None, eweight=None, pin=None, groups=None, C=0.2,
     max_iter : int (optional, default: ``0``)
         Maximum number of iterations. If this value is ``0``, it runs until
         convergence.
-    pos : :class:`~graph_tool.PropertyMap` (optional, default: ``None``)
-        Initial vertex layout. If not provided, it will be randomly chosen.
+    pos : :class:`~graph_tool.PropertyMap` or :class:`numpy.ndarray` (optional, default: ``None``)
+        Initial vertex layout. If not provided, it will be randomly chosen. It
+        can also be an array of shape ``(N, 2)``, as accepted by
+        :func:`random_layout`, in which case the final layout is stored in it,
+        without allocating a vector for each vertex.
     multilevel : bool (optional, default: ``None``)
         Use a multilevel layout algorithm. If ``None`` is given, it will be
         activated based on the size of the graph.
@@ -643,9 +695,9 @@ def sfdp_layout(g, vweight=None, eweight=None, pin=None, groups=None, C=0.2,
 
     Returns
     -------
-    pos : :class:`~graph_tool.PropertyMap`
+    pos : :class:`~graph_tool.PropertyMap` or :class:`numpy.ndarray`
         A vector-valued vertex property map with the coordinates of the
-        vertices.
+        vertices, or the array given as ``pos``.
 
     Notes
     -----
@@ -684,7 +736,8 @@ def sfdp_layout(g, vweight=None, eweight=None, pin=None, groups=None, C=0.2,
 
     if pos is None:
         pos = random_layout(g, dim=2)
-    _check_prop_vector(pos, name="pos", floating=True)
+    _check_pos(g, pos, 2)
+    flat = isinstance(pos, numpy.ndarray)
 
     g_ = g
     g = GraphView(g, directed=False)
@@ -715,11 +768,13 @@ def sfdp_layout(g, vweight=None, eweight=None, pin=None, groups=None, C=0.2,
                                 eweight=eweight,
                                 vweight=vweight,
                                 groups=groups,
-                                verbose=verbose)
+                                verbose=verbose,
+                                pos=pos if flat else None)
         else:
             cgs = coarse_graph_stack(g, coarse_stack[0], coarse_stack[1],
                                      eweight=eweight, vweight=vweight,
-                                     verbose=verbose)
+                                     verbose=verbose,
+                                     pos=pos if flat else None)
         for count, (u, pos, K, vcount, ecount) in enumerate(cgs):
             if verbose:
                 print("Positioning level:", count, u.num_vertices(), end=' ')
@@ -739,13 +794,16 @@ def sfdp_layout(g, vweight=None, eweight=None, pin=None, groups=None, C=0.2,
                               #               _avg_edge_distance(u, pos)),
                               multilevel=False,
                               verbose=False)
-        pos = g_.own_property(pos)
+        if not flat:
+            pos = g_.own_property(pos)
         return pos
 
     if g.num_vertices() <= 1:
         return pos
     if g.num_vertices() == 2:
         vs = [g.vertex(0, False), g.vertex(1, False)]
+        if flat:
+            vs = [int(v) for v in vs]
         pos[vs[0]] = [0, 0]
         pos[vs[1]] = [1, 1]
         return pos
@@ -764,7 +822,8 @@ def sfdp_layout(g, vweight=None, eweight=None, pin=None, groups=None, C=0.2,
                                      theta, init_step, cooling_step, max_level,
                                      epsilon, max_iter, not adaptive_cooling,
                                      verbose, _get_rng())
-    pos = g_.own_property(pos)
+    if not flat:
+        pos = g_.own_property(pos)
     return pos
 
 def radial_tree_layout(g, root, rel_order=None, rel_order_leaf=False,
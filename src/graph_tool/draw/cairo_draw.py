@@ -96,7 +96,7 @@ except ImportError:
     warnings.warn(msg, RuntimeWarning)
 
 from .. draw import sfdp_layout, random_layout, _avg_edge_distance, \
-    coarse_graphs, radial_tree_layout, prop_to_size
+    coarse_graphs, radial_tree_layout, prop_to_size, _pos_property
 
 from .. generation import graph_union
 from .. topology import shortest_path
@@ -560,9 +560,10 @@ def cairo_draw(g, pos, cr, vprops=None, eprops=None, vorder=None, eorder=None,
     ----------
     g : :class:`~graph_tool.Graph`
         Graph to be drawn.
-    pos : :class:`~graph_tool.PropertyMap`
+    pos : :class:`~graph_tool.PropertyMap` or :class:`numpy.ndarray`
         Vector-valued vertex property map containing the x and y coordinates of
-        the vertices.
+        the vertices, or an array of shape ``(N, 2)`` with the coordinates of
+        each vertex index, as returned by the layout functions.
     cr : :class:`~cairo.Context`
         A :class:`~cairo.Context` instance.
     vprops : dict (optional, default: ``None``)
@@ -626,6 +627,8 @@ def cairo_draw(g, pos, cr, vprops=None, eprops=None, vorder=None, eorder=None,
     if vorder is not None:
         _check_prop_scalar(vorder, name="vorder")
 
+    pos = _pos_property(g, pos)
+
     vprops = {} if vprops is None else copy.copy(vprops)
     eprops = {} if eprops is None else copy.copy(eprops)
 
@@ -761,9 +764,11 @@ def graph_draw(g, pos=None, vprops=None, eprops=None, vorder=None, eorder=None,
     ----------
     g : :class:`~graph_tool.Graph`
         Graph to be drawn.
-    pos : :class:`~graph_tool.PropertyMap` (optional, default: ``None``)
+    pos : :class:`~graph_tool.PropertyMap` or :class:`numpy.ndarray` (optional, default: ``None``)
         Vector-valued vertex property map containing the x and y coordinates of
-        the vertices. If not given, it will be computed using :func:`sfdp_layout`.
+        the vertices, or an array of shape ``(N, 2)`` with the coordinates of
+        each vertex index, as returned by the layout functions. If not given, it
+        will be computed using :func:`sfdp_layout`.
     vprops : dict (optional, default: ``None``)
         Dictionary with the vertex properties. Individual properties may also be
         given via the ``vertex_<prop-name>`` parameters, where ``<prop-name>`` is
@@ -819,8 +824,9 @@ def graph_draw(g, pos=None, vprops=None, eprops=None, vorder=None, eorder=None,
 
     Returns
     -------
-    pos : :class:`~graph_tool.PropertyMap`
-        Vector vertex property map with the x and y coordinates of the vertices.
+    pos : :class:`~graph_tool.PropertyMap` or :class:`numpy.ndarray`
+        Vector vertex property map with the x and y coordinates of the vertices,
+        or the array given as ``pos``.
     selected : :class:`~graph_tool.PropertyMap` (optional, only if ``output is None``)
         Boolean-valued vertex property map marking the vertices which were
         selected interactively.
@@ -1031,6 +1037,9 @@ def graph_draw(g, pos=None, vprops=None, eprops=None, vorder=None, eorder=None,
     props = _convert_props(props, "e", g, kwargs.get("ecmap", default_cm))
     eprops.update(props)
 
+    flat_pos = pos if isinstance(pos, numpy.ndarray) else None
+    pos = _pos_property(g, pos)
+
     if pos is None:
         if (g.num_vertices() > 2 and output is None and
             not inline and kwargs.get("update_layout", True) and
@@ -1109,7 +1118,7 @@ def graph_draw(g, pos=None, vprops=None, eprops=None, vorder=None, eorder=None,
             ax.set_xlim(l - w * .1, r + w * .1)
             ax.set_ylim(b - h * .1, t + h * .1)
 
-        return pos
+        return pos if flat_pos is None else flat_pos
 
     output_file = output
     if inline and output is None:
@@ -1212,7 +1221,7 @@ def graph_draw(g, pos=None, vprops=None, eprops=None, vorder=None, eorder=None,
             srf.finish()
             IPython.display.display(img)
         del srf
-        return pos
+        return pos if flat_pos is None else flat_pos
 
 
 def adjust_default_sizes(g, geometry, vprops, eprops, force=False):
@@ -49,6 +49,8 @@ Summary
    transitive_closure
    tsp_tour
    sequential_vertex_coloring
+   vertex_ordering
+   edge_span
    label_components
    label_biconnected_components
    label_largest_component
@@ -90,7 +92,8 @@ __all__ = ["isomorphism", "subgraph_isomorphism", "mark_subgraph",
            "shortest_distance", "shortest_path", "all_shortest_paths",
            "all_predecessors", "all_paths", "all_circuits", "pseudo_diameter",
            "is_bipartite", "is_DAG", "is_planar", "make_maximal_planar",
-           "similarity", "vertex_similarity", "edge_reciprocity"]
+           "similarity", "vertex_similarity", "edge_reciprocity",
+           "vertex_ordering", "edge_span"]
 
 def similarity(g1, g2, eweight1=None, eweight2=None, label1=None, label2=None,
                norm=True, p=1., distance=False, asymmetric=False):
@@ -2878,4 +2881,117 @@ def sequential_vertex_coloring(g, order=None, color=None):
     return color
 
 
+def vertex_ordering(g, method="rcm", window=5, max_deg=1000):
+    r"""Return a vertex ordering that improves the memory locality of
+    traversals, to be used with :meth:`~graph_tool.Graph.reorder_vertices`.
+
+    Parameters
+    ----------
+    g : :class:`~graph_tool.Graph`
+        Graph to be used.
+    method : ``str`` (optional, default: ``"rcm"``)
+        Ordering heuristic. It can be either ``"rcm"`` (reverse Cuthill-McKee),
+        ``"degree"`` (descending degree) or ``"window"`` (Gorder-style greedy
+        window ordering).
+    window : ``int`` (optional, default: ``5``)
+        Size of the window of recently placed vertices used by
+        ``method == "window"``.
+    max_deg : ``int`` (optional, default: ``1000``)
+        Vertices with degree larger than this value are not traversed when
+        counting common neighbors with ``method == "window"``.
+
+    Returns
+    -------
+    order : :class:`~graph_tool.PropertyMap`
+        Vertex property map with the new position of each vertex.
+
+    Notes
+    -----
+    The reverse Cuthill-McKee ordering [cuthill-mckee]_ traverses each
+    component in breadth-first order, starting from a vertex with minimum
+    degree, and visiting the neighbors in increasing order of degree. The
+    resulting sequence is then reversed.
+
+    The window ordering is a simplified version of Gorder [gorder]_, which
+    greedily places next the vertex with the largest number of neighbors and
+    common neighbors among the last ``window`` placed vertices.
+
+    The graph is always considered to be undirected. If the graph is
+    filtered, the filtered-out vertices are placed at the end, in their
+    current relative order.
+
+    The time complexity is :math:`O(V\log V + E)` for ``"rcm"`` and
+    ``"degree"``, and :math:`O(\sum_v k_v\min(k_v, d)\log V)` for
+    ``"window"``, where :math:`d` is ``max_deg``.
+
+    Examples
+    --------
+    .. testcode::
+       :hide:
+
+       import numpy.random
+       numpy.random.seed(42)
+       gt.seed_rng(42)
+
+    >>> g = gt.lattice([30, 30])
+    >>> g.reorder_vertices(numpy.random.permutation(g.num_vertices()))
+    >>> order = gt.vertex_ordering(g, "rcm")
+    >>> before = gt.edge_span(g)
+    >>> g.reorder_vertices(order)
+    >>> after = gt.edge_span(g)
+    >>> after[0] < before[0]
+    True
+
+    References
+    ----------
+    .. [cuthill-mckee] E. Cuthill and J. McKee, "Reducing the bandwidth of
+       sparse symmetric matrices", Proc. 24th Nat. Conf. ACM, pp. 157-172
+       (1969), :doi:`10.1145/800195.805928`
+    .. [gorder] H. Wei, J. X. Yu, C. Lu, X. Lin, "Speedup Graph Processing by
+       Graph Ordering", Proc. SIGMOD, pp. 1813-1828 (2016),
+       :doi:`10.1145/2882903.2915220`
+    """
+
+    if method not in ["rcm", "degree", "window"]:
+        raise ValueError("invalid ordering method: " + str(method))
+    order = g.new_vertex_property("int64_t")
+    libgraph_tool_topology.vertex_ordering(g._Graph__graph, method,
+                                           _prop("v", g, order),
+                                           window, max_deg)
+    return order
+
+def edge_span(g, order=None):
+    r"""Return the average index gap between the endpoints of the edges, which
+    measures the memory locality of the graph layout.
+
+    Parameters
+    ----------
+    g : :class:`~graph_tool.Graph`
+        Graph to be used.
+    order : :class:`~graph_tool.PropertyMap` (optional, default: ``None``)
+        Vertex positions to be used. If not given, the vertex index is used.
+
+    Returns
+    -------
+    span : ``float``
+        Average value of :math:`|i_s - i_t|` over all edges :math:`(s,t)`.
+    log_span : ``float``
+        Average value of :math:`\log_2(1 + |i_s - i_t|)` over all edges.
+
+    Notes
+    -----
+    This can be used to evaluate the benefit of :func:`vertex_ordering`, by
+    comparing the values before and after
+    :meth:`~graph_tool.Graph.reorder_vertices`, or by passing the ordering
+    directly as the ``order`` parameter.
+
+    The time complexity is :math:`O(E)`.
+    """
+
+    if order is None:
+        order = g.vertex_index
+    return libgraph_tool_topology.edge_span(g._Graph__graph,
+                                            _prop("v", g, order))
+
+
 from .. flow import libgraph_tool_flow
\ No newline at end of file